@@ -358,6 +358,7 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             continue;
         }
         buf->datalen = datalen;
+        buf->flags = 0;
         suite = ccnl_pkt2suite(buf->data, datalen, &skip);
 
         pk = NULL;
@@ -525,27 +526,37 @@ ccnl_android_http_io(int fd, int events, void *data)
             // we should check if there are pending clients ...
             return 0;
         } else if (len > 0) {
-            http->in[len] = 0;
+            http->inlen += len;
+            http->in[http->inlen] = 0;
             ccnl_http_status(relay, http);
+            if (http->steps) // answering: be called whenever we can send
+                ALooper_addFd(theLooper, http->client, ALOOPER_POLL_CALLBACK,
+                              ALOOPER_EVENT_INPUT | ALOOPER_EVENT_OUTPUT,
+                              ccnl_android_http_io, relay);
         }
     }
-    if (http->outlen > 0 && (events | ALOOPER_EVENT_OUTPUT)) {
-        int len = send(http->client, http->out + http->outoffs,
-                       http->outlen, 0);
-        if (len > 0) {
-            http->outlen -= len;
-            http->outoffs += len;
-            if (http->outlen <= 0) {
-                ALooper_removeFd(theLooper, http->client);
-                close(http->client);
-                http->client = 0;
-                // we should check if there are pending clients ...
-                DEBUGMSG(TRACE, " http closed\n");
-                return 0;
-            } else {
-                DEBUGMSG(TRACE, " http more to send %d\n", http->outlen);
+    if (events | ALOOPER_EVENT_OUTPUT) {
+        // the page is rendered piecewise, whenever the buffer has drained
+        if (http->outlen <= 0)
+            ccnl_http_more(relay, http);
+        if (http->outlen > 0) {
+            int len = send(http->client, http->out + http->outoffs,
+                           http->outlen, 0);
+            if (len > 0) {
+                http->outlen -= len;
+                http->outoffs += len;
             }
         }
+        if (http->outlen <= 0 && ccnl_http_more(relay, http)
+                              && http->outlen <= 0) {
+            ALooper_removeFd(theLooper, http->client);
+            close(http->client);
+            http->client = 0;
+            // we should check if there are pending clients ...
+            DEBUGMSG(TRACE, " http closed\n");
+            return 0;
+        }
+        DEBUGMSG(TRACE, " http more to send %d\n", http->outlen);
     }
 
     return 1; // continue receiving callbacks
@@ -574,6 +585,7 @@ ccnl_android_http_accept(int fd, int events, void *data)
     else {
         DEBUGMSG(DEBUG, "accepted web server client fd=%d\n", http->client);
         http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
+        http->steps = NULL;
 
         ALooper_addFd(theLooper, http->client,
                       ALOOPER_POLL_CALLBACK,
@@ -22,6 +22,7 @@
 #ifndef CCNL_LINUXKERNEL
 #include <unistd.h> //FIXME: SWITCH HERE
 #include <string.h>
+#include <stdint.h>
 #endif
 #include <stddef.h>
 
@@ -31,6 +32,7 @@ struct ccnl_relay_s;
 struct ccnl_buf_s {
     struct ccnl_buf_s *next;
     size_t datalen;
+    uint8_t flags;
     unsigned char data[1];
 };
 
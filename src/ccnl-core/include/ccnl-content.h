@@ -33,6 +33,8 @@
 struct ccnl_pkt_s;
 struct ccnl_prefix_s;
 
+#define CCNL_CONTENT_DIGEST_LEN     32  /**< length of the implicit SHA-256 digest */
+
 /**
  * @brief Defines if content added to the content store is
  * static or stale.
@@ -66,6 +68,8 @@ typedef struct ccnl_content_s {
     evtimer_msg_event_t evtmsg_cstimeout; /**< event timer message which is triggered when a timeout in the content store occurs */
 #endif
     int served_cnt;                       /**< determines how often the content has been served */
+    bool has_digest;                      /**< indicates if \p digest is computed */
+    uint8_t digest[CCNL_CONTENT_DIGEST_LEN]; /**< implicit digest of the packet, see \ref ccnl_content_digest */
 } ccnl_content;
 
 /**
@@ -89,5 +93,34 @@ ccnl_content_new(struct ccnl_pkt_s **packet);
 int
 ccnl_content_free(struct ccnl_content_s *content);
 
+/**
+ * @brief Returns the implicit SHA-256 digest of a \p content object
+ *
+ * The digest is computed over the packet on first use and kept with the
+ * content object, so later lookups by full name do not hash again.
+ *
+ * @param[in] content The content object
+ *
+ * @return Upon success, a pointer to \ref CCNL_CONTENT_DIGEST_LEN bytes
+ * @return NULL if digests are not supported or the packet has no bytes
+ */
+uint8_t*
+ccnl_content_digest(struct ccnl_content_s *content);
+
+/**
+ * @brief Checks if \p name is the full name of \p content
+ *
+ * A full name is the name of the content object followed by its implicit
+ * digest. The digest is only looked at if all other components match.
+ *
+ * @param[in] content The content object
+ * @param[in] name    The name to compare with
+ *
+ * @return 1 if \p name is the full name of \p content, 0 otherwise
+ */
+int
+ccnl_content_matchFullName(struct ccnl_content_s *content,
+                           struct ccnl_prefix_s *name);
+
 #endif // EOF
 /** @} */
@@ -29,6 +29,7 @@
 #include "ccnl-face.h"
 #include "ccnl-frag.h"
 #include "ccnl-interest.h"
+#include "ccnl-linkrel.h"
 #include "ccnl-malloc.h"
 #include "ccnl-os-time.h"
 #include "ccnl-pkt.h"
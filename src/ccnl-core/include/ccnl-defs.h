@@ -44,6 +44,7 @@
 #  define CCNL_MAX_INTERFACES            1
 # endif
 # define CCNL_MAX_IF_QLEN                14
+# define CCNL_MAX_IF_SUBQ                3
 #ifndef CCNL_MAX_PACKET_SIZE
 # define CCNL_MAX_PACKET_SIZE            120
 #endif
@@ -56,6 +57,7 @@
 #elif defined(CCNL_ANDROID) // max of BTLE and 2xUDP
 # define CCNL_MAX_INTERFACES             3
 # define CCNL_MAX_IF_QLEN                10
+# define CCNL_MAX_IF_SUBQ                4
 # define CCNL_MAX_PACKET_SIZE            4096
 # define CCNL_MAX_ADDRESS_LEN            6
 # define CCNL_MAX_NAME_COMP              16
@@ -64,6 +66,7 @@
 #else
 # define CCNL_MAX_INTERFACES             10
 # define CCNL_MAX_IF_QLEN                64
+# define CCNL_MAX_IF_SUBQ                16
 # define CCNL_MAX_PACKET_SIZE            8096
 # define CCNL_MAX_ADDRESS_LEN            6
 # define CCNL_MAX_NAME_COMP              64
@@ -71,6 +74,28 @@
 # define CCNL_DEFAULT_MAX_PIT_ENTRIES    (-1)
 #endif
 
+#ifndef CCNL_DEFAULT_MAX_PIT_BYTES
+# if defined(CCNL_RIOT) || defined(CCNL_ARDUINO) || defined(CCNL_ANDROID)
+#  define CCNL_DEFAULT_MAX_PIT_BYTES     0 // bounded by the number of entries
+# else
+#  define CCNL_DEFAULT_MAX_PIT_BYTES     (64 * 1024 * 1024)
+# endif
+#endif
+#ifndef CCNL_DEFAULT_FACE_IBURST
+# define CCNL_DEFAULT_FACE_IBURST        64 // Interests a face may send at once
+#endif
+
+#ifndef CCNL_IF_DRR_QUANTUM
+# define CCNL_IF_DRR_QUANTUM             1500 // bytes per round and weight unit
+#endif
+
+#ifndef CCNL_IF_SOJOURN_TARGET
+# define CCNL_IF_SOJOURN_TARGET          5000   // usec, acceptable queueing
+#endif
+#ifndef CCNL_IF_SOJOURN_INTERVAL
+# define CCNL_IF_SOJOURN_INTERVAL        100000 // usec above target to mark
+#endif
+
 #ifndef CCNL_CONTENT_TIMEOUT
 # define CCNL_CONTENT_TIMEOUT            300 // sec
 #endif
@@ -86,6 +111,16 @@
 # define CCNL_FACE_TIMEOUT       30 // sec
 #endif
 
+#ifndef CCNL_MAX_DUMPS
+# define CCNL_MAX_DUMPS                  8    // table dumps open at once
+#endif
+#ifndef CCNL_DUMP_TIMEOUT
+# define CCNL_DUMP_TIMEOUT               60   // sec a dump is kept between pages
+#endif
+#ifndef CCNL_DUMP_SCAN
+# define CCNL_DUMP_SCAN                  4096 // entries looked at per page
+#endif
+
 #define CCNL_DEFAULT_MAX_CACHE_ENTRIES  0   // means: no content caching
 #ifdef CCNL_RIOT
 #define CCNL_MAX_NONCES                 -1 // -1 --> detect dups by PIT
@@ -111,6 +146,29 @@ enum {
 
 #define CCNL_SUITE_DEFAULT (CCNL_SUITE_LAST - 1)
 
+// single suite builds (cmake -DCCNL_SINGLE_SUITE=NDN|CCNX): every packet
+// has the same suite, so suite tests fold into constants
+#if defined(CCNL_SUITE_FIXED_NDNTLV) && defined(USE_SUITE_NDNTLV)
+# define CCNL_SUITE_FIXED       CCNL_SUITE_NDNTLV
+#elif defined(CCNL_SUITE_FIXED_CCNTLV) && defined(USE_SUITE_CCNTLV)
+# define CCNL_SUITE_FIXED       CCNL_SUITE_CCNTLV
+#elif defined(CCNL_SUITE_FIXED_NDNTLV) || defined(CCNL_SUITE_FIXED_CCNTLV)
+# error "the fixed suite is not enabled (USE_SUITE_*)"
+#endif
+
+#ifdef CCNL_SUITE_FIXED
+# define CCNL_SUITE_OF(x)       ((void) (x), CCNL_SUITE_FIXED)
+#else
+# define CCNL_SUITE_OF(x)       ((x)->suite)
+#endif
+
+// hint for the walks over the (linked) CS, PIT and FIB
+#if defined(__GNUC__) || defined(__clang__)
+# define CCNL_PREFETCH(p)       __builtin_prefetch(p)
+#else
+# define CCNL_PREFETCH(p)       ((void) (p))
+#endif
+
 // ----------------------------------------------------------------------
 // our own packet format extension for switching encodings:
 // 0x80 followed by:
@@ -146,6 +204,10 @@ typedef enum ccnl_enc_e {
 #define CCNL_DTAG_MTU           99010 //
 #define CCNL_DTAG_WPANADR       99011 // newface: WPAN 
 #define CCNL_DTAG_WPANPANID     99012 // newface: WPAN 
+#define CCNL_DTAG_ROUTES        99013 // prefixregbatch: lines of a route file
+#define CCNL_DTAG_LASTPART      99014 // prefixregbatch: the batch is complete
+#define CCNL_DTAG_CURSOR        99015 // tabledump: where the next page starts
+#define CCNL_DTAG_WEIGHT        99016 // setweight: DRR share of a face
 
 #define CCNL_DTAG_DEBUGREQUEST  99100 //
 #define CCNL_DTAG_DEBUGACTION   99101 // dump, halt, dump+halt
@@ -240,6 +302,9 @@ typedef enum ccnl_enc_e {
 #define CCNL_FACE_FLAGS_REFLECT 2
 #define CCNL_FACE_FLAGS_SERVED  4
 #define CCNL_FACE_FLAGS_FWDALLI 8 // forward all interests, also known ones
+#define CCNL_FACE_FLAGS_LINKREL 32 // hop-by-hop ACK/retransmit (NDNLPv2)
+
+#define CCNL_BUF_FLAGS_PRIO     1 // reply to a mgmt request, strict priority on TX
 
 #define CCNL_FRAG_NONE          0
 #define CCNL_FRAG_SEQUENCED2012 1
@@ -258,9 +323,9 @@ typedef enum ccnl_enc_e {
 
 
 #ifdef USE_CCNxDIGEST
-#  define compute_ccnx_digest(buf) SHA256(buf->data, buf->datalen, NULL)
+#  define compute_ccnx_digest(buf, md) SHA256((buf)->data, (buf)->datalen, (md))
 #else
-#  define compute_ccnx_digest(b) NULL
+#  define compute_ccnx_digest(b, md) NULL
 #endif
 
 #endif //CCNL_DEFS_H
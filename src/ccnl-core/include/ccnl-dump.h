@@ -69,4 +69,114 @@ int get_pendint_dump(int lev, void *p, char **out);
 int get_num_contents(void *p);
 int get_content_dump(int lev, void *p, long *content, long *next, long *prev, int *last_use, int *served_cnt, int *prefixlen, char **prefix);
 
+/**
+ * @brief The tables of a relay that can be dumped page by page
+ */
+enum {
+    CCNL_DUMP_FACES = 1,        /**< the faces */
+    CCNL_DUMP_FIB,              /**< the FIB entries */
+    CCNL_DUMP_PIT,              /**< the pending Interests */
+    CCNL_DUMP_CS                /**< the cached content */
+};
+
+struct ccnl_relay_s;
+struct ccnl_prefix_s;
+
+/**
+ * @brief Where a dump of one of the relay's tables continues
+ *
+ * A dump is produced page by page, each page looks at a bounded number of
+ * entries. In between, the relay moves the cursor off any entry it removes:
+ * entries added or removed while a dump runs may be missed, but all others
+ * are listed exactly once.
+ */
+struct ccnl_dump_s {
+    struct ccnl_dump_s *next;
+    uint32_t id;                    /**< names the cursor to clients, not 0 */
+    int table;                      /**< CCNL_DUMP_* */
+    void *entry;                    /**< entry to look at next, NULL: done */
+    struct ccnl_prefix_s *prefix;   /**< only names under it, NULL: all */
+    int faceid;                     /**< only entries of this face, -1: all */
+    unsigned long pos;              /**< number of entries listed so far */
+    double last_used;
+};
+
+/**
+ * @brief Table name ("faces", "fib", "pit" or "cs") to CCNL_DUMP_*
+ *
+ * @return the table, -1 if unknown
+ */
+int
+ccnl_dump_str2table(const char *s);
+
+/**
+ * @brief CCNL_DUMP_* to the table name
+ */
+const char*
+ccnl_dump_table2str(int table);
+
+/**
+ * @brief Opens a cursor at the start of a table
+ *
+ * Of at most CCNL_MAX_DUMPS cursors, the one longest unused is dropped to
+ * make room; cursors unused for CCNL_DUMP_TIMEOUT seconds are dropped, too.
+ *
+ * @param[in] relay  the relay whose table is dumped
+ * @param[in] table  CCNL_DUMP_*
+ * @param[in] prefix filter on the names of FIB, PIT and CS entries, NULL:
+ *                   none; owned by the cursor, also on failure
+ * @param[in] faceid filter on the face of faces, FIB and PIT entries, -1:
+ *                   none
+ *
+ * @return the cursor, NULL on out of memory or an unknown table
+ */
+struct ccnl_dump_s*
+ccnl_dump_open(struct ccnl_relay_s *relay, int table,
+               struct ccnl_prefix_s *prefix, int faceid);
+
+/**
+ * @brief Looks up an open cursor
+ *
+ * @return the cursor, NULL if it was closed or expired
+ */
+struct ccnl_dump_s*
+ccnl_dump_find(struct ccnl_relay_s *relay, uint32_t id);
+
+/**
+ * @brief The next entry of a dump that passes the filters
+ *
+ * Skips entries that do not pass, each entry looked at costs one of
+ * \p budget. The entry stays the next one until ccnl_dump_consume().
+ *
+ * @return the entry, NULL if the table is done (d->entry is NULL) or the
+ *         budget is spent
+ */
+void*
+ccnl_dump_peek(struct ccnl_dump_s *d, int *budget);
+
+/**
+ * @brief Moves a cursor past the entry returned by ccnl_dump_peek()
+ */
+void
+ccnl_dump_consume(struct ccnl_dump_s *d);
+
+/**
+ * @brief Closes a cursor
+ */
+void
+ccnl_dump_close(struct ccnl_relay_s *relay, struct ccnl_dump_s *d);
+
+/**
+ * @brief Moves the cursors at \p entry to its successor, to be called
+ *        before a face, FIB, PIT or CS entry is unlinked
+ */
+void
+ccnl_dump_forget(struct ccnl_relay_s *relay, void *entry);
+
+/**
+ * @brief Closes all cursors of a relay
+ */
+void
+ccnl_dump_cleanup(struct ccnl_relay_s *relay);
+
 #endif // CCNL_DUMP_H
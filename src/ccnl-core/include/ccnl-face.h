@@ -24,11 +24,15 @@
 #define CCNL_FACE_H
 
 #include "ccnl-sockunion.h"
+#include "ccnl-os-time.h"
 
 #ifdef CCNL_RIOT
 #include "evtimer_msg.h"
 #endif
 
+struct ccnl_interest_s;
+struct ccnl_fib_batch_s;
+
 struct ccnl_face_s {
     struct ccnl_face_s *next, *prev;
     int faceid;
@@ -36,9 +40,20 @@ struct ccnl_face_s {
     sockunion peer;
     int flags;
     int last_used; // updated when we receive a packet
+    int weight; // DRR share on the outgoing interface, <= 0 means 1
+    int irate;  // admitted incoming Interests per second, 0: unlimited
+    int iburst; // token bucket depth, in Interests
+    int64_t itokens; // available tokens, in millionths of an Interest
+    struct timeval itokens_ts; // last token refill
+    int pitcnt; // PIT entries created by Interests from this face
+    struct ccnl_interest_s *pit, *pitend; // those entries, newest first
+    uint32_t ilimit_cnt;    // Interests dropped by the rate limit
+    uint32_t ioverload_cnt; // own Interests rejected or evicted on PIT overload
     struct ccnl_buf_s *outq, *outqend; // queue of packets to send
     struct ccnl_frag_s *frag;  // which special datagram armoring
+    struct ccnl_linkrel_s *linkrel; // hop-by-hop reliability, if enabled
     struct ccnl_sched_s *sched;
+    struct ccnl_fib_batch_s *fib_batch; // prefixregbatch being received
 #ifdef CCNL_RIOT
     evtimer_msg_event_t evtmsg_timeout;
 #endif
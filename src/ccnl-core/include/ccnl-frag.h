@@ -18,6 +18,7 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 reordering reassembly window, fragment views for TX
  */
 
 #ifndef CCNL_FRAG_H
@@ -26,10 +27,41 @@
 #include "ccnl-sockunion.h"
 #include "ccnl-face.h"
 #include "ccnl-relay.h"
+#include "ccnl-os-time.h"
 
 // returns >=0 if content consumed, buf and len pointers updated
-typedef int (RX_datagram)(struct ccnl_relay_s*, struct ccnl_face_s*,
-                          unsigned char**, int*);
+typedef int8_t (RX_datagram)(struct ccnl_relay_s*, struct ccnl_face_s*,
+                             uint8_t**, size_t*);
+
+#ifndef CCNL_FRAG_REASM_SLOTS
+# define CCNL_FRAG_REASM_SLOTS      32      // power of two, at most 0x4000
+#endif
+#ifndef CCNL_FRAG_REASM_TIMEOUT
+# define CCNL_FRAG_REASM_TIMEOUT    2000000 // usec a fragment waits for its peers
+#endif
+#define CCNL_FRAG_HDRMAX            16      // largest BeginEnd fragment header
+
+// a received fragment waiting for the rest of its packet
+struct ccnl_frag_slot_s {
+    struct ccnl_buf_s *buf;     // fragment payload, NULL if slot is free
+    unsigned int seqno;
+    unsigned char flags;        // CCNL_BEFRAG_FLAG_*
+    struct timeval rcvd;
+};
+
+/**
+ * @brief One outgoing fragment as header plus a view into the packet
+ *
+ * @p data points into the packet being fragmented and stays valid until
+ * the next call to ccnl_frag_getnextIov(), ccnl_frag_getnext() or
+ * ccnl_frag_reset() on the same fragmenter.
+ */
+struct ccnl_frag_iov_s {
+    uint8_t hdr[CCNL_FRAG_HDRMAX];
+    size_t hdrlen;
+    uint8_t *data;
+    size_t datalen;
+};
 
  struct ccnl_frag_s {
     int protocol; // fragmentation protocol, 0=none
@@ -42,7 +74,11 @@ typedef int (RX_datagram)(struct ccnl_relay_s*, struct ccnl_face_s*,
     int ifndx;
 
     // int insuite; // suite of incoming packet series
-    struct ccnl_buf_s *defrag; // incoming bytes
+    // incoming fragments by seqno % CCNL_FRAG_REASM_SLOTS; BeginEnd
+    // numbers every fragment, so packets may interleave and reorder
+    struct ccnl_frag_slot_s reasm[CCNL_FRAG_REASM_SLOTS];
+    unsigned int reasm_cnt;     // packets reassembled
+    unsigned int reasm_drop;    // fragments dropped (timeout, evicted, dup)
 
     unsigned int sendseq;
     unsigned int losscount;
@@ -84,6 +120,34 @@ ccnl_frag_getnextSEQD2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su);
 struct ccnl_buf_s*
 ccnl_frag_getnextBE2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su);
 
+/**
+ * @brief Computes the 16 bit BeginEnd field of the next fragment
+ *
+ * @param[in] fr      The fragmenter
+ * @param[in] datalen Payload bytes the next fragment carries
+ *
+ * @return flags in the two upper bits, the sequence number below
+ */
+uint16_t
+ccnl_frag_BEfields(struct ccnl_frag_s *fr, size_t datalen);
+
+/**
+ * @brief Produces the next fragment without copying its payload
+ *
+ * For senders that can gather (writev, sendmsg). ccnl_frag_getnext()
+ * is the same with header and payload copied into one buffer.
+ *
+ * @param[in] fr     The fragmenter
+ * @param[out] iov   Header and payload view of the fragment
+ * @param[out] ifndx Interface to send on, may be NULL
+ * @param[out] su    Destination, may be NULL
+ *
+ * @return 0 if a fragment was produced, -1 if there is none
+ */
+int
+ccnl_frag_getnextIov(struct ccnl_frag_s *fr, struct ccnl_frag_iov_s *iov,
+                     int *ifndx, sockunion *su);
+
 struct ccnl_buf_s*
 ccnl_frag_getnext(struct ccnl_frag_s *fr, int *ifndx, sockunion *su);
 
@@ -136,13 +200,20 @@ ccnl_frag_RX_Sequenced2015(RX_datagram callback, struct ccnl_relay_s *relay,
 
 #endif // OBSOLTE_BY_2015_06
 
+/**
+ * @brief Processes a BeginEnd fragment received on a face
+ *
+ * Fragments are kept per face in a window of CCNL_FRAG_REASM_SLOTS
+ * sequence numbers. A packet is passed to @p callback as soon as the
+ * run from its first to its last fragment is complete, in any arrival
+ * order. Fragments older than CCNL_FRAG_REASM_TIMEOUT are dropped.
+ *
+ * @return 1 if the fragment was consumed, 0 if it was ignored
+ */
 int
 ccnl_frag_RX_BeginEnd2015(RX_datagram callback, struct ccnl_relay_s *relay,
                           struct ccnl_face_s *from, int mtu,
                           unsigned int bits, unsigned int seqno,
-                          unsigned char **data, int *datalen);
-
-struct ccnl_buf_s*
-ccnl_frag_getnext(struct ccnl_frag_s *fr, int *ifndx, sockunion *su);
+                          uint8_t **data, size_t *datalen);
 
 #endif //CCNL_FRAG_H
@@ -29,14 +29,43 @@ struct ccnl_http_s {
     int server, client; // socket
     unsigned char in[512], *out; // ring buffers
     int inoffs, outoffs, inlen, outlen;
+    const int *steps;   // parts of the page being sent, NULL: no request yet
+    int step;           // the part rendered next
+    int table;          // CCNL_DUMP_* of a table page, 0: the status page
+    uint32_t dump;      // cursor of the table being rendered, 0: none
+    int started;        // the table's heading was rendered
+    int rows;           // rows of the table still to render, -1: all
+    int pagerows;       // rows per page, 0: the whole table
 };
 
 
 struct ccnl_http_s*
 ccnl_http_new(struct ccnl_relay_s *ccnl, int serverport);
 
+/**
+ * @brief Starts the answer to the request received by \p http
+ *
+ * GET / is the status page, with the first rows of the FIB and of the
+ * faces. GET /faces, /fib, /pit and /cs list a table page by page, with
+ * the query parameters prefix=URI (FIB, PIT, CS) and face=FACEID (faces,
+ * FIB, PIT) as filters, rows=N rows per page (0: all) and cursor=ID from
+ * the link to the next page.
+ *
+ * @return 0
+ */
 int ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http);
 
+/**
+ * @brief Renders more of the answer into the output buffer
+ *
+ * To be called whenever the output buffer has drained. Each call looks at
+ * no more than CCNL_DUMP_SCAN table entries, so a large table is rendered
+ * over many calls, in between of which the relay keeps forwarding.
+ *
+ * @return 1 if the answer is complete, 0 if there is more to come
+ */
+int ccnl_http_more(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http);
+
 struct ccnl_http_s*
 ccnl_http_cleanup(struct ccnl_http_s *http);
 
@@ -54,9 +83,6 @@ ccnl_cmpfaceid(const void *a, const void *b);
 int
 ccnl_cmpfib(const void *a, const void *b);
 
-int
-ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http);
-
 #endif //USE_HTTP_STATUS
 
 #endif //CCN_LITE_CCNL_HTTP_STATUS_H
@@ -35,8 +35,27 @@
 struct ccnl_txrequest_s {
     struct ccnl_buf_s *buf;
     sockunion dst;
-    void (*txdone)(void*, int, int);
+    void (*txdone)(void*, int, int); // length -1: dropped, not sent
     struct ccnl_face_s* txdone_face;
+    int prio; // whether the request goes to the strict-priority class
+    int next; // index of the next request in the same sub-queue, or -1
+    struct timeval enqueued;
+};
+
+/**
+ * @brief Per-face sub-queue of an interface's TX scheduler
+ *
+ * Sub-queue 0 is the strict-priority class for management and control
+ * traffic, all others are served deficit round-robin with a quantum of
+ * CCNL_IF_DRR_QUANTUM bytes times the weight of the owning face. An
+ * all-zero interface is a valid, empty scheduler.
+ */
+struct ccnl_if_subq_s {
+    struct ccnl_face_s *face; // owner while non-empty, NULL if unused
+    int head, tail;   // indices into the interface's request pool
+    size_t qlen;
+    int deficit;
+    int quantum;
 };
 
 struct ccnl_if_s { // interface for packet IO
@@ -61,16 +80,63 @@ struct ccnl_if_s { // interface for packet IO
     int fwdalli; // whether to forward all I packets rcvd on this interface
     uint32_t mtu;
 
-    size_t qlen;  // number of pending sends
-    size_t qfront; // index of next packet to send
+    size_t qlen;  // number of pending sends, over all sub-queues
+    int qfree;    // where to start looking for a free request slot
+    int drr_cur;  // sub-queue currently served by the round-robin
+    int above;    // whether the last sojourn time exceeded the target
+    struct timeval above_since;
     struct ccnl_txrequest_s queue[CCNL_MAX_IF_QLEN];
+    struct ccnl_if_subq_s subq[CCNL_MAX_IF_SUBQ];
     struct ccnl_sched_s *sched;
 
 #ifdef USE_STATS
-    uint32_t rx_cnt, tx_cnt;
+    uint32_t rx_cnt, tx_cnt, drop_cnt, mark_cnt;
 #endif
 };
 
+/**
+ * @brief Queues a TX request on the sub-queue of the sending face
+ *
+ * Requests with @c prio set (replies to mgmt requests) and requests without
+ * a face go to the strict-priority class. If the request pool is exhausted,
+ * the oldest request of the longest sub-queue is dropped, unless that is the
+ * sub-queue of the new request, in which case the new request is dropped.
+ * The txdone callback of a request pushed out is called with length -1.
+ *
+ * @param[in] i The interface to queue on
+ * @param[in] req The request to queue (copied)
+ *
+ * @return 0 on success, -1 if @p req was dropped (buffer is not freed)
+ */
+int
+ccnl_interface_sched_enqueue(struct ccnl_if_s *i, struct ccnl_txrequest_s *req);
+
+/**
+ * @brief Pops the next TX request: priority class first, then DRR
+ *
+ * @param[in] i The interface to dequeue from
+ * @param[out] req The dequeued request
+ *
+ * @return 0 on success, -1 if the interface has nothing to send
+ */
+int
+ccnl_interface_sched_dequeue(struct ccnl_if_s *i, struct ccnl_txrequest_s *req);
+
+/**
+ * @brief Decides whether a dequeued request should carry a congestion mark
+ *
+ * Like CoDel, the interface counts as congested once the sojourn time of
+ * every dequeued request stayed above CCNL_IF_SOJOURN_TARGET for at least
+ * CCNL_IF_SOJOURN_INTERVAL. A single request below target resets the state.
+ *
+ * @param[in] i The interface @p req was dequeued from
+ * @param[in] req The dequeued request
+ *
+ * @return 1 if congested, 0 otherwise
+ */
+int
+ccnl_interface_congested(struct ccnl_if_s *i, struct ccnl_txrequest_s *req);
+
 void
 ccnl_interface_cleanup(struct ccnl_if_s *i);
 
@@ -20,6 +20,7 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 in-record set instead of a linked list of pending faces
  */
 
 #ifndef CCNL_INTEREST_H
@@ -32,13 +33,31 @@
 #include "evtimer_msg.h"
 #endif
 
+#ifndef CCNL_PENDSET_INLINE
+# define CCNL_PENDSET_INLINE    4  /**< in-records kept without allocation */
+#endif
+
 /**
- * @brief A pending interest linked list element
+ * @brief A pending interest in-record: a face wanting the content
  */
-struct ccnl_pendint_s { 
-    struct ccnl_pendint_s *next; /**< pointer to the next list element */
-    struct ccnl_face_s *face;    /**< pointer to incoming face  */
-    uint32_t last_used;          /** */
+struct ccnl_pendint_s {
+    struct ccnl_face_s *face;    /**< pointer to incoming face, NULL if free */
+    uint32_t last_used;          /**< last time the face sent the interest */
+};
+
+/**
+ * @brief Set of in-records of a PIT entry, keyed by face
+ *
+ * Up to CCNL_PENDSET_INLINE faces are kept in an inline array, beyond that
+ * the records move to an open addressing hash table that doubles when it
+ * is 3/4 full. Insert, lookup and removal are O(1) on average. An all-zero
+ * set is valid and empty.
+ */
+struct ccnl_pendset_s {
+    size_t cnt;                  /**< number of in-records */
+    size_t cap;                  /**< hash table size, 0 while inline */
+    struct ccnl_pendint_s *tab;  /**< hash table, NULL while inline */
+    struct ccnl_pendint_s inl[CCNL_PENDSET_INLINE]; /**< inline records */
 };
 
 /**
@@ -49,7 +68,10 @@ struct ccnl_interest_s {
     struct ccnl_interest_s *prev;       /**< pointer to the previous list element */
     struct ccnl_pkt_s *pkt;             /**< the packet the interests originates from (?) */
     struct ccnl_face_s *from;           /**< the face the interest was received from */
-    struct ccnl_pendint_s *pending;     /**< linked list of faces wanting that content */
+    struct ccnl_interest_s *fnext;      /**< next (older) entry of the same from face */
+    struct ccnl_interest_s *fprev;      /**< previous (newer) entry of the same from face */
+    struct ccnl_pendset_s pending;      /**< set of faces wanting that content */
+    size_t size;                        /**< memory accounted in the relay's pit_bytes */
     uint32_t lifetime;                  /**< interest lifetime */
     uint32_t last_used;                 /**< last time the entry was used */
     int retries;                        /**< current number of executed retransmits. */
@@ -115,4 +137,58 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i, struct ccnl_face_s *from
 int
 ccnl_interest_remove_pending(struct ccnl_interest_s *i, struct ccnl_face_s *face);
 
+/**
+ * @brief Looks up the in-record of a face
+ *
+ * @param[in] set  The in-record set
+ * @param[in] face The face to look for
+ *
+ * @return the in-record, NULL if @p face is not in the set
+ */
+struct ccnl_pendint_s*
+ccnl_pendset_lookup(struct ccnl_pendset_s *set, struct ccnl_face_s *face);
+
+/**
+ * @brief Adds an in-record for a face unless there is one already
+ *
+ * @param[in] set  The in-record set
+ * @param[in] face The face to add
+ *
+ * @return the new or existing in-record, NULL if out of memory
+ */
+struct ccnl_pendint_s*
+ccnl_pendset_insert(struct ccnl_pendset_s *set, struct ccnl_face_s *face);
+
+/**
+ * @brief Removes the in-record of a face
+ *
+ * @param[in] set  The in-record set
+ * @param[in] face The face to remove
+ *
+ * @return 1 if an in-record was removed, 0 if there was none
+ */
+int
+ccnl_pendset_remove(struct ccnl_pendset_s *set, struct ccnl_face_s *face);
+
+/**
+ * @brief Iterates over the in-records, in no particular order
+ *
+ * The set must not be modified during the iteration.
+ *
+ * @param[in] set The in-record set
+ * @param[in,out] pos Iteration state, set to 0 before the first call
+ *
+ * @return the next in-record, NULL at the end
+ */
+struct ccnl_pendint_s*
+ccnl_pendset_next(struct ccnl_pendset_s *set, size_t *pos);
+
+/**
+ * @brief Removes all in-records and frees the hash table
+ *
+ * @param[in] set The in-record set
+ */
+void
+ccnl_pendset_clear(struct ccnl_pendset_s *set);
+
 #endif //CCNL_INTEREST_H
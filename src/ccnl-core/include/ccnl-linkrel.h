@@ -0,0 +1,136 @@
+/*
+ * @f ccnl-linkrel.h
+ * @b CCN lite, hop-by-hop link reliability (NDNLPv2 style)
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#ifndef CCNL_LINKREL_H
+#define CCNL_LINKREL_H
+
+#include <stdint.h>
+#include "ccnl-os-time.h"
+#include "ccnl-pkt-ndntlv.h"
+
+#ifndef CCNL_LINKREL_WINDOW
+# define CCNL_LINKREL_WINDOW          16      // unacked frames per face
+#endif
+#ifndef CCNL_LINKREL_MAX_RETRIES
+# define CCNL_LINKREL_MAX_RETRIES     3
+#endif
+#define CCNL_LINKREL_RTO_INIT         200000  // usec
+#define CCNL_LINKREL_RTO_MIN          10000   // usec
+#define CCNL_LINKREL_RTO_MAX          2000000 // usec
+#define CCNL_LINKREL_ACK_DELAY        5000    // usec, wait for piggybacking
+
+struct ccnl_relay_s;
+struct ccnl_face_s;
+struct ccnl_buf_s;
+
+struct ccnl_linkrel_frame_s {
+    struct ccnl_buf_s *buf;     // network packet, NULL if slot is free
+    uint64_t seq;
+    struct timeval sent;
+    int retries;
+    uint64_t congmark;          // CongestionMark to repeat on every copy
+};
+
+/**
+ * @brief Per-face link reliability state
+ *
+ * Every outgoing NDN packet is wrapped into an LpPacket with a fresh
+ * TxSequence and kept in a bounded window until the peer acknowledges it.
+ * Received TxSequences are acknowledged by piggybacking Ack fields on the
+ * next outgoing frame, or in an IDLE LpPacket after CCNL_LINKREL_ACK_DELAY.
+ */
+struct ccnl_linkrel_s {
+    uint64_t sendseq;
+    struct ccnl_linkrel_frame_s unacked[CCNL_LINKREL_WINDOW];
+    uint64_t acks[NDN_LP_MAX_ACKS];     // received, still to acknowledge
+    size_t ackcnt;
+    uint64_t seen[2 * CCNL_LINKREL_WINDOW]; // by TxSequence: seq + 1, 0: none
+    long srtt, rttvar, rto;             // usec
+    void *timer;
+    uint32_t tx_cnt;    // frames sent, without retransmissions
+    uint32_t retx_cnt;  // retransmissions
+    uint32_t loss_cnt;  // frames given up after CCNL_LINKREL_MAX_RETRIES
+    uint32_t rx_cnt;    // frames received with a TxSequence
+    uint32_t dup_cnt;   // duplicates suppressed on RX
+    uint32_t ack_cnt;   // own frames acknowledged by the peer
+};
+
+/**
+ * @brief Allocates the link reliability state for a face
+ *
+ * @return the new state, NULL if out of memory
+ */
+struct ccnl_linkrel_s*
+ccnl_linkrel_new(void);
+
+/**
+ * @brief Frees the link reliability state including unacked frames
+ *
+ * @param[in] lr The state to free, may be NULL
+ */
+void
+ccnl_linkrel_free(struct ccnl_linkrel_s *lr);
+
+/**
+ * @brief Wraps an outgoing packet into a sequenced LpPacket
+ *
+ * The network packet is kept for retransmission. Packets of other suites
+ * than NDNTLV are passed through unchanged. An LpPacket (e.g. one carrying
+ * a congestion mark) is unwrapped first so that frames never nest.
+ *
+ * @param[in] relay The relay the face belongs to
+ * @param[in] f     The face with link reliability enabled
+ * @param[in] buf   The network packet (consumed)
+ *
+ * @return the link frame to send, NULL if none
+ */
+struct ccnl_buf_s*
+ccnl_linkrel_TX(struct ccnl_relay_s *relay, struct ccnl_face_s *f,
+                struct ccnl_buf_s *buf);
+
+/**
+ * @brief Processes the reliability fields of a received LpPacket
+ *
+ * Frees acknowledged frames, schedules an Ack for the TxSequence and
+ * enables link reliability on @p f if the peer uses it.
+ *
+ * @param[in] relay The relay the face belongs to
+ * @param[in] f     The face the LpPacket was received on
+ * @param[in] lp    The decoded LpPacket
+ *
+ * @return 1 if lp->frag should be processed, 0 if it is a duplicate or
+ *         there is no network packet
+ */
+int
+ccnl_linkrel_RX(struct ccnl_relay_s *relay, struct ccnl_face_s *f,
+                struct ccnl_ndntlv_lp_s *lp);
+
+/**
+ * @brief Timer callback: retransmits overdue frames and flushes Acks
+ *
+ * @param[in] relay The relay (struct ccnl_relay_s*)
+ * @param[in] face  The face (struct ccnl_face_s*)
+ */
+void
+ccnl_linkrel_timeout(void *relay, void *face);
+
+#endif // CCNL_LINKREL_H
@@ -23,6 +23,7 @@
 #define CCNL_MALLOC_H
 
 #ifndef CCNL_LINUXKERNEL
+#include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
 #include "ccnl-os-time.h"
@@ -30,8 +31,12 @@
 
 
 #ifdef USE_DEBUG_MALLOC
+#define CCNL_MHDR_MAGIC     0x6d686472  /**< marks the header of a live block */
+
 struct mhdr {
+    uint32_t magic;         /**< CCNL_MHDR_MAGIC while the block is allocated */
     struct mhdr *next;
+    struct mhdr **pprev;    /**< what points to this block, NULL if freed */
     char *fname;
     int lineno;
     size_t size;
@@ -46,6 +51,17 @@ struct mhdr {
 
 #ifdef USE_DEBUG_MALLOC
 
+/**
+ * @brief Calls into the debug allocator, for benchmarks
+ */
+struct ccnl_malloc_stats_s {
+    unsigned long allocs;   /**< blocks handed out, reallocations included */
+    unsigned long frees;    /**< blocks given back */
+    size_t bytes;           /**< bytes handed out */
+};
+
+extern struct ccnl_malloc_stats_s ccnl_malloc_stats;
+
 void *debug_realloc(void *p, size_t s, const char *fn, int lno);
 void debug_free(void *p, const char *fn, int lno);
 
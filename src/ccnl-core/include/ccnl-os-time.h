@@ -51,6 +51,14 @@ timestamp(void);
 #endif
 
 #ifndef CCNL_LINUXKERNEL
+/**
+ * @brief If set, the clock read instead of gettimeofday()
+ *
+ * Timers, CCNL_NOW() and the log timestamps all follow it, so relays can
+ * run in virtual time. Set it before the first timer or log message.
+ */
+extern void (*ccnl_clock_ptr)(struct timeval *tv);
+
 double
 current_time(void);
 
@@ -40,6 +40,7 @@
 #define CCNL_PKT_FRAGMENT   0x03 // "Fragment"
 #define CCNL_PKT_FRAG_BEGIN 0x04 // see also CCNL_DATA_FRAG_FLAG_FIRST etc
 #define CCNL_PKT_FRAG_END   0x08
+#define CCNL_PKT_CONGESTED  0x10 // arrived with a congestion mark
 
 /**
  * @brief Options for Interest messages of all TLV formats
@@ -48,6 +49,9 @@ typedef union {
 #ifdef USE_SUITE_NDNTLV
     struct ccnl_ndntlv_interest_opts_s ndntlv;      /**< options for NDN Interest messages */
 #endif
+#ifndef USE_SUITE_NDNTLV
+    uint8_t none;                               /**< no options (ISO C needs a member) */
+#endif
 } ccnl_interest_opts_u;
 
 /**
@@ -57,6 +61,9 @@ typedef union {
 #ifdef USE_SUITE_NDNTLV
     struct ccnl_ndntlv_data_opts_s ndntlv;      /**< options for NDN Data messages */
 #endif
+#ifndef USE_SUITE_NDNTLV
+    uint8_t none;                               /**< no options (ISO C needs a member) */
+#endif
 } ccnl_data_opts_u;
 
 struct ccnl_pktdetail_ccnb_s {
@@ -86,7 +93,9 @@ struct ccnl_pktdetail_ndntlv_s {
 };
 
 struct ccnl_pkt_s {
-    struct ccnl_buf_s *buf;        /**< the packet's bytes */
+    struct ccnl_buf_s *buf;        /**< the packet's bytes, NULL for a view */
+    uint8_t *view;                 /**< borrowed bytes of a view, see ccnl_pkt_materialize() */
+    size_t viewlen;
     struct ccnl_prefix_s *pfx;     /**< prefix/name */
     uint8_t *content;              /**< pointer into the data buffer */
     size_t contlen;
@@ -117,6 +126,21 @@ struct ccnl_pkt_s {
 void
 ccnl_pkt_free(struct ccnl_pkt_s *pkt);
 
+/**
+ * @brief Copies the bytes of a packet view into a buffer of its own
+ *
+ * A view, as returned by e.g. ccnl_ndntlv_bytes2pktView(), points into the
+ * caller's receive buffer and is only valid until that is reused. It must
+ * be materialized before it outlives the receive call (PIT, CS, callbacks).
+ * Packets which already own their bytes are left unchanged.
+ *
+ * @param[in] pkt       the packet
+ *
+ * @return  0 on success, -1 if out of memory
+*/
+int
+ccnl_pkt_materialize(struct ccnl_pkt_s *pkt);
+
 /**
  * @brief Duplicates a pkt data structure
  *
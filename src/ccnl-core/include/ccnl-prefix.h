@@ -41,6 +41,8 @@ struct ccnl_prefix_s {
     ssize_t namelen; /**<  valid length of name memory */
     uint8_t *bytes;   /**< memory for name component copies */
     uint32_t *chunknum;   /**< if defined, number of the chunk else -1 */
+    uint32_t *comphash;   /**< comphash[i]: hash over components 0..i */
+    uint32_t hashcnt;     /**< number of valid entries in comphash */
 };
 
 /**
@@ -84,6 +86,34 @@ ccnl_prefix_dup(struct ccnl_prefix_s *prefix);
 int8_t
 ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, uint8_t *cmp, size_t cmplen);
 
+/**
+ * @brief Computes the cumulative component hashes of a Prefix
+ *
+ * Must be called again after components were modified other than by
+ * ccnl_prefix_appendCmp() or by decrementing compcnt. Prefixes without
+ * hashes are compared byte by byte.
+ *
+ * @param[in,out] prefix   Prefix whose components are complete
+ *
+ * @return      0 on success, -1 if out of memory
+*/
+int
+ccnl_prefix_updateHashes(struct ccnl_prefix_s *prefix);
+
+/**
+ * @brief Returns the hash over the first components of a Prefix
+ *
+ * Equal names have equal hashes, so the value can key hash tables of
+ * names and name prefixes.
+ *
+ * @param[in] prefix       The Prefix
+ * @param[in] cnt          Number of leading components, at most compcnt
+ *
+ * @return      the hash
+*/
+uint32_t
+ccnl_prefix_hashOf(struct ccnl_prefix_s *prefix, uint32_t cnt);
+
 /**
  * @brief Set a Cunknum to a Prefix
  *
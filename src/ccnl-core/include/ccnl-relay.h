@@ -44,9 +44,15 @@ struct ccnl_relay_s {
     struct ccnl_content_s *contents; /**< contentsend; */
     struct ccnl_buf_s *nonces;  /**< The nonces that are currently in use */
     int contentcnt;             /**< number of cached items */
+    uint32_t csgen;             /**< bumped whenever the content store changes */
     int max_cache_entries;      /**< max number of cached items -1: unlimited */
     int pitcnt;                 /**< Number of entries in the PIT */
-    int max_pit_entries;        /**< max number of pit entries; -1: unlimited */ 
+    int max_pit_entries;        /**< max number of pit entries; -1: unlimited */
+    struct ccnl_face_s *pit_heavy; /**< candidate for PIT eviction: the face
+                                        that last outgrew the previous one */
+    size_t pit_bytes;           /**< memory held by the PIT entries */
+    size_t max_pit_bytes;       /**< max memory of the PIT; 0: unlimited */
+    int face_irate;             /**< Interest rate limit of new faces; 0: none */
     struct ccnl_if_s ifs[CCNL_MAX_INTERFACES];
     int ifcount;               /**< number of active interfaces */
     char halt_flag;            /**< Flag to interrupt the IO_Loop and to exit the relay */
@@ -54,6 +60,8 @@ struct ccnl_relay_s {
                                                  void(*cts_done)(void*,void*)); /**< FuncPoint to the scheduler for faces*/
     struct ccnl_sched_s* (*defaultInterfaceScheduler)(struct ccnl_relay_s*,
                                                  void(*cts_done)(void*,void*)); /**< FuncPoint to the scheduler for interfaces*/
+    struct ccnl_verify_s *verify; /**< signature verification pipeline, NULL: none */
+    struct ccnl_dump_s *dumps;  /**< cursors of the table dumps in progress */
 #ifdef USE_HTTP_STATUS
     struct ccnl_http_s *http;  /**< http server for status information*/
 #endif
@@ -83,6 +91,43 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
 struct ccnl_face_s*
 ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f);
 
+/**
+ * @brief Sets the share of a face in the DRR scheduling of its interface
+ *
+ * A face with weight n may send n times as many bytes per round as a face
+ * with weight 1. The new weight applies once the face's sub-queue on the
+ * interface has drained.
+ *
+ * @param[in] f         The face to configure
+ * @param[in] weight    The weight, must be at least 1
+ *
+ * @return 0 on success, -1 on invalid parameters
+ */
+int
+ccnl_face_set_weight(struct ccnl_face_s *f, int weight);
+
+/**
+ * @brief Limits the rate of Interests accepted from a face
+ *
+ * @param[in] f         The face to configure
+ * @param[in] rate      Interests per second, 0 removes the limit
+ * @param[in] burst     Interests accepted back-to-back, at least 1
+ *
+ * @return 0 on success, -1 on invalid parameters
+ */
+int
+ccnl_face_set_interest_rate(struct ccnl_face_s *f, int rate, int burst);
+
+/**
+ * @brief Takes a token from the Interest rate limiter of a face
+ *
+ * @param[in] f         The face an Interest was received on
+ *
+ * @return 1 if the Interest may be processed, 0 if it must be dropped
+ */
+int
+ccnl_face_admit_interest(struct ccnl_face_s *f);
+
 void
 ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
                        struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
@@ -126,6 +171,25 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
 struct ccnl_interest_s*
 ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i);
 
+/**
+ * @brief Makes room in the PIT for a new entry
+ *
+ * While max_pit_entries or max_pit_bytes would be exceeded, the oldest
+ * entry of the face owning the most entries is evicted. If that is the
+ * requesting face itself, the new Interest is rejected instead. The face
+ * evicted from is remembered from the admissions, so an eviction costs
+ * O(1) rather than a walk of the faces and the PIT.
+ *
+ * @param[in] ccnl  The relay
+ * @param[in] from  The face the Interest was received on, NULL if local
+ * @param[in] size  The memory the new entry will hold
+ *
+ * @return 0 if the entry may be created, -1 if it must be rejected
+ */
+int
+ccnl_pit_admit(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
+               size_t size);
+
 /**
  * @brief Forwards interest message according to FIB rules 
  *
@@ -204,6 +268,45 @@ ccnl_fib_add_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
 int
 ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
                    struct ccnl_face_s *face);
+
+/**
+ * @brief Adds a list of entries to the FIB in one step
+ *
+ * As with ccnl_fib_add_entry(), there is one entry per suite and prefix:
+ * an entry for a prefix already in the FIB, or earlier in the list, sets
+ * the face of that entry instead, so the last face given wins. The FIB is
+ * indexed once for the whole list instead of being searched for every
+ * entry.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] routes  Entries linked by their next pointers, owned by the
+ *                  FIB on success
+ *
+ * @return number of entries added, not counting the ones that replaced
+ *         the face of an entry
+ * @return -1   if out of memory, the FIB and \p routes are unchanged
+ */
+int
+ccnl_fib_add_batch(struct ccnl_relay_s *relay, struct ccnl_forward_s *routes);
+
+/**
+ * @brief Adds the routes of a route file, all of them or none
+ *
+ * Every line holds a prefix and the face to forward it to, either the
+ * face id or the UDP address of the peer (IP/PORT); a '#' starts a
+ * comment. A face for an address is created if needed and made static.
+ *
+ * @par[in] relay   Local relay struct
+ * @par[in] suite   Suite of the prefixes
+ * @par[in] routes  The lines, NUL terminated; modified while parsing
+ * @par[out] lineno Line of the first error, 0 if out of memory
+ *
+ * @return number of routes added
+ * @return -1   on errors, the FIB is unchanged
+ */
+int
+ccnl_fib_add_routes(struct ccnl_relay_s *relay, int suite, char *routes,
+                    int *lineno);
 #endif //NEEDS_PREFIX_MATCHING
 
 /**
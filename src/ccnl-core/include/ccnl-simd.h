@@ -0,0 +1,92 @@
+/*
+ * @f ccnl-simd.h
+ * @b CCN lite, vectorized kernels for name components
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#ifndef CCNL_SIMD_H
+#define CCNL_SIMD_H
+
+#ifndef CCNL_LINUXKERNEL
+#include <stddef.h>
+#include <stdint.h>
+#endif
+
+// x86 kernels are compiled in where the compiler can target them per
+// function; everything else (RIOT, Arduino, the kernel) is scalar only
+#if defined(__x86_64__) && defined(__GNUC__) && !defined(CCNL_RIOT) && \
+    !defined(CCNL_ARDUINO) && !defined(CCNL_LINUXKERNEL)
+# define CCNL_SIMD_X86
+#endif
+
+#define CCNL_SIMD_SCALAR        0
+#define CCNL_SIMD_SSE42         1
+#define CCNL_SIMD_AVX2          2
+
+/**
+ * @brief Selects the kernels to use
+ *
+ * Without a call, the best level supported by the CPU is chosen on first
+ * use. That is not thread-safe: programs using the kernels from several
+ * threads call this (or ccnl_core_init()) before starting them. Forcing a
+ * lower level is meant for tests and benchmarks.
+ *
+ * @param[in] level    Highest CCNL_SIMD_* level to use, -1 for the best one
+ *
+ * @return the level in effect, which may be lower than requested
+ */
+int
+ccnl_simd_setLevel(int level);
+
+/**
+ * @brief Returns the name of the kernels in effect
+ *
+ * @return "scalar", "sse4.2" or "avx2"
+ */
+const char*
+ccnl_simd_name(void);
+
+/**
+ * @brief Compares two byte ranges of the same length
+ *
+ * @param[in] a        First range
+ * @param[in] b        Second range
+ * @param[in] len      Number of bytes in each range
+ *
+ * @return 1 if the ranges are equal, 0 otherwise
+ */
+int
+ccnl_simd_memeq(const uint8_t *a, const uint8_t *b, size_t len);
+
+/**
+ * @brief Updates a CRC-32C (Castagnoli) over a byte range
+ *
+ * No pre- or post-inversion is applied, so the value can be chained
+ * across components. All levels compute the same value.
+ *
+ * @param[in] crc      Running value
+ * @param[in] data     Bytes to add
+ * @param[in] len      Number of bytes
+ *
+ * @return the updated value
+ */
+uint32_t
+ccnl_simd_crc32c(uint32_t crc, const uint8_t *data, size_t len);
+
+#endif // CCNL_SIMD_H
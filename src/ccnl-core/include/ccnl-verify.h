@@ -0,0 +1,201 @@
+/*
+ * @f ccnl-verify.h
+ * @b CCN lite, asynchronous batched signature verification
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#ifndef CCNL_VERIFY_H
+#define CCNL_VERIFY_H
+
+#include <stddef.h>
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+
+#ifndef CCNL_VERIFY_MAX_THREADS
+# define CCNL_VERIFY_MAX_THREADS      16
+#endif
+#ifndef CCNL_VERIFY_BATCH
+# define CCNL_VERIFY_BATCH            8       // jobs a worker takes at once
+#endif
+#ifndef CCNL_VERIFY_MAX_PENDING
+# define CCNL_VERIFY_MAX_PENDING      1024    // Data held for a result
+#endif
+#ifndef CCNL_VERIFY_CACHE_SIZE
+# define CCNL_VERIFY_CACHE_SIZE       256     // power of two
+#endif
+#define CCNL_VERIFY_KEYID_LEN         32
+
+struct ccnl_relay_s;
+struct ccnl_content_s;
+
+/**
+ * @brief One signed Data packet waiting for its verification result
+ *
+ * The signed range and the signature point into the packet of \p c, which
+ * is not touched by the relay while the job is pending.
+ */
+struct ccnl_verify_job_s {
+    struct ccnl_verify_job_s *next;
+    struct ccnl_content_s *c;   // the content object held back
+    int faceid;                 // face the Data arrived on
+    const uint8_t *data;        // signed range
+    size_t datalen;
+    const uint8_t *sig;         // signature value
+    size_t siglen;
+    int8_t result;              // 1 valid, 0 invalid, set by the verifier
+};
+
+/**
+ * @brief Verifies a batch of jobs, sets job->result for each of them
+ *
+ * Called on a worker thread, must not call into the relay or allocate
+ * with ccnl_malloc().
+ */
+typedef void (*ccnl_verify_func)(void *ctx, size_t n,
+                                 struct ccnl_verify_job_s *jobs[]);
+
+/**
+ * @brief Continues the processing of Data once its result is known
+ *
+ * Called on the relay's thread, from ccnl_verify_poll(). Takes ownership
+ * of \p c.
+ */
+typedef void (*ccnl_verify_done_func)(struct ccnl_relay_s *relay,
+                                      struct ccnl_content_s *c,
+                                      int faceid, int verified);
+
+struct ccnl_verify_cache_s {
+    uint8_t keyid[CCNL_VERIFY_KEYID_LEN];
+    uint8_t digest[32];
+    bool valid;
+};
+
+/**
+ * @brief Verification pipeline of a relay
+ *
+ * Signed Data is queued to a pool of worker threads and held until its
+ * result is handed back to the relay's thread by ccnl_verify_poll().
+ * Workers take up to \p batch jobs at once so that verifiers with
+ * multi-buffer kernels can process them side by side. Packets whose
+ * (key, digest) pair was verified recently skip the verifier.
+ */
+struct ccnl_verify_s {
+    ccnl_verify_func verify;
+    void *ctx;
+    uint8_t keyid[CCNL_VERIFY_KEYID_LEN];
+    ccnl_verify_done_func done;
+
+    pthread_t threads[CCNL_VERIFY_MAX_THREADS];
+    int nthreads;
+    size_t batch;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;        // signals queued jobs and stop
+    struct ccnl_verify_job_s *queue, *queue_tail;
+    struct ccnl_verify_job_s *done_list;
+    size_t pending;             // jobs queued, in progress or done
+    int wakefd[2];              // readable while done_list is not empty
+    bool stop;
+    bool accept_unsigned;       // pass on Data without a signature
+
+    struct ccnl_verify_cache_s cache[CCNL_VERIFY_CACHE_SIZE];
+
+    uint32_t submit_cnt;        // signed Data submitted
+    uint32_t hit_cnt;           // skipped thanks to the cache
+    uint32_t fail_cnt;          // signatures found invalid
+    uint32_t drop_cnt;          // refused, too many pending
+    uint32_t unsigned_cnt;      // refused, no signature to check
+};
+
+/**
+ * @brief Creates a verification pipeline and starts its workers
+ *
+ * @param[in] nthreads Number of worker threads, 0 to verify inline
+ * @param[in] batch    Max jobs handed to \p verify at once
+ * @param[in] verify   The verifier
+ * @param[in] ctx      Context of the verifier, e.g. the key
+ * @param[in] keyid    Identifies the key, CCNL_VERIFY_KEYID_LEN bytes
+ * @param[in] done     Continuation for verified (or rejected) Data
+ *
+ * @return the pipeline, NULL on failure
+ */
+struct ccnl_verify_s*
+ccnl_verify_new(int nthreads, size_t batch, ccnl_verify_func verify,
+                void *ctx, const uint8_t *keyid, ccnl_verify_done_func done);
+
+/**
+ * @brief Stops the workers and frees the pipeline with all held Data
+ *
+ * @param[in] v The pipeline, may be NULL
+ */
+void
+ccnl_verify_free(struct ccnl_verify_s *v);
+
+/**
+ * @brief Submits a signed range of \p c for verification
+ *
+ * @param[in] v       The pipeline
+ * @param[in] c       The content object, held until the result is known
+ * @param[in] faceid  Face the Data arrived on, passed to the continuation
+ * @param[in] data    Signed range inside the packet of \p c
+ * @param[in] datalen Length of the signed range
+ * @param[in] sig     Signature value inside the packet of \p c
+ * @param[in] siglen  Length of the signature
+ *
+ * @return 1 if \p c is held (the continuation gets it later)
+ * @return 0 if \p c is known to be valid and can be processed right away
+ * @return -1 if \p c is invalid or cannot be held; the caller keeps it
+ */
+int
+ccnl_verify_submitJob(struct ccnl_verify_s *v, struct ccnl_content_s *c,
+                      int faceid, const uint8_t *data, size_t datalen,
+                      const uint8_t *sig, size_t siglen);
+
+/**
+ * @brief Submits a received content object for verification
+ *
+ * Only Data carrying a signature the pipeline understands (HMAC-SHA256)
+ * is held back. Data without one is refused unless v->accept_unsigned
+ * is set, then it is passed on unverified.
+ *
+ * @return see ccnl_verify_submitJob()
+ */
+int
+ccnl_verify_submit(struct ccnl_verify_s *v, struct ccnl_content_s *c,
+                   int faceid);
+
+/**
+ * @brief Hands the finished jobs to the continuation
+ *
+ * @param[in] relay The relay owning the pipeline in relay->verify
+ *
+ * @return the number of content objects released
+ */
+int
+ccnl_verify_poll(struct ccnl_relay_s *relay);
+
+/**
+ * @brief Returns a descriptor that is readable while results are waiting
+ *
+ * @return the descriptor, -1 for an inline pipeline
+ */
+int
+ccnl_verify_fd(struct ccnl_verify_s *v);
+
+#endif // CCNL_VERIFY_H
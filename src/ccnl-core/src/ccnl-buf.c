@@ -29,6 +29,10 @@
 #include "ccnl-forward.h"
 #include "ccnl-prefix.h"
 #include "ccnl-malloc.h"
+#include "ccnl-dump.h"
+#ifdef USE_VERIFY_POOL
+#include "ccnl-verify.h"
+#endif
 #else
 #include <ccnl-os-time.h>
 #include <ccnl-buf.h>
@@ -37,6 +41,7 @@
 #include <ccnl-forward.h>
 #include <ccnl-prefix.h>
 #include <ccnl-malloc.h>
+#include <ccnl-dump.h>
 #endif
 
 struct ccnl_buf_s*
@@ -49,6 +54,7 @@ ccnl_buf_new(void *data, size_t len)
     }
     b->next = NULL;
     b->datalen = len;
+    b->flags = 0;
     if (data) {
         memcpy(b->data, data, len);
     }
@@ -62,6 +68,12 @@ ccnl_core_cleanup(struct ccnl_relay_s *ccnl)
 
     DEBUGMSG_CORE(TRACE, "ccnl_core_cleanup %p\n", (void *) ccnl);
 
+#ifdef USE_VERIFY_POOL
+    ccnl_verify_free(ccnl->verify); // stops the workers, drops held Data
+    ccnl->verify = NULL;
+#endif
+
+    ccnl_dump_cleanup(ccnl);
     while (ccnl->pit)
         ccnl_interest_remove(ccnl, ccnl->pit);
     while (ccnl->faces)
@@ -49,7 +49,7 @@ ccnl_callback_rx_on_data(struct ccnl_relay_s *relay,
                          struct ccnl_face_s *from,
                          struct ccnl_pkt_s *pkt)
 {
-    if (_cb_rx_on_data) {
+    if (_cb_rx_on_data && !ccnl_pkt_materialize(pkt)) {
         return _cb_rx_on_data(relay, from, pkt);
     }
 
@@ -18,6 +18,7 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 implicit digest computed once per content object
  */
 
 #ifndef CCNL_LINUXKERNEL
@@ -28,6 +29,10 @@
 #include "ccnl-os-time.h"
 #include "ccnl-logging.h"
 #include "ccnl-defs.h"
+#include <string.h>
+#if !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
+#include <openssl/sha.h>
+#endif // !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
 #else
 #include <ccnl-content.h>
 #include <ccnl-malloc.h>
@@ -54,6 +59,8 @@ ccnl_content_new(struct ccnl_pkt_s **pkt)
              (void*) *pkt, ccnl_prefix_to_str((*pkt)->pfx, s, CCNL_MAX_PREFIX_SIZE),
              ((*pkt)->pfx->chunknum) ? (long unsigned) *((*pkt)->pfx->chunknum) : (long unsigned) 0);
 
+    if (ccnl_pkt_materialize(*pkt))
+        return NULL;
     c = (struct ccnl_content_s *) ccnl_calloc(1, sizeof(struct ccnl_content_s));
     if (!c)
         return NULL;
@@ -80,3 +87,42 @@ ccnl_content_free(struct ccnl_content_s *content)
 
     return -1;
 }
+
+uint8_t*
+ccnl_content_digest(struct ccnl_content_s *content)
+{
+    if (!content || !content->pkt || !content->pkt->buf) {
+        return NULL;
+    }
+    if (!content->has_digest) {
+        // straight into the content object: safe on verification workers
+        if (!compute_ccnx_digest(content->pkt->buf, content->digest)) {
+            return NULL;
+        }
+        content->has_digest = true;
+    }
+    return content->digest;
+}
+
+int
+ccnl_content_matchFullName(struct ccnl_content_s *content,
+                           struct ccnl_prefix_s *name)
+{
+    struct ccnl_prefix_s *p = content->pkt->pfx;
+    uint8_t *md;
+
+    if (name->compcnt != p->compcnt + 1 ||
+        name->complen[p->compcnt] != CCNL_CONTENT_DIGEST_LEN) {
+        return 0;
+    }
+    // cheap checks first: most candidates differ before the digest
+    if (p->compcnt &&
+        ccnl_prefix_cmp(p, NULL, name, CMP_MATCH) != (int32_t) p->compcnt) {
+        return 0;
+    }
+    md = ccnl_content_digest(content);
+    if (!md) {
+        return 0;
+    }
+    return !memcmp(md, name->comp[p->compcnt], CCNL_CONTENT_DIGEST_LEN);
+}
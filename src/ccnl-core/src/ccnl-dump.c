@@ -37,8 +37,14 @@
 #include "ccnl-prefix.h"
 #include "ccnl-forward.h"
 #include "ccnl-interest.h"
+#include "ccnl-linkrel.h"
 #include "ccnl-pkt.h"
 #include "ccnl-content.h"
+#include "ccnl-malloc.h"
+#include "ccnl-os-time.h"
+#ifdef USE_FRAG
+#include "ccnl-frag.h"
+#endif
 
 
 static void
@@ -51,6 +57,21 @@ blob(struct ccnl_buf_s *buf)
         CONSOLE("%02x", *cp);
 }
 
+#ifdef USE_FRAG
+char*
+frag_protocol(int e)
+{
+    switch (e) {
+    case CCNL_FRAG_NONE:            return "none";
+    case CCNL_FRAG_SEQUENCED2012:   return "seqd2012";
+    case CCNL_FRAG_CCNx2013:        return "ccnx2013";
+    case CCNL_FRAG_SEQUENCED2015:   return "seqd2015";
+    case CCNL_FRAG_BEGINEND2015:    return "beginend2015";
+    default:                        return "?";
+    }
+}
+#endif
+
 
 void
 ccnl_dump(int lev, int typ, void *p)
@@ -64,7 +85,9 @@ ccnl_dump(int lev, int typ, void *p)
 #endif
     struct ccnl_forward_s *fwd = (struct ccnl_forward_s *) p;
     struct ccnl_interest_s *itr = (struct ccnl_interest_s *) p;
-    struct ccnl_pendint_s *pir = (struct ccnl_pendint_s *) p;
+    struct ccnl_pendset_s *pst = (struct ccnl_pendset_s *) p;
+    struct ccnl_pendint_s *pir;
+    size_t pos = 0;
     struct ccnl_pkt_s *pkt = (struct ccnl_pkt_s *) p;
     struct ccnl_content_s *con = (struct ccnl_content_s *) p;
     int i, k;
@@ -163,6 +186,15 @@ ccnl_dump(int lev, int typ, void *p)
                     CONSOLE(" peer=?");
                 if (fac->frag)
                     ccnl_dump(lev + 2, CCNL_FRAG, fac->frag);
+                CONSOLE(" pit=%d ilimited=%" PRIu32 " ioverload=%" PRIu32,
+                        fac->pitcnt, fac->ilimit_cnt, fac->ioverload_cnt);
+#ifdef USE_LINKREL
+                if (fac->linkrel)
+                    CONSOLE(" linkrel tx=%u retx=%u lost=%u rx=%u dup=%u rto=%ldus",
+                            fac->linkrel->tx_cnt, fac->linkrel->retx_cnt,
+                            fac->linkrel->loss_cnt, fac->linkrel->rx_cnt,
+                            fac->linkrel->dup_cnt, fac->linkrel->rto);
+#endif
                 CONSOLE("\n");
                 if (fac->outq) {
                     INDENT(lev + 1);
@@ -174,8 +206,9 @@ ccnl_dump(int lev, int typ, void *p)
             break;
 #ifdef USE_FRAG
         case CCNL_FRAG:
-        CONSOLE(" fragproto=%s mtu=%d",
-                frag_protocol(frg->protocol), frg->mtu);
+        CONSOLE(" fragproto=%s mtu=%d reassembled=%u dropped=%u",
+                frag_protocol(frg->protocol), frg->mtu,
+                frg->reasm_cnt, frg->reasm_drop);
         break;
 #endif
         case CCNL_FWD:
@@ -195,22 +228,20 @@ ccnl_dump(int lev, int typ, void *p)
                         (void *) itr, (void *) itr->next, (void *) itr->prev,
                         itr->last_used, itr->retries);
                 ccnl_dump(lev + 1, CCNL_PACKET, itr->pkt);
-                if (itr->pending) {
+                if (itr->pending.cnt) {
                     INDENT(lev + 1);
                     CONSOLE("pending:\n");
-                    ccnl_dump(lev + 2, CCNL_PENDINT, itr->pending);
+                    ccnl_dump(lev + 2, CCNL_PENDINT, &itr->pending);
                 }
                 itr = itr->next;
 
             }
             break;
         case CCNL_PENDINT:
-            while (pir) {
+            while ((pir = ccnl_pendset_next(pst, &pos)) != NULL) {
                 INDENT(lev);
-                CONSOLE("%p PENDINT next=%p face=%p last=%" PRIu32 "\n",
-                        (void *) pir, (void *) pir->next,
-                        (void *) pir->face, pir->last_used);
-                pir = pir->next;
+                CONSOLE("%p PENDINT face=%p last=%" PRIu32 "\n",
+                        (void *) pir, (void *) pir->face, pir->last_used);
             }
             break;
         case CCNL_PACKET:
@@ -469,16 +500,20 @@ get_interest_dump(int lev, void *p, long *interest, long *next, long *prev,
         publisher[line] = 0L;
         if (itr->pkt->pfx)
             switch (itr->pkt->pfx->suite) {
+#ifdef USE_SUITE_CCNB
                 case CCNL_SUITE_CCNB:
                     min[line] = itr->pkt->s.ccnb.minsuffix;
                     max[line] = itr->pkt->s.ccnb.maxsuffix;
                     publisher[line] = (long)(void *) itr->pkt->s.ccnb.ppkd;
                     break;
+#endif
+#ifdef USE_SUITE_NDNTLV
                 case CCNL_SUITE_NDNTLV:
                     min[line] = itr->pkt->s.ndntlv.minsuffix;
                     max[line] = itr->pkt->s.ndntlv.maxsuffix;
                     publisher[line] = (long)(void *) itr->pkt->s.ndntlv.ppkl;
                     break;
+#endif
                 default:
                     break;
             }
@@ -497,23 +532,21 @@ get_pendint_dump(int lev, void *p, char **out) {
 
     struct ccnl_relay_s *top = (struct ccnl_relay_s *) p;
     struct ccnl_interest_s *itr = (struct ccnl_interest_s *) top->pit;
-    struct ccnl_pendint_s *pir = (struct ccnl_pendint_s *) itr->pending;
+    struct ccnl_pendint_s *pir;
+    size_t pos = 0;
 
     int line = 0;
     int result = 0;
 
-    while (pir) {
+    while ((pir = ccnl_pendset_next(&itr->pending, &pos)) != NULL) {
         /* indent entry by 'lev' spaces */
         //INDENT(lev);
 
         /* check if the sprintf call fails */
-        if ((result = sprintf(out[line], "%p PENDINT next=%p face=%p last=%d",
-                       (void *) pir, (void *) pir->next,
-                       (void *) pir->face, pir->last_used)) < 0) { 
+        if ((result = sprintf(out[line], "%p PENDINT face=%p last=%d",
+                       (void *) pir, (void *) pir->face, pir->last_used)) < 0) {
             DEBUGMSG(ERROR, "get_pendint_dump: could not write PIT entry\n");
         }
-        /* set pointer to next entry */
-        pir = pir->next;
         /* new entry in pit */
         ++line;
     }
@@ -546,4 +579,223 @@ get_content_dump(int lev, void *p, long *content, long *next, long *prev,
 }
 #endif // USE_MGMT
 
+// ----------------------------------------------------------------------
+// table dumps, page by page
+
+static uint32_t ccnl_dump_lastid;
+
+int
+ccnl_dump_str2table(const char *s)
+{
+    if (!strcmp(s, "faces"))
+        return CCNL_DUMP_FACES;
+    if (!strcmp(s, "fib"))
+        return CCNL_DUMP_FIB;
+    if (!strcmp(s, "pit"))
+        return CCNL_DUMP_PIT;
+    if (!strcmp(s, "cs"))
+        return CCNL_DUMP_CS;
+    return -1;
+}
+
+const char*
+ccnl_dump_table2str(int table)
+{
+    switch (table) {
+    case CCNL_DUMP_FACES:   return "faces";
+    case CCNL_DUMP_FIB:     return "fib";
+    case CCNL_DUMP_PIT:     return "pit";
+    case CCNL_DUMP_CS:      return "cs";
+    default:                return "?";
+    }
+}
+
+static void*
+ccnl_dump_first(struct ccnl_relay_s *relay, int table)
+{
+    switch (table) {
+    case CCNL_DUMP_FACES:   return relay->faces;
+    case CCNL_DUMP_FIB:     return relay->fib;
+    case CCNL_DUMP_PIT:     return relay->pit;
+    case CCNL_DUMP_CS:      return relay->contents;
+    default:                return NULL;
+    }
+}
+
+static void*
+ccnl_dump_successor(int table, void *entry)
+{
+    switch (table) {
+    case CCNL_DUMP_FACES:   return ((struct ccnl_face_s*) entry)->next;
+    case CCNL_DUMP_FIB:     return ((struct ccnl_forward_s*) entry)->next;
+    case CCNL_DUMP_PIT:     return ((struct ccnl_interest_s*) entry)->next;
+    case CCNL_DUMP_CS:      return ((struct ccnl_content_s*) entry)->next;
+    default:                return NULL;
+    }
+}
+
+// is name under the prefix of the filter? (all suites alike)
+static int
+ccnl_dump_under(struct ccnl_prefix_s *prefix, struct ccnl_prefix_s *name)
+{
+    uint32_t i;
+
+    if (!prefix)
+        return 1;
+    if (!name || name->compcnt < prefix->compcnt)
+        return 0;
+    for (i = 0; i < prefix->compcnt; i++) {
+        if (prefix->complen[i] != name->complen[i] ||
+            memcmp(prefix->comp[i], name->comp[i], prefix->complen[i]))
+            return 0;
+    }
+    return 1;
+}
+
+static int
+ccnl_dump_matches(struct ccnl_dump_s *d, void *entry)
+{
+    struct ccnl_face_s *face = NULL;
+    struct ccnl_prefix_s *name = NULL;
+
+    switch (d->table) {
+    case CCNL_DUMP_FACES:
+        face = (struct ccnl_face_s*) entry;
+        break;
+    case CCNL_DUMP_FIB:
+        face = ((struct ccnl_forward_s*) entry)->face;
+        name = ((struct ccnl_forward_s*) entry)->prefix;
+        break;
+    case CCNL_DUMP_PIT:
+        face = ((struct ccnl_interest_s*) entry)->from;
+        name = ((struct ccnl_interest_s*) entry)->pkt->pfx;
+        break;
+    case CCNL_DUMP_CS:
+        name = ((struct ccnl_content_s*) entry)->pkt->pfx;
+        break;
+    }
+    if (d->faceid >= 0 && d->table != CCNL_DUMP_CS &&
+                                    (!face || face->faceid != d->faceid))
+        return 0;
+    return d->table == CCNL_DUMP_FACES || ccnl_dump_under(d->prefix, name);
+}
+
+struct ccnl_dump_s*
+ccnl_dump_open(struct ccnl_relay_s *relay, int table,
+               struct ccnl_prefix_s *prefix, int faceid)
+{
+    struct ccnl_dump_s *d, *next, *lru = NULL;
+    int cnt = 0;
+
+    if (table < CCNL_DUMP_FACES || table > CCNL_DUMP_CS) {
+        if (prefix)
+            ccnl_prefix_free(prefix);
+        return NULL;
+    }
+    for (d = relay->dumps; d; d = next) {
+        next = d->next;
+        if (d->last_used + CCNL_DUMP_TIMEOUT < CCNL_NOW()) {
+            DEBUGMSG(DEBUG, "table dump %u expired\n", (unsigned) d->id);
+            ccnl_dump_close(relay, d);
+            continue;
+        }
+        if (!lru || d->last_used < lru->last_used)
+            lru = d;
+        cnt++;
+    }
+    if (cnt >= CCNL_MAX_DUMPS && lru) {
+        DEBUGMSG(INFO, "table dump %u dropped for a new one\n",
+                 (unsigned) lru->id);
+        ccnl_dump_close(relay, lru);
+    }
+
+    d = (struct ccnl_dump_s*) ccnl_calloc(1, sizeof(*d));
+    if (!d) {
+        if (prefix)
+            ccnl_prefix_free(prefix);
+        return NULL;
+    }
+    if (!++ccnl_dump_lastid)
+        ++ccnl_dump_lastid;
+    d->id = ccnl_dump_lastid;
+    d->table = table;
+    d->entry = ccnl_dump_first(relay, table);
+    d->prefix = prefix;
+    d->faceid = faceid;
+    d->last_used = CCNL_NOW();
+    d->next = relay->dumps;
+    relay->dumps = d;
+
+    return d;
+}
+
+struct ccnl_dump_s*
+ccnl_dump_find(struct ccnl_relay_s *relay, uint32_t id)
+{
+    struct ccnl_dump_s *d;
+
+    for (d = relay->dumps; d; d = d->next) {
+        if (d->id == id) {
+            d->last_used = CCNL_NOW();
+            return d;
+        }
+    }
+    return NULL;
+}
+
+void*
+ccnl_dump_peek(struct ccnl_dump_s *d, int *budget)
+{
+    while (d->entry && *budget > 0) {
+        (*budget)--;
+        if (ccnl_dump_matches(d, d->entry))
+            return d->entry;
+        d->entry = ccnl_dump_successor(d->table, d->entry);
+    }
+    return NULL;
+}
+
+void
+ccnl_dump_consume(struct ccnl_dump_s *d)
+{
+    if (d->entry) {
+        d->entry = ccnl_dump_successor(d->table, d->entry);
+        d->pos++;
+    }
+}
+
+void
+ccnl_dump_close(struct ccnl_relay_s *relay, struct ccnl_dump_s *d)
+{
+    struct ccnl_dump_s **pp;
+
+    for (pp = &relay->dumps; *pp; pp = &(*pp)->next) {
+        if (*pp == d) {
+            *pp = d->next;
+            break;
+        }
+    }
+    if (d->prefix)
+        ccnl_prefix_free(d->prefix);
+    ccnl_free(d);
+}
+
+void
+ccnl_dump_forget(struct ccnl_relay_s *relay, void *entry)
+{
+    struct ccnl_dump_s *d;
+
+    for (d = relay->dumps; d; d = d->next) {
+        if (d->entry == entry)
+            d->entry = ccnl_dump_successor(d->table, entry);
+    }
+}
+
+void
+ccnl_dump_cleanup(struct ccnl_relay_s *relay)
+{
+    while (relay->dumps)
+        ccnl_dump_close(relay, relay->dumps);
+}
+
 //#endif // USE_DEBUG
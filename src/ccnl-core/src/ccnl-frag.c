@@ -18,11 +18,15 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 reordering reassembly window, fragment views for TX
  */
  
 #include "ccnl-frag.h"
 #include "ccnl-malloc.h"
 #include "ccnl-pkt.h"
+#include "ccnl-pkt-util.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-ndntlv.h"
 #include "ccnl-logging.h"
 
 #ifdef USE_FRAG
@@ -98,7 +102,7 @@ ccnl_frag_reset(struct ccnl_frag_s *e, struct ccnl_buf_s *buf,
                   int ifndx, sockunion *dst)
 {
     DEBUGMSG_EFRA(VERBOSE, "ccnl_frag_reset if=%d (%zd bytes) dst=%s\n", ifndx,
-             buf ? buf->datalen : -1, ccnl_addr2ascii(dst));
+             buf ? (ssize_t) buf->datalen : -1, ccnl_addr2ascii(dst));
     if (!e)
         return;
     e->ifndx = ifndx;
@@ -371,50 +375,89 @@ ccnl_frag_getnextSEQD2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
 }
 #endif // OBSOLETE
 
-struct ccnl_buf_s*
-ccnl_frag_getnextBE2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
+uint16_t
+ccnl_frag_BEfields(struct ccnl_frag_s *fr, size_t datalen)
 {
-    struct ccnl_buf_s *buf = 0;
-    unsigned int datalen = 0;
+    uint16_t flags;
+
+    if (datalen >= fr->bigpkt->datalen) {                       // single
+        flags = CCNL_BEFRAG_FLAG_SINGLE;
+    } else if (fr->sendoffs == 0) {                             // start
+        flags = CCNL_BEFRAG_FLAG_FIRST;
+    } else if (datalen >= fr->bigpkt->datalen - fr->sendoffs) { // end
+        flags = CCNL_BEFRAG_FLAG_LAST;
+    } else {                                                    // middle
+        flags = CCNL_BEFRAG_FLAG_MID;
+    }
+    return (uint16_t) ((flags << 14) | (fr->sendseq & 0x3fff));
+}
 
-    DEBUGMSG_EFRA(VERBOSE, "ccnl_frag_getnextBE2015: remaining=%zd\n",
-                  fr->bigpkt->datalen - fr->sendoffs);
+int
+ccnl_frag_getnextIov(struct ccnl_frag_s *fr, struct ccnl_frag_iov_s *iov,
+                     int *ifndx, sockunion *su)
+{
+    int8_t rc = -1;
+
+    if (!fr->bigpkt || fr->sendoffs >= fr->bigpkt->datalen) {
+        // the last view was handed out before: the packet can go now
+        ccnl_free(fr->bigpkt);
+        fr->bigpkt = NULL;
+        return -1;
+    }
+    if (fr->protocol != CCNL_FRAG_BEGINEND2015) {
+        DEBUGMSG_EFRA(VERBOSE, "  unknown protocol %d\n", fr->protocol);
+        return -1;
+    }
 
     switch(fr->outsuite) {
 #ifdef USE_SUITE_CCNTLV
     case CCNL_SUITE_CCNTLV:
-        buf = ccnl_ccntlv_mkFrag(fr, &datalen);
+        rc = ccnl_ccntlv_mkFragHdr(fr, iov->hdr, &iov->hdrlen, &iov->datalen);
         break;
 #endif
 #ifdef USE_SUITE_NDNTLV
     case CCNL_SUITE_NDNTLV:
-        buf = ccnl_ndntlv_mkFrag(fr, &datalen);
+        rc = ccnl_ndntlv_mkFragHdr(fr, iov->hdr, &iov->hdrlen, &iov->datalen);
         break;
 #endif
     default:
         break;
     }
+    if (rc) {
+        DEBUGMSG_EFRA(VERBOSE, "  produced NO fragment, seqnr remains at =%u-1\n",
+                 fr->sendseq);
+        return -1;
+    }
 
-    if (buf) {
-        fr->sendseq++;
+    iov->data = fr->bigpkt->data + fr->sendoffs;
+    fr->sendoffs += iov->datalen;
+    fr->sendseq++;
 
-        fr->sendoffs += datalen;
-        if (fr->sendoffs >= (unsigned) fr->bigpkt->datalen) {
-            ccnl_free(fr->bigpkt);
-            fr->bigpkt = NULL;
-        }
+    if (ifndx)
+        *ifndx = fr->ifndx;
+    if (su)
+        memcpy(su, &fr->dest, sizeof(*su));
 
-        if (ifndx)
-            *ifndx = fr->ifndx;
-        if (su)
-            memcpy(su, &fr->dest, sizeof(*su));
+    DEBUGMSG_EFRA(VERBOSE, "  produced %zu+%zu bytes fragment, seqnr=%u-1\n",
+                  iov->hdrlen, iov->datalen, fr->sendseq);
+    return 0;
+}
 
-        DEBUGMSG_EFRA(VERBOSE, "  produced %zd bytes fragment, seqnr=%d-1\n",
-                 buf->datalen, fr->sendseq);
-    } else
-        DEBUGMSG_EFRA(VERBOSE, "  produced NO fragment, seqnr remains at =%d-1\n",
-                 fr->sendseq);
+struct ccnl_buf_s*
+ccnl_frag_getnextBE2015(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
+{
+    struct ccnl_frag_iov_s iov;
+    struct ccnl_buf_s *buf;
 
+    if (ccnl_frag_getnextIov(fr, &iov, ifndx, su)) {
+        return NULL;
+    }
+    // the interface queue owns whole buffers: gather once
+    buf = ccnl_buf_new(NULL, iov.hdrlen + iov.datalen);
+    if (buf) {
+        memcpy(buf->data, iov.hdr, iov.hdrlen);
+        memcpy(buf->data + iov.hdrlen, iov.data, iov.datalen);
+    }
     return buf;
 }
 
@@ -423,7 +466,7 @@ ccnl_frag_getnext(struct ccnl_frag_s *fr, int *ifndx, sockunion *su)
 {
     if (!fr->bigpkt) return NULL;
 
-    DEBUGMSG_EFRA(VERBOSE, "fragmenting %zd bytes (@ %d)\n",
+    DEBUGMSG_EFRA(VERBOSE, "fragmenting %zd bytes (@ %u)\n",
                                 fr->bigpkt->datalen, fr->sendoffs);
 
     switch (fr->protocol) {
@@ -456,9 +499,13 @@ ccnl_frag_nomorefragments(struct ccnl_frag_s *e)
 void
 ccnl_frag_destroy(struct ccnl_frag_s *e)
 {
+    int i;
+
     if (e) {
         ccnl_free(e->bigpkt);
-        ccnl_free(e->defrag);
+        for (i = 0; i < CCNL_FRAG_REASM_SLOTS; i++) {
+            ccnl_free(e->reasm[i].buf);
+        }
         ccnl_free(e);
     }
 }
@@ -753,16 +800,73 @@ ccnl_frag_RX_Sequenced2015(RX_datagram callback, struct ccnl_relay_s *relay,
 }
 #endif // OBSOLETE
 
+static void
+ccnl_frag_slotFree(struct ccnl_frag_slot_s *sl)
+{
+    ccnl_free(sl->buf);
+    sl->buf = NULL;
+}
+
+#define reasm_slot(E,SEQ)   ((E)->reasm + ((SEQ) % CCNL_FRAG_REASM_SLOTS))
+#define reasm_has(E,SEQ)    (reasm_slot(E,SEQ)->buf && \
+                             reasm_slot(E,SEQ)->seqno == (SEQ))
+
+// concatenates the run first..last if all its fragments are present
+static struct ccnl_buf_s*
+ccnl_frag_reasm(struct ccnl_frag_s *e, unsigned int seqno)
+{
+    struct ccnl_buf_s *buf;
+    unsigned int first = seqno, last = seqno, n, s;
+    size_t len = 0;
+
+    for (n = 0; !(reasm_slot(e, first)->flags & CCNL_BEFRAG_FLAG_FIRST); n++) {
+        first = (first - 1) & 0x3fff;
+        if (n >= CCNL_FRAG_REASM_SLOTS || !reasm_has(e, first) ||
+            (reasm_slot(e, first)->flags & CCNL_BEFRAG_FLAG_LAST)) {
+            return NULL;
+        }
+    }
+    for (n = 0; !(reasm_slot(e, last)->flags & CCNL_BEFRAG_FLAG_LAST); n++) {
+        last = (last + 1) & 0x3fff;
+        if (n >= CCNL_FRAG_REASM_SLOTS || !reasm_has(e, last) ||
+            (reasm_slot(e, last)->flags & CCNL_BEFRAG_FLAG_FIRST)) {
+            return NULL;
+        }
+    }
+
+    for (s = first; ; s = (s + 1) & 0x3fff) {
+        len += reasm_slot(e, s)->buf->datalen;
+        if (s == last)
+            break;
+    }
+    buf = ccnl_buf_new(NULL, len);
+    len = 0;
+    for (s = first; ; s = (s + 1) & 0x3fff) {
+        struct ccnl_frag_slot_s *sl = reasm_slot(e, s);
+        if (buf) {
+            memcpy(buf->data + len, sl->buf->data, sl->buf->datalen);
+            len += sl->buf->datalen;
+        }
+        ccnl_frag_slotFree(sl);
+        if (s == last)
+            break;
+    }
+    return buf;
+}
+
 int
 ccnl_frag_RX_BeginEnd2015(RX_datagram callback, struct ccnl_relay_s *relay,
                           struct ccnl_face_s *from, int mtu,
                           unsigned int bits, unsigned int seqno,
-                          unsigned char **data, int *datalen)
+                          uint8_t **data, size_t *datalen)
 {
     struct ccnl_buf_s *buf = NULL;
     struct ccnl_frag_s *e;
+    struct ccnl_frag_slot_s *sl;
+    struct timeval now;
+    int i;
 
-    DEBUGMSG_EFRA(DEBUG, "ccnl_frag_RX_BeginEnd2015 (%d bytes), seqno=%d\n",
+    DEBUGMSG_EFRA(DEBUG, "ccnl_frag_RX_BeginEnd2015 (%zu bytes), seqno=%u\n",
                   *datalen, seqno);
 
     if (!from) {
@@ -779,82 +883,56 @@ ccnl_frag_RX_BeginEnd2015(RX_datagram callback, struct ccnl_relay_s *relay,
         DEBUGMSG_EFRA(WARNING, "WRONG FRAG PROTOCOL\n");
         return 0;
     }
-
     e = from->frag;
-    if (e->recvseq != seqno) {
-        // should increase error counter here
-        DEBUGMSG_EFRA(WARNING, "  >> seqnum mismatch: rcvd %d, expected %d\n",
-                      seqno, e->recvseq);
-        if (e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "  >> had to drop defrag buf\n");
-            ccnl_free(e->defrag);
-            e->defrag = NULL;
-        }
-        e->recvseq = seqno;
-    }
+    seqno &= 0x3fff;
+    bits &= CCNL_BEFRAG_FLAG_MASK;
 
-    switch(bits & (CCNL_BEFRAG_FLAG_MASK)) {
-    case CCNL_BEFRAG_FLAG_SINGLE: // single packet
-        DEBUGMSG_EFRA(VERBOSE, "  >> single fragment seqno=%d (%d bytes)\n",
+    if (bits == CCNL_BEFRAG_FLAG_SINGLE) {
+        DEBUGMSG_EFRA(VERBOSE, "  >> single fragment seqno=%u (%zu bytes)\n",
                       seqno, *datalen);
-        if (e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "    had to drop defrag buf\n");
-            ccnl_free(e->defrag);
-            e->defrag = NULL;
-        }
-        e->recvseq++;
+        e->recvseq = seqno + 1;
         // no need to copy the buffer:
         callback(relay, from, data, datalen);
         return 1;
-    case CCNL_BEFRAG_FLAG_FIRST: // start of fragment sequence
-        DEBUGMSG_EFRA(VERBOSE, "  >> start of fragment series\n");
-        if (e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "    had to drop defrag buf\n");
-            ccnl_free(e->defrag);
-        }
-        e->defrag = ccnl_buf_new(*data, *datalen);
-        break;
-    case CCNL_BEFRAG_FLAG_LAST: // end of fragment sequence
-        DEBUGMSG_EFRA(VERBOSE, "  >> last fragment of a series\n");
-        if (!e->defrag) {
-            DEBUGMSG_EFRA(WARNING, "  >> no e->defrag?\n");
-            break;
-        }
-        buf = ccnl_buf_new(NULL, e->defrag->datalen + *datalen);
-        if (buf) {
-            memcpy(buf->data, e->defrag->data, e->defrag->datalen);
-            memcpy(buf->data + e->defrag->datalen, *data, *datalen);
-        }
-        ccnl_free(e->defrag);
-        e->defrag = NULL;
-        break;
-    case CCNL_BEFRAG_FLAG_MID:  // fragment in the middle of a squence
-    default:
-        DEBUGMSG_EFRA(VERBOSE, "  >> fragment in the middle of a series\n");
-        if (!e->defrag)
-            break;
-        buf = ccnl_buf_new(NULL, e->defrag->datalen + *datalen);
-        if (buf) {
-            memcpy(buf->data, e->defrag->data, e->defrag->datalen);
-            memcpy(buf->data + e->defrag->datalen, *data, *datalen);
-            ccnl_free(e->defrag);
-            e->defrag = buf;
-            buf = NULL;
-        } else {
-            ccnl_free(e->defrag);
-            e->defrag = NULL;
+    }
+
+    // expire fragments whose packet did not complete in time
+    ccnl_get_timeval(&now);
+    for (i = 0; i < CCNL_FRAG_REASM_SLOTS; i++) {
+        sl = e->reasm + i;
+        if (sl->buf && timevaldelta(&now, &sl->rcvd) > CCNL_FRAG_REASM_TIMEOUT) {
+            DEBUGMSG_EFRA(DEBUG, "  >> fragment seqno=%u timed out\n", sl->seqno);
+            ccnl_frag_slotFree(sl);
+            e->reasm_drop++;
         }
-        break;
     }
+
+    sl = reasm_slot(e, seqno);
+    if (sl->buf) {
+        // a duplicate, or a fragment a full window older: keep the newer
+        DEBUGMSG_EFRA(DEBUG, "  >> seqno=%u replaces seqno=%u\n",
+                      seqno, sl->seqno);
+        ccnl_frag_slotFree(sl);
+        e->reasm_drop++;
+    }
+    sl->buf = ccnl_buf_new(*data, *datalen);
+    sl->seqno = seqno;
+    sl->flags = (unsigned char) bits;
+    sl->rcvd = now;
+    e->recvseq = seqno + 1;
     *data += *datalen;
     *datalen = 0;
-    e->recvseq++;
+    if (!sl->buf) {
+        return 1;
+    }
 
+    buf = ccnl_frag_reasm(e, seqno);
     if (buf) {
-        unsigned char *frag = buf->data;
-        int fraglen = buf->datalen;
+        uint8_t *frag = buf->data;
+        size_t fraglen = buf->datalen;
         DEBUGMSG_EFRA(DEBUG, "  >> reassembled fragment is %zd bytes\n",
                       buf->datalen);
+        e->reasm_cnt++;
         // FIXME: loop over multiple packets in this reassembled frame?
         callback(relay, from, &frag, &fraglen);
         ccnl_free(buf);
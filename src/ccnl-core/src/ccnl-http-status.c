@@ -24,10 +24,46 @@ void null_func(void);
 
 #ifdef USE_HTTP_STATUS
 
+#include <ctype.h>
+#include <stdarg.h>
+#include <stdlib.h>
 
 #include "ccnl-http-status.h"
+#include "ccnl-dump.h"
+#include "ccnl-malloc.h"
 #include "ccnl-os-time.h"
 
+#ifndef CCNL_HTTP_BUFSIZE
+#define CCNL_HTTP_BUFSIZE   16384   // output buffer, refilled as it drains
+#endif
+#ifndef CCNL_HTTP_ROWS
+#define CCNL_HTTP_ROWS      100     // default rows per table page
+#endif
+// room one table row may need
+#define CCNL_HTTP_ROWMAX    (CCNL_MAX_PREFIX_SIZE + 512)
+
+// parts of a page
+enum {
+    HTTP_DONE = 0,
+    HTTP_HEAD,
+    HTTP_FIB,           // the first rows of the FIB, status page
+    HTTP_FACES,         // the first rows of the faces, status page
+    HTTP_INFO,          // interfaces, stats and config, status page
+    HTTP_TABLE,         // a table page
+    HTTP_FOOT,
+    HTTP_NOTFOUND
+};
+
+static const int ccnl_http_status_page[] = {
+    HTTP_HEAD, HTTP_FIB, HTTP_FACES, HTTP_INFO, HTTP_FOOT, HTTP_DONE
+};
+static const int ccnl_http_table_page[] = {
+    HTTP_HEAD, HTTP_TABLE, HTTP_FOOT, HTTP_DONE
+};
+static const int ccnl_http_notfound_page[] = {
+    HTTP_NOTFOUND, HTTP_DONE
+};
+
 // ----------------------------------------------------------------------
 
 struct ccnl_http_s*
@@ -60,6 +96,12 @@ ccnl_http_new(struct ccnl_relay_s *ccnl, int serverport)
         close(s);
         return NULL;
     }
+    http->out = (unsigned char*) ccnl_malloc(CCNL_HTTP_BUFSIZE);
+    if (!http->out) {
+        ccnl_free(http);
+        close(s);
+        return NULL;
+    }
     http->server = s;
 
     DEBUGMSG(INFO, "HTTP status server listening at TCP port %d\n", serverport);
@@ -77,10 +119,31 @@ ccnl_http_cleanup(struct ccnl_http_s *http)
         close(http->server);
     if (http->client)
         close(http->client);
+    ccnl_free(http->out);
     ccnl_free(http);
     return NULL;
 }
 
+static int
+ccnl_http_complete(struct ccnl_http_s *http)
+{
+    return http->steps && http->steps[http->step] == HTTP_DONE;
+}
+
+static void
+ccnl_http_close(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
+{
+    struct ccnl_dump_s *d;
+
+    if (http->dump && (d = ccnl_dump_find(ccnl, http->dump)) != NULL) {
+        ccnl_dump_close(ccnl, d);
+    }
+    close(http->client);
+    http->client = 0;
+    http->steps = NULL;
+    http->dump = 0;
+}
+
 
 int
 ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
@@ -94,9 +157,9 @@ ccnl_http_anteselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
         if (*maxfd <= http->server)
             *maxfd = http->server + 1;
     } else {
-        if ((unsigned long)http->inlen < sizeof(http->in))
+        if ((unsigned long)http->inlen < sizeof(http->in) - 1)
             FD_SET(http->client, readfs);
-        if (http->outlen > 0)
+        if (http->outlen > 0 || (http->steps && !ccnl_http_complete(http)))
             FD_SET(http->client, writefs);
         if (*maxfd <= http->client)
             *maxfd = http->client + 1;
@@ -122,31 +185,34 @@ ccnl_http_postselect(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
             DEBUGMSG(INFO, "accepted web server client %s\n",
                      ccnl_addr2ascii((sockunion*)&peer));
             http->inlen = http->outlen = http->inoffs = http->outoffs = 0;
+            http->steps = NULL;
         }
     }
     if (http->client && FD_ISSET(http->client, readfs)) {
         int len = sizeof(http->in) - http->inlen - 1;
         len = recv(http->client, http->in + http->inlen, len, 0);
-        if (len == 0) {
+        if (len <= 0) {
             DEBUGMSG(INFO, "web client went away\n");
-            close(http->client);
-            http->client = 0;
-        } else if (len > 0) {
-            http->in[len] = 0;
+            ccnl_http_close(ccnl, http);
+        } else {
+            http->inlen += len;
+            http->in[http->inlen] = 0;
             ccnl_http_status(ccnl, http);
         }
     }
-    if (http->client && FD_ISSET(http->client, writefs) && http->out) {
-        int len = send(http->client, http->out + http->outoffs,
-                       http->outlen, 0);
-        if (len > 0) {
-            http->outlen -= len;
-            http->outoffs += len;
-            if (http->outlen == 0) {
-                close(http->client);
-                http->client = 0;
+    if (http->client && FD_ISSET(http->client, writefs)) {
+        if (http->outlen == 0)
+            ccnl_http_more(ccnl, http);
+        if (http->outlen > 0) {
+            int len = send(http->client, http->out + http->outoffs,
+                           http->outlen, 0);
+            if (len > 0) {
+                http->outlen -= len;
+                http->outoffs += len;
             }
         }
+        if (http->outlen == 0 && ccnl_http_complete(http))
+            ccnl_http_close(ccnl, http);
     }
     return 0;
 }
@@ -192,160 +258,443 @@ ccnl_cmpfib(const void *a, const void *b)
     return 0;
 }
 
-int
-ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
+// ----------------------------------------------------------------------
+// rendering
+
+static int
+ccnl_http_room(struct ccnl_http_s *http)
+{
+    return CCNL_HTTP_BUFSIZE - http->outoffs - http->outlen;
+}
+
+static void
+ccnl_http_printf(struct ccnl_http_s *http, const char *fmt, ...)
+{
+    va_list ap;
+    int room = ccnl_http_room(http), len;
+
+    if (room <= 1)
+        return;
+    va_start(ap, fmt);
+    len = vsnprintf((char*) http->out + http->outoffs + http->outlen,
+                    room, fmt, ap);
+    va_end(ap);
+    if (len < 0)
+        return;
+    http->outlen += len < room ? len : room - 1;
+}
+
+static void
+ccnl_http_section(struct ccnl_http_s *http, const char *title)
+{
+    ccnl_http_printf(http, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
+                     "<tr><td><em>%s</em></table><ul>\n", title);
+}
+
+static const char*
+ccnl_http_title(int table)
+{
+    switch (table) {
+    case CCNL_DUMP_FACES:
+        return "Faces";
+    case CCNL_DUMP_FIB:
+        return "Forwarding table";
+    case CCNL_DUMP_PIT:
+        return "Pending interests";
+    case CCNL_DUMP_CS:
+        return "Content store";
+    default:
+        return "?";
+    }
+}
+
+static void
+ccnl_http_head(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
 {
-    static char txt[64000];
-    char *hdr =
-        "HTTP/1.1 200 OK\n\r"
-        "Content-Type: text/html; charset=utf-8\n\r"
-        "Connection: close\n\r\n\r", *cp;
-    size_t len = strlen(hdr);
-    int i, j, cnt;
+    char *cp;
     time_t t;
-    //struct utsname uts;
-    struct ccnl_face_s *f;
-    struct ccnl_forward_s *fwd;
-    struct ccnl_interest_s *ipt;
-    struct ccnl_buf_s *bpt;
-    char s[CCNL_MAX_PREFIX_SIZE];
 
-    strcpy(txt, hdr);
-    len += sprintf(txt+len,
-                   "<html><head><title>ccn-lite-relay status</title>\n"
-                   "<style type=\"text/css\">\n"
-                   "body {font-family: sans-serif;}\n"
-                   "</style>\n"
-                   "</head><body>\n");
-    len += sprintf(txt+len, "\n<table borders=0>\n<tr><td>"
-                   "<a href=\"\">[refresh]</a>&nbsp;&nbsp;<td>"
-                   "ccn-lite-relay Status Page &nbsp;&nbsp;");
-    //uname(&uts);
-    //len += sprintf(txt+len, "node <strong>%s (%d)</strong>\n",
-    //               uts.nodename, getpid());
+    ccnl_http_printf(http,
+                     "HTTP/1.1 200 OK\r\n"
+                     "Content-Type: text/html; charset=utf-8\r\n"
+                     "Connection: close\r\n\r\n");
+    ccnl_http_printf(http,
+                     "<html><head><title>ccn-lite-relay %s</title>\n"
+                     "<style type=\"text/css\">\n"
+                     "body {font-family: sans-serif;}\n"
+                     "</style>\n"
+                     "</head><body>\n",
+                     http->table ? ccnl_dump_table2str(http->table) : "status");
+    ccnl_http_printf(http, "\n<table borders=0>\n<tr><td>"
+                     "<a href=\"\">[refresh]</a>&nbsp;&nbsp;<td>");
+    if (http->table)
+        ccnl_http_printf(http, "<a href=\"/\">ccn-lite-relay Status Page</a>"
+                         " &nbsp;&nbsp;");
+    else
+        ccnl_http_printf(http, "ccn-lite-relay Status Page &nbsp;&nbsp;");
     t = time(NULL);
     cp = ctime(&t);
     cp[strlen(cp)-1] = 0;
-    len += sprintf(txt+len, "<tr><td><td><font size=-1>%s &nbsp;&nbsp;", cp);
+    ccnl_http_printf(http, "<tr><td><td><font size=-1>%s &nbsp;&nbsp;", cp);
     cp = ctime(&ccnl->startup_time);
     cp[strlen(cp)-1] = 0;
-    len += sprintf(txt+len, " (started %s)</font>\n</table>\n", cp);
-
-    len += sprintf(txt+len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Forwarding table</em></table><ul>\n");
-    for (fwd = ccnl->fib, cnt = 0; fwd; fwd = fwd->next, cnt++);
-    if (cnt > 0) {
-        struct ccnl_forward_s **fwda;
-        fwda = (struct ccnl_forward_s**) ccnl_malloc(cnt * sizeof(fwd));
-        for (fwd = ccnl->fib, i = 0; fwd; fwd = fwd->next, i++)
-            fwda[i] = fwd;
-        qsort(fwda, cnt, sizeof(fwd), ccnl_cmpfib);
-        for (i = 0; i < cnt; i++) {
-            char fname[16];
+    ccnl_http_printf(http, " (started %s)</font>\n</table>\n", cp);
+}
+
+static void
+ccnl_http_row(struct ccnl_http_s *http, int table, void *entry)
+{
+    char s[CCNL_MAX_PREFIX_SIZE];
+
+    switch (table) {
+    case CCNL_DUMP_FACES: {
+        struct ccnl_face_s *f = (struct ccnl_face_s*) entry;
+        struct ccnl_buf_s *bpt;
+        int j;
+
+        ccnl_http_printf(http,
+                         "<li><strong>f%d</strong> (via i%d) &nbsp;"
+                         "peer=<font face=courier>%s</font> &nbsp;ttl=",
+                         f->faceid, f->ifndx, ccnl_addr2ascii(&(f->peer)));
+        if (f->flags & CCNL_FACE_FLAGS_STATIC)
+            ccnl_http_printf(http, "static");
+        else
+            ccnl_http_printf(http, "%.1fsec",
+                             f->last_used + CCNL_FACE_TIMEOUT - CCNL_NOW());
+        for (j = 0, bpt = f->outq; bpt; bpt = bpt->next, j++);
+        ccnl_http_printf(http, " &nbsp;qlen=%d weight=%d", j,
+                         f->weight > 0 ? f->weight : 1);
+        ccnl_http_printf(http, " &nbsp;pit=%d ilimited=%u ioverload=%u",
+                         f->pitcnt, (unsigned) f->ilimit_cnt,
+                         (unsigned) f->ioverload_cnt);
+#ifdef USE_LINKREL
+        if (f->linkrel)
+            ccnl_http_printf(http, " &nbsp;link: tx=%u retx=%u lost=%u"
+                             " dup=%u rto=%ldms",
+                             f->linkrel->tx_cnt, f->linkrel->retx_cnt,
+                             f->linkrel->loss_cnt, f->linkrel->dup_cnt,
+                             f->linkrel->rto / 1000);
+#endif
+        ccnl_http_printf(http, "\n");
+        break;
+    }
+    case CCNL_DUMP_FIB: {
+        struct ccnl_forward_s *fwd = (struct ccnl_forward_s*) entry;
+        char fname[16];
+
 #ifdef USE_ECHO
-            if (fwda[i]->tap)
-                strcpy(fname, "'echoserver'");
-            else
+        if (fwd->tap)
+            strcpy(fname, "'echoserver'");
+        else
 #endif
-            if(fwda[i]->face)
-                sprintf(fname, "f%d", fwda[i]->face->faceid);
-            else
-                sprintf(fname, "?");
-            len += sprintf(txt+len,
-                           "<li>via %4s: <font face=courier>%s</font>\n",
-                           fname, ccnl_prefix_to_str(fwda[i]->prefix,s,CCNL_MAX_PREFIX_SIZE));
+        if (fwd->face)
+            snprintf(fname, sizeof(fname), "f%d", fwd->face->faceid);
+        else
+            strcpy(fname, "?");
+        ccnl_http_printf(http, "<li>via %4s: <font face=courier>%s</font>\n",
+                         fname, ccnl_prefix_to_str(fwd->prefix, s,
+                                                   CCNL_MAX_PREFIX_SIZE));
+        break;
+    }
+    case CCNL_DUMP_PIT: {
+        struct ccnl_interest_s *i = (struct ccnl_interest_s*) entry;
+
+        ccnl_http_printf(http, "<li>from f%d: <font face=courier>%s</font>"
+                         " &nbsp;retries=%d\n",
+                         i->from ? i->from->faceid : -1,
+                         ccnl_prefix_to_str(i->pkt->pfx, s,
+                                            CCNL_MAX_PREFIX_SIZE),
+                         i->retries);
+        break;
+    }
+    case CCNL_DUMP_CS: {
+        struct ccnl_content_s *c = (struct ccnl_content_s*) entry;
+
+        ccnl_http_printf(http, "<li><font face=courier>%s</font>"
+                         " &nbsp;served=%d\n",
+                         ccnl_prefix_to_str(c->pkt->pfx, s,
+                                            CCNL_MAX_PREFIX_SIZE),
+                         c->served_cnt);
+        break;
+    }
+    default:
+        break;
+    }
+}
+
+/*
+ * Renders rows of a table until the table or the page is done (returns
+ * 1), or until the buffer is full or the budget is spent (returns 0).
+ */
+static int
+ccnl_http_table(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http,
+                int table, int *budget)
+{
+    struct ccnl_dump_s *d;
+    void *entry;
+
+    if (!http->started) {
+        if (ccnl_http_room(http) < CCNL_HTTP_ROWMAX)
+            return 0;
+        ccnl_http_section(http, ccnl_http_title(table));
+        http->started = 1;
+        if (!http->table) { // the first rows on the status page
+            d = ccnl_dump_open(ccnl, table, NULL, -1);
+            http->dump = d ? d->id : 0;
+            http->rows = http->pagerows = CCNL_HTTP_ROWS;
         }
-        ccnl_free(fwda);
     }
-    len += sprintf(txt+len, "</ul>\n");
-
-    len += sprintf(txt+len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Faces</em></table><ul>\n");
-    for (f = ccnl->faces, cnt = 0; f; f = f->next, cnt++);
-    if (cnt > 0) {
-        struct ccnl_face_s **fa;
-        fa = (struct ccnl_face_s**) ccnl_malloc(cnt * sizeof(f));
-        for (f = ccnl->faces, i = 0; f; f = f->next, i++)
-            fa[i] = f;
-        qsort(fa, cnt, sizeof(f), ccnl_cmpfaceid);
-        for (i = 0; i < cnt; i++) {
-            len += sprintf(txt+len,
-                           "<li><strong>f%d</strong> (via i%d) &nbsp;"
-                           "peer=<font face=courier>%s</font> &nbsp;ttl=",
-                           fa[i]->faceid, fa[i]->ifndx,
-                           ccnl_addr2ascii(&(fa[i]->peer)));
-            if (fa[i]->flags & CCNL_FACE_FLAGS_STATIC)
-                len += sprintf(txt+len, "static");
-            else
-                len += sprintf(txt+len, "%.1fsec",
-                        fa[i]->last_used + CCNL_FACE_TIMEOUT - CCNL_NOW());
-            for (j = 0, bpt = fa[i]->outq; bpt; bpt = bpt->next, j++);
-            len += sprintf(txt+len, " &nbsp;qlen=%d\n", j);
+    d = http->dump ? ccnl_dump_find(ccnl, http->dump) : NULL;
+    if (!d) {
+        ccnl_http_printf(http, "</ul>\n<p>This listing is no longer "
+                         "available, <a href=\"/%s\">start over</a>.\n",
+                         ccnl_dump_table2str(table));
+        goto done;
+    }
+    for (;;) {
+        if (ccnl_http_room(http) < CCNL_HTTP_ROWMAX)
+            return 0;
+        entry = ccnl_dump_peek(d, budget);
+        if (!entry) {
+            if (d->entry) // budget spent
+                return 0;
+            break;
+        }
+        if (http->rows == 0) { // page is full, and there is more
+            ccnl_http_printf(http, "</ul>\n<p>%lu entries so far, "
+                             "<a href=\"/%s?cursor=%lu&rows=%d\">more</a>\n",
+                             d->pos, ccnl_dump_table2str(table),
+                             (unsigned long) d->id, http->pagerows);
+            http->dump = 0;
+            goto done;
         }
-        ccnl_free(fa);
+        ccnl_http_row(http, table, entry);
+        ccnl_dump_consume(d);
+        if (http->rows > 0)
+            http->rows--;
     }
-    len += sprintf(txt+len, "</ul>\n");
+    ccnl_http_printf(http, "</ul>\n<p>%lu entries\n", d->pos);
+    ccnl_dump_close(ccnl, d);
+    http->dump = 0;
+done:
+    http->started = 0;
+    return 1;
+}
 
-    len += sprintf(txt+len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Interfaces</em></table><ul>\n");
+static void
+ccnl_http_info(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
+{
+    struct ccnl_buf_s *bpt;
+    int i, cnt;
+
+    ccnl_http_section(http, "Interfaces");
     for (i = 0; i < ccnl->ifcount; i++) {
 #ifdef USE_STATS
-        len += sprintf(txt+len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
-                       "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
-                       "qlen=%zu/%d"
-                       "&nbsp;&nbsp;rx=%u&nbsp;&nbsp;tx=%u"
-                       "\n",
-                       i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN,
-                       ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt);
+        ccnl_http_printf(http, "<li><strong>i%d</strong>&nbsp;&nbsp;"
+                         "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
+                         "qlen=%zu/%d"
+                         "&nbsp;&nbsp;rx=%u&nbsp;&nbsp;tx=%u&nbsp;&nbsp;"
+                         "drop=%u&nbsp;&nbsp;marks=%u\n",
+                         i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
+                         ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN,
+                         ccnl->ifs[i].rx_cnt, ccnl->ifs[i].tx_cnt,
+                         ccnl->ifs[i].drop_cnt, ccnl->ifs[i].mark_cnt);
 #else
-        len += sprintf(txt+len, "<li><strong>i%d</strong>&nbsp;&nbsp;"
-                       "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
-                       "qlen=%d/%d"
-                       "\n",
-                       i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
-                       ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN);
+        ccnl_http_printf(http, "<li><strong>i%d</strong>&nbsp;&nbsp;"
+                         "addr=<font face=courier>%s</font>&nbsp;&nbsp;"
+                         "qlen=%d/%d"
+                         "\n",
+                         i, ccnl_addr2ascii(&ccnl->ifs[i].addr),
+                         ccnl->ifs[i].qlen, CCNL_MAX_IF_QLEN);
 #endif
     }
-    len += sprintf(txt+len, "</ul>\n");
+    ccnl_http_printf(http, "</ul>\n");
 
-    len += sprintf(txt+len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Misc stats</em></table><ul>\n");
+    ccnl_http_section(http, "Misc stats");
     for (cnt = 0, bpt = ccnl->nonces; bpt; bpt = bpt->next, cnt++);
-    len += sprintf(txt+len, "<li>Nonces: %d\n", cnt);
-    for (cnt = 0, ipt = ccnl->pit; ipt; ipt = ipt->next, cnt++);
-    len += sprintf(txt+len, "<li>Pending interests: %d\n", cnt);
-    len += sprintf(txt+len, "<li>Content chunks: %d (max=%d)\n",
-                   ccnl->contentcnt, ccnl->max_cache_entries);
-    len += sprintf(txt+len, "</ul>\n");
-
-    len += sprintf(txt+len, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
-                   "<tr><td><em>Config</em></table><table borders=0>\n");
-    len += sprintf(txt+len, "<tr><td>content.timeout:"
-                   "<td align=right> %d<td>\n", CCNL_CONTENT_TIMEOUT);
-    len += sprintf(txt+len, "<tr><td>face.timeout:"
-                   "<td align=right> %d<td>\n", CCNL_FACE_TIMEOUT);
-    len += sprintf(txt+len, "<tr><td>interest.maxretransmit:"
-                   "<td align=right> %d<td>\n", CCNL_MAX_INTEREST_RETRANSMIT);
-    len += sprintf(txt+len, "<tr><td>interest.timeout:"
-                   "<td align=right> %d<td>\n", CCNL_INTEREST_TIMEOUT);
-    len += sprintf(txt+len, "<tr><td>nonces.max:"
-                   "<td align=right> %d<td>\n", CCNL_MAX_NONCES);
-
-    //len += sprintf(txt+len, "<tr><td>compile.featureset:<td><td> %s\n",
-    //               compile_string);
-    len += sprintf(txt+len, "<tr><td>compile.time:"
-                   "<td><td>%s %s\n", __DATE__, __TIME__);
-    len += sprintf(txt+len, "<tr><td>compile.ccnl_core_version:"
-                   "<td><td>%s\n", CCNL_VERSION);
-    len += sprintf(txt+len, "</table>\n");
-
-    len += sprintf(txt+len, "\n<p><hr></body></html>\n");
-
-    http->out = (unsigned char*) txt;
-    http->outoffs = 0;
-    http->outlen = len;
+    ccnl_http_printf(http, "<li>Nonces: %d\n", cnt);
+    ccnl_http_printf(http, "<li>Pending interests: %d "
+                     "<a href=\"/pit\">[list]</a>\n", ccnl->pitcnt);
+    ccnl_http_printf(http, "<li>Content chunks: %d (max=%d) "
+                     "<a href=\"/cs\">[list]</a>\n",
+                     ccnl->contentcnt, ccnl->max_cache_entries);
+    ccnl_http_printf(http, "</ul>\n");
+
+    ccnl_http_printf(http, "\n<p><table borders=0 width=100%% bgcolor=#e0e0ff>"
+                     "<tr><td><em>Config</em></table><table borders=0>\n");
+    ccnl_http_printf(http, "<tr><td>content.timeout:"
+                     "<td align=right> %d<td>\n", CCNL_CONTENT_TIMEOUT);
+    ccnl_http_printf(http, "<tr><td>face.timeout:"
+                     "<td align=right> %d<td>\n", CCNL_FACE_TIMEOUT);
+    ccnl_http_printf(http, "<tr><td>interest.maxretransmit:"
+                     "<td align=right> %d<td>\n", CCNL_MAX_INTEREST_RETRANSMIT);
+    ccnl_http_printf(http, "<tr><td>interest.timeout:"
+                     "<td align=right> %d<td>\n", CCNL_INTEREST_TIMEOUT);
+    ccnl_http_printf(http, "<tr><td>nonces.max:"
+                     "<td align=right> %d<td>\n", CCNL_MAX_NONCES);
+
+    ccnl_http_printf(http, "<tr><td>compile.time:"
+                     "<td><td>%s %s\n", __DATE__, __TIME__);
+    ccnl_http_printf(http, "<tr><td>compile.ccnl_core_version:"
+                     "<td><td>%s\n", CCNL_VERSION);
+    ccnl_http_printf(http, "</table>\n");
+}
+
+int
+ccnl_http_more(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
+{
+    int budget = CCNL_DUMP_SCAN;
+
+    if (!http->steps)
+        return 0;
+    if (http->outoffs > 0) {
+        memmove(http->out, http->out + http->outoffs, http->outlen);
+        http->outoffs = 0;
+    }
+    while (!ccnl_http_complete(http) && budget > 0) {
+        int step = http->steps[http->step];
+
+        if (step == HTTP_FIB || step == HTTP_FACES || step == HTTP_TABLE) {
+            int table = step == HTTP_FIB ? CCNL_DUMP_FIB :
+                        step == HTTP_FACES ? CCNL_DUMP_FACES : http->table;
+            if (!ccnl_http_table(ccnl, http, table, &budget))
+                break;
+        } else {
+            if (ccnl_http_room(http) < CCNL_HTTP_BUFSIZE / 2)
+                break;
+            switch (step) {
+            case HTTP_HEAD:
+                ccnl_http_head(ccnl, http);
+                break;
+            case HTTP_INFO:
+                ccnl_http_info(ccnl, http);
+                break;
+            case HTTP_FOOT:
+                ccnl_http_printf(http, "\n<p><hr></body></html>\n");
+                break;
+            case HTTP_NOTFOUND:
+                ccnl_http_printf(http,
+                                 "HTTP/1.1 404 Not Found\r\n"
+                                 "Content-Type: text/html; charset=utf-8\r\n"
+                                 "Connection: close\r\n\r\n"
+                                 "<html><body>Not found, see the "
+                                 "<a href=\"/\">status page</a>."
+                                 "</body></html>\n");
+                break;
+            default:
+                break;
+            }
+        }
+        http->step++;
+    }
+    return ccnl_http_complete(http);
+}
+
+// ----------------------------------------------------------------------
+// requests
+
+// decodes %XX and '+' in place
+static void
+ccnl_http_urldecode(char *s)
+{
+    char *cp = s;
+
+    while (*s) {
+        if (*s == '+') {
+            *cp++ = ' ';
+            s++;
+        } else if (*s == '%' && isxdigit((unsigned char) s[1])
+                   && isxdigit((unsigned char) s[2])) {
+            char hex[3] = { s[1], s[2], 0 };
+            *cp++ = (char) strtol(hex, NULL, 16);
+            s += 3;
+        } else
+            *cp++ = *s++;
+    }
+    *cp = 0;
+}
+
+int
+ccnl_http_status(struct ccnl_relay_s *ccnl, struct ccnl_http_s *http)
+{
+    char *path, *query, *cp, *key, *val;
+    struct ccnl_prefix_s *prefix = NULL;
+    struct ccnl_dump_s *d = NULL;
+    unsigned long cursor = 0;
+    int faceid = -1, rows = CCNL_HTTP_ROWS;
+
+    if (http->steps) // already answering, ignore the rest of the request
+        return 0;
+    // wait for the request line, unless it does not fit
+    if (!strchr((char*) http->in, '\n')
+        && (unsigned long) http->inlen < sizeof(http->in) - 1)
+        return 0;
+    http->inlen = 0;
+    http->step = http->started = 0;
+    http->table = 0;
+    http->dump = 0;
+    http->outoffs = http->outlen = 0;
+
+    path = (char*) http->in;
+    if (strncmp(path, "GET ", 4)) {
+        http->steps = ccnl_http_notfound_page;
+        goto out;
+    }
+    path += 4;
+    path[strcspn(path, " \r\n")] = 0;
+    query = strchr(path, '?');
+    if (query)
+        *query++ = 0;
+    DEBUGMSG(DEBUG, "http: GET %s%s%s\n", path, query ? "?" : "",
+             query ? query : "");
+
+    if (!strcmp(path, "/")) {
+        http->steps = ccnl_http_status_page;
+        goto out;
+    }
+    http->table = ccnl_dump_str2table(path + 1);
+    if (path[0] != '/' || http->table < 0) {
+        http->table = 0;
+        http->steps = ccnl_http_notfound_page;
+        goto out;
+    }
+
+    for (cp = query; cp && *cp; ) {
+        key = cp;
+        cp = strchr(cp, '&');
+        if (cp)
+            *cp++ = 0;
+        val = strchr(key, '=');
+        if (!val)
+            continue;
+        *val++ = 0;
+        ccnl_http_urldecode(val);
+        if (!strcmp(key, "prefix") && *val && !prefix) {
+            prefix = ccnl_URItoPrefix(val, CCNL_SUITE_DEFAULT, NULL);
+        } else if (!strcmp(key, "face") && *val) {
+            faceid = atoi(val);
+        } else if (!strcmp(key, "cursor")) {
+            cursor = strtoul(val, NULL, 10);
+        } else if (!strcmp(key, "rows")) {
+            rows = atoi(val);
+        }
+    }
 
+    if (cursor) {
+        if (prefix)
+            ccnl_prefix_free(prefix);
+        d = ccnl_dump_find(ccnl, (uint32_t) cursor);
+        if (d && d->table != http->table)
+            d = NULL;
+    } else
+        d = ccnl_dump_open(ccnl, http->table, prefix, faceid);
+    http->dump = d ? d->id : 0;
+    http->pagerows = rows > 0 ? rows : 0;
+    http->rows = rows > 0 ? rows : -1;
+    http->steps = ccnl_http_table_page;
+
+out:
+    ccnl_http_more(ccnl, http);
     return 0;
 }
 
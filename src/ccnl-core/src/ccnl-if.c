@@ -18,6 +18,7 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 per-face DRR sub-queues with a strict-priority class
  */
 
 
@@ -26,6 +27,9 @@
 #include "ccnl-os-time.h"
 #include "ccnl-malloc.h"
 #include "ccnl-logging.h"
+#include "ccnl-defs.h"
+#include "ccnl-buf.h"
+#include <string.h>
 #include <sys/socket.h>
 #ifndef CCNL_RIOT
 #include <sys/un.h>
@@ -38,18 +42,174 @@
 #include <ccnl-os-time.h>
 #include <ccnl-malloc.h>
 #include <ccnl-logging.h>
+#include <ccnl-defs.h>
+#include <ccnl-buf.h>
 #endif
 
+static int
+ccnl_interface_subq_of(struct ccnl_if_s *i, struct ccnl_txrequest_s *req)
+{
+    struct ccnl_face_s *f = req->txdone_face;
+    int k, unused = -1;
+
+    if (!f || req->prio) {
+        return 0;
+    }
+    for (k = 1; k < CCNL_MAX_IF_SUBQ; k++) {
+        if (!i->subq[k].qlen) {
+            if (unused < 0) {
+                unused = k;
+            }
+        } else if (i->subq[k].face == f) {
+            return k;
+        }
+    }
+    if (unused > 0) {
+        return unused;
+    }
+    // more busy faces than sub-queues: share one, keyed by face id
+    return 1 + (int)((unsigned) f->faceid % (CCNL_MAX_IF_SUBQ - 1));
+}
+
+static void
+ccnl_interface_subq_pop(struct ccnl_if_s *i, int k, struct ccnl_txrequest_s *req)
+{
+    struct ccnl_if_subq_s *q = i->subq + k;
+    struct ccnl_txrequest_s *r = i->queue + q->head;
+
+    memcpy(req, r, sizeof(*req));
+    r->buf = NULL;
+    q->head = r->next;
+    q->qlen--;
+    i->qlen--;
+    if (!q->qlen) {
+        q->face = NULL;
+        q->deficit = 0;
+    }
+}
+
+int
+ccnl_interface_sched_enqueue(struct ccnl_if_s *i, struct ccnl_txrequest_s *req)
+{
+    struct ccnl_if_subq_s *q;
+    struct ccnl_txrequest_s *r, victim;
+    int k, slot;
+
+    k = ccnl_interface_subq_of(i, req);
+    q = i->subq + k;
+    victim.buf = NULL;
+
+    if (i->qlen >= CCNL_MAX_IF_QLEN) {
+        int j, longest = 1;
+
+        // the priority class is never pushed out by bulk traffic
+        for (j = 2; j < CCNL_MAX_IF_SUBQ; j++) {
+            if (i->subq[j].qlen > i->subq[longest].qlen) {
+                longest = j;
+            }
+        }
+        if (!i->subq[longest].qlen ||
+            (k && q->qlen >= i->subq[longest].qlen)) {
+            return -1;
+        }
+        DEBUGMSG_CORE(DEBUG, "  interface full, dropping head of subq %d\n",
+                      longest);
+        ccnl_interface_subq_pop(i, longest, &victim);
+#ifdef USE_STATS
+        i->drop_cnt++;
+#endif
+    }
+
+    for (slot = i->qfree; i->queue[slot].buf;
+         slot = (slot + 1) % CCNL_MAX_IF_QLEN);
+    i->qfree = (slot + 1) % CCNL_MAX_IF_QLEN;
+
+    r = i->queue + slot;
+    memcpy(r, req, sizeof(*r));
+    r->next = -1;
+    ccnl_get_timeval(&r->enqueued);
+    if (q->qlen) {
+        i->queue[q->tail].next = slot;
+    } else {
+        int w = req->txdone_face ? req->txdone_face->weight : 1;
+        q->face = req->txdone_face;
+        q->head = slot;
+        q->quantum = (w > 0 ? w : 1) * CCNL_IF_DRR_QUANTUM;
+    }
+    q->tail = slot;
+    q->qlen++;
+    i->qlen++;
+
+    // only now, the callback may queue the next request of its face
+    if (victim.buf) {
+        if (victim.txdone) {
+            victim.txdone(victim.txdone_face, 1, -1);
+        }
+        ccnl_free(victim.buf);
+    }
+    return 0;
+}
+
+int
+ccnl_interface_sched_dequeue(struct ccnl_if_s *i, struct ccnl_txrequest_s *req)
+{
+    struct ccnl_if_subq_s *q;
+
+    if (!i->qlen) {
+        return -1;
+    }
+    if (i->subq[0].qlen) {
+        ccnl_interface_subq_pop(i, 0, req);
+        return 0;
+    }
+    if (i->drr_cur < 1) {
+        i->drr_cur = 1;
+    }
+    // terminates: every round credits a quantum to each busy sub-queue
+    for (;;) {
+        q = i->subq + i->drr_cur;
+        if (q->qlen && i->queue[q->head].buf->datalen <= (size_t) q->deficit) {
+            q->deficit -= (int) i->queue[q->head].buf->datalen;
+            ccnl_interface_subq_pop(i, i->drr_cur, req);
+            return 0;
+        }
+        if (++i->drr_cur >= CCNL_MAX_IF_SUBQ) {
+            i->drr_cur = 1;
+        }
+        q = i->subq + i->drr_cur;
+        if (q->qlen) {
+            q->deficit += q->quantum;
+        }
+    }
+}
+
+int
+ccnl_interface_congested(struct ccnl_if_s *i, struct ccnl_txrequest_s *req)
+{
+    struct timeval now;
+
+    ccnl_get_timeval(&now);
+    if (timevaldelta(&now, &req->enqueued) < CCNL_IF_SOJOURN_TARGET) {
+        i->above = 0;
+        return 0;
+    }
+    if (!i->above) {
+        i->above = 1;
+        i->above_since = now;
+        return 0;
+    }
+    return timevaldelta(&now, &i->above_since) >= CCNL_IF_SOJOURN_INTERVAL;
+}
+
 void
 ccnl_interface_cleanup(struct ccnl_if_s *i)
 {
-    size_t j;
+    struct ccnl_txrequest_s r;
     DEBUGMSG_CORE(TRACE, "ccnl_interface_cleanup\n");
 
     ccnl_sched_destroy(i->sched);
-    for (j = 0; j < i->qlen; j++) {
-        struct ccnl_txrequest_s *r = i->queue + (i->qfront+j)%CCNL_MAX_IF_QLEN;
-        ccnl_free(r->buf);
+    while (!ccnl_interface_sched_dequeue(i, &r)) {
+        ccnl_free(r.buf);
     }
 #if !defined(CCNL_RIOT) && !defined(CCNL_ANDROID) && !defined(CCNL_LINUXKERNEL)
     ccnl_close_socket(i->sock);
@@ -19,6 +19,7 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 in-record set instead of a linked list of pending faces
  */
 
 #ifndef CCNL_LINUXKERNEL
@@ -29,6 +30,7 @@
 #include "ccnl-prefix.h"
 #include "ccnl-logging.h"
 #include "ccnl-pkt-util.h"
+#include <string.h>
 #else
 #include <ccnl-relay.h>
 #include <ccnl-interest.h>
@@ -43,28 +45,193 @@
 #include "ccn-lite-riot.h"
 #endif
 
+#define CCNL_PENDSET_MINCAP     16 // hash table size when leaving inline mode
+
+static size_t
+ccnl_pendset_home(struct ccnl_pendset_s *set, struct ccnl_face_s *face)
+{
+    uint32_t h = (uint32_t) ((uintptr_t) face >> 4) * 2654435761u;
+
+    return (h ^ (h >> 16)) & (set->cap - 1);
+}
+
+static struct ccnl_pendint_s*
+ccnl_pendset_slot(struct ccnl_pendset_s *set, struct ccnl_face_s *face)
+{
+    size_t k = ccnl_pendset_home(set, face);
+
+    // linear probing, the table is never full
+    while (set->tab[k].face && set->tab[k].face != face) {
+        k = (k + 1) & (set->cap - 1);
+    }
+    return set->tab + k;
+}
+
+static int
+ccnl_pendset_resize(struct ccnl_pendset_s *set, size_t cap)
+{
+    struct ccnl_pendint_s *old = set->tab, *src;
+    size_t oldcap = set->cap, k;
+
+    set->tab = (struct ccnl_pendint_s*) ccnl_calloc(cap, sizeof(*set->tab));
+    if (!set->tab) {
+        set->tab = old;
+        return -1;
+    }
+    set->cap = cap;
+    src = old ? old : set->inl;
+    for (k = 0; k < (old ? oldcap : set->cnt); k++) {
+        if (src[k].face) {
+            *ccnl_pendset_slot(set, src[k].face) = src[k];
+        }
+    }
+    ccnl_free(old);
+    return 0;
+}
+
+struct ccnl_pendint_s*
+ccnl_pendset_lookup(struct ccnl_pendset_s *set, struct ccnl_face_s *face)
+{
+    struct ccnl_pendint_s *pi;
+    size_t k;
+
+    if (!set->tab) {
+        for (k = 0; k < set->cnt; k++) {
+            if (set->inl[k].face == face) {
+                return set->inl + k;
+            }
+        }
+        return NULL;
+    }
+    pi = ccnl_pendset_slot(set, face);
+    return pi->face ? pi : NULL;
+}
+
+struct ccnl_pendint_s*
+ccnl_pendset_insert(struct ccnl_pendset_s *set, struct ccnl_face_s *face)
+{
+    struct ccnl_pendint_s *pi = ccnl_pendset_lookup(set, face);
+
+    if (pi) {
+        return pi;
+    }
+    if (!set->tab && set->cnt < CCNL_PENDSET_INLINE) {
+        pi = set->inl + set->cnt;
+    } else {
+        if (!set->tab || 4 * (set->cnt + 1) > 3 * set->cap) {
+            if (ccnl_pendset_resize(set, set->tab ? 2 * set->cap
+                                                  : CCNL_PENDSET_MINCAP)) {
+                return NULL;
+            }
+        }
+        pi = ccnl_pendset_slot(set, face);
+    }
+    pi->face = face;
+    pi->last_used = 0;
+    set->cnt++;
+    return pi;
+}
+
+int
+ccnl_pendset_remove(struct ccnl_pendset_s *set, struct ccnl_face_s *face)
+{
+    struct ccnl_pendint_s *pi = ccnl_pendset_lookup(set, face);
+    size_t i, j, k, mask = set->cap - 1;
+
+    if (!pi) {
+        return 0;
+    }
+    set->cnt--;
+    if (!set->tab) {
+        *pi = set->inl[set->cnt];
+        memset(set->inl + set->cnt, 0, sizeof(*pi));
+        return 1;
+    }
+    // backward shift deletion keeps probe sequences intact
+    i = j = (size_t) (pi - set->tab);
+    for (;;) {
+        j = (j + 1) & mask;
+        if (!set->tab[j].face) {
+            break;
+        }
+        k = ccnl_pendset_home(set, set->tab[j].face);
+        if (i <= j ? (i < k && k <= j) : (i < k || k <= j)) {
+            continue;
+        }
+        set->tab[i] = set->tab[j];
+        i = j;
+    }
+    memset(set->tab + i, 0, sizeof(*pi));
+    return 1;
+}
+
+struct ccnl_pendint_s*
+ccnl_pendset_next(struct ccnl_pendset_s *set, size_t *pos)
+{
+    if (!set->tab) {
+        return *pos < set->cnt ? set->inl + (*pos)++ : NULL;
+    }
+    while (*pos < set->cap) {
+        struct ccnl_pendint_s *pi = set->tab + (*pos)++;
+        if (pi->face) {
+            return pi;
+        }
+    }
+    return NULL;
+}
+
+void
+ccnl_pendset_clear(struct ccnl_pendset_s *set)
+{
+    ccnl_free(set->tab);
+    memset(set, 0, sizeof(*set));
+}
+
 struct ccnl_interest_s*
 ccnl_interest_new(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
                   struct ccnl_pkt_s **pkt)
 {
     char s[CCNL_MAX_PREFIX_SIZE];
     (void) s;
+    size_t size;
 
-    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_calloc(1,
-                                            sizeof(struct ccnl_interest_s));
     DEBUGMSG_CORE(TRACE,
                   "ccnl_new_interest(prefix=%s, suite=%s)\n",
                   ccnl_prefix_to_str((*pkt)->pfx, s, CCNL_MAX_PREFIX_SIZE),
                   ccnl_suite2str((*pkt)->pfx->suite));
 
+    if (ccnl_pkt_materialize(*pkt))
+        return NULL;
+    size = sizeof(struct ccnl_interest_s) +
+           ((*pkt)->buf ? (*pkt)->buf->datalen : 0);
+    if (ccnl_pit_admit(ccnl, from, size))
+        return NULL;
+    struct ccnl_interest_s *i = (struct ccnl_interest_s *) ccnl_calloc(1,
+                                            sizeof(struct ccnl_interest_s));
     if (!i)
         return NULL;
     i->pkt = *pkt;
+    i->size = size;
     /* currently, the aging function relies on seconds rather than on milli seconds */
     i->lifetime = ccnl_pkt_interest_lifetime(*pkt);
 
     *pkt = NULL;
     i->from = from;
+    if (from) {
+        from->pitcnt++;
+        i->fnext = from->pit;
+        if (from->pit) {
+            from->pit->fprev = i;
+        } else {
+            from->pitend = i;
+        }
+        from->pit = i;
+        if (!ccnl->pit_heavy || from->pitcnt > ccnl->pit_heavy->pitcnt) {
+            ccnl->pit_heavy = from;
+        }
+    }
+    ccnl->pitcnt++;
+    ccnl->pit_bytes += size;
     i->last_used = CCNL_NOW();
     DBL_LINKED_LIST_ADD(ccnl->pit, i);
 
@@ -81,11 +248,11 @@ ccnl_interest_isSame(struct ccnl_interest_s *i, struct ccnl_pkt_s *pkt)
 {
     if (i) {
         if (pkt) {
-            if (i->pkt->pfx->suite != pkt->suite || ccnl_prefix_cmp(i->pkt->pfx, NULL, pkt->pfx, CMP_EXACT)) { 
+            if (CCNL_SUITE_OF(i->pkt->pfx) != CCNL_SUITE_OF(pkt) || ccnl_prefix_cmp(i->pkt->pfx, NULL, pkt->pfx, CMP_EXACT)) { 
                 return 0;
             }
             
-            switch (i->pkt->pfx->suite) {
+            switch (CCNL_SUITE_OF(i->pkt->pfx)) {
 #ifdef USE_SUITE_CCNB
                 case CCNL_SUITE_CCNB: 
                     return i->pkt->s.ccnb.minsuffix == pkt->s.ccnb.minsuffix && i->pkt->s.ccnb.maxsuffix == pkt->s.ccnb.maxsuffix &&
@@ -121,32 +288,23 @@ ccnl_interest_append_pending(struct ccnl_interest_s *i,  struct ccnl_face_s *fro
     if (i) {
         DEBUGMSG_CORE(TRACE, "ccnl_append_pending\n");
         if (from) {
-            struct ccnl_pendint_s *pi, *last = NULL;
+            struct ccnl_pendint_s *pi;
             char s[CCNL_MAX_PREFIX_SIZE];
+            (void) s;
 
-            for (pi = i->pending; pi; pi = pi->next) { // check whether already listed
-                    if (pi->face == from) {
-                            DEBUGMSG_CORE(DEBUG, "  we found a matching interest, updating time\n");
-                            pi->last_used = CCNL_NOW();
-                            return 0;
-                    }
-                    last = pi;
-            }
-            pi = (struct ccnl_pendint_s *) ccnl_calloc(1,sizeof(struct ccnl_pendint_s));
+            pi = ccnl_pendset_insert(&i->pending, from);
             if (!pi) {
                     DEBUGMSG_CORE(DEBUG, "  no mem\n");
                     return -1;
             }
-
-            DEBUGMSG_CORE(DEBUG, "  appending a new pendint entry %p <%s>(%p)\n",
+            if (pi->last_used) {
+                    DEBUGMSG_CORE(DEBUG, "  we found a matching interest, updating time\n");
+            } else {
+                    DEBUGMSG_CORE(DEBUG, "  appending a new pendint entry %p <%s>(%p)\n",
                             (void *) pi, ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE),
                             (void *) i->pkt->pfx);
-            pi->face = from;
+            }
             pi->last_used = CCNL_NOW();
-            if (last)
-                    last->next = pi;
-            else
-                    i->pending = pi;
             return 0;
         }
 
@@ -167,33 +325,15 @@ ccnl_interest_remove_pending(struct ccnl_interest_s *interest, struct ccnl_face_
         /** face is valid? */
         if (face) {
             char s[CCNL_MAX_PREFIX_SIZE];
-            result = 0;
+            (void) s;
 
-            struct ccnl_pendint_s *prev = NULL;
-            struct ccnl_pendint_s *pend = interest->pending; 
-            
-            DEBUGMSG_CORE(TRACE, "ccnl_interest_remove_pending\n"); 
-            
-            while (pend) {  // TODO: is this really the most elegant solution?
-                if (face->faceid == pend->face->faceid) { 
-                    DEBUGMSG_CFWD(INFO, "  removed face (%s) for interest %s\n",
-                        ccnl_addr2ascii(&pend->face->peer), 
-                        ccnl_prefix_to_str(interest->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE)); 
-                    
-                    result++; 
-                    if (prev) { 
-                        prev->next = pend->next;
-                        ccnl_free(pend);
-                        pend = prev->next;
-                    } else {
-                        interest->pending = pend->next;
-                        ccnl_free(pend);
-                        pend = interest->pending;
-                    }
-                } else {
-                    prev = pend;
-                    pend = pend->next; 
-                }
+            DEBUGMSG_CORE(TRACE, "ccnl_interest_remove_pending\n");
+
+            result = ccnl_pendset_remove(&interest->pending, face);
+            if (result) {
+                DEBUGMSG_CFWD(INFO, "  removed face (%s) for interest %s\n",
+                    ccnl_addr2ascii(&face->peer),
+                    ccnl_prefix_to_str(interest->pkt->pfx,s,CCNL_MAX_PREFIX_SIZE));
             }
             return result;
         }
@@ -0,0 +1,329 @@
+/*
+ * @f ccnl-linkrel.c
+ * @b CCN lite, hop-by-hop link reliability (NDNLPv2 style)
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#include "ccnl-linkrel.h"
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+
+#if defined(USE_LINKREL) && defined(USE_SUITE_NDNTLV)
+
+// room for the LpPacket header: TL, TxSequence, Acks and Fragment TL
+#define CCNL_LINKREL_HDRLEN     (16 + 14 + NDN_LP_MAX_ACKS * 14)
+
+struct ccnl_linkrel_s*
+ccnl_linkrel_new(void)
+{
+    struct ccnl_linkrel_s *lr;
+
+    lr = (struct ccnl_linkrel_s*) ccnl_calloc(1, sizeof(*lr));
+    if (lr) {
+        lr->rto = CCNL_LINKREL_RTO_INIT;
+    }
+    return lr;
+}
+
+void
+ccnl_linkrel_free(struct ccnl_linkrel_s *lr)
+{
+    int i;
+
+    if (!lr) {
+        return;
+    }
+    if (lr->timer) {
+        ccnl_rem_timer(lr->timer);
+    }
+    for (i = 0; i < CCNL_LINKREL_WINDOW; i++) {
+        ccnl_free(lr->unacked[i].buf);
+    }
+    ccnl_free(lr);
+}
+
+// encodes a link frame carrying all pending acks (which are cleared)
+static struct ccnl_buf_s*
+ccnl_linkrel_mkFrame(struct ccnl_linkrel_s *lr,
+                     struct ccnl_linkrel_frame_s *fr)
+{
+    struct ccnl_ndntlv_lp_s lp;
+    struct ccnl_buf_s *wire;
+    size_t offset, len;
+
+    memset(&lp, 0, sizeof(lp));
+    if (fr) {
+        lp.has_txseq = 1;
+        lp.txseq = fr->seq;
+        lp.frag = fr->buf->data;
+        lp.fraglen = fr->buf->datalen;
+        lp.congmark = fr->congmark;
+    }
+    memcpy(lp.acks, lr->acks, lr->ackcnt * sizeof(uint64_t));
+    lp.ackcnt = lr->ackcnt;
+
+    wire = ccnl_buf_new(NULL, lp.fraglen + CCNL_LINKREL_HDRLEN);
+    if (!wire) {
+        return NULL;
+    }
+    if (fr) {
+        wire->flags = fr->buf->flags;
+    }
+    offset = wire->datalen;
+    if (ccnl_ndntlv_prependLpPacket(&lp, &offset, wire->data, &len)) {
+        ccnl_free(wire);
+        return NULL;
+    }
+    memmove(wire->data, wire->data + offset, len);
+    wire->datalen = len;
+    lr->ackcnt = 0;
+
+    return wire;
+}
+
+static long
+ccnl_linkrel_frameRTO(struct ccnl_linkrel_s *lr,
+                      struct ccnl_linkrel_frame_s *fr)
+{
+    long rto = lr->rto << fr->retries;
+
+    return rto > CCNL_LINKREL_RTO_MAX ? CCNL_LINKREL_RTO_MAX : rto;
+}
+
+// (re)arms the face timer for the earliest retransmission or ack deadline
+static void
+ccnl_linkrel_arm(struct ccnl_relay_s *relay, struct ccnl_face_s *f)
+{
+    struct ccnl_linkrel_s *lr = f->linkrel;
+    struct timeval now;
+    long due = -1, left;
+    int i;
+
+    ccnl_get_timeval(&now);
+    for (i = 0; i < CCNL_LINKREL_WINDOW; i++) {
+        struct ccnl_linkrel_frame_s *fr = lr->unacked + i;
+        if (!fr->buf) {
+            continue;
+        }
+        left = ccnl_linkrel_frameRTO(lr, fr) - timevaldelta(&now, &fr->sent);
+        if (left < 0) {
+            left = 0;
+        }
+        if (due < 0 || left < due) {
+            due = left;
+        }
+    }
+    if (lr->ackcnt && (due < 0 || due > CCNL_LINKREL_ACK_DELAY)) {
+        due = CCNL_LINKREL_ACK_DELAY;
+    }
+
+    if (lr->timer) {
+        ccnl_rem_timer(lr->timer);
+        lr->timer = NULL;
+    }
+    if (due >= 0) {
+        lr->timer = ccnl_set_timer(due, ccnl_linkrel_timeout, relay, f);
+    }
+}
+
+static void
+ccnl_linkrel_send(struct ccnl_relay_s *relay, struct ccnl_face_s *f,
+                  struct ccnl_buf_s *wire)
+{
+    if (wire) {
+        ccnl_interface_enqueue(ccnl_face_CTS_done, f, relay,
+                               relay->ifs + f->ifndx, wire, &f->peer);
+    }
+}
+
+struct ccnl_buf_s*
+ccnl_linkrel_TX(struct ccnl_relay_s *relay, struct ccnl_face_s *f,
+                struct ccnl_buf_s *buf)
+{
+    struct ccnl_linkrel_s *lr = f->linkrel;
+    struct ccnl_linkrel_frame_s *fr;
+    struct ccnl_buf_s *wire;
+    struct ccnl_ndntlv_lp_s lp;
+    uint8_t *data;
+    size_t datalen, len;
+    uint64_t typ;
+
+    if (!lr || !buf ||
+        ccnl_pkt2suite(buf->data, buf->datalen, NULL) != CCNL_SUITE_NDNTLV) {
+        return buf;
+    }
+
+    memset(&lp, 0, sizeof(lp));
+    data = buf->data;
+    datalen = buf->datalen;
+    if (!ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) &&
+        typ == NDN_TLV_LpPacket) {
+        struct ccnl_buf_s *frag = NULL;
+        if (!ccnl_ndntlv_parseLpPacket(data, len, &lp) && lp.frag) {
+            frag = ccnl_buf_new(lp.frag, lp.fraglen);
+        }
+        ccnl_free(buf);
+        if (!frag) {
+            return NULL;
+        }
+        buf = frag;
+    }
+
+    fr = lr->unacked + (lr->sendseq % CCNL_LINKREL_WINDOW);
+    if (fr->buf) {
+        DEBUGMSG_CORE(DEBUG, "linkrel: window full, giving up seq=%llu\n",
+                      (unsigned long long) fr->seq);
+        ccnl_free(fr->buf);
+        lr->loss_cnt++;
+    }
+    fr->buf = buf;
+    fr->seq = lr->sendseq++;
+    fr->retries = 0;
+    fr->congmark = lp.congmark;
+    ccnl_get_timeval(&fr->sent);
+
+    wire = ccnl_linkrel_mkFrame(lr, fr);
+    if (!wire) {
+        return NULL;
+    }
+    lr->tx_cnt++;
+    ccnl_linkrel_arm(relay, f);
+
+    return wire;
+}
+
+// RFC 6298 estimator, fed with samples of frames never retransmitted
+static void
+ccnl_linkrel_rttSample(struct ccnl_linkrel_s *lr, long rtt)
+{
+    if (!lr->srtt) {
+        lr->srtt = rtt;
+        lr->rttvar = rtt / 2;
+    } else {
+        long err = rtt - lr->srtt;
+        lr->rttvar += ((err < 0 ? -err : err) - lr->rttvar) / 4;
+        lr->srtt += err / 8;
+    }
+    lr->rto = lr->srtt + 4 * lr->rttvar;
+    if (lr->rto < CCNL_LINKREL_RTO_MIN) {
+        lr->rto = CCNL_LINKREL_RTO_MIN;
+    } else if (lr->rto > CCNL_LINKREL_RTO_MAX) {
+        lr->rto = CCNL_LINKREL_RTO_MAX;
+    }
+}
+
+int
+ccnl_linkrel_RX(struct ccnl_relay_s *relay, struct ccnl_face_s *f,
+                struct ccnl_ndntlv_lp_s *lp)
+{
+    struct ccnl_linkrel_s *lr = f->linkrel;
+    struct timeval now;
+    uint64_t *seen;
+    size_t i;
+
+    if (!lr) {
+        if (!lp->has_txseq) {
+            return lp->frag != NULL;
+        }
+        // the peer runs the reliability protocol, so must we
+        lr = f->linkrel = ccnl_linkrel_new();
+        if (!lr) {
+            return lp->frag != NULL;
+        }
+    }
+
+    ccnl_get_timeval(&now);
+    for (i = 0; i < lp->ackcnt; i++) {
+        struct ccnl_linkrel_frame_s *fr;
+        fr = lr->unacked + (lp->acks[i] % CCNL_LINKREL_WINDOW);
+        if (!fr->buf || fr->seq != lp->acks[i]) {
+            continue;
+        }
+        if (!fr->retries) {
+            ccnl_linkrel_rttSample(lr, timevaldelta(&now, &fr->sent));
+        }
+        ccnl_free(fr->buf);
+        fr->buf = NULL;
+        lr->ack_cnt++;
+    }
+
+    if (lp->has_txseq) {
+        lr->rx_cnt++;
+        if (lr->ackcnt == NDN_LP_MAX_ACKS) { // the peer will retransmit
+            memmove(lr->acks, lr->acks + 1, (lr->ackcnt - 1) * sizeof(uint64_t));
+            lr->ackcnt--;
+        }
+        lr->acks[lr->ackcnt++] = lp->txseq;
+
+        seen = lr->seen + (lp->txseq % (2 * CCNL_LINKREL_WINDOW));
+        if (*seen == lp->txseq + 1) {
+            DEBUGMSG_CORE(DEBUG, "linkrel: duplicate seq=%llu\n",
+                          (unsigned long long) lp->txseq);
+            lr->dup_cnt++;
+            ccnl_linkrel_arm(relay, f);
+            return 0;
+        }
+        *seen = lp->txseq + 1;
+    }
+    ccnl_linkrel_arm(relay, f);
+
+    return lp->frag != NULL;
+}
+
+void
+ccnl_linkrel_timeout(void *relay, void *face)
+{
+    struct ccnl_relay_s *ccnl = (struct ccnl_relay_s*) relay;
+    struct ccnl_face_s *f = (struct ccnl_face_s*) face;
+    struct ccnl_linkrel_s *lr = f->linkrel;
+    struct timeval now;
+    int i;
+
+    lr->timer = NULL;
+    ccnl_get_timeval(&now);
+    for (i = 0; i < CCNL_LINKREL_WINDOW; i++) {
+        struct ccnl_linkrel_frame_s *fr = lr->unacked + i;
+        if (!fr->buf ||
+            timevaldelta(&now, &fr->sent) < ccnl_linkrel_frameRTO(lr, fr)) {
+            continue;
+        }
+        if (fr->retries >= CCNL_LINKREL_MAX_RETRIES) {
+            DEBUGMSG_CORE(DEBUG, "linkrel: face %d lost seq=%llu\n",
+                          f->faceid, (unsigned long long) fr->seq);
+            ccnl_free(fr->buf);
+            fr->buf = NULL;
+            lr->loss_cnt++;
+            continue;
+        }
+        DEBUGMSG_CORE(VERBOSE, "linkrel: face %d retransmits seq=%llu\n",
+                      f->faceid, (unsigned long long) fr->seq);
+        fr->retries++;
+        fr->sent = now;
+        lr->retx_cnt++;
+        ccnl_linkrel_send(ccnl, f, ccnl_linkrel_mkFrame(lr, fr));
+    }
+    if (lr->ackcnt) { // nothing to piggyback on: IDLE packet
+        ccnl_linkrel_send(ccnl, f, ccnl_linkrel_mkFrame(lr, NULL));
+    }
+    ccnl_linkrel_arm(ccnl, f);
+}
+
+#endif // USE_LINKREL && USE_SUITE_NDNTLV
+
+// eof
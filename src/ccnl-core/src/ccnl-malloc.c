@@ -26,6 +26,20 @@
 
 #ifdef USE_DEBUG_MALLOC
 
+struct ccnl_malloc_stats_s ccnl_malloc_stats;
+
+static void
+debug_link(struct mhdr *hdr)
+{
+    hdr->next = mem;
+    if (mem) {
+        mem->pprev = &hdr->next;
+    }
+    hdr->pprev = &mem;
+    hdr->magic = CCNL_MHDR_MAGIC;
+    mem = hdr;
+}
+
 #ifdef CCNL_ARDUINO
 void* debug_malloc(size_t s, const char *fn, int lno, double tstamp)
 #else
@@ -45,11 +59,12 @@ void* debug_malloc(size_t s, const char *fn, int lno, char *tstamp)
             return NULL;
         }
 
-        h->next = mem;
-        mem = h;
+        debug_link(h);
         h->fname = (char *) fn;
         h->lineno = lno;
         h->size = s;
+        ccnl_malloc_stats.allocs++;
+        ccnl_malloc_stats.bytes += s;
 
 #ifdef CCNL_ARDUINO
         h->tstamp = tstamp;
@@ -120,17 +135,19 @@ void* debug_calloc(size_t n, size_t s, const char *fn, int lno, char *tstamp)
 int
 debug_unlink(struct mhdr *hdr)
 {
-    struct mhdr **pp = &mem;
-
-    for (pp = &mem; pp; pp = &((*pp)->next)) {
-        if (*pp == hdr) {
-            *pp = hdr->next;
-            return 0;
-        }
-    if (!(*pp)->next)
-            break;
+    // blocks know where they are linked from, unlinking does not walk the
+    // list of all blocks; pprev is only trusted in the header of a live
+    // block, not in whatever precedes a pointer that is not ours
+    if (hdr->magic != CCNL_MHDR_MAGIC || !hdr->pprev || *hdr->pprev != hdr) {
+        return 1;
+    }
+    *hdr->pprev = hdr->next;
+    if (hdr->next) {
+        hdr->next->pprev = hdr->pprev;
     }
-    return 1;
+    hdr->pprev = NULL;
+    hdr->magic = 0;
+    return 0;
 }
 
 void*
@@ -151,9 +168,9 @@ debug_realloc(void *p, size_t s, const char *fn, int lno)
 #endif // BUILTIN_INT_ADD_OVERFLOW_DETECTION_UNAVAILABLE
     if (p) {
         if (debug_unlink(h)) {
-            CONSOLE("%s @@@ memerror - realloc(%s:%d) at "
-                    "%s:%d does not find memory block\n",
-                    timestamp(), h->fname, h->lineno, fn, lno);
+            CONSOLE("%s @@@ memerror - realloc() at "
+                    "%s:%d does not find memory block %p\n",
+                    timestamp(), fn, lno, p);
             return NULL;
         }
 
@@ -173,8 +190,9 @@ debug_realloc(void *p, size_t s, const char *fn, int lno)
     h->fname = (char *) fn;
     h->lineno = lno;
     h->size = s;
-    h->next = mem;
-    mem = h;
+    debug_link(h);
+    ccnl_malloc_stats.allocs++;
+    ccnl_malloc_stats.bytes += s;
     return ((unsigned char *)h) + sizeof(struct mhdr);
 }
 
@@ -224,6 +242,7 @@ debug_free(void *p, const char *fn, int lno)
                 timestamp(), fn, lno, p);
         return;
     }
+    ccnl_malloc_stats.frees++;
 #ifndef CCNL_ARDUINO
     if (h->tstamp && *h->tstamp)
          free(h->tstamp);
@@ -234,6 +234,8 @@ ccnl_mgmt_send_return_split(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                 if (!retbuf) {
                     goto Bail;
                 }
+                // the reply bypasses bulk traffic on the interface
+                retbuf->flags |= CCNL_BUF_FLAGS_PRIO;
                 ccnl_face_enqueue(ccnl, from, retbuf);
             } else {
                 char uri[50];
@@ -1252,6 +1254,277 @@ Bail:
     return rc;
 }
 
+// a page of a table dump fits into one segment of a split reply
+#define CCNL_DUMP_PAGE_SIZE     (CCNL_MAX_PACKET_SIZE / 4 - 64)
+
+static int8_t
+ccnl_mgmt_dump_int(uint8_t *stmt, const uint8_t *stmtend, uint64_t dtag,
+                   const char *fmt, long val, size_t *len)
+{
+    char str[32];
+
+    snprintf(str, sizeof(str), fmt, val);
+    return ccnl_ccnb_mkStrBlob(stmt + *len, stmtend, dtag, CCN_TT_DTAG, str, len);
+}
+
+// one entry of a table dump, as in the debug dump but without the list
+// pointers
+static int8_t
+ccnl_mgmt_dump_entry(int table, void *entry, uint8_t *stmt,
+                     const uint8_t *stmtend, size_t *len)
+{
+    struct ccnl_face_s *f = NULL;
+    struct ccnl_forward_s *fwd;
+    struct ccnl_interest_s *i;
+    struct ccnl_content_s *c;
+    struct ccnl_prefix_s *name = NULL;
+    char s[CCNL_MAX_PREFIX_SIZE];
+    uint64_t dtag;
+
+    switch (table) {
+    case CCNL_DUMP_FACES:
+        f = (struct ccnl_face_s*) entry;
+        if (ccnl_ccnb_mkHeader(stmt + *len, stmtend, CCN_DTAG_FACEINSTANCE, CCN_TT_DTAG, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCN_DTAG_FACEID, "%ld", f->faceid, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCNL_DTAG_IFNDX, "%ld", f->ifndx, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCNL_DTAG_FACEFLAGS, "%02lx", f->flags, len)) {
+            return -1;
+        }
+        switch (f->peer.sa.sa_family) {
+        case AF_INET:
+#ifdef USE_IPV6
+        case AF_INET6:
+#endif
+            dtag = CCNL_DTAG_IP;
+            break;
+#ifdef USE_LINKLAYER
+#if !(defined(__FreeBSD__) || defined(__APPLE__))
+        case AF_PACKET:
+            dtag = CCNL_DTAG_ETH;
+            break;
+#endif
+#endif
+        case AF_UNIX:
+            dtag = CCNL_DTAG_UNIX;
+            break;
+        default:
+            dtag = CCNL_DTAG_PEER;
+        }
+        if (ccnl_ccnb_mkStrBlob(stmt + *len, stmtend, dtag, CCN_TT_DTAG,
+                                ccnl_addr2ascii(&f->peer), len)) {
+            return -1;
+        }
+        break;
+    case CCNL_DUMP_FIB:
+        fwd = (struct ccnl_forward_s*) entry;
+        name = fwd->prefix;
+        if (ccnl_ccnb_mkHeader(stmt + *len, stmtend, CCN_DTAG_FWDINGENTRY, CCN_TT_DTAG, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCN_DTAG_FACEID, "%ld",
+                               fwd->face ? fwd->face->faceid : 0, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCNL_DTAG_SUITE, "%ld", fwd->suite, len)) {
+            return -1;
+        }
+        break;
+    case CCNL_DUMP_PIT:
+        i = (struct ccnl_interest_s*) entry;
+        name = i->pkt->pfx;
+        if (ccnl_ccnb_mkHeader(stmt + *len, stmtend, CCN_DTAG_INTEREST, CCN_TT_DTAG, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCN_DTAG_FACEID, "%ld",
+                               i->from ? i->from->faceid : 0, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCNL_DTAG_LAST, "%ld", (long) i->last_used, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCNL_DTAG_RETRIES, "%ld", i->retries, len)) {
+            return -1;
+        }
+        break;
+    case CCNL_DUMP_CS:
+        c = (struct ccnl_content_s*) entry;
+        name = c->pkt->pfx;
+        if (ccnl_ccnb_mkHeader(stmt + *len, stmtend, CCN_DTAG_CONTENT, CCN_TT_DTAG, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCNL_DTAG_LASTUSE, "%ld", (long) c->last_used, len) ||
+            ccnl_mgmt_dump_int(stmt, stmtend, CCNL_DTAG_SERVEDCTN, "%ld", (long) c->served_cnt, len)) {
+            return -1;
+        }
+        break;
+    default:
+        return -1;
+    }
+    if (name && ccnl_ccnb_mkStrBlob(stmt + *len, stmtend, CCNL_DTAG_PREFIX, CCN_TT_DTAG,
+                              ccnl_prefix_to_str(name, s, sizeof(s)), len)) {
+        return -1;
+    }
+    if (stmt + *len + 1 >= stmtend) {
+        return -1;
+    }
+    stmt[(*len)++] = 0; // end of entry
+    return 0;
+}
+
+int8_t
+ccnl_mgmt_tabledump(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
+                    struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
+{
+    uint8_t *buf, *action = NULL, *table = NULL, *filter = NULL,
+            *faceid = NULL, *cursor = NULL;
+    size_t buflen, len = 0, len3 = 0, mark;
+    uint64_t num;
+    uint8_t typ;
+    uint8_t out[CCNL_DUMP_PAGE_SIZE + 64], stmt[CCNL_DUMP_PAGE_SIZE];
+    struct ccnl_dump_s *d = NULL;
+    struct ccnl_prefix_s *pfx = NULL;
+    char *cp = "tabledump failed", msg[64], id[16] = "0";
+    void *entry;
+    int budget = CCNL_DUMP_SCAN, cnt = 0, tab = -1;
+    int8_t rc = -1;
+
+    DEBUGMSG(TRACE, "ccnl_mgmt_tabledump from=%s\n", ccnl_addr2ascii(&from->peer));
+
+    buf = prefix->comp[3];
+    buflen = prefix->complen[3];
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto Reply;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_CONTENTOBJ) {
+        goto Reply;
+    }
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto Reply;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_CONTENT) {
+        goto Reply;
+    }
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto Reply;
+    }
+    if (typ != CCN_TT_BLOB) {
+        goto Reply;
+    }
+    buflen = num;
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto Reply;
+    }
+    if (typ != CCN_TT_DTAG || num != CCNL_DTAG_DEBUGREQUEST) {
+        goto Reply;
+    }
+
+    while (!ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        if (num == 0 && typ == 0) {
+            break; // end
+        }
+        extractStr(action, CCN_DTAG_ACTION);
+        extractStr(table, CCNL_DTAG_DEBUGACTION);
+        extractStr(filter, CCNL_DTAG_PREFIX);
+        extractStr(faceid, CCN_DTAG_FACEID);
+        extractStr(cursor, CCNL_DTAG_CURSOR);
+
+        if (ccnl_ccnb_consume(typ, num, &buf, &buflen, 0, 0)) {
+            goto Reply;
+        }
+    }
+
+    // a request without a cursor starts a dump, one with a cursor gets the
+    // next page, with the table and filters given at the start
+    if (cursor && strcmp((char*) cursor, "0")) {
+        d = ccnl_dump_find(ccnl, (uint32_t) strtoul((char*) cursor, NULL, 10));
+        if (!d) {
+            cp = "tabledump failed: no such cursor";
+            goto Reply;
+        }
+    } else {
+        if (!table || (tab = ccnl_dump_str2table((char*) table)) < 0) {
+            cp = "tabledump failed: unknown table";
+            goto Reply;
+        }
+        if (filter && filter[0]) {
+            pfx = ccnl_URItoPrefix((char*) filter, CCNL_SUITE_DEFAULT, NULL);
+            if (!pfx) {
+                goto Reply;
+            }
+        }
+        d = ccnl_dump_open(ccnl, tab, pfx,
+                           faceid ? (int) strtol((char*) faceid, NULL, 10) : -1);
+        if (!d) {
+            goto Reply;
+        }
+    }
+    tab = d->table;
+
+    // as many entries as fit, looking at no more than CCNL_DUMP_SCAN
+    if (ccnl_ccnb_mkHeader(stmt, stmt + sizeof(stmt), CCNL_DTAG_DEBUGREPLY, CCN_TT_DTAG, &len3)) {
+        goto Reply;
+    }
+    while ((entry = ccnl_dump_peek(d, &budget))) {
+        mark = len3;
+        if (ccnl_mgmt_dump_entry(tab, entry, stmt, stmt + sizeof(stmt) - 64, &len3)) {
+            len3 = mark;
+            if (cnt) {
+                break;
+            }
+            DEBUGMSG(WARNING, "tabledump: entry too large for a page, skipped\n");
+        } else {
+            cnt++;
+        }
+        ccnl_dump_consume(d);
+    }
+    snprintf(msg, sizeof(msg), "tabledump %s: %d entries, %lu so far",
+             ccnl_dump_table2str(tab), cnt, d->pos);
+    cp = msg;
+    if (d->entry) {
+        snprintf(id, sizeof(id), "%lu", (unsigned long) d->id);
+    } else {
+        ccnl_dump_close(ccnl, d);
+    }
+    rc = 0;
+
+Reply:
+    if (!rc) {
+        if (ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCNL_DTAG_CURSOR, CCN_TT_DTAG, id, &len3)) {
+            rc = -1;
+        }
+    } else {
+        len3 = 0;
+        if (ccnl_ccnb_mkHeader(stmt, stmt + sizeof(stmt), CCNL_DTAG_DEBUGREPLY, CCN_TT_DTAG, &len3)) {
+            goto Bail;
+        }
+    }
+    if (ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCN_DTAG_ACTION, CCN_TT_DTAG,
+                            (char*) (tab > 0 ? ccnl_dump_table2str(tab) : "tabledump"), &len3) ||
+        ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCNL_DTAG_DEBUGACTION, CCN_TT_DTAG,
+                            cp, &len3)) {
+        goto Bail;
+    }
+    if (len3 + 1 >= sizeof(stmt)) {
+        goto Bail;
+    }
+    stmt[len3++] = 0; // end of debug reply
+
+    if (ccnl_ccnb_mkHeader(out+len, out + sizeof(out), CCN_DTAG_NAME, CCN_TT_DTAG, &len) ||
+        ccnl_ccnb_mkStrBlob(out+len, out + sizeof(out), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "ccnx", &len) ||
+        ccnl_ccnb_mkStrBlob(out+len, out + sizeof(out), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "", &len) ||
+        ccnl_ccnb_mkStrBlob(out+len, out + sizeof(out), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "tabledump", &len)) {
+        goto Bail;
+    }
+    if (len + 1 >= sizeof(out)) {
+        goto Bail;
+    }
+    out[len++] = 0; // end of name
+    if (ccnl_ccnb_mkBlob(out+len, out + sizeof(out), CCN_DTAG_CONTENT, CCN_TT_DTAG,
+                         (char*) stmt, len3, &len)) {
+        goto Bail;
+    }
+    if (ccnl_mgmt_send_return_split(ccnl, orig, prefix, from, len, out)) {
+        rc = -1;
+    }
+
+Bail:
+    ccnl_free(action);
+    ccnl_free(table);
+    ccnl_free(filter);
+    ccnl_free(faceid);
+    ccnl_free(cursor);
+
+    return rc;
+}
+
 int8_t
 ccnl_mgmt_newface(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                 struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
@@ -1431,6 +1704,11 @@ ccnl_mgmt_newface(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         DEBUGMSG(TRACE, "  adding a new face (id=%d) worked!\n", f->faceid);
         f->flags = flagval &
             (CCNL_FACE_FLAGS_STATIC|CCNL_FACE_FLAGS_REFLECT);
+#ifdef USE_LINKREL
+        if ((flagval & CCNL_FACE_FLAGS_LINKREL) && !f->linkrel) {
+            f->linkrel = ccnl_linkrel_new();
+        }
+#endif
 
 #ifdef USE_FRAG
         if (frag) {
@@ -1750,6 +2028,138 @@ Bail:
     return rc;
 }
 
+int8_t
+ccnl_mgmt_setweight(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
+                    struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
+{
+    uint8_t *buf;
+    size_t buflen;
+    uint64_t num;
+    uint8_t typ;
+    uint8_t *action, *faceid, *weight;
+    char *cp = "setweight cmd failed";
+    int8_t rc = -1;
+    struct ccnl_face_s *f;
+    size_t len = 0, len3 = 0;
+
+    DEBUGMSG(TRACE, "ccnl_mgmt_setweight from=%p, ifndx=%d\n",
+             (void*) from, from->ifndx);
+    action = faceid = weight = NULL;
+
+    buf = prefix->comp[3];
+    buflen = prefix->complen[3];
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_CONTENTOBJ) {
+        goto SoftBail;
+    }
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_CONTENT) {
+        goto SoftBail;
+    }
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_BLOB) {
+        goto SoftBail;
+    }
+    buflen = num;
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_FACEINSTANCE) {
+        goto SoftBail;
+    }
+
+    while (!ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        if (num==0 && typ==0) {
+            break; // end
+        }
+        extractStr(action, CCN_DTAG_ACTION);
+        extractStr(faceid, CCN_DTAG_FACEID);
+        extractStr(weight, CCNL_DTAG_WEIGHT);
+
+        if (ccnl_ccnb_consume(typ, num, &buf, &buflen, 0, 0)) {
+            goto SoftBail;
+        }
+    }
+
+    if (faceid && weight) {
+        long fi = strtol((const char*)faceid, NULL, 0), w;
+
+        for (f = ccnl->faces; f && f->faceid != fi; f = f->next);
+        errno = 0;
+        w = strtol((const char*) weight, NULL, 0);
+        if (f && !errno && w > 0 && w <= INT_MAX
+                && !ccnl_face_set_weight(f, (int) w)) {
+            cp = "setweight cmd worked";
+        }
+    }
+    if (strcmp(cp, "setweight cmd worked")) {
+        DEBUGMSG(TRACE, "  setweight request for (faceid=%s weight=%s) failed\n",
+                 faceid, weight);
+    }
+
+SoftBail:
+
+    if (ccnl_ccnb_mkHeader(out_buf+len, out_buf + OUT_BUF_SIZE, CCN_DTAG_NAME, CCN_TT_DTAG, &len)) {  // name
+        goto Bail;
+    }
+    if (ccnl_ccnb_mkStrBlob(out_buf+len, out_buf + OUT_BUF_SIZE, CCN_DTAG_COMPONENT, CCN_TT_DTAG, "ccnx", &len)) {
+        goto Bail;
+    }
+    if (ccnl_ccnb_mkStrBlob(out_buf+len, out_buf + OUT_BUF_SIZE, CCN_DTAG_COMPONENT, CCN_TT_DTAG, "", &len)) {
+        goto Bail;
+    }
+    if (ccnl_ccnb_mkStrBlob(out_buf+len, out_buf + OUT_BUF_SIZE, CCN_DTAG_COMPONENT, CCN_TT_DTAG, "setweight", &len)) {
+        goto Bail;
+    }
+    if (len + 1 >= OUT_BUF_SIZE) {
+        goto Bail;
+    }
+    out_buf[len++] = 0; // end-of-name
+
+    // prepare FACEINSTANCE
+    if (ccnl_ccnb_mkHeader(faceinst_buf, faceinst_buf + FACEINST_BUF_SIZE, CCN_DTAG_FACEINSTANCE, CCN_TT_DTAG, &len3)) {
+        goto Bail;
+    }
+    if (ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCN_DTAG_ACTION, CCN_TT_DTAG, cp, &len3)) {
+        goto Bail;
+    }
+    if (faceid && ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCN_DTAG_FACEID, CCN_TT_DTAG, (char*) faceid, &len3)) {
+        goto Bail;
+    }
+    if (weight && ccnl_ccnb_mkStrBlob(faceinst_buf+len3, faceinst_buf + FACEINST_BUF_SIZE, CCNL_DTAG_WEIGHT, CCN_TT_DTAG, (char*) weight, &len3)) {
+        goto Bail;
+    }
+    if (len3 + 1 >= FACEINST_BUF_SIZE) {
+        goto Bail;
+    }
+    faceinst_buf[len3++] = 0; // end-of-faceinst
+
+    if (ccnl_ccnb_mkBlob(out_buf+len, out_buf + OUT_BUF_SIZE, CCN_DTAG_CONTENT, CCN_TT_DTAG,  // content
+                   (char*) faceinst_buf, len3, &len)) {
+        goto Bail;
+    }
+
+    if (ccnl_mgmt_send_return_split(ccnl, orig, prefix, from, len, (unsigned char*)out_buf)) {
+        goto Bail;
+    }
+
+    rc = 0;
+
+Bail:
+
+    ccnl_free(action);
+    ccnl_free(faceid);
+    ccnl_free(weight);
+
+    return rc;
+}
+
 int8_t
 ccnl_mgmt_destroyface(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                       struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
@@ -2673,6 +3083,179 @@ Bail:
     return rc;
 }
 
+#ifndef CCNL_FIB_BATCH_MAX
+# define CCNL_FIB_BATCH_MAX      (64 * 1024 * 1024) // bytes of route lines
+#endif
+
+// the route lines of a prefixregbatch, collected per face until its
+// last part
+struct ccnl_fib_batch_s {
+    int suite;
+    long nextpart;
+    size_t len, max;
+    char routes[];
+};
+
+int8_t
+ccnl_mgmt_prefixregbatch(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
+                         struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
+{
+    uint8_t *buf, *routes = NULL;
+    size_t buflen, routeslen = 0;
+    uint64_t num;
+    uint8_t typ;
+    uint8_t *action = NULL, *suite = NULL, *seqno = NULL, *last = NULL;
+    struct ccnl_fib_batch_s *b = from->fib_batch;
+    char *cp = "prefixregbatch cmd failed", msg[64];
+    char *end;
+    long part;
+    int8_t rc = -1;
+
+    DEBUGMSG(TRACE, "ccnl_mgmt_prefixregbatch\n");
+
+    buf = prefix->comp[3];
+    buflen = prefix->complen[3];
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_CONTENTOBJ) {
+        goto SoftBail;
+    }
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_CONTENT) {
+        goto SoftBail;
+    }
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_BLOB) {
+        goto SoftBail;
+    }
+    buflen = num;
+    if (ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        goto SoftBail;
+    }
+    if (typ != CCN_TT_DTAG || num != CCN_DTAG_FWDINGENTRY) {
+        goto SoftBail;
+    }
+
+    while (!ccnl_ccnb_dehead(&buf, &buflen, &num, &typ)) {
+        if (num == 0 && typ == 0) {
+            break; // end
+        }
+        if (typ == CCN_TT_DTAG && num == CCNL_DTAG_ROUTES) {
+            // the lines stay in the message until they are copied below
+            if (ccnl_ccnb_consume(typ, num, &buf, &buflen, &routes,
+                                  &routeslen)) {
+                goto SoftBail;
+            }
+            continue;
+        }
+
+        extractStr(action, CCN_DTAG_ACTION);
+        extractStr(suite, CCNL_DTAG_SUITE);
+        extractStr(seqno, CCN_DTAG_SEQNO);
+        extractStr(last, CCNL_DTAG_LASTPART);
+
+        if (ccnl_ccnb_consume(typ, num, &buf, &buflen, 0, 0)) {
+            goto SoftBail;
+        }
+    }
+
+    if (!seqno || !suite || !ccnl_isSuite(suite[0])) {
+        goto SoftBail;
+    }
+    errno = 0;
+    part = strtol((const char*) seqno, &end, 10);
+    if (errno || *end || part < 0) {
+        goto SoftBail;
+    }
+
+    // a batch starts with part 0 and is applied with its last part; parts
+    // out of order or beyond the size limit discard it. Every face stages
+    // its own batch, so batches from different faces do not interfere.
+    if (part == 0) {
+        ccnl_free(b);
+        b = from->fib_batch = (struct ccnl_fib_batch_s*)
+                ccnl_malloc(sizeof(*b) + routeslen + 1);
+        if (!b) {
+            goto SoftBail;
+        }
+        b->suite = suite[0];
+        b->nextpart = 0;
+        b->len = 0;
+        b->max = routeslen + 1;
+    } else if (!b || b->nextpart != part) {
+        cp = "prefixregbatch failed: part out of order";
+        goto Discard;
+    }
+    if (b->len + routeslen >= CCNL_FIB_BATCH_MAX) {
+        cp = "prefixregbatch failed: too many routes";
+        goto Discard;
+    }
+    if (b->len + routeslen + 1 > b->max) {
+        struct ccnl_fib_batch_s *b2;
+        size_t max = 2 * b->max;
+
+        while (max < b->len + routeslen + 1) {
+            max *= 2;
+        }
+        b2 = (struct ccnl_fib_batch_s*) ccnl_realloc(b, sizeof(*b) + max);
+        if (!b2) {
+            goto Discard;
+        }
+        b = from->fib_batch = b2;
+        b->max = max;
+    }
+    if (routeslen) {
+        memcpy(b->routes + b->len, routes, routeslen);
+    }
+    b->len += routeslen;
+    b->routes[b->len] = '\0';
+    b->nextpart++;
+
+    if (!last) {
+        snprintf(msg, sizeof(msg), "prefixregbatch part %ld staged", part);
+        cp = msg;
+        rc = 0;
+        goto SoftBail;
+    }
+
+    {
+        int lineno, added;
+
+        added = ccnl_fib_add_routes(ccnl, b->suite, b->routes, &lineno);
+        if (added >= 0) {
+            snprintf(msg, sizeof(msg), "prefixregbatch worked: %d routes added",
+                     added);
+            rc = 0;
+        } else if (lineno) {
+            snprintf(msg, sizeof(msg), "prefixregbatch failed at line %d",
+                     lineno);
+        } else {
+            snprintf(msg, sizeof(msg), "prefixregbatch failed: out of memory");
+        }
+        cp = msg;
+    }
+
+Discard:
+    ccnl_free(from->fib_batch);
+    from->fib_batch = NULL;
+SoftBail:
+    DEBUGMSG(TRACE, "mgmt: %s\n", cp);
+    ccnl_mgmt_return_ccn_msg(ccnl, orig, prefix, from, "prefixregbatch", cp);
+Bail:
+    ccnl_free(last);
+    ccnl_free(seqno);
+    ccnl_free(suite);
+    ccnl_free(action);
+
+    return rc;
+}
+
+
 int8_t
 ccnl_mgmt_addcacheobject(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
                     struct ccnl_prefix_s *prefix, struct ccnl_face_s *from)
@@ -3043,6 +3626,8 @@ ccnl_mgmt_handle(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         return ccnl_mgmt_newdev(ccnl, orig, prefix, from);
     } else if (!strcmp(cmd, "setfrag")) {
         return ccnl_mgmt_setfrag(ccnl, orig, prefix, from);
+    } else if (!strcmp(cmd, "setweight")) {
+        return ccnl_mgmt_setweight(ccnl, orig, prefix, from);
     } else if (!strcmp(cmd, "destroydev")) {
         return ccnl_mgmt_destroydev(ccnl, orig, prefix, from);
 #ifdef USE_ECHO
@@ -3055,6 +3640,10 @@ ccnl_mgmt_handle(struct ccnl_relay_s *ccnl, struct ccnl_buf_s *orig,
         return ccnl_mgmt_destroyface(ccnl, orig, prefix, from);
     } else if (!strcmp(cmd, "prefixreg")) {
         return ccnl_mgmt_prefixreg(ccnl, orig, prefix, from);
+    } else if (!strcmp(cmd, "prefixregbatch")) {
+        return ccnl_mgmt_prefixregbatch(ccnl, orig, prefix, from);
+    } else if (!strcmp(cmd, "tabledump")) {
+        return ccnl_mgmt_tabledump(ccnl, orig, prefix, from);
 //  TODO: Add ccnl_mgmt_prefixunreg(ccnl, orig, prefix, from)
 //  } else if (!strcmp(cmd, "prefixunreg")) {
 //      return ccnl_mgmt_prefixunreg(ccnl, orig, prefix, from);
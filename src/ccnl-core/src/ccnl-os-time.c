@@ -63,6 +63,8 @@ gettimeofday(struct timeval *tv, void *dummy)
     tv->tv_usec = (t % Hz) * (1000000 / Hz);
 }
 
+#define ccnl_gettime(tv)        gettimeofday(tv, NULL)
+
 char*
 timestamp(void)
 {
@@ -77,6 +79,18 @@ timestamp(void)
 #else // !CCNL_ARDUINO
 
 #ifndef CCNL_LINUXKERNEL
+void (*ccnl_clock_ptr)(struct timeval *tv);
+
+static void
+ccnl_gettime(struct timeval *tv)
+{
+    if (ccnl_clock_ptr) {
+        ccnl_clock_ptr(tv);
+    } else {
+        gettimeofday(tv, NULL);
+    }
+}
+
 double
 current_time(void)
 {
@@ -84,7 +98,7 @@ current_time(void)
     static time_t start;
     static time_t start_usec;
 
-    gettimeofday(&tv, NULL);
+    ccnl_gettime(&tv);
 
     if (!start) {
         start = tv.tv_sec;
@@ -126,7 +140,7 @@ timevaldelta(struct timeval *a, struct timeval *b) {
 void
 ccnl_get_timeval(struct timeval *tv)
 {
-    gettimeofday(tv, NULL);
+    ccnl_gettime(tv);
 }
 
 void*
@@ -140,7 +154,7 @@ ccnl_set_timer(uint64_t usec, void (*fct)(void *aux1, void *aux2),
     if (!t)
         return 0;
     t->fct2 = fct;
-    gettimeofday(&t->timeout, NULL);
+    ccnl_gettime(&t->timeout);
     usec += t->timeout.tv_usec;
     t->timeout.tv_sec += usec / 1000000;
     t->timeout.tv_usec = usec % 1000000;
@@ -256,7 +270,7 @@ ccnl_run_events(void)
     static struct timeval now;
     long usec;
 
-    gettimeofday(&now, 0);
+    ccnl_gettime(&now);
     while (eventqueue) {
         struct ccnl_timer_s *t = eventqueue;
 
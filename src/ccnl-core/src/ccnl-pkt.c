@@ -18,6 +18,7 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 packet views
  */
 
 #include "ccnl-pkt.h"
@@ -70,6 +71,39 @@ ccnl_pkt_free(struct ccnl_pkt_s *pkt)
 }
 
 
+int
+ccnl_pkt_materialize(struct ccnl_pkt_s *pkt)
+{
+    uint8_t *old;
+    uint32_t i;
+
+    if (!pkt || pkt->buf || !pkt->view) {
+        return 0;
+    }
+    old = pkt->view;
+    pkt->buf = ccnl_buf_new(old, pkt->viewlen);
+    if (!pkt->buf) {
+        return -1;
+    }
+    // carefully rebase ptrs to new buf because of 64bit pointers:
+#define REBASE(p) do { if (p) (p) = pkt->buf->data + ((p) - old); } while (0)
+    REBASE(pkt->content);
+    if (pkt->pfx) {
+        for (i = 0; i < pkt->pfx->compcnt; i++) {
+            REBASE(pkt->pfx->comp[i]);
+        }
+        REBASE(pkt->pfx->nameptr);
+    }
+#ifdef USE_HMAC256
+    REBASE(pkt->hmacStart);
+    REBASE(pkt->hmacSignature);
+#endif
+#undef REBASE
+    pkt->view = NULL;
+    pkt->viewlen = 0;
+    return 0;
+}
+
 struct ccnl_pkt_s *
 ccnl_pkt_dup(struct ccnl_pkt_s *pkt){
     struct ccnl_pkt_s * ret = ccnl_malloc(sizeof(struct ccnl_pkt_s));
@@ -82,6 +116,10 @@ ccnl_pkt_dup(struct ccnl_pkt_s *pkt){
     if(!ret){
         return NULL;
     }
+    if (ccnl_pkt_materialize(pkt)) {
+        ccnl_free(ret);
+        return NULL;
+    }
     if (pkt->pfx) {
         ret->s = pkt->s;
         switch (pkt->pfx->suite) {
@@ -18,23 +18,25 @@
  *
  * File history:
  * 2017-06-16 created
+ * 2026-10-19 cumulative component hashes, compared with the SIMD kernels
  */
 
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-prefix.h"
+#include "ccnl-content.h"
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-pkt-ccntlv.h"
+#include "ccnl-simd.h"
 #include <string.h>
 #include <stdio.h>
 #include <ctype.h>
-#if !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
-#include <openssl/sha.h>
-#endif // !defined(CCNL_RIOT) && !defined(CCNL_ANDROID)
 #else //CCNL_LINUXKERNEL
 #include <ccnl-prefix.h>
+#include <ccnl-content.h>
 #include <ccnl-pkt-ndntlv.h>
 #include <ccnl-pkt-ccntlv.h>
+#include <ccnl-simd.h>
 #endif //CCNL_LINUXKERNEL
 
 
@@ -63,6 +65,7 @@ ccnl_prefix_new(char suite, uint32_t cnt)
 void
 ccnl_prefix_free(struct ccnl_prefix_s *p)
 {
+    ccnl_free(p->comphash);
     ccnl_free(p->bytes);
     ccnl_free(p->comp);
     ccnl_free(p->complen);
@@ -70,6 +73,67 @@ ccnl_prefix_free(struct ccnl_prefix_s *p)
     ccnl_free(p);
 }
 
+#define CCNL_PREFIX_HASH_INIT   0xffffffffu
+
+// CRC-32C over the length and bytes of one component, chained
+static uint32_t
+ccnl_prefix_hashStep(uint32_t h, uint8_t *comp, size_t len)
+{
+    uint8_t l[2];
+
+    l[0] = (uint8_t) (len >> 8);
+    l[1] = (uint8_t) len;
+    h = ccnl_simd_crc32c(h, l, sizeof(l));
+    return ccnl_simd_crc32c(h, comp, len);
+}
+
+// number of leading components covered by valid hashes
+static uint32_t
+ccnl_prefix_hashed(struct ccnl_prefix_s *p)
+{
+    return p->hashcnt < p->compcnt ? p->hashcnt : p->compcnt;
+}
+
+int
+ccnl_prefix_updateHashes(struct ccnl_prefix_s *prefix)
+{
+    uint32_t i, h = CCNL_PREFIX_HASH_INIT;
+
+    ccnl_free(prefix->comphash);
+    prefix->comphash = NULL;
+    prefix->hashcnt = 0;
+    if (!prefix->compcnt) {
+        return 0;
+    }
+    prefix->comphash = (uint32_t*) ccnl_malloc(prefix->compcnt * sizeof(uint32_t));
+    if (!prefix->comphash) {
+        return -1;
+    }
+    for (i = 0; i < prefix->compcnt; i++) {
+        h = ccnl_prefix_hashStep(h, prefix->comp[i], prefix->complen[i]);
+        prefix->comphash[i] = h;
+    }
+    prefix->hashcnt = prefix->compcnt;
+    return 0;
+}
+
+uint32_t
+ccnl_prefix_hashOf(struct ccnl_prefix_s *prefix, uint32_t cnt)
+{
+    uint32_t i, h = CCNL_PREFIX_HASH_INIT;
+
+    if (!cnt) {
+        return h;
+    }
+    if (cnt <= ccnl_prefix_hashed(prefix)) {
+        return prefix->comphash[cnt - 1];
+    }
+    for (i = 0; i < cnt; i++) {
+        h = ccnl_prefix_hashStep(h, prefix->comp[i], prefix->complen[i]);
+    }
+    return h;
+}
+
 struct ccnl_prefix_s*
 ccnl_prefix_dup(struct ccnl_prefix_s *prefix)
 {
@@ -106,6 +170,16 @@ ccnl_prefix_dup(struct ccnl_prefix_s *prefix)
         *p->chunknum = *prefix->chunknum;
     }
 
+    p->hashcnt = ccnl_prefix_hashed(prefix);
+    if (p->hashcnt) {
+        p->comphash = (uint32_t*) ccnl_malloc(p->hashcnt * sizeof(uint32_t));
+        if (!p->comphash) {
+            p->hashcnt = 0;
+        } else {
+            memcpy(p->comphash, prefix->comphash, p->hashcnt * sizeof(uint32_t));
+        }
+    }
+
     return p;
 }
 
@@ -166,6 +240,25 @@ ccnl_prefix_appendCmp(struct ccnl_prefix_s *prefix, uint8_t *cmp,
     ccnl_free(oldcomplen);
     ccnl_free(oldbytes);
 
+    // extend the hashes if they covered all previous components
+    if (ccnl_prefix_hashed(prefix) == lastcmp) {
+        uint32_t *hashes;
+        hashes = (uint32_t*) ccnl_malloc(prefix->compcnt * sizeof(uint32_t));
+        if (hashes) {
+            if (lastcmp) {
+                memcpy(hashes, prefix->comphash, lastcmp * sizeof(uint32_t));
+            }
+            hashes[lastcmp] = ccnl_prefix_hashStep(lastcmp ? hashes[lastcmp - 1]
+                                                   : CCNL_PREFIX_HASH_INIT,
+                                                   cmp, cmplen);
+        }
+        ccnl_free(prefix->comphash);
+        prefix->comphash = hashes;
+        prefix->hashcnt = hashes ? prefix->compcnt : 0;
+    } else if (prefix->hashcnt > lastcmp) {
+        prefix->hashcnt = lastcmp;
+    }
+
     return 0;
 }
 
@@ -351,6 +444,7 @@ ccnl_URItoPrefix(char* uri, int suite, uint32_t *chunknum)
     }
 
     p->compcnt = cnt;
+    ccnl_prefix_updateHashes(p);
 
     if (chunknum) {
         p->chunknum = (uint32_t*) ccnl_malloc(sizeof(uint32_t));
@@ -391,6 +485,7 @@ ccnl_prefix_cmp(struct ccnl_prefix_s *pfx, unsigned char *md,
     int32_t rc = -1;
     size_t clen;
     uint32_t plen = pfx->compcnt + (md ? 1 : 0), i;
+    uint32_t n, h, lo, differ;
     unsigned char *comp;
     char s[CCNL_MAX_PREFIX_SIZE];
 
@@ -417,10 +512,37 @@ ccnl_prefix_cmp(struct ccnl_prefix_s *pfx, unsigned char *md,
         }
     }
 
-    for (i = 0; i < plen && i < nam->compcnt; ++i) {
+    // the cumulative hashes locate the first differing component without
+    // touching the bytes; memcmp below only confirms the components before
+    n = plen < nam->compcnt ? plen : nam->compcnt;
+    h = ccnl_prefix_hashed(pfx);
+    if (h > ccnl_prefix_hashed(nam)) {
+        h = ccnl_prefix_hashed(nam);
+    }
+    if (h > n) {
+        h = n;
+    }
+    differ = n;
+    if (h && pfx->comphash[h - 1] != nam->comphash[h - 1]) {
+        if (mode == CMP_EXACT) {
+            DEBUGMSG(VERBOSE, "name hash mismatch\n");
+            goto done;
+        }
+        for (lo = 0, differ = h - 1; lo < differ; ) {
+            uint32_t mid = lo + (differ - lo) / 2;
+            if (pfx->comphash[mid] == nam->comphash[mid]) {
+                lo = mid + 1;
+            } else {
+                differ = mid;
+            }
+        }
+    }
+
+    for (i = 0; i < n; ++i) {
         comp = i < pfx->compcnt ? pfx->comp[i] : md;
         clen = i < pfx->compcnt ? pfx->complen[i] : 32; // SHA256_DIGEST_LEN
-        if (clen != nam->complen[i] || memcmp(comp, nam->comp[i], nam->complen[i])) {
+        if (i == differ || clen != nam->complen[i] ||
+            !ccnl_simd_memeq(comp, nam->comp[i], clen)) {
             rc = mode == CMP_EXACT ? -1 : (int32_t) i;
             DEBUGMSG(VERBOSE, "component mismatch: %lu\n", (long unsigned) i);
             goto done;
@@ -459,19 +581,12 @@ ccnl_i_prefixof_c(struct ccnl_prefix_s *prefix,
         return -2;
     }
 
-    unsigned char *md = NULL;
-
+    // the Interest carries a full name: the digest is cached with the content
     if ((prefix->compcnt - p->compcnt) == 1) {
-        md = compute_ccnx_digest(c->pkt->buf);
-
-        /* computing the ccnx digest failed */
-        if (!md) {
-            DEBUGMSG(TRACE, "computing the digest failed\n");
-            return -3;
-        }
+        return ccnl_content_matchFullName(c, prefix);
     }
 
-    int32_t cmp = ccnl_prefix_cmp(p, md, prefix, CMP_MATCH);
+    int32_t cmp = ccnl_prefix_cmp(p, NULL, prefix, CMP_MATCH);
     return cmp > 0 && (uint32_t) cmp == prefix->compcnt;
 }
 
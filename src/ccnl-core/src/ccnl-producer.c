@@ -39,7 +39,7 @@ int
 local_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                    struct ccnl_pkt_s *pkt)
 {
-    if (_prod_func) {
+    if (_prod_func && !ccnl_pkt_materialize(pkt)) {
         return _prod_func(relay, from, pkt);
     }
 
@@ -25,6 +25,12 @@
 #include <stdio.h>
 #include <inttypes.h>
 #include <assert.h>
+#include <ctype.h>
+#include <errno.h>
+#include <limits.h>
+#if defined(USE_IPV4) || defined(USE_IPV6)
+#include <arpa/inet.h>
+#endif
 #else //CCNL_LINUXKERNEL
 #include <ccnl-core.h>
 #endif //CCNL_LINUXKERNEL
@@ -87,6 +93,10 @@ ccnl_get_face_or_create(struct ccnl_relay_s *ccnl, int ifndx,
     }
     f->faceid = ++seqno;
     f->ifndx = ifndx;
+    if (ifndx >= 0 && ccnl->face_irate > 0) {
+        ccnl_face_set_interest_rate(f, ccnl->face_irate,
+                                    CCNL_DEFAULT_FACE_IBURST);
+    }
 
     if (ifndx >= 0) {
         if (ccnl->defaultFaceScheduler) {
@@ -132,22 +142,18 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
 #ifdef USE_FRAG
     ccnl_frag_destroy(f->frag);
 #endif
+#ifdef USE_LINKREL
+    ccnl_linkrel_free(f->linkrel);
+#endif
+    ccnl_free(f->fib_batch);
     DEBUGMSG_CORE(TRACE, "face_remove: cleaning PIT\n");
     for (pit = ccnl->pit; pit; ) {
-        struct ccnl_pendint_s **ppend, *pend;
         if (pit->from == f) {
             pit->from = NULL;
+            pit->fnext = pit->fprev = NULL;
         }
-        for (ppend = &pit->pending; *ppend;) {
-            if ((*ppend)->face == f) {
-                pend = *ppend;
-                *ppend = pend->next;
-                ccnl_free(pend);
-            } else {
-                ppend = &(*ppend)->next;
-            }
-        }
-        if (pit->pending) {
+        ccnl_pendset_remove(&pit->pending, f);
+        if (pit->pending.cnt) {
             pit = pit->next;
         } else {
             DEBUGMSG_CORE(TRACE, "before interest_remove 0x%p\n",
@@ -159,6 +165,7 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     for (ppfwd = &ccnl->fib; *ppfwd;) {
         if ((*ppfwd)->face == f) {
             struct ccnl_forward_s *pfwd = *ppfwd;
+            ccnl_dump_forget(ccnl, pfwd);
             ccnl_prefix_free(pfwd->prefix);
             *ppfwd = pfwd->next;
             ccnl_free(pfwd);
@@ -175,6 +182,10 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking1 %p %p\n",
              (void*)f->next, (void*)f->prev);
     f2 = f->next;
+    if (ccnl->pit_heavy == f) {
+        ccnl->pit_heavy = NULL;
+    }
+    ccnl_dump_forget(ccnl, f);
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking2\n");
     DBL_LINKED_LIST_REMOVE(ccnl->faces, f);
     DEBUGMSG_CORE(TRACE, "face_remove: unlinking3\n");
@@ -184,34 +195,83 @@ ccnl_face_remove(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
     return f2;
 }
 
+int
+ccnl_face_set_weight(struct ccnl_face_s *f, int weight)
+{
+    if (!f || weight < 1) {
+        return -1;
+    }
+    f->weight = weight;
+    return 0;
+}
+
+int
+ccnl_face_set_interest_rate(struct ccnl_face_s *f, int rate, int burst)
+{
+    if (!f || rate < 0 || burst < 1) {
+        return -1;
+    }
+    f->irate = rate;
+    f->iburst = burst;
+    f->itokens = (int64_t) burst * 1000000;
+    ccnl_get_timeval(&f->itokens_ts);
+    return 0;
+}
+
+int
+ccnl_face_admit_interest(struct ccnl_face_s *f)
+{
+    struct timeval now;
+    int64_t max;
+
+    if (!f->irate) {
+        return 1;
+    }
+    ccnl_get_timeval(&now);
+    max = (int64_t) f->iburst * 1000000;
+    f->itokens += (int64_t) timevaldelta(&now, &f->itokens_ts) * f->irate;
+    if (f->itokens > max) {
+        f->itokens = max;
+    }
+    f->itokens_ts = now;
+    if (f->itokens < 1000000) {
+        f->ilimit_cnt++;
+        return 0;
+    }
+    f->itokens -= 1000000;
+    return 1;
+}
+
 void
 ccnl_interface_enqueue(void (tx_done)(void*, int, int), struct ccnl_face_s *f,
                        struct ccnl_relay_s *ccnl, struct ccnl_if_s *ifc,
                        struct ccnl_buf_s *buf, sockunion *dest)
 {
     if (ifc) {
-        struct ccnl_txrequest_s *r;
-        
-        if (buf) { 
-            DEBUGMSG_CORE(TRACE, "enqueue interface=%p buf=%p len=%zu (qlen=%zu)\n",
-                  (void*)ifc, (void*)buf,
-                  buf ? buf->datalen : 0, ifc ? ifc->qlen : 0);
-        }
-
-        if (ifc->qlen >= CCNL_MAX_IF_QLEN) {
-            if (buf) {
-                DEBUGMSG_CORE(WARNING, "  DROPPING buf=%p\n", (void*)buf); 
-                ccnl_free(buf); 
-                return;
+        struct ccnl_txrequest_s r;
+
+        if (!buf) {
+            return;
+        }
+        DEBUGMSG_CORE(TRACE, "enqueue interface=%p buf=%p len=%zu (qlen=%zu)\n",
+                  (void*)ifc, (void*)buf, buf->datalen, ifc->qlen);
+
+        r.buf = buf;
+        memcpy(&r.dst, dest, sizeof(sockunion));
+        r.txdone = tx_done;
+        r.txdone_face = f;
+        r.prio = buf->flags & CCNL_BUF_FLAGS_PRIO;
+        if (ccnl_interface_sched_enqueue(ifc, &r)) {
+            DEBUGMSG_CORE(WARNING, "  DROPPING buf=%p\n", (void*)buf);
+#ifdef USE_STATS
+            ifc->drop_cnt++;
+#endif
+            ccnl_free(buf);
+            if (tx_done) {
+                tx_done(f, 1, -1);
             }
+            return;
         }
-        
-        r = ifc->queue + ((ifc->qfront + ifc->qlen) % CCNL_MAX_IF_QLEN); 
-        r->buf = buf;
-        memcpy(&r->dst, dest, sizeof(sockunion));
-        r->txdone = tx_done;
-        r->txdone_face = f;
-        ifc->qlen++;
 
 #ifdef USE_SCHEDULER
         ccnl_sched_RTS(ifc->sched, 1, buf->datalen, ccnl, ifc);
@@ -259,6 +319,11 @@ ccnl_face_CTS(struct ccnl_relay_s *ccnl, struct ccnl_face_s *f)
 
     if (!f->frag || f->frag->protocol == CCNL_FRAG_NONE) {
         buf = ccnl_face_dequeue(ccnl, f);
+#ifdef USE_LINKREL
+        if (buf && f->linkrel) {
+            buf = ccnl_linkrel_TX(ccnl, f, buf);
+        }
+#endif
         if (buf) {
             ccnl_interface_enqueue(ccnl_face_CTS_done, f,
                                    ccnl, ccnl->ifs + f->ifndx, buf, &f->peer);
@@ -289,6 +354,15 @@ int
 ccnl_send_pkt(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
                 struct ccnl_pkt_s *pkt)
 {
+#ifdef USE_SUITE_NDNTLV
+    // pass on a congestion mark received from upstream
+    if ((pkt->flags & CCNL_PKT_CONGESTED) && CCNL_SUITE_OF(pkt) == CCNL_SUITE_NDNTLV) {
+        struct ccnl_buf_s *marked = ccnl_ndntlv_mkCongestionMark(pkt->buf);
+        if (marked) {
+            return ccnl_face_enqueue(ccnl, to, marked);
+        }
+    }
+#endif
     return ccnl_face_enqueue(ccnl, to, buf_dup(pkt->buf));
 }
 
@@ -336,6 +410,56 @@ ccnl_face_enqueue(struct ccnl_relay_s *ccnl, struct ccnl_face_s *to,
 }
 
 
+static int
+ccnl_pit_full(struct ccnl_relay_s *ccnl, size_t size)
+{
+    return (ccnl->max_pit_entries >= 0 &&
+            ccnl->pitcnt >= ccnl->max_pit_entries) ||
+           (ccnl->max_pit_bytes &&
+            ccnl->pit_bytes + size > ccnl->max_pit_bytes);
+}
+
+int
+ccnl_pit_admit(struct ccnl_relay_s *ccnl, struct ccnl_face_s *from,
+               size_t size)
+{
+    struct ccnl_face_s *f, *heavy;
+    struct ccnl_interest_s *victim;
+
+    while (ccnl_pit_full(ccnl, size)) {
+        // The candidate is only replaced by a face that outgrows it, so it
+        // may lag behind the heaviest face, but it never is lighter than
+        // the requester when evicted from. Rescan the faces only once it
+        // has no entries left.
+        heavy = ccnl->pit_heavy;
+        if (!heavy || heavy->pitcnt <= 0) {
+            heavy = NULL;
+            for (f = ccnl->faces; f; f = f->next) {
+                if (f->pitcnt > 0 && (!heavy || f->pitcnt > heavy->pitcnt)) {
+                    heavy = f;
+                }
+            }
+            ccnl->pit_heavy = heavy;
+        }
+        if (!heavy || (from && from->pitcnt >= heavy->pitcnt)) {
+            DEBUGMSG_CORE(DEBUG, "  PIT overload, rejecting interest\n");
+            if (from) {
+                from->ioverload_cnt++;
+            }
+            return -1;
+        }
+        victim = heavy->pitend; // its oldest entry
+        if (!victim) {
+            return -1;
+        }
+        DEBUGMSG_CORE(DEBUG, "  PIT overload, evicting entry of face %d\n",
+                      heavy->faceid);
+        heavy->ioverload_cnt++;
+        ccnl_interest_remove(ccnl, victim);
+    }
+    return 0;
+}
+
 struct ccnl_interest_s*
 ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
 {
@@ -352,12 +476,24 @@ ccnl_interest_remove(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
     evtimer_del((evtimer_t *)(&ccnl_evtimer), (evtimer_event_t *)&i->evtmsg_timeout);
 #endif
 
-    while (i->pending) {
-        struct ccnl_pendint_s *tmp = i->pending->next;          \
-        ccnl_free(i->pending);
-        i->pending = tmp;
+    ccnl_pendset_clear(&i->pending);
+    if (i->from) {
+        i->from->pitcnt--;
+        if (i->fprev) {
+            i->fprev->fnext = i->fnext;
+        } else {
+            i->from->pit = i->fnext;
+        }
+        if (i->fnext) {
+            i->fnext->fprev = i->fprev;
+        } else {
+            i->from->pitend = i->fprev;
+        }
     }
+    ccnl->pitcnt--;
+    ccnl->pit_bytes -= i->size;
     i2 = i->next;
+    ccnl_dump_forget(ccnl, i);
     DBL_LINKED_LIST_REMOVE(ccnl->pit, i);
 
     if (i->pkt) {
@@ -396,7 +532,7 @@ ccnl_interest_propagate(struct ccnl_relay_s *ccnl, struct ccnl_interest_s *i)
         }
 
         //Only for matching suite
-        if (!i->pkt->pfx || fwd->suite != i->pkt->pfx->suite) {
+        if (!i->pkt->pfx || CCNL_SUITE_OF(fwd) != CCNL_SUITE_OF(i->pkt->pfx)) {
             DEBUGMSG_CORE(VERBOSE, "  not same suite (%d/%d)\n",
                      fwd->suite, i->pkt->pfx ? i->pkt->pfx->suite : -1);
             continue;
@@ -519,7 +655,9 @@ ccnl_content_remove(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     DEBUGMSG_CORE(TRACE, "ccnl_content_remove\n");
 
     c2 = c->next;
+    ccnl_dump_forget(ccnl, c);
     DBL_LINKED_LIST_REMOVE(ccnl->contents, c);
+    ccnl->csgen++;
 
 //    free_content(c);
     if (c->pkt) {
@@ -576,6 +714,7 @@ ccnl_content_add2cache(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
          (ccnl->contentcnt <= ccnl->max_cache_entries)) {
             DBL_LINKED_LIST_ADD(ccnl->contents, c);
             ccnl->contentcnt++;
+            ccnl->csgen++;
 #ifdef CCNL_RIOT
             /* set cache timeout timer if content is not static */
             if (!(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
@@ -601,11 +740,12 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
     }
     for (i = ccnl->pit; i;) {
         struct ccnl_pendint_s *pi;
+        size_t pos = 0;
         if (!i->pkt->pfx) {
             continue;
         }
 
-        switch (i->pkt->pfx->suite) {
+        switch (CCNL_SUITE_OF(i->pkt->pfx)) {
 #ifdef USE_SUITE_CCNB
         case CCNL_SUITE_CCNB:
             if (!ccnl_i_prefixof_c(i->pkt->pfx, i->pkt->s.ccnb.minsuffix,
@@ -641,7 +781,7 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
         }
 
         //Hook for add content to cache by callback:
-        if(i && ! i->pending){
+        if(i && ! i->pending.cnt){
             DEBUGMSG_CORE(WARNING, "releasing interest 0x%p OK?\n", (void*)i);
             c->flags |= CCNL_CONTENT_FLAGS_STATIC;
             i = ccnl_interest_remove(ccnl, i);
@@ -655,7 +795,7 @@ ccnl_content_serve_pending(struct ccnl_relay_s *ccnl, struct ccnl_content_s *c)
 
         // CONFORM: "Data MUST only be transmitted in response to
         // an Interest that matches the Data."
-        for (pi = i->pending; pi; pi = pi->next) {
+        while ((pi = ccnl_pendset_next(&i->pending, &pos)) != NULL) {
             if (pi->face->flags & CCNL_FACE_FLAGS_SERVED) {
                 continue;
             }
@@ -727,7 +867,7 @@ ccnl_do_ageing(void *ptr, void *dummy)
         }
         else {
 #ifdef USE_SUITE_NDNTLV
-            if (c->pkt->suite == CCNL_SUITE_NDNTLV) {
+            if (CCNL_SUITE_OF(c->pkt) == CCNL_SUITE_NDNTLV) {
                 // Mark content as stale if its freshness period expired and it is not static
                 if ((c->last_used + (c->pkt->s.ndntlv.freshnessperiod / 1000)) <= (uint32_t) t &&
                         !(c->flags & CCNL_CONTENT_FLAGS_STATIC)) {
@@ -806,7 +946,7 @@ ccnl_nonce_isDup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt)
         }
         return 0;
     }
-    switch (pkt->suite) {
+    switch (CCNL_SUITE_OF(pkt)) {
 #ifdef USE_SUITE_CCNB
     case CCNL_SUITE_CCNB:
         return pkt->s.ccnb.nonce &&
@@ -886,6 +1026,7 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
             ((pfx == NULL) || !ccnl_prefix_cmp(fwd->prefix, NULL, pfx, CMP_EXACT)) &&
             ((face == NULL) || (fwd->face == face))) {
             res = 0;
+            ccnl_dump_forget(relay, fwd);
             if (!last) {
                 relay->fib = fwd->next;
             }
@@ -906,6 +1047,210 @@ ccnl_fib_rem_entry(struct ccnl_relay_s *relay, struct ccnl_prefix_s *pfx,
 
     return res;
 }
+
+// routes for the same (suite, prefix) hash equally
+static uint32_t
+ccnl_fib_routeHash(struct ccnl_forward_s *fwd)
+{
+    uint32_t h = ccnl_prefix_hashOf(fwd->prefix, fwd->prefix->compcnt);
+
+    return h ^ (uint32_t) (unsigned char) fwd->suite;
+}
+
+// puts a route into an open addressing index, returns the route for the
+// same suite and prefix if there is one already (and leaves the index)
+static struct ccnl_forward_s*
+ccnl_fib_routeIndex(struct ccnl_forward_s **index, size_t mask,
+                    struct ccnl_forward_s *fwd)
+{
+    size_t i;
+
+    for (i = ccnl_fib_routeHash(fwd) & mask; index[i]; i = (i + 1) & mask) {
+        if (index[i]->suite == fwd->suite &&
+            !ccnl_prefix_cmp(index[i]->prefix, NULL, fwd->prefix, CMP_EXACT)) {
+            return index[i];
+        }
+    }
+    index[i] = fwd;
+    return NULL;
+}
+
+int
+ccnl_fib_add_batch(struct ccnl_relay_s *relay, struct ccnl_forward_s *routes)
+{
+    struct ccnl_forward_s **index, **tail, *fwd, *old, *next;
+    size_t cnt = 0, size = 16;
+    int added = 0;
+
+    for (tail = &relay->fib; *tail; tail = &(*tail)->next) {
+        cnt++;
+    }
+    for (fwd = routes; fwd; fwd = fwd->next) {
+        cnt++;
+    }
+    while (size < 2 * cnt) {
+        size *= 2;
+    }
+    index = (struct ccnl_forward_s**) ccnl_calloc(size, sizeof(*index));
+    if (!index) {
+        return -1;
+    }
+    for (fwd = relay->fib; fwd; fwd = fwd->next) {
+        if (fwd->prefix) {
+            ccnl_fib_routeIndex(index, size - 1, fwd);
+        }
+    }
+    for (fwd = routes; fwd; fwd = next) {
+        next = fwd->next;
+        fwd->next = NULL;
+        old = ccnl_fib_routeIndex(index, size - 1, fwd);
+        if (old) { // as ccnl_fib_add_entry(): the last face wins
+            old->face = fwd->face;
+            ccnl_prefix_free(fwd->prefix);
+            ccnl_free(fwd);
+            continue;
+        }
+        *tail = fwd;
+        tail = &fwd->next;
+        added++;
+    }
+    ccnl_free(index);
+    DEBUGMSG_CUTL(INFO, "added %d FIB entries in one batch\n", added);
+
+    return added;
+}
+
+// the face of a route: a face id, or the address of a UDP peer
+static struct ccnl_face_s*
+ccnl_fib_routeFace(struct ccnl_relay_s *relay, char *s)
+{
+    struct ccnl_face_s *f = NULL;
+    char *end;
+
+    if (isdigit((unsigned char) *s) && !strchr(s, '/')) {
+        long id;
+
+        errno = 0;
+        id = strtol(s, &end, 10);
+        if (errno || *end || id > INT_MAX) {
+            return NULL;
+        }
+        for (f = relay->faces; f && f->faceid != (int) id; f = f->next);
+        return f;
+    }
+#ifndef CCNL_LINUXKERNEL
+    {
+        sockunion su;
+        size_t addrlen = 0;
+        unsigned long port;
+        int i;
+        char *cp = strrchr(s, '/');
+
+        if (!cp || !cp[1]) {
+            return NULL;
+        }
+        *cp++ = '\0';
+        errno = 0;
+        port = strtoul(cp, &end, 10);
+        if (errno || *end || port > UINT16_MAX) {
+            return NULL;
+        }
+        memset(&su, 0, sizeof(su));
+#ifdef USE_IPV4
+        if (inet_pton(AF_INET, s, &su.ip4.sin_addr) == 1) {
+            su.ip4.sin_family = AF_INET;
+            su.ip4.sin_port = htons((uint16_t) port);
+            addrlen = sizeof(su.ip4);
+        }
+#endif
+#ifdef USE_IPV6
+        if (!addrlen && inet_pton(AF_INET6, s, &su.ip6.sin6_addr) == 1) {
+            su.ip6.sin6_family = AF_INET6;
+            su.ip6.sin6_port = htons((uint16_t) port);
+            addrlen = sizeof(su.ip6);
+        }
+#endif
+        // with the interface given, an existing face is found, not added
+        for (i = 0; addrlen && i < relay->ifcount; i++) {
+            if (relay->ifs[i].addr.sa.sa_family == su.sa.sa_family) {
+                f = ccnl_get_face_or_create(relay, i, &su.sa, addrlen);
+                break;
+            }
+        }
+        if (f) {
+            f->flags |= CCNL_FACE_FLAGS_STATIC;
+        }
+    }
+#endif // CCNL_LINUXKERNEL
+    return f;
+}
+
+int
+ccnl_fib_add_routes(struct ccnl_relay_s *relay, int suite, char *routes,
+                    int *lineno)
+{
+    struct ccnl_forward_s *list = NULL, **tail = &list, *fwd;
+    char *line, *next, *uri, *face, *cp;
+    int rc;
+
+    *lineno = 0;
+    for (line = routes; line; line = next) {
+        next = strchr(line, '\n');
+        if (next) {
+            *next++ = '\0';
+        }
+        (*lineno)++;
+        cp = strchr(line, '#');
+        if (cp) {
+            *cp = '\0';
+        }
+        uri = line + strspn(line, " \t\r");
+        if (!*uri) {
+            continue;
+        }
+        cp = uri + strcspn(uri, " \t\r");
+        face = cp + strspn(cp, " \t\r");
+        *cp = '\0';
+        cp = face + strcspn(face, " \t\r");
+        if (*uri != '/' || !*face || cp[strspn(cp, " \t\r")]) {
+            goto Bail;
+        }
+        *cp = '\0';
+
+        fwd = (struct ccnl_forward_s *) ccnl_calloc(1, sizeof(*fwd));
+        if (!fwd) {
+            goto NoMem;
+        }
+        *tail = fwd;
+        tail = &fwd->next;
+        fwd->suite = (char) suite;
+        fwd->face = ccnl_fib_routeFace(relay, face);
+        if (!fwd->face) {
+            DEBUGMSG_CUTL(WARNING, "routes: no face %s\n", face);
+            goto Bail;
+        }
+        fwd->prefix = ccnl_URItoPrefix(uri, suite, NULL);
+        if (!fwd->prefix) {
+            goto NoMem;
+        }
+    }
+
+    rc = ccnl_fib_add_batch(relay, list);
+    if (rc >= 0) {
+        return rc;
+    }
+NoMem:
+    *lineno = 0;
+Bail:
+    while ((fwd = list)) {
+        list = fwd->next;
+        if (fwd->prefix) {
+            ccnl_prefix_free(fwd->prefix);
+        }
+        ccnl_free(fwd);
+    }
+    return -1;
+}
 #endif
 
 /* prints the current FIB */
@@ -964,23 +1309,32 @@ ccnl_interface_CTS(void *aux1, void *aux2)
 {
     struct ccnl_relay_s *ccnl = (struct ccnl_relay_s *)aux1;
     struct ccnl_if_s *ifc = (struct ccnl_if_s *)aux2;
-    struct ccnl_txrequest_s *r, req;
+    struct ccnl_txrequest_s req;
 
     DEBUGMSG_CORE(TRACE, "interface_CTS interface=%p, qlen=%zu, sched=%p\n",
              (void*)ifc, ifc->qlen, (void*)ifc->sched);
 
-    if (ifc->qlen <= 0) {
+    if (ccnl_interface_sched_dequeue(ifc, &req)) {
         return;
     }
+#ifdef USE_SUITE_NDNTLV
+    if (ccnl_interface_congested(ifc, &req)) {
+        struct ccnl_buf_s *marked = ccnl_ndntlv_mkCongestionMark(req.buf);
+        if (marked) {
+            DEBUGMSG_CORE(DEBUG, "interface_CTS: congestion mark\n");
+            ccnl_free(req.buf);
+            req.buf = marked;
+#ifdef USE_STATS
+            ifc->mark_cnt++;
+#endif
+        }
+    }
+#endif
 
 #ifdef USE_STATS
     ifc->tx_cnt++;
 #endif
 
-    r = ifc->queue + ifc->qfront;
-    memcpy(&req, r, sizeof(req));
-    ifc->qfront = (ifc->qfront + 1) % CCNL_MAX_IF_QLEN;
-    ifc->qlen--;
 #ifndef CCNL_LINUXKERNEL
     assert(ccnl->ccnl_ll_TX_ptr != 0);
 #endif
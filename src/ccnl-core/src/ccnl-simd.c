@@ -0,0 +1,253 @@
+/*
+ * @f ccnl-simd.c
+ * @b CCN lite, vectorized kernels for name components
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#ifndef CCNL_LINUXKERNEL
+#include "ccnl-simd.h"
+#include <string.h>
+#else
+#include <ccnl-simd.h>
+#endif
+
+#ifdef CCNL_SIMD_X86
+#include <immintrin.h>
+#endif
+
+#define CCNL_CRC32C_POLY        0x82F63B78u     // reflected Castagnoli
+
+typedef int (*ccnl_memeq_func)(const uint8_t*, const uint8_t*, size_t);
+typedef uint32_t (*ccnl_crc32c_func)(uint32_t, const uint8_t*, size_t);
+
+static int ccnl_simd_level = -1;
+static ccnl_memeq_func ccnl_simd_memeq_impl;
+static ccnl_crc32c_func ccnl_simd_crc32c_impl;
+static uint32_t ccnl_crc32c_tab[256];
+
+// ----------------------------------------------------------------------
+// scalar kernels, word at a time
+
+static uint64_t
+ccnl_load64(const uint8_t *p)
+{
+    uint64_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+static uint32_t
+ccnl_load32(const uint8_t *p)
+{
+    uint32_t v;
+
+    memcpy(&v, p, sizeof(v));
+    return v;
+}
+
+// ranges shorter than 16 bytes: two overlapping loads cover them
+static int
+ccnl_memeq_short(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    if (len >= 8) {
+        return ccnl_load64(a) == ccnl_load64(b) &&
+               ccnl_load64(a + len - 8) == ccnl_load64(b + len - 8);
+    }
+    if (len >= 4) {
+        return ccnl_load32(a) == ccnl_load32(b) &&
+               ccnl_load32(a + len - 4) == ccnl_load32(b + len - 4);
+    }
+    while (len--) {
+        if (*a++ != *b++) {
+            return 0;
+        }
+    }
+    return 1;
+}
+
+static int
+ccnl_memeq_scalar(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    for (; len >= 16; a += 16, b += 16, len -= 16) {
+        if ((ccnl_load64(a) ^ ccnl_load64(b)) |
+            (ccnl_load64(a + 8) ^ ccnl_load64(b + 8))) {
+            return 0;
+        }
+    }
+    return ccnl_memeq_short(a, b, len);
+}
+
+static uint32_t
+ccnl_crc32c_scalar(uint32_t crc, const uint8_t *data, size_t len)
+{
+    while (len--) {
+        crc = ccnl_crc32c_tab[(crc ^ *data++) & 0xff] ^ (crc >> 8);
+    }
+    return crc;
+}
+
+// ----------------------------------------------------------------------
+// x86 kernels, compiled for their target and only called if supported
+
+#ifdef CCNL_SIMD_X86
+
+__attribute__((target("sse4.2")))
+static int
+ccnl_memeq_sse42(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    for (; len >= 16; a += 16, b += 16, len -= 16) {
+        __m128i x = _mm_loadu_si128((const __m128i*) a);
+        __m128i y = _mm_loadu_si128((const __m128i*) b);
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(x, y)) != 0xffff) {
+            return 0;
+        }
+    }
+    return ccnl_memeq_short(a, b, len);
+}
+
+__attribute__((target("sse4.2")))
+static uint32_t
+ccnl_crc32c_sse42(uint32_t crc, const uint8_t *data, size_t len)
+{
+    uint64_t c = crc;
+
+    for (; len >= 8; data += 8, len -= 8) {
+        c = _mm_crc32_u64(c, ccnl_load64(data));
+    }
+    crc = (uint32_t) c;
+    while (len--) {
+        crc = _mm_crc32_u8(crc, *data++);
+    }
+    return crc;
+}
+
+__attribute__((target("avx2")))
+static int
+ccnl_memeq_avx2(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    for (; len >= 32; a += 32, b += 32, len -= 32) {
+        __m256i x = _mm256_loadu_si256((const __m256i*) a);
+        __m256i y = _mm256_loadu_si256((const __m256i*) b);
+        if ((uint32_t) _mm256_movemask_epi8(_mm256_cmpeq_epi8(x, y)) !=
+            0xffffffffu) {
+            return 0;
+        }
+    }
+    return ccnl_memeq_sse42(a, b, len);
+}
+
+static int
+ccnl_simd_supported(void)
+{
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("sse4.2")) {
+        return CCNL_SIMD_AVX2;
+    }
+    if (__builtin_cpu_supports("sse4.2")) {
+        return CCNL_SIMD_SSE42;
+    }
+    return CCNL_SIMD_SCALAR;
+}
+
+#else
+
+static int
+ccnl_simd_supported(void)
+{
+    return CCNL_SIMD_SCALAR;
+}
+
+#endif // CCNL_SIMD_X86
+
+// ----------------------------------------------------------------------
+
+int
+ccnl_simd_setLevel(int level)
+{
+    int best = ccnl_simd_supported();
+    uint32_t i, j, c;
+
+    if (!ccnl_crc32c_tab[1]) {
+        for (i = 0; i < 256; i++) {
+            for (c = i, j = 0; j < 8; j++) {
+                c = (c & 1) ? (c >> 1) ^ CCNL_CRC32C_POLY : c >> 1;
+            }
+            ccnl_crc32c_tab[i] = c;
+        }
+    }
+    if (level < 0 || level > best) {
+        level = best;
+    }
+
+    ccnl_simd_memeq_impl = ccnl_memeq_scalar;
+    ccnl_simd_crc32c_impl = ccnl_crc32c_scalar;
+#ifdef CCNL_SIMD_X86
+    if (level >= CCNL_SIMD_SSE42) {
+        ccnl_simd_memeq_impl = ccnl_memeq_sse42;
+        ccnl_simd_crc32c_impl = ccnl_crc32c_sse42;
+    }
+    if (level >= CCNL_SIMD_AVX2) {
+        ccnl_simd_memeq_impl = ccnl_memeq_avx2;
+    }
+#endif
+    ccnl_simd_level = level;
+
+    return level;
+}
+
+const char*
+ccnl_simd_name(void)
+{
+    if (ccnl_simd_level < 0) {
+        ccnl_simd_setLevel(-1);
+    }
+    switch (ccnl_simd_level) {
+    case CCNL_SIMD_AVX2:
+        return "avx2";
+    case CCNL_SIMD_SSE42:
+        return "sse4.2";
+    default:
+        return "scalar";
+    }
+}
+
+int
+ccnl_simd_memeq(const uint8_t *a, const uint8_t *b, size_t len)
+{
+    // name components are mostly short: no call through the pointer
+    if (len < 16) {
+        return ccnl_memeq_short(a, b, len);
+    }
+    if (ccnl_simd_level < 0) {
+        ccnl_simd_setLevel(-1);
+    }
+    return ccnl_simd_memeq_impl(a, b, len);
+}
+
+uint32_t
+ccnl_simd_crc32c(uint32_t crc, const uint8_t *data, size_t len)
+{
+    if (ccnl_simd_level < 0) {
+        ccnl_simd_setLevel(-1);
+    }
+    return ccnl_simd_crc32c_impl(crc, data, len);
+}
+
+// eof
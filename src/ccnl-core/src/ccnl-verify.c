@@ -0,0 +1,378 @@
+/*
+ * @f ccnl-verify.c
+ * @b CCN lite, asynchronous batched signature verification
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#ifdef USE_VERIFY_POOL
+
+#include "ccnl-verify.h"
+#include "ccnl-core.h"
+
+#include <string.h>
+#include <unistd.h>
+#include <fcntl.h>
+
+#define CCNL_VERIFY_BATCH_MAX   64
+
+// ----------------------------------------------------------------------
+// cache of verified (key, digest) pairs, the caller holds v->lock
+
+static struct ccnl_verify_cache_s*
+ccnl_verify_slot(struct ccnl_verify_s *v, const uint8_t *digest)
+{
+    uint32_t h;
+
+    memcpy(&h, digest, sizeof(h)); // a SHA-256 value: any bits will do
+    return v->cache + (h & (CCNL_VERIFY_CACHE_SIZE - 1));
+}
+
+static int
+ccnl_verify_cached(struct ccnl_verify_s *v, const uint8_t *digest)
+{
+    struct ccnl_verify_cache_s *e = ccnl_verify_slot(v, digest);
+
+    return e->valid && !memcmp(e->digest, digest, sizeof(e->digest)) &&
+           !memcmp(e->keyid, v->keyid, sizeof(e->keyid));
+}
+
+static void
+ccnl_verify_remember(struct ccnl_verify_s *v, const uint8_t *digest)
+{
+    struct ccnl_verify_cache_s *e = ccnl_verify_slot(v, digest);
+
+    memcpy(e->keyid, v->keyid, sizeof(e->keyid));
+    memcpy(e->digest, digest, sizeof(e->digest));
+    e->valid = true;
+}
+
+// ----------------------------------------------------------------------
+
+// sets the result of n jobs, asking the verifier only about cache misses
+static void
+ccnl_verify_run(struct ccnl_verify_s *v, size_t n,
+                struct ccnl_verify_job_s *jobs[])
+{
+    struct ccnl_verify_job_s *miss[CCNL_VERIFY_BATCH_MAX];
+    uint8_t *md[CCNL_VERIFY_BATCH_MAX];
+    size_t i, m = 0;
+
+    // hashing the packets is the part the workers share with the cache
+    for (i = 0; i < n; i++) {
+        md[i] = ccnl_content_digest(jobs[i]->c);
+    }
+    pthread_mutex_lock(&v->lock);
+    for (i = 0; i < n; i++) {
+        if (md[i] && ccnl_verify_cached(v, md[i])) {
+            jobs[i]->result = 1;
+            v->hit_cnt++;
+        } else {
+            jobs[i]->result = 0;
+            miss[m++] = jobs[i];
+        }
+    }
+    pthread_mutex_unlock(&v->lock);
+
+    if (!m) {
+        return;
+    }
+    v->verify(v->ctx, m, miss);
+
+    pthread_mutex_lock(&v->lock);
+    for (i = 0; i < n; i++) {
+        if (md[i] && jobs[i]->result == 1) {
+            ccnl_verify_remember(v, md[i]);
+        }
+    }
+    pthread_mutex_unlock(&v->lock);
+}
+
+static void*
+ccnl_verify_worker(void *arg)
+{
+    struct ccnl_verify_s *v = (struct ccnl_verify_s*) arg;
+    struct ccnl_verify_job_s *jobs[CCNL_VERIFY_BATCH_MAX];
+    size_t n, i;
+
+    for (;;) {
+        pthread_mutex_lock(&v->lock);
+        while (!v->queue && !v->stop) {
+            pthread_cond_wait(&v->cond, &v->lock);
+        }
+        if (v->stop) {
+            pthread_mutex_unlock(&v->lock);
+            break;
+        }
+        for (n = 0; n < v->batch && v->queue; n++) {
+            jobs[n] = v->queue;
+            v->queue = v->queue->next;
+        }
+        if (!v->queue) {
+            v->queue_tail = NULL;
+        }
+        pthread_mutex_unlock(&v->lock);
+
+        ccnl_verify_run(v, n, jobs);
+
+        pthread_mutex_lock(&v->lock);
+        if (!v->done_list && write(v->wakefd[1], "", 1) < 0) {
+            // the pipe is full, so the relay wakes up anyway
+        }
+        for (i = 0; i < n; i++) {
+            jobs[i]->next = v->done_list;
+            v->done_list = jobs[i];
+        }
+        pthread_mutex_unlock(&v->lock);
+    }
+
+    return NULL;
+}
+
+struct ccnl_verify_s*
+ccnl_verify_new(int nthreads, size_t batch, ccnl_verify_func verify,
+                void *ctx, const uint8_t *keyid, ccnl_verify_done_func done)
+{
+    struct ccnl_verify_s *v;
+    int i;
+
+    if (!verify || !done || nthreads < 0) {
+        return NULL;
+    }
+    v = (struct ccnl_verify_s*) ccnl_calloc(1, sizeof(*v));
+    if (!v) {
+        return NULL;
+    }
+    v->verify = verify;
+    v->ctx = ctx;
+    v->done = done;
+    if (keyid) {
+        memcpy(v->keyid, keyid, sizeof(v->keyid));
+    }
+    v->batch = batch < 1 ? 1 : batch > CCNL_VERIFY_BATCH_MAX ?
+                               CCNL_VERIFY_BATCH_MAX : batch;
+    v->wakefd[0] = v->wakefd[1] = -1;
+    pthread_mutex_init(&v->lock, NULL);
+    pthread_cond_init(&v->cond, NULL);
+
+    if (!nthreads) {
+        return v;
+    }
+    if (pipe(v->wakefd) < 0) {
+        DEBUGMSG_CORE(ERROR, "verify: could not create the wakeup pipe\n");
+        ccnl_verify_free(v);
+        return NULL;
+    }
+    fcntl(v->wakefd[0], F_SETFL, O_NONBLOCK);
+    fcntl(v->wakefd[1], F_SETFL, O_NONBLOCK);
+
+    if (nthreads > CCNL_VERIFY_MAX_THREADS) {
+        nthreads = CCNL_VERIFY_MAX_THREADS;
+    }
+    for (i = 0; i < nthreads; i++) {
+        if (pthread_create(v->threads + i, NULL, ccnl_verify_worker, v)) {
+            DEBUGMSG_CORE(ERROR, "verify: could not start worker %d\n", i);
+            break;
+        }
+        v->nthreads++;
+    }
+    if (!v->nthreads) {
+        ccnl_verify_free(v);
+        return NULL;
+    }
+    DEBUGMSG_CORE(INFO, "verify: %d workers, batches of %zu\n",
+                  v->nthreads, v->batch);
+
+    return v;
+}
+
+static void
+ccnl_verify_freeJobs(struct ccnl_verify_job_s *job)
+{
+    struct ccnl_verify_job_s *next;
+
+    for (; job; job = next) {
+        next = job->next;
+        ccnl_content_free(job->c);
+        ccnl_free(job);
+    }
+}
+
+void
+ccnl_verify_free(struct ccnl_verify_s *v)
+{
+    int i;
+
+    if (!v) {
+        return;
+    }
+    pthread_mutex_lock(&v->lock);
+    v->stop = true;
+    pthread_cond_broadcast(&v->cond);
+    pthread_mutex_unlock(&v->lock);
+    for (i = 0; i < v->nthreads; i++) {
+        pthread_join(v->threads[i], NULL);
+    }
+
+    ccnl_verify_freeJobs(v->queue);
+    ccnl_verify_freeJobs(v->done_list);
+    for (i = 0; i < 2; i++) {
+        if (v->wakefd[i] >= 0) {
+            close(v->wakefd[i]);
+        }
+    }
+    pthread_cond_destroy(&v->cond);
+    pthread_mutex_destroy(&v->lock);
+    ccnl_free(v);
+}
+
+int
+ccnl_verify_submitJob(struct ccnl_verify_s *v, struct ccnl_content_s *c,
+                      int faceid, const uint8_t *data, size_t datalen,
+                      const uint8_t *sig, size_t siglen)
+{
+    struct ccnl_verify_job_s *job, tmp;
+    int hit = 0;
+
+    v->submit_cnt++;
+    if (c->has_digest) { // hashed before, e.g. for a full name lookup
+        pthread_mutex_lock(&v->lock);
+        hit = ccnl_verify_cached(v, c->digest);
+        if (hit) {
+            v->hit_cnt++;
+        }
+        pthread_mutex_unlock(&v->lock);
+        if (hit) {
+            return 0;
+        }
+    }
+
+    if (!v->nthreads) {
+        memset(&tmp, 0, sizeof(tmp));
+        job = &tmp;
+    } else {
+        if (v->pending >= CCNL_VERIFY_MAX_PENDING) {
+            v->drop_cnt++;
+            return -1;
+        }
+        job = (struct ccnl_verify_job_s*) ccnl_calloc(1, sizeof(*job));
+        if (!job) {
+            return -1;
+        }
+    }
+    job->c = c;
+    job->faceid = faceid;
+    job->data = data;
+    job->datalen = datalen;
+    job->sig = sig;
+    job->siglen = siglen;
+
+    if (!v->nthreads) {
+        ccnl_verify_run(v, 1, &job);
+        if (job->result != 1) {
+            v->fail_cnt++;
+            return -1;
+        }
+        return 0;
+    }
+
+    pthread_mutex_lock(&v->lock);
+    if (v->queue_tail) {
+        v->queue_tail->next = job;
+    } else {
+        v->queue = job;
+    }
+    v->queue_tail = job;
+    pthread_cond_signal(&v->cond);
+    pthread_mutex_unlock(&v->lock);
+    v->pending++;
+
+    return 1;
+}
+
+int
+ccnl_verify_submit(struct ccnl_verify_s *v, struct ccnl_content_s *c,
+                   int faceid)
+{
+#ifdef USE_HMAC256
+    struct ccnl_pkt_s *pkt = c->pkt;
+
+    if (pkt->hmacLen && pkt->hmacSignature) {
+        return ccnl_verify_submitJob(v, c, faceid, pkt->hmacStart,
+                                     pkt->hmacLen, pkt->hmacSignature, 32);
+    }
+#else
+    (void) c;
+    (void) faceid;
+#endif
+    if (v->accept_unsigned) {
+        return 0;
+    }
+    v->unsigned_cnt++;
+    return -1;
+}
+
+int
+ccnl_verify_poll(struct ccnl_relay_s *relay)
+{
+    struct ccnl_verify_s *v = relay->verify;
+    struct ccnl_verify_job_s *list, *job, *fifo = NULL;
+    char drain[64];
+    int cnt = 0;
+
+    if (!v || !v->nthreads) {
+        return 0;
+    }
+    pthread_mutex_lock(&v->lock);
+    list = v->done_list;
+    v->done_list = NULL;
+    while (read(v->wakefd[0], drain, sizeof(drain)) > 0) {
+        ;
+    }
+    pthread_mutex_unlock(&v->lock);
+
+    while (list) { // restore the order of arrival
+        job = list;
+        list = job->next;
+        job->next = fifo;
+        fifo = job;
+    }
+    while (fifo) {
+        job = fifo;
+        fifo = job->next;
+        v->pending--;
+        if (job->result != 1) {
+            v->fail_cnt++;
+        }
+        v->done(relay, job->c, job->faceid, job->result == 1);
+        ccnl_free(job);
+        cnt++;
+    }
+
+    return cnt;
+}
+
+int
+ccnl_verify_fd(struct ccnl_verify_s *v)
+{
+    return v ? v->wakefd[0] : -1;
+}
+
+#endif // USE_VERIFY_POOL
+
+// eof
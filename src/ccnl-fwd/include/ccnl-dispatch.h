@@ -29,6 +29,9 @@
 
 /**
  * @brief       Initialize the dispatcher for handling different packet forwarders
+ *
+ * Also selects the name kernels of ccnl-simd, so call it before starting
+ * threads.
  */
 void
 ccnl_core_init(void);
@@ -48,5 +51,35 @@ void
 ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
              size_t datalen, struct sockaddr *sa, size_t addrlen);
 
+#ifndef CCNL_RX_BATCH
+# define CCNL_RX_BATCH  32      /**< frames processed as one vector */
+#endif
+
+/**
+ * @brief One received frame of a batch
+ */
+struct ccnl_rx_s {
+    int ifndx;                  /**< index of the receiving interface */
+    uint8_t *data;              /**< the frame, valid until processed */
+    size_t datalen;             /**< length of the frame */
+    sockunion src;              /**< address of the sender */
+    size_t addrlen;             /**< length of \p src, 0: local client */
+};
+
+/**
+ * @brief       Processing of a vector of received frames
+ *
+ * Same result as calling ccnl_core_RX() for each frame in order, but in
+ * stages over up to CCNL_RX_BATCH frames: NDN Interests are parsed
+ * first, then looked up in the Content Store with a single walk, then
+ * forwarded. Other frames take the ccnl_core_RX() path in their turn.
+ *
+ * @param[in] relay     pointer to current ccnl relay
+ * @param[in] rx        the frames
+ * @param[in] n         number of frames
+ */
+void
+ccnl_core_RXbatch(struct ccnl_relay_s *relay, struct ccnl_rx_s *rx, size_t n);
+
 #endif
 /** @} */
@@ -124,6 +124,52 @@ int
 ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                         struct ccnl_pkt_s **pkt, cMatchFct cMatch);
 
+/**
+ * @brief Result of a Content Store lookup done ahead of the forwarding
+ *        decision, e.g. for a whole batch of Interests
+ */
+struct ccnl_cs_hint_s {
+    uint32_t csgen;             /**< relay->csgen when the lookup was done */
+    struct ccnl_content_s *c;   /**< first matching content, NULL: none */
+};
+
+/**
+ * @brief Handle an incoming Interest Message with a Content Store hint
+ *
+ * Like ccnl_fwd_handleInterest(), but takes the Content Store result from
+ * \p hint while the Content Store is unchanged since the lookup.
+ *
+ * @param[in] relay   pointer to current ccnl relay
+ * @param[in] from    face on which the interest was received
+ * @param[in] pkt     packet which was received
+ * @param[in] cMatch  matching strategy for the Content Store
+ * @param[in] hint    Content Store lookup done before, may be NULL
+ *
+ * @return   0 on success
+ * @return   < 0 on failure
+*/
+int
+ccnl_fwd_handleInterestHint(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                            struct ccnl_pkt_s **pkt, cMatchFct cMatch,
+                            const struct ccnl_cs_hint_s *hint);
+
+/**
+ * @brief Looks up the Content Store for a batch of Interests
+ *
+ * Walks the Content Store once for all Interests instead of once per
+ * Interest, so each entry is brought into the cache once per batch.
+ *
+ * @param[in] relay   pointer to current ccnl relay
+ * @param[in] n       number of packets
+ * @param[in] pkts    the Interests, NULL entries are skipped
+ * @param[in] cMatch  matching strategy for the Content Store
+ * @param[out] hints  the first matching content of each Interest
+*/
+void
+ccnl_fwd_csLookupBatch(struct ccnl_relay_s *relay, size_t n,
+                       struct ccnl_pkt_s *pkts[], cMatchFct cMatch,
+                       struct ccnl_cs_hint_s hints[]);
+
 
 /**
  * @brief Handle and incomming Content Message
@@ -139,6 +185,34 @@ int
 ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                        struct ccnl_pkt_s **pkt);
 
+/**
+ * @brief Serves pending Interests with a received content object and
+ *        caches it
+ *
+ * @param[in] relay   pointer to current ccnl relay
+ * @param[in] from    face on which the content was received, may be NULL
+ * @param[in] c       the content object (consumed)
+*/
+void
+ccnl_fwd_serveContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                      struct ccnl_content_s *c);
+
+#ifdef USE_VERIFY_POOL
+/**
+ * @brief Continues with a content object held for signature verification
+ *
+ * To be passed as the continuation to ccnl_verify_new().
+ *
+ * @param[in] relay    pointer to current ccnl relay
+ * @param[in] c        the content object (consumed)
+ * @param[in] faceid   id of the face the content was received on
+ * @param[in] verified 1 if the signature is valid
+*/
+void
+ccnl_fwd_contentVerified(struct ccnl_relay_s *relay, struct ccnl_content_s *c,
+                         int faceid, int verified);
+#endif
+
 #endif
 
 /** @} */
@@ -27,6 +27,7 @@
 
 #include "ccnl-relay.h"
 #include "ccnl-pkt-util.h"
+#include "ccnl-simd.h"
 
 #include "ccnl-fwd.h"
 
@@ -40,6 +41,12 @@
 
 struct ccnl_suite_s ccnl_core_suites[CCNL_SUITE_LAST];
 
+#if defined(CCNL_SUITE_FIXED_NDNTLV)
+# define CCNL_SUITE_FIXED_RX    ccnl_ndntlv_forwarder
+#elif defined(CCNL_SUITE_FIXED_CCNTLV)
+# define CCNL_SUITE_FIXED_RX    ccnl_ccntlv_forwarder
+#endif
+
 void
 ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
              size_t datalen, struct sockaddr *sa, size_t addrlen)
@@ -86,7 +93,16 @@ ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
             return;
         }
 
+#ifdef CCNL_SUITE_FIXED_RX
+        if (suite != CCNL_SUITE_FIXED) {
+            DEBUGMSG_CORE(WARNING, "ccnl_core_RX: suite %s is not served by "
+                          "this build\n", ccnl_suite2str(suite));
+            return;
+        }
+        dispatch = CCNL_SUITE_FIXED_RX; // folds into a direct call
+#else
         dispatch = ccnl_core_suites[suite].RX;
+#endif
         if (!dispatch) {
             DEBUGMSG_CORE(ERROR, "Forwarder not initialized or dispatcher "
                      "for suite %s does not exist.\n", ccnl_suite2str(suite));
@@ -101,11 +117,93 @@ ccnl_core_RX(struct ccnl_relay_s *relay, int ifndx, uint8_t *data,
     }
 }
 
+#ifdef USE_SUITE_NDNTLV
+// a frame holding exactly one NDN Interest, parsed in place; NULL for
+// anything else, which takes the ccnl_core_RX() path
+static struct ccnl_pkt_s*
+ccnl_core_RXinterest(uint8_t *data, size_t datalen)
+{
+    uint8_t *start = data;
+    struct ccnl_pkt_s *pkt;
+    uint64_t typ;
+    size_t len, skip;
+
+    if (ccnl_pkt2suite(data, datalen, &skip) != CCNL_SUITE_NDNTLV || skip) {
+        return NULL;
+    }
+    if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) ||
+        typ != NDN_TLV_Interest || len != datalen) {
+        return NULL;
+    }
+    pkt = ccnl_ndntlv_bytes2pktView(typ, start, &data, &datalen);
+    if (pkt) {
+        pkt->type = typ;
+    }
+    return pkt;
+}
+#endif
+
+void
+ccnl_core_RXbatch(struct ccnl_relay_s *relay, struct ccnl_rx_s *rx, size_t n)
+{
+#ifdef USE_SUITE_NDNTLV
+    struct ccnl_pkt_s *pkts[CCNL_RX_BATCH];
+    struct ccnl_cs_hint_s hints[CCNL_RX_BATCH];
+    struct ccnl_face_s *from;
+    size_t i, cnt;
+
+    for (; n > 0; rx += cnt, n -= cnt) {
+        cnt = n < CCNL_RX_BATCH ? n : CCNL_RX_BATCH;
+
+        // decode: the names get their component hashes while parsed
+        for (i = 0; i < cnt; i++) {
+            pkts[i] = ccnl_core_RXinterest(rx[i].data, rx[i].datalen);
+        }
+        // one CS walk for all Interests of the vector
+        ccnl_fwd_csLookupBatch(relay, cnt, pkts, ccnl_ndntlv_cMatch, hints);
+
+        // forward in the order of arrival, a hint is dropped as soon as
+        // an earlier packet changed the CS
+        for (i = 0; i < cnt; i++) {
+            struct sockaddr *sa = rx[i].addrlen ? &rx[i].src.sa : NULL;
+
+            if (i + 1 < cnt) {
+                CCNL_PREFETCH(pkts[i + 1]);
+            }
+            if (!pkts[i]) {
+                ccnl_core_RX(relay, rx[i].ifndx, rx[i].data, rx[i].datalen,
+                             sa, rx[i].addrlen);
+                continue;
+            }
+#ifdef USE_STATS
+            if (rx[i].ifndx >= 0) {
+                relay->ifs[rx[i].ifndx].rx_cnt++;
+            }
+#endif
+            from = ccnl_get_face_or_create(relay, rx[i].ifndx, sa,
+                                           rx[i].addrlen);
+            if (from) {
+                ccnl_fwd_handleInterestHint(relay, from, pkts + i,
+                                            ccnl_ndntlv_cMatch, hints + i);
+            }
+            ccnl_pkt_free(pkts[i]);
+        }
+    }
+#else
+    for (; n > 0; rx++, n--) {
+        ccnl_core_RX(relay, rx->ifndx, rx->data, rx->datalen,
+                     rx->addrlen ? &rx->src.sa : NULL, rx->addrlen);
+    }
+#endif
+}
+
 // ----------------------------------------------------------------------
 
 void
 ccnl_core_init(void)
 {
+    // before any thread may compare or hash names, see ccnl_simd_setLevel()
+    ccnl_simd_setLevel(-1);
 #ifdef USE_SUITE_CCNB
     ccnl_core_suites[CCNL_SUITE_CCNB].RX         = ccnl_ccnb_forwarder;
     ccnl_core_suites[CCNL_SUITE_CCNB].cMatch     = ccnl_ccnb_cMatch;
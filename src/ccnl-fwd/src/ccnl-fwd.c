@@ -28,12 +28,16 @@
 #include "ccnl-callbacks.h"
 
 #include "ccnl-pkt-util.h"
+#ifdef USE_VERIFY_POOL
+#include "ccnl-verify.h"
+#endif
 
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-pkt-ccnb.h"
 #include "ccnl-pkt-ccntlv.h"
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-pkt-switch.h"
+#include "ccnl-pkt-match.h"
 #include <inttypes.h>
 #include <limits.h>
 #else
@@ -41,10 +45,21 @@
 #include <ccnl-pkt-ccntlv.h>
 #include <ccnl-pkt-ndntlv.h>
 #include <ccnl-pkt-switch.h>
+#include <ccnl-pkt-match.h>
 #endif
 
 //#include "ccnl-logging.h"
 
+// single suite builds call their content matcher inline instead of
+// through the cMatchFct pointer
+#if defined(CCNL_SUITE_FIXED_NDNTLV) && defined(NEEDS_PREFIX_MATCHING)
+# define CCNL_CMATCH(cMatch, p, c)  ((void) (cMatch), ccnl_ndntlv_cMatchInline(p, c))
+#elif defined(CCNL_SUITE_FIXED_CCNTLV) && defined(NEEDS_PREFIX_MATCHING)
+# define CCNL_CMATCH(cMatch, p, c)  ((void) (cMatch), ccnl_ccntlv_cMatchInline(p, c))
+#else
+# define CCNL_CMATCH(cMatch, p, c)  (cMatch)(p, c)
+#endif
+
 
 #ifdef NEEDS_PREFIX_MATCHING
 struct ccnl_prefix_s* ccnl_prefix_dup(struct ccnl_prefix_s *prefix);
@@ -102,12 +117,56 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         return 0;
     }
 
+#ifdef USE_VERIFY_POOL
+    if (relay->verify) {
+        switch (ccnl_verify_submit(relay->verify, c, from ? from->faceid : -1)) {
+        case 1: // held, see ccnl_fwd_contentVerified()
+            return 0;
+        case 0:
+            break;
+        default:
+            DEBUGMSG_CFWD(DEBUG, "  removed, signature not verified\n");
+            ccnl_content_free(c);
+            return 0;
+        }
+    }
+#endif
+    ccnl_fwd_serveContent(relay, from, c);
+    return 0;
+}
+
+#ifdef USE_VERIFY_POOL
+void
+ccnl_fwd_contentVerified(struct ccnl_relay_s *relay, struct ccnl_content_s *c,
+                         int faceid, int verified)
+{
+    struct ccnl_face_s *from;
+
+    if (!verified) {
+        DEBUGMSG_CFWD(DEBUG, "  removed, invalid signature\n");
+        ccnl_content_free(c);
+        return;
+    }
+    // the face may have gone while the Data was held
+    for (from = relay->faces; from && from->faceid != faceid; from = from->next);
+    ccnl_fwd_serveContent(relay, from, c);
+}
+#endif
+
+void
+ccnl_fwd_serveContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                      struct ccnl_content_s *c)
+{
+    (void) from;
+
     if (!ccnl_content_serve_pending(relay, c)) { // unsolicited content
         // CONFORM: "A node MUST NOT forward unsolicited data [...]"
         DEBUGMSG_CFWD(DEBUG, "  removed because no matching interest\n");
         ccnl_content_free(c);
-        return 0;
+        return;
     }
+    // the mark describes the upstream path, not hits served from the cache
+    c->pkt->flags &= ~CCNL_PKT_CONGESTED;
 
     if (relay->max_cache_entries != 0) { // it's set to -1 or a limit
         DEBUGMSG_CFWD(DEBUG, "  adding content to cache\n");
@@ -130,7 +189,6 @@ ccnl_fwd_handleContent(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         ccnl_fib_add_entry(relay, pfx_wo_chunk, from);
     }
 #endif
-    return 0;
 }
 
 #ifdef USE_FRAG
@@ -139,9 +197,13 @@ int
 ccnl_fwd_handleFragment(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                         struct ccnl_pkt_s **pkt, dispatchFct callback)
 {
-    unsigned char *data = (*pkt)->content;
-    int datalen = (*pkt)->contlen;
+    uint8_t *data = (*pkt)->content;
+    size_t datalen = (*pkt)->contlen;
 
+    if (ccnl_pkt_materialize(*pkt)) {
+        return -1;
+    }
+    data = (*pkt)->content;
     if (from) {
         char *from_as_str = ccnl_addr2ascii(&(from->peer));
 
@@ -165,7 +227,7 @@ ccnl_fwd_handleFragment(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 int
 ccnl_pkt_fwdOK(struct ccnl_pkt_s *pkt)
 {
-    switch (pkt->suite) {
+    switch (CCNL_SUITE_OF(pkt)) {
 #ifdef USE_SUITE_NDNTLV
     case CCNL_SUITE_NDNTLV:
         return pkt->s.ndntlv.scope > 2;
@@ -177,9 +239,66 @@ ccnl_pkt_fwdOK(struct ccnl_pkt_s *pkt)
     return -1;
 }
 
+// first content matching the Interest, in the order of the CS
+static struct ccnl_content_s*
+ccnl_fwd_csLookup(struct ccnl_relay_s *relay, struct ccnl_pkt_s *pkt,
+                  cMatchFct cMatch)
+{
+    struct ccnl_content_s *c;
+
+    for (c = relay->contents; c; c = c->next) {
+        CCNL_PREFETCH(c->next);
+        if (CCNL_SUITE_OF(c->pkt->pfx) != CCNL_SUITE_OF(pkt->pfx))
+            continue;
+        if (!CCNL_CMATCH(cMatch, pkt, c))
+            break;
+    }
+    return c;
+}
+
+void
+ccnl_fwd_csLookupBatch(struct ccnl_relay_s *relay, size_t n,
+                       struct ccnl_pkt_s *pkts[], cMatchFct cMatch,
+                       struct ccnl_cs_hint_s hints[])
+{
+    struct ccnl_content_s *c, *next;
+    size_t i, open = 0;
+
+    for (i = 0; i < n; i++) {
+        hints[i].csgen = relay->csgen;
+        hints[i].c = NULL;
+        open += pkts[i] != NULL;
+    }
+    for (c = relay->contents; c && open; c = next) {
+        next = c->next;
+        if (next) { // the node after next, and the packet of the next one
+            CCNL_PREFETCH(next->next);
+            CCNL_PREFETCH(next->pkt);
+        }
+        for (i = 0; i < n; i++) {
+            if (!pkts[i] || hints[i].c ||
+                CCNL_SUITE_OF(c->pkt->pfx) != CCNL_SUITE_OF(pkts[i]->pfx)) {
+                continue;
+            }
+            if (!CCNL_CMATCH(cMatch, pkts[i], c)) {
+                hints[i].c = c;
+                open--;
+            }
+        }
+    }
+}
+
 int
 ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                         struct ccnl_pkt_s **pkt, cMatchFct cMatch)
+{
+    return ccnl_fwd_handleInterestHint(relay, from, pkt, cMatch, NULL);
+}
+
+int
+ccnl_fwd_handleInterestHint(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                            struct ccnl_pkt_s **pkt, cMatchFct cMatch,
+                            const struct ccnl_cs_hint_s *hint)
 {
     struct ccnl_interest_s *i;
     struct ccnl_content_s *c;
@@ -206,6 +325,14 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             ccnl_suite2str((*pkt)->suite), nonce,
             from_as_str ? from_as_str : "");
 #endif
+        // mgmt requests are not forwarded, they are exempt
+        if (!((*pkt)->pfx->compcnt == 4 &&
+              !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) &&
+            !ccnl_face_admit_interest(from)) {
+            DEBUGMSG_CFWD(DEBUG, "  dropped by the rate limit of face %d\n",
+                          from->faceid);
+            return 0;
+        }
     }
 
 #ifdef USE_DUP_CHECK
@@ -223,7 +350,7 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         return 0;
     }
 #if defined(USE_SUITE_CCNB) && defined(USE_MGMT)
-    if ((*pkt)->suite == CCNL_SUITE_CCNB && (*pkt)->pfx->compcnt == 4 &&
+    if (CCNL_SUITE_OF(*pkt) == CCNL_SUITE_CCNB && (*pkt)->pfx->compcnt == 4 &&
                                   !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) {
         DEBUGMSG_CFWD(INFO, "  found a mgmt message\n");
         ccnl_mgmt(relay, (*pkt)->buf, (*pkt)->pfx, from); // use return value? // TODO uncomment
@@ -232,11 +359,13 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #endif
 
 #ifdef USE_SUITE_NDNTLV
-    if ((*pkt)->suite == CCNL_SUITE_NDNTLV && (*pkt)->pfx->compcnt == 4 &&
+    if (CCNL_SUITE_OF(*pkt) == CCNL_SUITE_NDNTLV && (*pkt)->pfx->compcnt == 4 &&
         !memcmp((*pkt)->pfx->comp[0], "ccnx", 4)) {
         DEBUGMSG_CFWD(INFO, "  found a mgmt message\n");
 #ifdef USE_MGMT
-        ccnl_mgmt(relay, (*pkt)->buf, (*pkt)->pfx, from); // use return value?
+        if (!ccnl_pkt_materialize(*pkt)) {
+            ccnl_mgmt(relay, (*pkt)->buf, (*pkt)->pfx, from); // use return value?
+        }
 #endif
         return 0;
     }
@@ -245,12 +374,12 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
             // Step 1: search in content store
     DEBUGMSG_CFWD(DEBUG, "  searching in CS\n");
 
-    for (c = relay->contents; c; c = c->next) {
-        if (c->pkt->pfx->suite != (*pkt)->pfx->suite)
-            continue;
-        if (cMatch(*pkt, c))
-            continue;
-
+    if (hint && hint->csgen == relay->csgen) {
+        c = hint->c; // looked up ahead, and the CS did not change since
+    } else {
+        c = ccnl_fwd_csLookup(relay, *pkt, cMatch);
+    }
+    if (c) {
         DEBUGMSG_CFWD(DEBUG, "  found matching content %p\n", (void *) c);
 
         if (from) {
@@ -279,9 +408,11 @@ ccnl_fwd_handleInterest(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
     if (!i) {
         i = ccnl_interest_new(relay, from, pkt);
 
-        DEBUGMSG_CFWD(DEBUG,
-                      "  created new interest entry %p (prefix=%s)\n",
-                      (void *) i, ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PACKET_SIZE));
+        if (i) {
+            DEBUGMSG_CFWD(DEBUG,
+                          "  created new interest entry %p (prefix=%s)\n",
+                          (void *) i, ccnl_prefix_to_str(i->pkt->pfx,s,CCNL_MAX_PACKET_SIZE));
+        }
     }
     if (i) { // store the I request, for the incoming face (Step 3)
         DEBUGMSG_CFWD(DEBUG, "  appending interest entry %p\n", (void *) i);
@@ -456,7 +587,7 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
 #ifdef USE_FRAG
     if (hp->pkttype == CCNX_PT_Fragment) {
         uint16_t *sp = (uint16_t*) *data;
-        int fraglen = ntohs(*(sp+1));
+        size_t fraglen = ntohs(*(sp+1));
 
         if (ntohs(*sp) == CCNX_TLV_TL_Fragment && fraglen == (payloadlen-4)) {
             uint16_t fragfields; // = *(uint16_t *) &hp->fill;
@@ -471,15 +602,15 @@ ccnl_ccntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
                             relay->ifs[from->ifndx].mtu, fragfields >> 14,
                             fragfields & 0x3fff, data, datalen);
 
-            DEBUGMSG_CFWD(TRACE, "  done (fraglen=%d, payloadlen=%d, *datalen=%d)\n",
+            DEBUGMSG_CFWD(TRACE, "  done (fraglen=%zu, payloadlen=%zu, *datalen=%zu)\n",
                      fraglen, payloadlen, *datalen);
         } else {
-            DEBUGMSG_CFWD(DEBUG, "  problem with frag type or length (%d, %d, %d)\n",
+            DEBUGMSG_CFWD(DEBUG, "  problem with frag type or length (%d, %zu, %zu)\n",
                      ntohs(*sp), fraglen, payloadlen);
             *data += payloadlen;
             *datalen -= payloadlen;
         }
-        DEBUGMSG_CFWD(TRACE, "  returning after fragment: %d bytes\n", *datalen);
+        DEBUGMSG_CFWD(TRACE, "  returning after fragment: %zu bytes\n", *datalen);
         return 0;
     } else {
         DEBUGMSG_CFWD(TRACE, "  not a fragment, continueing\n");
@@ -534,6 +665,68 @@ Done:
 
 #ifdef USE_SUITE_NDNTLV
 
+// Data enclosed in an LpPacket with a CongestionMark
+static void
+ccnl_fwd_handleMarkedContent(struct ccnl_relay_s *relay,
+                             struct ccnl_face_s *from,
+                             uint8_t *data, size_t datalen)
+{
+    uint8_t *start = data;
+    struct ccnl_pkt_s *pkt;
+    uint64_t typ;
+    size_t len;
+
+    if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) || len > datalen) {
+        return;
+    }
+    pkt = ccnl_ndntlv_bytes2pktView(typ, start, &data, &datalen);
+    if (!pkt) {
+        DEBUGMSG_CFWD(INFO, "  ndntlv packet coding problem\n");
+        return;
+    }
+    pkt->type = typ;
+    pkt->flags |= CCNL_PKT_CONGESTED;
+    ccnl_fwd_handleContent(relay, from, &pkt);
+    ccnl_pkt_free(pkt);
+}
+
+// link layer frame: link fields first, then the enclosed packet
+static int8_t
+ccnl_fwd_handleLpPacket(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                        uint8_t **data, size_t *datalen, size_t len)
+{
+    struct ccnl_ndntlv_lp_s lp;
+    int8_t rc = 0;
+
+    if (ccnl_ndntlv_parseLpPacket(*data, len, &lp)) {
+        DEBUGMSG_CFWD(INFO, "  invalid LpPacket, dropped\n");
+        rc = -1;
+    }
+#ifdef USE_LINKREL
+    else if (from && !ccnl_linkrel_RX(relay, from, &lp)) {
+        // duplicate or IDLE frame
+    }
+#endif
+    else if (lp.frag && lp.fraglen) {
+        uint8_t *frag = lp.frag, *cp = lp.frag;
+        size_t fraglen = lp.fraglen, cplen = lp.fraglen, vallen;
+        uint64_t typ;
+
+        // NDNLPv2 does not nest LpPackets, and we must not recurse into them
+        if (ccnl_ndntlv_dehead(&cp, &cplen, &typ, &vallen) ||
+            typ == NDN_TLV_LpPacket) {
+            DEBUGMSG_CFWD(INFO, "  invalid LpPacket fragment, dropped\n");
+            rc = -1;
+        } else if (lp.congmark && *frag == NDN_TLV_Data) {
+            ccnl_fwd_handleMarkedContent(relay, from, frag, fraglen);
+        } else {
+            ccnl_ndntlv_forwarder(relay, from, &frag, &fraglen);
+        }
+    }
+    *data += len;
+    *datalen -= len;
+    return rc;
+}
 
 int8_t
 ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
@@ -551,7 +744,12 @@ ccnl_ndntlv_forwarder(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
         DEBUGMSG_CFWD(TRACE, "  invalid packet format\n");
         return -1;
     }
-    pkt = ccnl_ndntlv_bytes2pkt(typ, start, data, datalen);
+    if (typ == NDN_TLV_LpPacket &&
+        (!len || **data != NDN_TLV_Frag_BeginEndFields)) {
+        return ccnl_fwd_handleLpPacket(relay, from, data, datalen, len);
+    }
+    // parse in place, the bytes are only copied if the packet is kept
+    pkt = ccnl_ndntlv_bytes2pktView(typ, start, data, datalen);
     if (!pkt) {
         DEBUGMSG_CFWD(INFO, "  ndntlv packet coding problem\n");
         goto Done;
@@ -102,6 +102,7 @@
 #include "../../ccnl-core/src/ccnl-logging.c"
 #include "../../ccnl-core/src/ccnl-os-time.c"
 #include "../../ccnl-core/src/ccnl-prefix.c"
+#include "../../ccnl-core/src/ccnl-simd.c"
 #include "../../ccnl-core/src/ccnl-relay.c"
 #include "../../ccnl-core/src/ccnl-sched.c"
 #include "../../ccnl-core/src/ccnl-interest.c"
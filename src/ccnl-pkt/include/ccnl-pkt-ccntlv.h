@@ -216,4 +216,25 @@ ccnl_ccntlv_prependFixedHdr(uint8_t ver,
                             uint8_t hoplimit,
                             size_t *offset, uint8_t *buf);
 
+#ifdef USE_FRAG
+struct ccnl_frag_s;
+
+/**
+ * @brief Encodes the header of the next BeginEnd fragment of a packet
+ *
+ * The fragment payload is not copied: it is the @p datalen bytes at the
+ * current send offset of @p fr, to be sent right after the header.
+ *
+ * @param[in] fr       The fragmenter
+ * @param[out] hdr     At least CCNL_FRAG_HDRMAX bytes for the header
+ * @param[out] hdrlen  Length of the header
+ * @param[out] datalen Payload bytes carried by the fragment
+ *
+ * @return 0 on success, -1 if the MTU is too small
+ */
+int8_t
+ccnl_ccntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr,
+                      size_t *hdrlen, size_t *datalen);
+#endif
+
 #endif // eof
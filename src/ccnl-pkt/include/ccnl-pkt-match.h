@@ -0,0 +1,68 @@
+/*
+ * @f ccnl-pkt-match.h
+ * @b CCN lite (CCNL), content store matching of the TLV formats, inline
+ *
+ * Copyright (C) 2011-18, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#ifndef CCNL_PKT_MATCH_H
+#define CCNL_PKT_MATCH_H
+
+#include "ccnl-core.h"
+
+#ifdef NEEDS_PREFIX_MATCHING
+
+#ifdef USE_SUITE_NDNTLV
+/**
+ * @brief Body of ccnl_ndntlv_cMatch(), inlined into the content store walk
+ *        of single suite builds (CCNL_SUITE_FIXED)
+ *
+ * @return 0 if \p c satisfies the Interest \p p, -1 otherwise
+ */
+static inline int8_t
+ccnl_ndntlv_cMatchInline(struct ccnl_pkt_s *p, struct ccnl_content_s *c)
+{
+    if (!ccnl_i_prefixof_c(p->pfx, p->s.ndntlv.minsuffix,
+                           p->s.ndntlv.maxsuffix, c)) {
+        return -1;
+    }
+    if (p->s.ndntlv.mbf && (c->flags & CCNL_CONTENT_FLAGS_STALE)) {
+        return -1; // stale content
+    }
+    return 0;
+}
+#endif
+
+#ifdef USE_SUITE_CCNTLV
+/**
+ * @brief Body of ccnl_ccntlv_cMatch(), see ccnl_ndntlv_cMatchInline()
+ *
+ * @return 0 if \p c satisfies the Interest \p p, -1 otherwise
+ */
+static inline int8_t
+ccnl_ccntlv_cMatchInline(struct ccnl_pkt_s *p, struct ccnl_content_s *c)
+{
+    // TODO: check keyid
+    // TODO: check freshness, kind-of-reply
+    return ccnl_prefix_cmp(c->pkt->pfx, NULL, p->pfx, CMP_EXACT) ? -1 : 0;
+}
+#endif
+
+#endif // NEEDS_PREFIX_MATCHING
+
+#endif // CCNL_PKT_MATCH_H
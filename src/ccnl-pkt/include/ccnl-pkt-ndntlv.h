@@ -88,6 +88,13 @@
 #define NDN_TLV_NdnlpFragment           0x52
 #define NDN_TLV_Frag_BeginEndFields     0x5c
 
+// NDNLPv2 link protocol (subset):
+#define NDN_TLV_LpPacket                NDN_TLV_NDNLP
+#define NDN_TLV_LpFragment              0x50
+#define NDN_TLV_LpCongestionMark        0x340
+#define NDN_TLV_LpAck                   0x344
+#define NDN_TLV_LpTxSequence            0x348
+
 // reserved values:
 /*
 Values          Designation
@@ -141,6 +148,23 @@ struct ccnl_ndntlv_data_opts_s {
     uint32_t finalblockid;          /**< final block ID */
 };
 
+#ifndef NDN_LP_MAX_ACKS
+#define NDN_LP_MAX_ACKS                 8
+#endif
+
+/**
+ * @brief Header fields of an NDNLPv2 LpPacket
+ */
+struct ccnl_ndntlv_lp_s {
+    uint8_t has_txseq;              /**< whether txseq is present */
+    uint64_t txseq;                 /**< TxSequence of this link frame */
+    size_t ackcnt;                  /**< number of valid entries in acks */
+    uint64_t acks[NDN_LP_MAX_ACKS]; /**< acknowledged TxSequences */
+    uint64_t congmark;              /**< CongestionMark, 0 if absent */
+    uint8_t *frag;                  /**< network packet, NULL if IDLE */
+    size_t fraglen;                 /**< length of the network packet */
+};
+
 #ifdef USE_SUITE_NDNTLV
 int8_t
 ccnl_ndntlv_varlenint(uint8_t **buf, size_t *len, uint64_t *val);
@@ -165,6 +189,28 @@ struct ccnl_pkt_s*
 ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                       uint8_t **data, size_t *datalen);
 
+/**
+ * Like ccnl_ndntlv_bytes2pkt(), but the packet borrows the bytes from
+ * @p start instead of copying them. Call ccnl_pkt_materialize() before
+ * the packet outlives the buffer.
+ */
+struct ccnl_pkt_s*
+ccnl_ndntlv_bytes2pktView(uint64_t pkttype, uint8_t *start,
+                          uint8_t **data, size_t *datalen);
+
+/**
+ * Parses the value of an LpPacket TLV. Unknown header fields are skipped,
+ * acks beyond NDN_LP_MAX_ACKS are ignored.
+ * @param data start of the LpPacket value (after the outer TL)
+ * @param datalen length of the LpPacket value
+ * @param lp return value via pointer: the decoded fields, frag points
+ *           into @p data
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ndntlv_parseLpPacket(uint8_t *data, size_t datalen,
+                          struct ccnl_ndntlv_lp_s *lp);
+
 int8_t
 ccnl_ndntlv_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c);
 
@@ -178,6 +224,103 @@ ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
                            size_t *contentpos, struct ccnl_ndntlv_data_opts_s *opts,
                            size_t *offset, uint8_t *buf, size_t *reslen);
 
+/**
+ * Pre-encoded invariant parts of a stream of packets under one name:
+ * the name components, the MetaInfo (Data) or Selectors (Interest), and
+ * the signature (Data) or Guiders after the Nonce (Interest). Filling
+ * it only encodes the segment number, the lengths and the payload or
+ * Nonce. The output is identical to ccnl_ndntlv_prependContent() and
+ * ccnl_ndntlv_prependInterest() with the same arguments.
+ */
+struct ccnl_ndntlv_template_s {
+    uint64_t type;      /**< NDN_TLV_Data or NDN_TLV_Interest */
+    uint8_t *buf;       /**< components, meta part and tail, in wire order */
+    size_t complen;     /**< encoded name components */
+    size_t metalen;     /**< MetaInfo or Selectors */
+    size_t taillen;     /**< signature or Guiders */
+};
+
+/**
+ * Pre-encodes a Data template.
+ * @param t the template to initialize, release with ccnl_ndntlv_freeTemplate()
+ * @param name the invariant name, its chunknum is ignored
+ * @param opts MetaInfo fields, may be NULL
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ndntlv_mkContentTemplate(struct ccnl_ndntlv_template_s *t,
+                              struct ccnl_prefix_s *name,
+                              struct ccnl_ndntlv_data_opts_s *opts);
+
+/**
+ * Pre-encodes an Interest template.
+ * @param t the template to initialize, release with ccnl_ndntlv_freeTemplate()
+ * @param name the invariant name, its chunknum is ignored
+ * @param scope the Scope, -1 for none
+ * @param opts Selectors and Guiders, the nonce is ignored
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ndntlv_mkInterestTemplate(struct ccnl_ndntlv_template_s *t,
+                               struct ccnl_prefix_s *name, int scope,
+                               struct ccnl_ndntlv_interest_opts_s *opts);
+
+void
+ccnl_ndntlv_freeTemplate(struct ccnl_ndntlv_template_s *t);
+
+/**
+ * Prepends a Data packet from a template.
+ * @param t the template
+ * @param segnum segment number appended to the name, NULL for none
+ * @param payload the content; if it already ends where the signature
+ *                starts (at *offset - t->taillen) it is not copied
+ * @param paylen length of the content
+ * @param offset in: end of the free space in @p buf, out: start of packet
+ * @param buf the buffer to write into
+ * @param reslen return value via pointer: length of the packet
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ndntlv_fillContent(struct ccnl_ndntlv_template_s *t, uint32_t *segnum,
+                        uint8_t *payload, size_t paylen,
+                        size_t *offset, uint8_t *buf, size_t *reslen);
+
+/**
+ * Prepends an Interest packet from a template.
+ * @param t the template
+ * @param segnum segment number appended to the name, NULL for none
+ * @param nonce the Nonce
+ * @param offset in: end of the free space in @p buf, out: start of packet
+ * @param buf the buffer to write into
+ * @param reslen return value via pointer: length of the packet
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ndntlv_fillInterest(struct ccnl_ndntlv_template_s *t, uint32_t *segnum,
+                         int32_t nonce,
+                         size_t *offset, uint8_t *buf, size_t *reslen);
+
+/**
+ * Prepends a complete LpPacket carrying the fields of @p lp.
+ * @param lp the fields to encode, the network packet is copied
+ * @param offset in: end of the free space in @p buf, out: start of packet
+ * @param buf the buffer to write into
+ * @param reslen return value via pointer: length of the LpPacket
+ * @return 0 on success, -1 on failure.
+ */
+int8_t
+ccnl_ndntlv_prependLpPacket(struct ccnl_ndntlv_lp_s *lp,
+                            size_t *offset, uint8_t *buf, size_t *reslen);
+
+/**
+ * Returns a copy of an NDN Data packet carrying a congestion mark. The
+ * packet may be bare or already enclosed in an LpPacket.
+ * @param buf the packet to mark
+ * @return the marked LpPacket, NULL if @p buf is not a Data packet
+ */
+struct ccnl_buf_s*
+ccnl_ndntlv_mkCongestionMark(struct ccnl_buf_s *buf);
+
 int8_t
 ccnl_ndntlv_prependTL(uint64_t type, uint64_t len,
                       size_t *offset, uint8_t *buf);
@@ -198,4 +341,22 @@ int8_t
 ccnl_ndntlv_prependName(struct ccnl_prefix_s *name,
                         size_t *offset, uint8_t *buf);
 
+#ifdef USE_FRAG
+struct ccnl_frag_s;
+
+/**
+ * Encodes the header of the next BeginEnd fragment of a packet. The
+ * payload is not copied: it is the @p datalen bytes at the current send
+ * offset of @p fr, to be sent right after the header.
+ * @param fr the fragmenter
+ * @param hdr at least CCNL_FRAG_HDRMAX bytes for the header
+ * @param hdrlen return value via pointer: length of the header
+ * @param datalen return value via pointer: payload bytes in the fragment
+ * @return 0 on success, -1 if the MTU is too small
+ */
+int8_t
+ccnl_ndntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr,
+                      size_t *hdrlen, size_t *datalen);
+#endif
+
 #endif // EOF
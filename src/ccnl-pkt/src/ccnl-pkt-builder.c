@@ -196,7 +196,11 @@ ccnl_mkSimpleInterest(struct ccnl_prefix_s *name, ccnl_interest_opts_u *opts)
 int8_t
 ccnl_mkInterest(struct ccnl_prefix_s *name, ccnl_interest_opts_u *opts,
                 uint8_t *tmp, uint8_t *tmpend, size_t *len, size_t *offs) {
+#ifdef USE_SUITE_NDNTLV
     ccnl_interest_opts_u default_opts;
+#endif
+    (void) opts;
+    (void) tmpend;
 
     switch (name->suite) {
 #ifdef USE_SUITE_CCNB
@@ -307,6 +311,7 @@ ccnl_mkSimpleContent(struct ccnl_prefix_s *name,
 int8_t
 ccnl_mkContent(struct ccnl_prefix_s *name, uint8_t *payload, size_t paylen, uint8_t *tmp,
                size_t *len, size_t *contentpos, size_t *offs, ccnl_data_opts_u *opts) {
+    (void) opts;
     switch (name->suite) {
 #ifdef USE_SUITE_CCNB
         case CCNL_SUITE_CCNB:
@@ -194,6 +194,7 @@ ccnl_ccnb_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                     }
                 }
                 p->namelen = *data - p->nameptr;
+                ccnl_prefix_updateHashes(p);
                 break;
             case CCN_DTAG_CONTENT: {
                 if (ccnl_ccnb_consume(typ, num, data, datalen,
@@ -26,6 +26,7 @@
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-pkt-ccntlv.h"
 #include "ccnl-core.h"
+#include "ccnl-pkt-match.h"
 #include <stdlib.h>
 #include <string.h>
 #include <stdio.h>
@@ -34,6 +35,7 @@
 #else
 #include <ccnl-pkt-ccntlv.h>
 #include <ccnl-core.h>
+#include <ccnl-pkt-match.h>
 #endif
 
 
@@ -211,6 +213,7 @@ ccnl_ccntlv_bytes2pkt(uint8_t *start, uint8_t **data, size_t *datalen)
                 len2 -= len3;
             }
             p->namelen = *data - p->nameptr;
+            ccnl_prefix_updateHashes(p);
             break;
         case CCNX_TLV_M_ENDChunk: {
             uint32_t final_block_id;
@@ -293,12 +296,7 @@ ccnl_ccntlv_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c)
     assert(p);
     assert(p->suite == CCNL_SUITE_CCNTLV);
 #endif
-    if (ccnl_prefix_cmp(c->pkt->pfx, NULL, p->pfx, CMP_EXACT)) {
-        return -1;
-    }
-    // TODO: check keyid
-    // TODO: check freshness, kind-of-reply
-    return 0;
+    return ccnl_ccntlv_cMatchInline(p, c);
 }
 
 #endif
@@ -321,9 +319,9 @@ ccnl_ccntlv_prependTL(uint16_t type, size_t len,
     *offset -= 4;
 
     *(buf-1) = (uint8_t) (len & 0xffU);
-    *(buf-2) = (uint8_t) (len & 0xff00U) >> 8U;
+    *(buf-2) = (uint8_t) ((len & 0xff00U) >> 8U);
     *(buf-3) = (uint8_t) (type & 0xffU);
-    *(buf-4) = (uint8_t) (type & 0xff00U) >> 8U;
+    *(buf-4) = (uint8_t) ((type & 0xff00U) >> 8U);
 
     return 0;
 
@@ -575,57 +573,44 @@ ccnl_ccntlv_prependContentWithHdr(struct ccnl_prefix_s *name,
 
 #ifdef USE_FRAG
 
-// produces a full FRAG packet. It does not write, just read the fields in *fr
-struct ccnl_buf_s*
-ccnl_ccntlv_mkFrag(struct ccnl_frag_s *fr, unsigned int *consumed)
+// produces the header of the next FRAG packet, the payload follows it
+// as is. It does not write, just read the fields in *fr
+int8_t
+ccnl_ccntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr,
+                      size_t *hdrlen, size_t *datalen)
 {
-    size_t datalen;
-    struct ccnl_buf_s *buf;
-    struct ccnx_tlvhdr_ccnx2015_s *fp;
+    struct ccnx_tlvhdr_ccnx2015_s *fp = (struct ccnx_tlvhdr_ccnx2015_s*) hdr;
     uint16_t tmp;
 
-    DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_mkFrag seqno=%u\n", fr->sendseq);
+    DEBUGMSG_PCNX(TRACE, "ccnl_ccntlv_mkFragHdr seqno=%u\n", fr->sendseq);
 
-    datalen = fr->mtu - sizeof(*fp) - 4;
-    if (datalen > (fr->bigpkt->datalen - fr->sendoffs)) {
-        datalen = fr->bigpkt->datalen - fr->sendoffs;
+    if (fr->mtu <= (int) (sizeof(*fp) + 4)) {
+        return -1;
     }
-    if (datalen > UINT16_MAX) {
-        return NULL;
+    *datalen = fr->mtu - sizeof(*fp) - 4;
+    if (*datalen > (fr->bigpkt->datalen - fr->sendoffs)) {
+        *datalen = fr->bigpkt->datalen - fr->sendoffs;
     }
-
-    buf = ccnl_buf_new(NULL, sizeof(*fp) + 4 + datalen);
-    if (!buf) {
-        return NULL;
+    if (*datalen > UINT16_MAX - sizeof(*fp) - 4) {
+        return -1;
     }
-    fp = (struct ccnx_tlvhdr_ccnx2015_s*) buf->data;
+
     memset(fp, 0, sizeof(*fp));
     fp->version = CCNX_TLV_V1;
     fp->pkttype = CCNX_PT_Fragment;
     fp->hdrlen = sizeof(*fp);
-    fp->pktlen = htons(sizeof(*fp) + 4 + datalen);
+    fp->pktlen = htons((uint16_t) (sizeof(*fp) + 4 + *datalen));
 
     tmp = htons(CCNX_TLV_TL_Fragment);
     memcpy(fp+1, &tmp, 2);
-    tmp = htons((uint16_t) datalen);
+    tmp = htons((uint16_t) *datalen);
     memcpy((char*)(fp+1) + 2, &tmp, 2);
-    memcpy((char*)(fp+1) + 4, fr->bigpkt->data + fr->sendoffs, datalen);
-
-    tmp = fr->sendseq & 0x03fff;
-    if (datalen >= fr->bigpkt->datalen) {   // single
-        tmp |= CCNL_BEFRAG_FLAG_SINGLE << 14;
-    } else if (fr->sendoffs == 0) {          // start
-        tmp |= CCNL_BEFRAG_FLAG_FIRST  << 14;
-    } else if(datalen >= (fr->bigpkt->datalen - fr->sendoffs)) { // end
-        tmp |= CCNL_BEFRAG_FLAG_LAST   << 14;
-    } else {                                  // middle
-        tmp |= CCNL_BEFRAG_FLAG_MID    << 14;
-    }
-    tmp = htons(tmp);
+
+    tmp = htons(ccnl_frag_BEfields(fr, *datalen));
     memcpy(fp->fill, &tmp, 2);
 
-    *consumed = datalen;
-    return buf;
+    *hdrlen = sizeof(*fp) + 4;
+    return 0;
 }
 #endif
 
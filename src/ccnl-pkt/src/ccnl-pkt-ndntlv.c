@@ -19,6 +19,8 @@
  * File history:
  * 2014-03-05 created
  * 2014-11-05 merged from pkt-ndntlv-enc.c pkt-ndntlv-dec.c
+ * 2026-10-19 single byte fast path in dehead
+ * 2026-10-19 encoder templates for Data and Interest
  */
 
 #ifdef USE_SUITE_NDNTLV
@@ -26,6 +28,7 @@
 #ifndef CCNL_LINUXKERNEL
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-core.h"
+#include "ccnl-pkt-match.h"
 #include <stdlib.h>
 #include <string.h>
 #include <arpa/inet.h>
@@ -34,6 +37,7 @@
 #else
 #include <ccnl-pkt-ndntlv.h>
 #include <ccnl-core.h>
+#include <ccnl-pkt-match.h>
 #endif
 
 
@@ -45,7 +49,10 @@
 int8_t
 ccnl_ndntlv_varlenint(uint8_t **buf, size_t *len, uint64_t *val)
 {
-    if (**buf < 253 && *len >= 1) {
+    if (*len < 1) {
+        return -1;
+    }
+    if (**buf < 253) {
         *val = **buf;
         *buf += 1;
         *len -= 1;
@@ -85,6 +92,15 @@ ccnl_ndntlv_dehead(uint8_t **buf, size_t *len,
 {
     size_t maxlen = *len;
     uint64_t vallen_int = 0;
+
+    // common case inside names: one byte each for type and length
+    if (*len >= 2 && (*buf)[0] < 253 && (*buf)[1] < 253) {
+        *typ = (*buf)[0];
+        *vallen = (*buf)[1];
+        *buf += 2;
+        *len -= 2;
+        return *vallen > maxlen ? -1 : 0;
+    }
     if (ccnl_ndntlv_varlenint(buf, len, typ)) {
         return -1;
     }
@@ -103,8 +119,8 @@ ccnl_ndntlv_dehead(uint8_t **buf, size_t *len,
 
 // we use one extraction routine for each of interest, data and fragment pkts
 struct ccnl_pkt_s*
-ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
-                      uint8_t **data, size_t *datalen)
+ccnl_ndntlv_bytes2pktView(uint64_t pkttype, uint8_t *start,
+                          uint8_t **data, size_t *datalen)
 {
     struct ccnl_pkt_s *pkt;
     size_t oldpos, len, i;
@@ -115,7 +131,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
 #endif
 
 
-    DEBUGMSG(DEBUG, "ccnl_ndntlv_bytes2pkt len=%zu\n", *datalen);
+    DEBUGMSG(DEBUG, "ccnl_ndntlv_bytes2pktView len=%zu\n", *datalen);
 
     pkt = (struct ccnl_pkt_s*) ccnl_calloc(1, sizeof(struct ccnl_pkt_s));
     if (!pkt) {
@@ -195,6 +211,7 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
                 len2 -= i;
             }
             prefix->namelen = *data - prefix->nameptr;
+            ccnl_prefix_updateHashes(prefix);
             DEBUGMSG(DEBUG, "  check interest type\n");
             break;
         case NDN_TLV_Selectors:
@@ -311,22 +328,8 @@ ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
     }
 
     pkt->pfx = prefix;
-    pkt->buf = ccnl_buf_new(start, *data - start);
-    if (!pkt->buf) {
-        goto Bail;
-    }
-    // carefully rebase ptrs to new buf because of 64bit pointers:
-    if (pkt->content) {
-        pkt->content = pkt->buf->data + (pkt->content - start);
-    }
-    if (prefix) {
-        for (i = 0; i < prefix->compcnt; i++) {
-            prefix->comp[i] = pkt->buf->data + (prefix->comp[i] - start);
-        }
-        if (prefix->nameptr) {
-            prefix->nameptr = pkt->buf->data + (prefix->nameptr - start);
-        }
-    }
+    pkt->view = start;
+    pkt->viewlen = *data - start;
 
     return pkt;
 Bail:
@@ -334,6 +337,60 @@ Bail:
     return NULL;
 }
 
+struct ccnl_pkt_s*
+ccnl_ndntlv_bytes2pkt(uint64_t pkttype, uint8_t *start,
+                      uint8_t **data, size_t *datalen)
+{
+    struct ccnl_pkt_s *pkt;
+
+    pkt = ccnl_ndntlv_bytes2pktView(pkttype, start, data, datalen);
+    if (pkt && ccnl_pkt_materialize(pkt)) {
+        ccnl_pkt_free(pkt);
+        return NULL;
+    }
+    return pkt;
+}
+
+int8_t
+ccnl_ndntlv_parseLpPacket(uint8_t *data, size_t datalen,
+                          struct ccnl_ndntlv_lp_s *lp)
+{
+    uint64_t typ;
+    size_t len;
+
+    memset(lp, 0, sizeof(*lp));
+    while (datalen > 0) {
+        if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) || len > datalen) {
+            return -1;
+        }
+        switch (typ) {
+        case NDN_TLV_LpTxSequence:
+            lp->has_txseq = 1;
+            lp->txseq = ccnl_ndntlv_nonNegInt(data, len);
+            break;
+        case NDN_TLV_LpCongestionMark:
+            lp->congmark = ccnl_ndntlv_nonNegInt(data, len);
+            break;
+        case NDN_TLV_LpAck:
+            if (lp->ackcnt < NDN_LP_MAX_ACKS) {
+                lp->acks[lp->ackcnt++] = ccnl_ndntlv_nonNegInt(data, len);
+            }
+            break;
+        case NDN_TLV_LpFragment:
+            lp->frag = data;
+            lp->fraglen = len;
+            break;
+        default:
+            DEBUGMSG(TRACE, "  ndntlv: skipping LpPacket field %llu\n",
+                     (unsigned long long) typ);
+            break;
+        }
+        data += len;
+        datalen -= len;
+    }
+    return 0;
+}
+
 // ----------------------------------------------------------------------
 
 #ifdef NEEDS_PREFIX_MATCHING
@@ -347,12 +404,7 @@ ccnl_ndntlv_cMatch(struct ccnl_pkt_s *p, struct ccnl_content_s *c)
     assert(p->suite == CCNL_SUITE_NDNTLV);
 #endif
 
-    if (!ccnl_i_prefixof_c(p->pfx, p->s.ndntlv.minsuffix, p->s.ndntlv.maxsuffix, c)) {
-        return -1;
-    }
-
-    if (p->s.ndntlv.mbf && ((c->flags & CCNL_CONTENT_FLAGS_STALE) != 0)) {
-        DEBUGMSG(DEBUG, "ignore stale content\n");
+    if (ccnl_ndntlv_cMatchInline(p, c)) {
         return -1;
     }
 
@@ -525,12 +577,11 @@ ccnl_ndntlv_prependName(struct ccnl_prefix_s *name,
 
 // ----------------------------------------------------------------------
 
-int8_t
-ccnl_ndntlv_prependInterest(struct ccnl_prefix_s *name, int scope, struct ccnl_ndntlv_interest_opts_s *opts,
-                            size_t *offset, uint8_t *buf, size_t *reslen)
+// Guiders following the Nonce: InterestLifetime and Scope
+static int8_t
+ccnl_ndntlv_prependGuiders(int scope, struct ccnl_ndntlv_interest_opts_s *opts,
+                           size_t *offset, uint8_t *buf)
 {
-    size_t oldoffset = *offset;
-
     if (scope >= 0) {
         if (scope > 2) {
             return -1;
@@ -547,11 +598,13 @@ ccnl_ndntlv_prependInterest(struct ccnl_prefix_s *name, int scope, struct ccnl_n
             return -1;
         }
     }
+    return 0;
+}
 
-    if (ccnl_ndntlv_prependNonNegInt(NDN_TLV_Nonce, (uint64_t) opts->nonce, offset, buf) < 0) {
-        return -1;
-    }
-
+static int8_t
+ccnl_ndntlv_prependSelectors(struct ccnl_ndntlv_interest_opts_s *opts,
+                             size_t *offset, uint8_t *buf)
+{
     /* MustBeFresh is the only supported Selector for now */
     if (opts->mustbefresh) {
         size_t sel_offset = *offset;
@@ -563,6 +616,26 @@ ccnl_ndntlv_prependInterest(struct ccnl_prefix_s *name, int scope, struct ccnl_n
             return -1;
         }
     }
+    return 0;
+}
+
+int8_t
+ccnl_ndntlv_prependInterest(struct ccnl_prefix_s *name, int scope, struct ccnl_ndntlv_interest_opts_s *opts,
+                            size_t *offset, uint8_t *buf, size_t *reslen)
+{
+    size_t oldoffset = *offset;
+
+    if (ccnl_ndntlv_prependGuiders(scope, opts, offset, buf) < 0) {
+        return -1;
+    }
+
+    if (ccnl_ndntlv_prependNonNegInt(NDN_TLV_Nonce, (uint64_t) opts->nonce, offset, buf) < 0) {
+        return -1;
+    }
+
+    if (ccnl_ndntlv_prependSelectors(opts, offset, buf) < 0) {
+        return -1;
+    }
 
     if (ccnl_ndntlv_prependName(name, offset, buf)) {
         return -1;
@@ -577,21 +650,13 @@ ccnl_ndntlv_prependInterest(struct ccnl_prefix_s *name, int scope, struct ccnl_n
     return 0;
 }
 
-int8_t
-ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
-                           uint8_t *payload, size_t paylen,
-                           size_t *contentpos, struct ccnl_ndntlv_data_opts_s *opts,
-                           size_t *offset, uint8_t *buf, size_t *reslen)
+// SignatureInfo and SignatureValue (empty for now)
+static int8_t
+ccnl_ndntlv_prependSignature(size_t *offset, uint8_t *buf)
 {
-    size_t oldoffset = *offset, oldoffset2;
+    size_t oldoffset2;
     uint8_t signatureType = NDN_VAL_SIGTYPE_DIGESTSHA256;
 
-    if (contentpos) {
-        *contentpos = *offset - paylen;
-    }
-
-    // fill in backwards
-
     // mandatory (empty for now)
     if (ccnl_ndntlv_prependTL(NDN_TLV_SignatureValue, 0, offset, buf) < 0) {
         return -1;
@@ -617,15 +682,16 @@ ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
     if (ccnl_ndntlv_prependTL(NDN_TLV_SignatureInfo, oldoffset2 - *offset, offset, buf) < 0) {
         return -1;
     }
+    return 0;
+}
 
-    // mandatory
-    if (ccnl_ndntlv_prependBlob(NDN_TLV_Content, payload, paylen,
-                                offset, buf) < 0) {
-        return -1;
-    }
-
+static int8_t
+ccnl_ndntlv_prependMetaInfo(struct ccnl_ndntlv_data_opts_s *opts,
+                            size_t *offset, uint8_t *buf)
+{
     // to find length of optional (?) MetaInfo fields
-    oldoffset2 = *offset;
+    size_t oldoffset2 = *offset;
+
     if (opts) {
         if (opts->finalblockid != UINT32_MAX) {
             if (ccnl_ndntlv_prependIncludedNonNegInt(NDN_TLV_NameComponent,
@@ -655,6 +721,36 @@ ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
                               offset, buf) < 0) {
         return -1;
     }
+    return 0;
+}
+
+int8_t
+ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
+                           uint8_t *payload, size_t paylen,
+                           size_t *contentpos, struct ccnl_ndntlv_data_opts_s *opts,
+                           size_t *offset, uint8_t *buf, size_t *reslen)
+{
+    size_t oldoffset = *offset;
+
+    if (contentpos) {
+        *contentpos = *offset - paylen;
+    }
+
+    // fill in backwards
+
+    if (ccnl_ndntlv_prependSignature(offset, buf)) {
+        return -1;
+    }
+
+    // mandatory
+    if (ccnl_ndntlv_prependBlob(NDN_TLV_Content, payload, paylen,
+                                offset, buf) < 0) {
+        return -1;
+    }
+
+    if (ccnl_ndntlv_prependMetaInfo(opts, offset, buf) < 0) {
+        return -1;
+    }
 
     // mandatory
     if (ccnl_ndntlv_prependName(name, offset, buf)) {
@@ -675,72 +771,304 @@ ccnl_ndntlv_prependContent(struct ccnl_prefix_s *name,
     return 0;
 }
 
-#ifdef USE_FRAG
+// ----------------------------------------------------------------------
+// encoder templates
+
+static int8_t
+ccnl_ndntlv_prependBytes(uint8_t *data, size_t len,
+                         size_t *offset, uint8_t *buf)
+{
+    if (*offset < len) {
+        return -1;
+    }
+    *offset -= len;
+    memcpy(buf + *offset, data, len);
+    return 0;
+}
+
+// encodes the invariant parts with the regular prepend functions
+static int8_t
+ccnl_ndntlv_mkTemplate(struct ccnl_ndntlv_template_s *t, uint64_t type,
+                       struct ccnl_prefix_s *name, int scope,
+                       struct ccnl_ndntlv_interest_opts_s *iopts,
+                       struct ccnl_ndntlv_data_opts_s *dopts)
+{
+    uint8_t *tmp;
+    size_t offset = CCNL_MAX_PACKET_SIZE, end;
+    uint32_t cnt;
+
+    memset(t, 0, sizeof(*t));
+    t->type = type;
+    tmp = (uint8_t*) ccnl_malloc(CCNL_MAX_PACKET_SIZE);
+    if (!tmp) {
+        return -1;
+    }
+
+    // wire order: name components, meta part, tail
+    if (type == NDN_TLV_Data) {
+        if (ccnl_ndntlv_prependSignature(&offset, tmp)) {
+            goto Bail;
+        }
+    } else if (ccnl_ndntlv_prependGuiders(scope, iopts, &offset, tmp) < 0) {
+        goto Bail;
+    }
+    t->taillen = CCNL_MAX_PACKET_SIZE - offset;
+
+    end = offset;
+    if (type == NDN_TLV_Data) {
+        if (ccnl_ndntlv_prependMetaInfo(dopts, &offset, tmp) < 0) {
+            goto Bail;
+        }
+    } else if (ccnl_ndntlv_prependSelectors(iopts, &offset, tmp) < 0) {
+        goto Bail;
+    }
+    t->metalen = end - offset;
+
+    end = offset;
+    for (cnt = name->compcnt; cnt > 0; cnt--) {
+        if (ccnl_ndntlv_prependBlob(NDN_TLV_NameComponent, name->comp[cnt-1],
+                                    name->complen[cnt-1], &offset, tmp) < 0) {
+            goto Bail;
+        }
+    }
+    t->complen = end - offset;
+
+    t->buf = (uint8_t*) ccnl_malloc(CCNL_MAX_PACKET_SIZE - offset);
+    if (!t->buf) {
+        goto Bail;
+    }
+    memcpy(t->buf, tmp + offset, CCNL_MAX_PACKET_SIZE - offset);
+    ccnl_free(tmp);
+    return 0;
+
+Bail:
+    ccnl_free(tmp);
+    return -1;
+}
+
+int8_t
+ccnl_ndntlv_mkContentTemplate(struct ccnl_ndntlv_template_s *t,
+                              struct ccnl_prefix_s *name,
+                              struct ccnl_ndntlv_data_opts_s *opts)
+{
+    return ccnl_ndntlv_mkTemplate(t, NDN_TLV_Data, name, -1, NULL, opts);
+}
+
+int8_t
+ccnl_ndntlv_mkInterestTemplate(struct ccnl_ndntlv_template_s *t,
+                               struct ccnl_prefix_s *name, int scope,
+                               struct ccnl_ndntlv_interest_opts_s *opts)
+{
+    return ccnl_ndntlv_mkTemplate(t, NDN_TLV_Interest, name, scope, opts, NULL);
+}
+
+void
+ccnl_ndntlv_freeTemplate(struct ccnl_ndntlv_template_s *t)
+{
+    ccnl_free(t->buf);
+    t->buf = NULL;
+}
+
+// Name with the pre-encoded components and an optional segment
+static int8_t
+ccnl_ndntlv_prependTemplateName(struct ccnl_ndntlv_template_s *t,
+                                uint32_t *segnum,
+                                size_t *offset, uint8_t *buf)
+{
+    size_t oldoffset = *offset;
+
+    if (segnum && ccnl_ndntlv_prependIncludedNonNegInt(NDN_TLV_NameComponent,
+                                                       *segnum,
+                                                       NDN_Marker_SegmentNumber,
+                                                       offset, buf) < 0) {
+        return -1;
+    }
+    if (ccnl_ndntlv_prependBytes(t->buf, t->complen, offset, buf) < 0) {
+        return -1;
+    }
+    return ccnl_ndntlv_prependTL(NDN_TLV_Name, oldoffset - *offset,
+                                 offset, buf);
+}
+
+int8_t
+ccnl_ndntlv_fillContent(struct ccnl_ndntlv_template_s *t, uint32_t *segnum,
+                        uint8_t *payload, size_t paylen,
+                        size_t *offset, uint8_t *buf, size_t *reslen)
+{
+    size_t oldoffset = *offset;
+
+    if (t->type != NDN_TLV_Data ||
+        ccnl_ndntlv_prependBytes(t->buf + t->complen + t->metalen, t->taillen,
+                                 offset, buf) < 0 ||
+        *offset < paylen) {
+        return -1;
+    }
+    // payload read straight into place is not copied again
+    if (payload != buf + *offset - paylen) {
+        memmove(buf + *offset - paylen, payload, paylen);
+    }
+    *offset -= paylen;
+
+    if (ccnl_ndntlv_prependTL(NDN_TLV_Content, paylen, offset, buf) < 0 ||
+        ccnl_ndntlv_prependBytes(t->buf + t->complen, t->metalen,
+                                 offset, buf) < 0 ||
+        ccnl_ndntlv_prependTemplateName(t, segnum, offset, buf) < 0 ||
+        ccnl_ndntlv_prependTL(NDN_TLV_Data, oldoffset - *offset,
+                              offset, buf) < 0) {
+        return -1;
+    }
+
+    *reslen = oldoffset - *offset;
+    return 0;
+}
+
+int8_t
+ccnl_ndntlv_fillInterest(struct ccnl_ndntlv_template_s *t, uint32_t *segnum,
+                         int32_t nonce,
+                         size_t *offset, uint8_t *buf, size_t *reslen)
+{
+    size_t oldoffset = *offset;
+
+    if (t->type != NDN_TLV_Interest ||
+        ccnl_ndntlv_prependBytes(t->buf + t->complen + t->metalen, t->taillen,
+                                 offset, buf) < 0 ||
+        ccnl_ndntlv_prependNonNegInt(NDN_TLV_Nonce, (uint64_t) nonce,
+                                     offset, buf) < 0 ||
+        ccnl_ndntlv_prependBytes(t->buf + t->complen, t->metalen,
+                                 offset, buf) < 0 ||
+        ccnl_ndntlv_prependTemplateName(t, segnum, offset, buf) < 0 ||
+        ccnl_ndntlv_prependTL(NDN_TLV_Interest, oldoffset - *offset,
+                              offset, buf) < 0) {
+        return -1;
+    }
+
+    *reslen = oldoffset - *offset;
+    return 0;
+}
+
+int8_t
+ccnl_ndntlv_prependLpPacket(struct ccnl_ndntlv_lp_s *lp,
+                            size_t *offset, uint8_t *buf, size_t *reslen)
+{
+    size_t oldoffset = *offset, i;
+
+    if (lp->frag && ccnl_ndntlv_prependBlob(NDN_TLV_LpFragment, lp->frag,
+                                            lp->fraglen, offset, buf) < 0) {
+        return -1;
+    }
+    for (i = lp->ackcnt; i > 0; i--) {
+        if (ccnl_ndntlv_prependNonNegInt(NDN_TLV_LpAck, lp->acks[i-1],
+                                         offset, buf) < 0) {
+            return -1;
+        }
+    }
+    if (lp->congmark && ccnl_ndntlv_prependNonNegInt(NDN_TLV_LpCongestionMark,
+                                                     lp->congmark,
+                                                     offset, buf) < 0) {
+        return -1;
+    }
+    if (lp->has_txseq && ccnl_ndntlv_prependNonNegInt(NDN_TLV_LpTxSequence,
+                                                      lp->txseq,
+                                                      offset, buf) < 0) {
+        return -1;
+    }
+    if (ccnl_ndntlv_prependTL(NDN_TLV_LpPacket, oldoffset - *offset,
+                              offset, buf) < 0) {
+        return -1;
+    }
+
+    *reslen = oldoffset - *offset;
+    return 0;
+}
 
-// produces a full FRAG packet. It does not write, just read the fields in *fr
 struct ccnl_buf_s*
-ccnl_ndntlv_mkFrag(struct ccnl_frag_s *fr, unsigned int *consumed)
+ccnl_ndntlv_mkCongestionMark(struct ccnl_buf_s *buf)
 {
-    unsigned char test[20];
-    size_t offset, hdrlen;
-    long datalen;
-    struct ccnl_buf_s *buf;
-    uint16_t tmp = 0;
-
-    DEBUGMSG(TRACE, "ccnl_ndntlv_mkFrag seqno=%d\n", fr->sendseq);
-
-    // pre-compute overhead, first
-    datalen = fr->bigpkt->datalen - fr->sendoffs;
-    if (datalen > fr->mtu) {
-        datalen = fr->mtu;
-    }
-    offset = sizeof(test);
-    hdrlen = ccnl_ndntlv_prependTL(NDN_TLV_NdnlpFragment, datalen,
-                                   &offset, test);
-    hdrlen += ccnl_ndntlv_prependTL(NDN_TLV_Frag_BeginEndFields, 2,
-                                    &offset, test) + 2;
-    hdrlen += ccnl_ndntlv_prependTL(NDN_TLV_Fragment, hdrlen + datalen,
-                                    &offset, test);
-
-    // with real values:
-    datalen = fr->bigpkt->datalen - fr->sendoffs;
-    if (datalen > (fr->mtu - hdrlen)) {
-        datalen = fr->mtu - hdrlen;
-    }
-
-    buf = ccnl_buf_new(NULL, datalen + hdrlen);
-    if (!buf) {
-        return 0;
-    }
-    offset = buf->datalen - datalen;
-    memcpy(buf->data + offset,
-           fr->bigpkt->data + fr->sendoffs, datalen);
-    ccnl_ndntlv_prependTL(NDN_TLV_NdnlpFragment, datalen,
-                          &offset, buf->data);
-
-    tmp = fr->sendseq & 0x03fff;
-    if (datalen >= fr->bigpkt->datalen) {            // single
-        tmp |= CCNL_DTAG_FRAG_FLAG_SINGLE << 14;
-    } else if (fr->sendoffs == 0) {                  // start
-        tmp |= CCNL_DTAG_FRAG_FLAG_FIRST << 14;
-    } else if((unsigned) datalen >= (fr->bigpkt->datalen - fr->sendoffs)) { // end
-        tmp |= CCNL_DTAG_FRAG_FLAG_LAST << 14;
-    } else
-        tmp |= CCNL_DTAG_FRAG_FLAG_MID << 14;        // middle
-    offset -= 2;
-    *(uint16_t*) (buf->data + offset) = htons(tmp);
-    tmp = ccnl_ndntlv_prependTL(NDN_TLV_Frag_BeginEndFields, 2,
-                          &offset, buf->data);
-    tmp = ccnl_ndntlv_prependTL(NDN_TLV_Fragment, buf->datalen - offset,
-                          &offset, buf->data);
-
-    if (offset > 0) {
-        buf->datalen -= offset;
-        memmove(buf->data, buf->data + offset, buf->datalen);
-    }
-
-    *consumed = datalen;
-    return buf;
+    struct ccnl_ndntlv_lp_s lp;
+    struct ccnl_buf_s *marked;
+    uint8_t *data = buf->data;
+    size_t datalen = buf->datalen, len, offset;
+    uint64_t typ;
+
+    if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len)) {
+        return NULL;
+    }
+    if (typ == NDN_TLV_LpPacket) {
+        if (ccnl_ndntlv_parseLpPacket(data, len, &lp) || !lp.frag ||
+            !lp.fraglen || lp.frag[0] != NDN_TLV_Data) {
+            return NULL;
+        }
+    } else if (typ == NDN_TLV_Data) {
+        memset(&lp, 0, sizeof(lp));
+        lp.frag = buf->data;
+        lp.fraglen = buf->datalen;
+    } else {
+        return NULL;
+    }
+    lp.congmark = 1;
+
+    // worst case LpPacket overhead: TL, TxSequence, Acks, mark, Fragment TL
+    marked = ccnl_buf_new(NULL, lp.fraglen + 40 + NDN_LP_MAX_ACKS * 14);
+    if (!marked) {
+        return NULL;
+    }
+    offset = marked->datalen;
+    if (ccnl_ndntlv_prependLpPacket(&lp, &offset, marked->data, &len)) {
+        ccnl_free(marked);
+        return NULL;
+    }
+    memmove(marked->data, marked->data + offset, len);
+    marked->datalen = len;
+    return marked;
+}
+
+#ifdef USE_FRAG
+
+// produces the header of the next FRAG packet, the payload follows it
+// as is. It does not write, just read the fields in *fr
+int8_t
+ccnl_ndntlv_mkFragHdr(struct ccnl_frag_s *fr, uint8_t *hdr,
+                      size_t *hdrlen, size_t *datalen)
+{
+    uint8_t tmp[CCNL_FRAG_HDRMAX];
+    size_t offset, len, left = fr->bigpkt->datalen - fr->sendoffs;
+    uint16_t fields;
+
+    DEBUGMSG(TRACE, "ccnl_ndntlv_mkFragHdr seqno=%u\n", fr->sendseq);
+
+    // the TL lengths depend on the payload size: shrink until it fits
+    *datalen = left < (size_t) fr->mtu ? left : (size_t) fr->mtu;
+    for (;;) {
+        offset = sizeof(tmp);
+        if (ccnl_ndntlv_prependTL(NDN_TLV_NdnlpFragment, *datalen,
+                                  &offset, tmp) < 0) {
+            return -1;
+        }
+        fields = htons(ccnl_frag_BEfields(fr, *datalen));
+        offset -= 2;
+        memcpy(tmp + offset, &fields, 2);
+        if (ccnl_ndntlv_prependTL(NDN_TLV_Frag_BeginEndFields, 2,
+                                  &offset, tmp) < 0) {
+            return -1;
+        }
+        len = sizeof(tmp) - offset;
+        if (ccnl_ndntlv_prependTL(NDN_TLV_Fragment, len + *datalen,
+                                  &offset, tmp) < 0) {
+            return -1;
+        }
+        len = sizeof(tmp) - offset;
+        if (len + *datalen <= (size_t) fr->mtu) {
+            break;
+        }
+        if (len >= (size_t) fr->mtu) {
+            return -1;
+        }
+        *datalen = fr->mtu - len;
+    }
+
+    memcpy(hdr, tmp + offset, len);
+    *hdrlen = len;
+    return 0;
 }
 #endif // USE_FRAG
 
@@ -28,6 +28,7 @@
 #include <sys/types.h>
 #include <inttypes.h>
 #include <limits.h>
+#include <signal.h>
 
 #ifdef USE_HTTP_STATUS
 #include "ccnl-http-status.h"
@@ -37,6 +38,19 @@
 #include "ccnl-core.h"
 
 #include "ccnl-dispatch.h"
+#include "ccnl-mmap-producer.h"
+#include "ccnl-archive.h"
+#include "ccnl-snapshot.h"
+#include "ccnl-producer.h"
+
+#ifdef USE_HMAC256
+#include "ccnl-ext-hmac.h"
+#include "base64.h"
+#endif
+#ifdef USE_VERIFY_POOL
+#include "ccnl-verify.h"
+#include "ccnl-fwd.h"
+#endif
 
 /*
 
@@ -109,6 +123,9 @@ const char *compile_string = ""
 #ifdef USE_KITE
         "KITE, "
 #endif
+#ifdef USE_LINKREL
+        "LINKREL, "
+#endif
 #ifdef USE_LOGGING
         "LOGGING, "
 #endif
@@ -124,6 +141,9 @@ const char *compile_string = ""
 #ifdef USE_SUITE_CCNB
         "SUITE_CCNB, "
 #endif
+#ifdef CCNL_SUITE_FIXED
+        "SUITE_FIXED, "
+#endif
 #ifdef USE_SUITE_CCNTLV
         "SUITE_CCNTLV, "
 #endif
@@ -135,6 +155,9 @@ const char *compile_string = ""
 #endif
 #ifdef USE_UNIXSOCKET
         "UNIXSOCKET, "
+#endif
+#ifdef USE_VERIFY_POOL
+        "VERIFY_POOL, "
 #endif
         ;
 
@@ -142,10 +165,161 @@ const char *compile_string = ""
 
 // ----------------------------------------------------------------------
 
+#ifdef USE_HMAC256
+// the first key of a file as written for ccn-lite-mkC -k (base64)
+static int
+ccnl_relay_readkey(const char *keyfile, uint8_t *keyval, uint8_t *keyid)
+{
+    uint8_t *key;
+    char line[256];
+    size_t len, keylen;
+    FILE *fp = fopen(keyfile, "r");
+
+    if (!fp) {
+        DEBUGMSG(ERROR, "could not open key file %s\n", keyfile);
+        return -1;
+    }
+    if (!fgets(line, sizeof(line), fp)) {
+        line[0] = '\0';
+    }
+    fclose(fp);
+    len = strcspn(line, "\r\n");
+    key = base64_decode(line, len, &keylen);
+    if (!key || !keylen) {
+        DEBUGMSG(ERROR, "no HMAC key in %s\n", keyfile);
+        free(key);
+        return -1;
+    }
+    ccnl_hmac256_keyval(key, keylen, keyval);
+    ccnl_hmac256_keyid(key, keylen, keyid);
+    free(key);
+    return 0;
+}
+#endif
+
+// routes of a route file (-R), see ccnl_fib_add_routes()
+static int
+ccnl_relay_loadRoutes(struct ccnl_relay_s *relay, const char *path, int suite)
+{
+    FILE *fp = fopen(path, "r");
+    char *routes;
+    long size;
+    int added, lineno;
+
+    if (!fp) {
+        DEBUGMSG(ERROR, "could not open route file %s\n", path);
+        return -1;
+    }
+    if (fseek(fp, 0L, SEEK_END) || (size = ftell(fp)) < 0 ||
+        fseek(fp, 0L, SEEK_SET)) {
+        fclose(fp);
+        return -1;
+    }
+    routes = (char*) malloc((size_t) size + 1);
+    if (!routes || fread(routes, 1, (size_t) size, fp) != (size_t) size) {
+        DEBUGMSG(ERROR, "could not read route file %s\n", path);
+        free(routes);
+        fclose(fp);
+        return -1;
+    }
+    fclose(fp);
+    routes[size] = '\0';
+
+    added = ccnl_fib_add_routes(relay, suite, routes, &lineno);
+    free(routes);
+    if (added < 0) {
+        DEBUGMSG(ERROR, "route file %s: error at line %d\n", path, lineno);
+        return -1;
+    }
+    DEBUGMSG(INFO, "%d routes from %s\n", added, path);
+    return 0;
+}
+
+// ----------------------------------------------------------------------
+// warm restart (-S): SIGTERM and SIGINT halt the relay, which then writes
+// the snapshot; SIGUSR1 writes one and keeps running
+
+static const char *snapshot_path;
+static volatile sig_atomic_t snapshot_requested;
+
+static void
+ccnl_relay_sighalt(int sig)
+{
+    (void) sig;
+    ccnl_io_halt = 1; // the interrupted select() lets the loop see it
+}
+
+static void
+ccnl_relay_sigsnapshot(int sig)
+{
+    (void) sig;
+    snapshot_requested = 1;
+}
+
+// polls for SIGUSR1, the handler itself cannot write
+static void
+ccnl_relay_snapshotTimer(void *relay, void *aux)
+{
+    (void) aux;
+    if (snapshot_requested) {
+        snapshot_requested = 0;
+        ccnl_snapshot_write((struct ccnl_relay_s*) relay, snapshot_path);
+    }
+    ccnl_set_timer(CCNL_SNAPSHOT_POLL, ccnl_relay_snapshotTimer, relay, NULL);
+}
+
+static void
+ccnl_relay_snapshot_setup(struct ccnl_relay_s *relay, const char *path)
+{
+    struct sigaction sa;
+
+    snapshot_path = path;
+    ccnl_snapshot_restore(relay, path);
+
+    memset(&sa, 0, sizeof(sa));
+    sigemptyset(&sa.sa_mask);
+    sa.sa_handler = ccnl_relay_sighalt;
+    sigaction(SIGTERM, &sa, NULL);
+    sigaction(SIGINT, &sa, NULL);
+    sa.sa_handler = ccnl_relay_sigsnapshot;
+    sigaction(SIGUSR1, &sa, NULL);
+    ccnl_set_timer(CCNL_SNAPSHOT_POLL, ccnl_relay_snapshotTimer, relay, NULL);
+}
+
+// answers from the files of -f and the archives of -a
+static int
+ccnl_relay_localProducer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                         struct ccnl_pkt_s *pkt)
+{
+    return ccnl_mmap_producer(relay, from, pkt) ||
+           ccnl_archive_producer(relay, from, pkt);
+}
+
+#ifdef USE_VERIFY_POOL
+static struct ccnl_hmac256_key_s verify_key;
+
+static struct ccnl_verify_s*
+ccnl_relay_verify_setup(const char *keyfile, int nthreads)
+{
+    uint8_t keyval[64], keyid[32];
+
+    if (ccnl_relay_readkey(keyfile, keyval, keyid)) {
+        return NULL;
+    }
+    ccnl_hmac256_keyinit(&verify_key, keyval, sizeof(keyval));
+    // the workers hash concurrently, detect the kernels before they start
+    ccnl_SHA256_setLevel(-1);
+
+    return ccnl_verify_new(nthreads, CCNL_VERIFY_BATCH,
+                           ccnl_hmac256_verifyBatch, &verify_key, keyid,
+                           ccnl_fwd_contentVerified);
+}
+#endif
+
 int
 main(int argc, char **argv)
 {
-    int opt, max_cache_entries = -1, httpport = -1;
+    int opt, max_cache_entries = -1, httpport = -1, irate = 0;
     int udpport1 = -1, udpport2 = -1;
     int udp6port1 = -1, udp6port2 = -1;
     char *datadir = NULL, *ethdev = NULL, *crypto_sock_path = NULL;
@@ -160,6 +334,17 @@ main(int argc, char **argv)
 #ifdef USE_ECHO
     char *echopfx = NULL;
 #endif
+#ifdef USE_VERIFY_POOL
+    char *keyfile = NULL;
+    int verify_threads = 2;
+    bool accept_unsigned = false;
+#endif
+    char *files[16], *archivefiles[16], *snapshotfile = NULL, *routefile = NULL;
+    int filecnt = 0, archivecnt = 0, i;
+#ifdef USE_HMAC256
+    char *signkeyfile = NULL;
+    uint8_t signkeyval[64], signkeyid[32];
+#endif
 
     time(&theRelay->startup_time);
     unsigned int seed = time(NULL) * getpid();
@@ -169,8 +354,14 @@ main(int argc, char **argv)
     srandom(seed);
 #endif
 
-    while ((opt = getopt(argc, argv, "hc:d:e:g:i:o:p:s:t:u:6:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "ha:c:d:e:f:g:i:j:k:o:p:r:s:t:u:6:v:w:x:K:R:S:U")) != -1) {
         switch (opt) {
+        case 'a':
+            if (archivecnt >= (int) (sizeof(archivefiles) / sizeof(archivefiles[0]))) {
+                goto usage;
+            }
+            archivefiles[archivecnt++] = optarg;
+            break;
         case 'c': {
             long max_cache_entries_l;
             errno = 0;
@@ -187,6 +378,13 @@ main(int argc, char **argv)
         case 'e':
             ethdev = optarg;
             break;
+        case 'f':
+            if (filecnt >= (int) (sizeof(files) / sizeof(files[0])) ||
+                !strchr(optarg, '=')) {
+                goto usage;
+            }
+            files[filecnt++] = optarg;
+            break;
         case 'g': {
             long inter_pkt_interval_l;
             errno = 0;
@@ -207,6 +405,29 @@ main(int argc, char **argv)
             inter_ccn_interval = (int) inter_ccn_interval_l;
             break;
         }
+#ifdef USE_VERIFY_POOL
+        case 'j': {
+            long threads_l;
+            errno = 0;
+            threads_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || threads_l < 0 || threads_l > CCNL_VERIFY_MAX_THREADS) {
+                goto usage;
+            }
+            verify_threads = (int) threads_l;
+            break;
+        }
+        case 'k':
+            keyfile = optarg;
+            break;
+        case 'U':
+            accept_unsigned = true;
+            break;
+#endif
+#ifdef USE_HMAC256
+        case 'K':
+            signkeyfile = optarg;
+            break;
+#endif
 #ifdef USE_ECHO
         case 'o':
             echopfx = optarg;
@@ -215,11 +436,27 @@ main(int argc, char **argv)
         case 'p':
             crypto_sock_path = optarg;
             break;
+        case 'r': {
+            long irate_l;
+            errno = 0;
+            irate_l = strtol(optarg, (char **) NULL, 10);
+            if (errno || irate_l < 0 || irate_l > INT_MAX) {
+                goto usage;
+            }
+            irate = (int) irate_l;
+            break;
+        }
+        case 'R':
+            routefile = optarg;
+            break;
         case 's':
             suite = ccnl_str2suite(optarg);
             if (!ccnl_isSuite(suite))
                 goto usage;
             break;
+        case 'S':
+            snapshotfile = optarg;
+            break;
         case 't': {
             long httpport_l;
             errno = 0;
@@ -296,19 +533,34 @@ main(int argc, char **argv)
 usage:
             fprintf(stderr,
                     "usage: %s [options]\n"
+                    "  -a ARCHIVE  serve the packets of a ccn-lite-archive file (repeatable)\n"
                     "  -c MAX_CONTENT_ENTRIES\n"
                     "  -d databasedir\n"
                     "  -e ethdev\n"
+                    "  -f URI=FILE serve FILE in chunks under URI (repeatable)\n"
                     "  -g MIN_INTER_PACKET_INTERVAL\n"
                     "  -h\n"
                     "  -i MIN_INTER_CCNMSG_INTERVAL\n"
+#ifdef USE_VERIFY_POOL
+                    "  -j VERIFY_THREADS (default 2, 0: verify inline)\n"
+                    "  -k FNAME    HMAC256 key (base64), verifies received Data\n"
+#endif
+#ifdef USE_HMAC256
+                    "  -K FNAME    HMAC256 key (base64), signs the chunks of -f\n"
+#endif
 #ifdef USE_ECHO
                     "  -o echo_prefix\n"
 #endif
                     "  -p crypto_face_ux_socket\n"
+                    "  -r MAX_INTERESTS_PER_SEC per face (0: unlimited)\n"
+                    "  -R FNAME    add the routes of a route file\n"
                     "  -s SUITE (ccnb, ccnx2015, ndn2013)\n"
+                    "  -S FNAME    keep cache and routes in FNAME across restarts\n"
                     "  -t tcpport (for HTML status page)\n"
                     "  -u udpport (can be specified twice)\n"
+#ifdef USE_VERIFY_POOL
+                    "  -U          with -k, pass on Data that is not signed\n"
+#endif
                     "  -6 udp6port (can be specified twice)\n"
 
 #ifdef USE_LOGGING
@@ -346,9 +598,48 @@ usage:
     ccnl_relay_config(theRelay, ethdev, wpandev, udpport1, udpport2,
                       udp6port1, udp6port2, httpport,
                       uxpath, suite, max_cache_entries, crypto_sock_path);
+    theRelay->face_irate = irate;
+#ifdef USE_VERIFY_POOL
+    if (keyfile) {
+        theRelay->verify = ccnl_relay_verify_setup(keyfile, verify_threads);
+        if (!theRelay->verify) {
+            exit(EXIT_FAILURE);
+        }
+        theRelay->verify->accept_unsigned = accept_unsigned;
+    }
+#endif
     if (datadir) {
         ccnl_populate_cache(theRelay, datadir);
     }
+#ifdef USE_HMAC256
+    if (signkeyfile && ccnl_relay_readkey(signkeyfile, signkeyval, signkeyid)) {
+        exit(EXIT_FAILURE);
+    }
+#endif
+    for (i = 0; i < filecnt; i++) {
+        char *path = strchr(files[i], '=');
+        uint8_t *keyval = NULL, *keyid = NULL;
+
+        *path++ = '\0';
+#ifdef USE_HMAC256
+        if (signkeyfile) {
+            keyval = signkeyval;
+            keyid = signkeyid;
+        }
+#endif
+        if (ccnl_mmap_producer_add(files[i], suite, path, CCNL_MMAP_CHUNK_SIZE,
+                                   keyval, keyid)) {
+            exit(EXIT_FAILURE);
+        }
+    }
+    for (i = 0; i < archivecnt; i++) {
+        if (ccnl_archive_add(archivefiles[i])) {
+            exit(EXIT_FAILURE);
+        }
+    }
+    if (filecnt || archivecnt) {
+        ccnl_set_local_producer(ccnl_relay_localProducer);
+    }
 
 #ifdef USE_ECHO
     if (echopfx) {
@@ -362,12 +653,24 @@ usage:
     }
 #endif
 
+    if (snapshotfile) {
+        ccnl_relay_snapshot_setup(theRelay, snapshotfile);
+    }
+    if (routefile && ccnl_relay_loadRoutes(theRelay, routefile, suite)) {
+        exit(EXIT_FAILURE);
+    }
+
     ccnl_io_loop(theRelay);
 
+    if (snapshotfile) {
+        ccnl_snapshot_write(theRelay, snapshotfile);
+    }
     while (eventqueue) {
         ccnl_rem_timer(eventqueue);
     }
 
+    ccnl_mmap_producer_cleanup();
+    ccnl_archive_cleanup();
     ccnl_core_cleanup(theRelay);
 #ifdef USE_HTTP_STATUS
     theRelay->http = ccnl_http_cleanup(theRelay->http);
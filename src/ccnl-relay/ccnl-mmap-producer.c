@@ -0,0 +1,305 @@
+/*
+ * @f ccnl-mmap-producer.c
+ * @b serves the chunks of a file straight out of a read-only mapping
+ *
+ * Copyright (C) 2011-18, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#define _DEFAULT_SOURCE     // posix_madvise()
+
+#include "ccnl-mmap-producer.h"
+
+#include <fcntl.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-ccntlv.h"
+#ifdef USE_HMAC256
+#include "ccnl-ext-hmac.h"
+#endif
+
+struct ccnl_mmap_chunk_s {
+    uint32_t chunknum;
+    struct ccnl_buf_s *buf;         // the encoded packet, NULL if unused
+};
+
+struct ccnl_mmap_producer_s {
+    struct ccnl_mmap_producer_s *next;
+    struct ccnl_prefix_s *prefix;   // stream name, without chunk number
+    int suite;
+    uint8_t *map;                   // the file, read-only
+    size_t size, chunk_size;
+    uint32_t last;                  // final chunk number
+#ifdef USE_SUITE_NDNTLV
+    struct ccnl_ndntlv_template_s tmpl; // unsigned NDN chunks
+#endif
+    int sign;
+    uint8_t keyval[64], keyid[32];
+    struct ccnl_mmap_chunk_s cache[CCNL_MMAP_CACHE_SIZE];
+    unsigned long served, encoded;
+};
+
+static struct ccnl_mmap_producer_s *producers;
+
+static struct ccnl_buf_s*
+ccnl_mmap_encode(struct ccnl_mmap_producer_s *p, uint32_t chunknum);
+
+int
+ccnl_mmap_producer_add(const char *uri, int suite, const char *path,
+                       size_t chunk_size, uint8_t *keyval, uint8_t *keyid)
+{
+    struct ccnl_mmap_producer_s *p;
+    struct stat st;
+    char *dup;
+    int fd;
+
+    switch (suite) {
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+#endif
+        break;
+    default:
+        DEBUGMSG(ERROR, "mmap producer: unsupported suite %d\n", suite);
+        return -1;
+    }
+    if (!chunk_size || chunk_size >= CCNL_MAX_PACKET_SIZE) {
+        DEBUGMSG(ERROR, "mmap producer: invalid chunk size %zu\n", chunk_size);
+        return -1;
+    }
+    p = (struct ccnl_mmap_producer_s*) ccnl_calloc(1, sizeof(*p));
+    if (!p) {
+        return -1;
+    }
+    dup = ccnl_strdup(uri);
+    p->prefix = dup ? ccnl_URItoPrefix(dup, suite, NULL) : NULL;
+    ccnl_free(dup);
+    if (!p->prefix) {
+        DEBUGMSG(ERROR, "mmap producer: invalid name %s\n", uri);
+        goto Bail;
+    }
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0 || st.st_size <= 0) {
+        DEBUGMSG(ERROR, "mmap producer: cannot open %s or it is empty\n", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        goto Bail;
+    }
+    p->size = (size_t) st.st_size;
+    p->map = (uint8_t*) mmap(NULL, p->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd); // the mapping keeps the file
+    if (p->map == MAP_FAILED) {
+        DEBUGMSG(ERROR, "mmap producer: cannot map %s\n", path);
+        p->map = NULL;
+        goto Bail;
+    }
+    // most consumers fetch in order, let the kernel read ahead
+    posix_madvise(p->map, p->size, POSIX_MADV_SEQUENTIAL);
+
+    p->suite = suite;
+    p->chunk_size = chunk_size;
+    p->last = (uint32_t) ((p->size - 1) / chunk_size);
+    if (keyval) {
+        p->sign = 1;
+        memcpy(p->keyval, keyval, sizeof(p->keyval));
+        if (keyid) {
+            memcpy(p->keyid, keyid, sizeof(p->keyid));
+        }
+    }
+#ifdef USE_SUITE_NDNTLV
+    if (suite == CCNL_SUITE_NDNTLV && !p->sign) {
+        struct ccnl_ndntlv_data_opts_s opts;
+
+        memset(&opts, 0, sizeof(opts));
+        opts.finalblockid = p->last;
+        if (ccnl_ndntlv_mkContentTemplate(&p->tmpl, p->prefix, &opts)) {
+            goto Bail;
+        }
+    }
+#endif
+    // a full chunk must fit into a packet
+    p->cache[0].buf = ccnl_mmap_encode(p, 0);
+    if (!p->cache[0].buf) {
+        goto Bail;
+    }
+
+    p->next = producers;
+    producers = p;
+    DEBUGMSG(INFO, "mmap producer: %s as %s, %zu bytes in %lu chunks%s\n",
+             path, uri, p->size, (unsigned long) p->last + 1,
+             p->sign ? ", signed" : "");
+    return 0;
+
+Bail:
+#ifdef USE_SUITE_NDNTLV
+    ccnl_ndntlv_freeTemplate(&p->tmpl);
+#endif
+    if (p->map) {
+        munmap(p->map, p->size);
+    }
+    ccnl_prefix_free(p->prefix);
+    ccnl_free(p);
+    return -1;
+}
+
+// encodes a chunk into a new buffer
+static struct ccnl_buf_s*
+ccnl_mmap_encode(struct ccnl_mmap_producer_s *p, uint32_t chunknum)
+{
+    static uint8_t out[CCNL_MAX_PACKET_SIZE];
+    size_t offs = sizeof(out), len = 0, start, paylen;
+    uint32_t cn = chunknum, last = p->last, *old = p->prefix->chunknum;
+    uint8_t *payload;
+    int8_t rc = -1;
+
+    start = (size_t) chunknum * p->chunk_size;
+    payload = p->map + start;
+    paylen = p->size - start < p->chunk_size ? p->size - start : p->chunk_size;
+
+    p->prefix->chunknum = &cn;
+    switch (p->suite) {
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+#ifdef USE_HMAC256
+        if (p->sign) {
+            rc = ccnl_ndntlv_prependSignedContent(p->prefix, payload, paylen,
+                                                  &last, NULL, p->keyval,
+                                                  p->keyid, &offs, out, &len);
+            break;
+        }
+#endif
+        rc = ccnl_ndntlv_fillContent(&p->tmpl, &cn, payload, paylen,
+                                     &offs, out, &len);
+        break;
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+#ifdef USE_HMAC256
+        if (p->sign) {
+            rc = ccnl_ccntlv_prependSignedContentWithHdr(p->prefix, payload,
+                                                 paylen, &last, NULL,
+                                                 p->keyval, p->keyid,
+                                                 &offs, out, &len);
+            break;
+        }
+#endif
+        rc = ccnl_ccntlv_prependContentWithHdr(p->prefix, payload, paylen,
+                                               &last, NULL, &offs, out, &len);
+        break;
+#endif
+    default:
+        break;
+    }
+    p->prefix->chunknum = old;
+    (void) last;
+
+    if (rc) {
+        DEBUGMSG(WARNING, "mmap producer: could not encode chunk %u\n",
+                 chunknum);
+        return NULL;
+    }
+    p->encoded++;
+    return ccnl_buf_new(out + offs, len);
+}
+
+// the chunk an Interest asks for, -1 if it is not for this stream
+static int64_t
+ccnl_mmap_match(struct ccnl_mmap_producer_s *p, struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_prefix_s *pfx = pkt->pfx;
+    uint32_t chunknum = pfx->chunknum ? *pfx->chunknum : 0;
+
+    if (pkt->suite != p->suite ||
+        pfx->compcnt != p->prefix->compcnt + (pfx->chunknum ? 1 : 0) ||
+        ccnl_prefix_cmp(p->prefix, NULL, pfx, CMP_MATCH) !=
+                                            (int32_t) p->prefix->compcnt ||
+        chunknum > p->last) {
+        return -1;
+    }
+    return chunknum;
+}
+
+int
+ccnl_mmap_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                   struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_mmap_producer_s *p;
+    struct ccnl_mmap_chunk_s *slot;
+    int64_t chunknum = -1;
+
+    if (!from || !pkt->pfx) {
+        return 0;
+    }
+    for (p = producers; p; p = p->next) {
+        chunknum = ccnl_mmap_match(p, pkt);
+        if (chunknum >= 0) {
+            break;
+        }
+    }
+    if (!p) {
+        return 0;
+    }
+
+    slot = p->cache + (chunknum & (CCNL_MMAP_CACHE_SIZE - 1));
+    if (!slot->buf || slot->chunknum != (uint32_t) chunknum) {
+        struct ccnl_buf_s *buf = ccnl_mmap_encode(p, (uint32_t) chunknum);
+        if (!buf) {
+            return 0;
+        }
+        ccnl_free(slot->buf);
+        slot->buf = buf;
+        slot->chunknum = (uint32_t) chunknum;
+    }
+    p->served++;
+    DEBUGMSG(DEBUG, "mmap producer: chunk %ld to face %d\n",
+             (long) chunknum, from->faceid);
+    ccnl_face_enqueue(relay, from, buf_dup(slot->buf));
+    return 1;
+}
+
+void
+ccnl_mmap_producer_cleanup(void)
+{
+    struct ccnl_mmap_producer_s *p;
+    int i;
+
+    while (producers) {
+        p = producers;
+        producers = p->next;
+        DEBUGMSG(INFO, "mmap producer: %lu chunks served, %lu encoded\n",
+                 p->served, p->encoded);
+        for (i = 0; i < CCNL_MMAP_CACHE_SIZE; i++) {
+            ccnl_free(p->cache[i].buf);
+        }
+#ifdef USE_SUITE_NDNTLV
+        ccnl_ndntlv_freeTemplate(&p->tmpl);
+#endif
+        munmap(p->map, p->size);
+        ccnl_prefix_free(p->prefix);
+        ccnl_free(p);
+    }
+}
+
+// eof
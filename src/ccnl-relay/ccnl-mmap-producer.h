@@ -0,0 +1,76 @@
+/*
+ * @f ccnl-mmap-producer.h
+ * @b serves the chunks of a file straight out of a read-only mapping
+ *
+ * Copyright (C) 2011-18, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#ifndef CCNL_MMAP_PRODUCER_H
+#define CCNL_MMAP_PRODUCER_H
+
+#include "ccnl-core.h"
+
+#ifndef CCNL_MMAP_CHUNK_SIZE
+#define CCNL_MMAP_CHUNK_SIZE    4096    // payload bytes per chunk
+#endif
+
+#ifndef CCNL_MMAP_CACHE_SIZE
+#define CCNL_MMAP_CACHE_SIZE    64      // encoded chunks kept per file, 2^n
+#endif
+
+/**
+ * @brief Publishes a file as the chunk stream \p uri
+ *
+ * The file is mapped read-only. An Interest for \p uri plus a chunk number
+ * (or for \p uri alone, which gets chunk 0) is answered by the relay
+ * itself: the chunk is encoded, and signed if \p keyval is given, when it
+ * is first asked for. The last CCNL_MMAP_CACHE_SIZE encoded chunks are
+ * kept. Nothing is written to disk or put into the content store.
+ * ccnl_mmap_producer() has to be called from the local producer.
+ *
+ * @param[in] uri        name of the stream, without a chunk number
+ * @param[in] suite      packet format of the chunks (NDNTLV or CCNTLV)
+ * @param[in] path       the file to publish, must not be empty
+ * @param[in] chunk_size payload bytes per chunk
+ * @param[in] keyval     HMAC256 key value (64 bytes) to sign the chunks
+ *                       with, NULL for unsigned chunks
+ * @param[in] keyid      digest of the key (32 bytes), may be NULL
+ *
+ * @return 0 on success, -1 if the file cannot be mapped or the name not
+ *         parsed
+ */
+int
+ccnl_mmap_producer_add(const char *uri, int suite, const char *path,
+                       size_t chunk_size, uint8_t *keyval, uint8_t *keyid);
+
+/**
+ * @brief The \ref ccnl_producer_func serving the published files
+ *
+ * @return 1 if the Interest was answered, 0 if it is left to the relay
+ */
+int
+ccnl_mmap_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                   struct ccnl_pkt_s *pkt);
+
+/**
+ * @brief Unmaps all published files and frees the cached chunks
+ */
+void
+ccnl_mmap_producer_cleanup(void);
+
+#endif // CCNL_MMAP_PRODUCER_H
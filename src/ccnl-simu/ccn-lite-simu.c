@@ -0,0 +1,488 @@
+/*
+ * @f ccn-lite-simu.c
+ * @b prog with multiple CCNL relays, running a standalone simulation
+ *
+ * Copyright (C) 2011-13, Christian Tschudin, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2011-11-22 created
+ * 2011-12 simulation scenario and logging support s.braun@stud.unibas.ch
+ * 2013-03-19 updated (ms): replacement code after renaming the field
+ *              ccnl_relay_s.client to ccnl_relay_s.aux
+ * 2014-12-18 removed log generation (cft)
+ * 2026-10-19 topology, routes and workloads from a configuration file,
+ *              virtual time, per-node statistics
+ */
+
+/*
+ * The configuration is read line by line, '#' starts a comment. Nodes
+ * are created by their first "node" or "link" line. Durations are in
+ * seconds unless noted.
+ *
+ *   suite    SUITE                 ndn2013 (default) or ccnx2015, first
+ *   node     NAME [cache=ENTRIES]  -1: unlimited, 0: no caching
+ *   link     NODE NODE [delay=MS] [bw=MBIT/S] [loss=PERCENT] [queue=PKTS]
+ *                                  both directions, bw 0 is unlimited
+ *   route    NODE PREFIX NEXTHOP   a FIB entry towards a neighbour
+ *   routes   PREFIX NODE           routes to NODE on all other nodes,
+ *                                  along the paths with fewest hops
+ *   producer NODE PREFIX [size=BYTES]
+ *   consumer NODE PREFIX [rate=PER_S] [names=N] [alpha=A] [order=zipf|seq]
+ *                        [arrivals=poisson|constant] [start=S] [stop=S]
+ *                        [timeout=S]
+ *
+ * A consumer requests PREFIX/0 .. PREFIX/N-1, by Zipf popularity or in
+ * turn. A request for a name that is still pending is not sent again.
+ */
+
+#define _DEFAULT_SOURCE     // strdup()
+
+#include <ctype.h>
+#include <errno.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ccnl-simu.h"
+#include "ccnl-dispatch.h"
+
+#define SIMU_LINELEN        1024
+#define SIMU_MAXARGS        16
+
+// defaults
+#define SIMU_CACHE          1000
+#define SIMU_DELAY          1           // ms
+#define SIMU_QUEUE          100         // packets
+#define SIMU_SIZE           1024        // bytes
+#define SIMU_RATE           100
+#define SIMU_NAMES          10000
+#define SIMU_TIMEOUT        4
+
+static struct simu_node_s **byname;    // hash table over the node names
+static size_t bynamemask;
+
+static const char *cfgfile;
+static int cfgline;
+
+static void
+simu_error(const char *msg, const char *arg)
+{
+    fprintf(stderr, "%s:%d: %s%s%s\n", cfgfile, cfgline, msg,
+            arg ? " " : "", arg ? arg : "");
+    exit(1);
+}
+
+static size_t
+simu_strhash(const char *s)
+{
+    size_t h = 5381;
+
+    while (*s) {
+        h = h * 33 + (unsigned char) *s++;
+    }
+    return h;
+}
+
+static struct simu_node_s*
+simu_lookup(const char *name)
+{
+    size_t i;
+
+    if (!byname) {
+        return NULL;
+    }
+    for (i = simu_strhash(name) & bynamemask; byname[i];
+         i = (i + 1) & bynamemask) {
+        if (!strcmp(byname[i]->name, name)) {
+            return byname[i];
+        }
+    }
+    return NULL;
+}
+
+static void
+simu_index(struct simu_node_s *n)
+{
+    size_t i;
+
+    if (2 * (size_t) simu.nodecnt > bynamemask) {
+        size_t size = byname ? 2 * (bynamemask + 1) : 1024;
+        int k;
+
+        free(byname);
+        byname = calloc(size, sizeof(*byname));
+        if (!byname) {
+            simu_error("out of memory", NULL);
+        }
+        bynamemask = size - 1;
+        for (k = 0; k < simu.nodecnt; k++) {
+            if (simu.nodes[k] != n) {
+                simu_index(simu.nodes[k]);
+            }
+        }
+    }
+    for (i = simu_strhash(n->name) & bynamemask; byname[i];
+         i = (i + 1) & bynamemask);
+    byname[i] = n;
+}
+
+static struct simu_node_s*
+simu_node(const char *name, int create)
+{
+    struct simu_node_s *n = simu_lookup(name);
+
+    if (!n && create) {
+        n = simu_node_add(name, simu.cache);
+        if (!n) {
+            simu_error("out of memory", NULL);
+        }
+        simu_index(n);
+    }
+    if (!n) {
+        simu_error("unknown node", name);
+    }
+    return n;
+}
+
+// "key=value" options after the positional arguments
+static char*
+simu_opt(char **argv, int argc, int first, const char *key)
+{
+    size_t len = strlen(key);
+    int i;
+
+    for (i = first; i < argc; i++) {
+        if (!strncmp(argv[i], key, len) && argv[i][len] == '=') {
+            argv[i][0] = '\0';  // consumed
+            return argv[i] + len + 1;
+        }
+    }
+    return NULL;
+}
+
+static double
+simu_num(char *s, double dflt, double min, double max)
+{
+    char *end;
+    double d;
+
+    if (!s) {
+        return dflt;
+    }
+    errno = 0;
+    d = strtod(s, &end);
+    if (errno || end == s || *end || d < min || d > max) {
+        simu_error("invalid value", s);
+    }
+    return d;
+}
+
+static void
+simu_unused(char **argv, int argc, int first)
+{
+    int i;
+
+    for (i = first; i < argc; i++) {
+        if (argv[i][0]) {
+            simu_error("unknown option", argv[i]);
+        }
+    }
+}
+
+static void
+simu_directive(char **argv, int argc, uint64_t duration)
+{
+    struct simu_node_s *n;
+
+    if (!strcmp(argv[0], "suite") && argc == 2) {
+        int suite = ccnl_str2suite(argv[1]);
+
+        if (simu.nodecnt) {
+            simu_error("suite must come first", NULL);
+        }
+        if (suite != CCNL_SUITE_NDNTLV && suite != CCNL_SUITE_CCNTLV) {
+            simu_error("unsupported suite", argv[1]);
+        }
+        simu.suite = suite;
+    } else if (!strcmp(argv[0], "node") && argc >= 2) {
+        if (simu_lookup(argv[1])) {
+            simu_error("duplicate node", argv[1]);
+        }
+        n = simu_node(argv[1], 1);
+        n->relay->max_cache_entries = (int) simu_num(
+            simu_opt(argv, argc, 2, "cache"), simu.cache, -1, 1e9);
+        simu_unused(argv, argc, 2);
+    } else if (!strcmp(argv[0], "link") && argc >= 3) {
+        struct simu_node_s *a = simu_node(argv[1], 1);
+        struct simu_node_s *b = simu_node(argv[2], 1);
+        double delay = simu_num(simu_opt(argv, argc, 3, "delay"),
+                                SIMU_DELAY, 0, 1e9);
+        double bw = simu_num(simu_opt(argv, argc, 3, "bw"), 0, 0, 1e9);
+        double loss = simu_num(simu_opt(argv, argc, 3, "loss"), 0, 0, 100);
+        double queue = simu_num(simu_opt(argv, argc, 3, "queue"),
+                                SIMU_QUEUE, 1, 1e7);
+
+        simu_unused(argv, argc, 3);
+        if (simu_link_add(a, b, (uint64_t) (delay * 1000),
+                          (uint64_t) (bw * 1e6), loss / 100, (int) queue)) {
+            simu_error("cannot link", argv[2]);
+        }
+    } else if (!strcmp(argv[0], "route") && argc == 4) {
+        if (simu_route_add(simu_node(argv[1], 0), argv[2],
+                           simu_node(argv[3], 0))) {
+            simu_error("no link to", argv[3]);
+        }
+    } else if (!strcmp(argv[0], "routes") && argc == 3) {
+        if (simu_route_shortest(argv[1], simu_node(argv[2], 0)) < 0) {
+            simu_error("cannot add routes for", argv[1]);
+        }
+    } else if (!strcmp(argv[0], "producer") && argc >= 3) {
+        n = simu_node(argv[1], 0);
+        if (simu_producer_add(n, argv[2], (size_t) simu_num(
+                simu_opt(argv, argc, 3, "size"), SIMU_SIZE, 0, 1e9))) {
+            simu_error("cannot add producer", argv[2]);
+        }
+        simu_unused(argv, argc, 3);
+    } else if (!strcmp(argv[0], "consumer") && argc >= 3) {
+        struct simu_consumer_s *c;
+        char *order, *arrivals;
+
+        n = simu_node(argv[1], 0);
+        c = simu_consumer_add(n, argv[2]);
+        if (!c) {
+            simu_error("out of memory", NULL);
+        }
+        c->rate = simu_num(simu_opt(argv, argc, 3, "rate"), SIMU_RATE,
+                           1e-6, 1e9);
+        c->names = (int) simu_num(simu_opt(argv, argc, 3, "names"),
+                                  SIMU_NAMES, 1, 1e9);
+        c->alpha = simu_num(simu_opt(argv, argc, 3, "alpha"), 1, 0, 100);
+        c->start = (uint64_t) (1e6 * simu_num(
+            simu_opt(argv, argc, 3, "start"), 0, 0, 1e9));
+        c->stop = (uint64_t) (1e6 * simu_num(
+            simu_opt(argv, argc, 3, "stop"), (double) duration / 1e6, 0, 1e9));
+        c->timeout = (uint64_t) (1e6 * simu_num(
+            simu_opt(argv, argc, 3, "timeout"), SIMU_TIMEOUT, 1e-3, 1e6));
+        order = simu_opt(argv, argc, 3, "order");
+        arrivals = simu_opt(argv, argc, 3, "arrivals");
+        simu_unused(argv, argc, 3);
+        if (!order || !strcmp(order, "zipf")) {
+            c->cdf = simu_zipf(c->names, c->alpha);
+            if (!c->cdf) {
+                simu_error("out of memory", NULL);
+            }
+        } else if (strcmp(order, "seq")) {
+            simu_error("unknown order", order);
+        }
+        if (!arrivals || !strcmp(arrivals, "poisson")) {
+            c->poisson = 1;
+        } else if (strcmp(arrivals, "constant")) {
+            simu_error("unknown arrivals", arrivals);
+        }
+    } else {
+        simu_error("cannot parse", argv[0]);
+    }
+}
+
+static void
+simu_readConfig(const char *fname, uint64_t duration)
+{
+    char line[SIMU_LINELEN], *argv[SIMU_MAXARGS], *cp;
+    FILE *f = fopen(fname, "r");
+    int argc;
+
+    if (!f) {
+        fprintf(stderr, "cannot open %s\n", fname);
+        exit(1);
+    }
+    cfgfile = fname;
+    while (fgets(line, sizeof(line), f)) {
+        cfgline++;
+        if (!strchr(line, '\n') && !feof(f)) {
+            simu_error("line too long", NULL);
+        }
+        cp = strchr(line, '#');
+        if (cp) {
+            *cp = '\0';
+        }
+        for (argc = 0, cp = strtok(line, " \t\r\n"); cp;
+             cp = strtok(NULL, " \t\r\n")) {
+            if (argc == SIMU_MAXARGS) {
+                simu_error("too many arguments", NULL);
+            }
+            argv[argc++] = cp;
+        }
+        if (argc) {
+            simu_directive(argv, argc, duration);
+        }
+    }
+    fclose(f);
+    if (!simu.nodecnt) {
+        cfgline = 0;
+        simu_error("no nodes", NULL);
+    }
+}
+
+static void
+simu_report(unsigned long events, double wall, uint64_t end)
+{
+    unsigned long requests = 0, satisfied = 0, timeouts = 0, joined = 0;
+    unsigned long rx = 0, hits = 0, produced = 0;
+    int i, j;
+
+    printf("# %d nodes, %d links, %d consumers, %s, %.3f s virtual time\n",
+           simu.nodecnt, simu.linkcnt, simu.consumercnt,
+           ccnl_suite2str(simu.suite), (double) end / 1e6);
+    printf("# %lu events in %.2f s, %.0f events/s\n", events, wall,
+           wall > 0 ? (double) events / wall : 0);
+#ifdef USE_DEBUG_MALLOC
+    printf("# allocator: %lu allocs, %lu frees, %zu bytes\n",
+           ccnl_malloc_stats.allocs, ccnl_malloc_stats.frees,
+           ccnl_malloc_stats.bytes);
+#endif
+
+    printf("#node          int_in    data_in    int_out   data_out"
+           "    bytes_out      hits   hit%%  produced     cs    pit"
+           "    drops     lost\n");
+    for (i = 0; i < simu.nodecnt; i++) {
+        struct simu_node_s *n = simu.nodes[i];
+        struct simu_stats_s *s = &n->st;
+        unsigned long drops = 0, lost = 0;
+
+        for (j = 0; j < n->linkcnt; j++) {
+            drops += n->links[j]->drops;
+            lost += n->links[j]->lost;
+        }
+        printf("%-12s %8lu %10lu %10lu %10lu %12lu %9lu %6.2f %9lu %6d %6d"
+               " %8lu %8lu\n", n->name, s->rx_interests, s->rx_data,
+               s->tx_interests, s->tx_data, s->tx_bytes, s->hits,
+               s->rx_interests ? 100.0 * s->hits / s->rx_interests : 0,
+               s->produced, n->relay->contentcnt, n->relay->pitcnt,
+               drops, lost);
+        rx += s->rx_interests;
+        hits += s->hits;
+        produced += s->produced;
+    }
+
+    printf("#consumer node         requests   joined  satisfied timeouts"
+           "      p50      p90      p99  prefix\n");
+    for (i = 0; i < simu.consumercnt; i++) {
+        struct simu_consumer_s *c = simu.consumers[i];
+
+        printf("%-9d %-12s %9lu %8lu %10lu %8lu %8.0f %8.0f %8.0f  %s\n",
+               c->id, c->node->name, c->requests, c->joined, c->satisfied,
+               c->timeouts, simu_percentile(c, 50), simu_percentile(c, 90),
+               simu_percentile(c, 99), c->prefix);
+        requests += c->requests;
+        joined += c->joined;
+        satisfied += c->satisfied;
+        timeouts += c->timeouts;
+    }
+    printf("# %lu requests, %lu joined, %lu satisfied, %lu timed out;"
+           " %lu Interests, %lu CS hits (%.2f%%), %lu produced\n",
+           requests, joined, satisfied, timeouts, rx, hits,
+           rx ? 100.0 * hits / rx : 0, produced);
+}
+
+int
+main(int argc, char **argv)
+{
+    int opt, cache = SIMU_CACHE, suite = CCNL_SUITE_NDNTLV, i;
+    double duration = 10;
+    uint64_t seed = 1, end, drain = 0;
+    struct timespec t0, t1;
+    unsigned long events;
+
+    while ((opt = getopt(argc, argv, "hc:d:s:S:v:")) != -1) {
+        switch (opt) {
+        case 'c':
+            cache = atoi(optarg);
+            break;
+        case 'd':
+            duration = atof(optarg);
+            if (duration <= 0) {
+                goto usage;
+            }
+            break;
+        case 's':
+            suite = ccnl_str2suite(optarg);
+            if (suite != CCNL_SUITE_NDNTLV && suite != CCNL_SUITE_CCNTLV) {
+                goto usage;
+            }
+            break;
+        case 'S':
+            seed = strtoull(optarg, NULL, 0);
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0]))
+                debug_level = atoi(optarg);
+            else
+                debug_level = ccnl_debug_str2level(optarg);
+#endif
+            break;
+        case 'h':
+        default:
+usage:
+            fprintf(stderr,
+            "Simulates a network of relays in virtual time.\n"
+            "usage: %s [options] CONFIG\n"
+            "  -c ENTRIES       cache size of the nodes, -1: unlimited"
+            " (dflt: %d)\n"
+            "  -d SECONDS       until the consumers stop (dflt: 10)\n"
+            "  -s SUITE         (ccnx2015, ndn2013), or set in CONFIG\n"
+            "  -S SEED          of the random numbers (dflt: 1)\n"
+#ifdef USE_LOGGING
+            "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+#endif
+            "The format of CONFIG is described in the source.\n",
+            argv[0], SIMU_CACHE);
+            exit(1);
+        }
+    }
+    if (optind != argc - 1) {
+        goto usage;
+    }
+
+    // the virtual clock first, the relays must never see the real one
+    simu_init(suite, seed);
+    simu.cache = cache;
+    ccnl_core_init();
+    simu_readConfig(argv[optind], (uint64_t) (duration * 1e6));
+
+    // the answers to the last requests are awaited
+    end = (uint64_t) (duration * 1e6);
+    for (i = 0; i < simu.consumercnt; i++) {
+        struct simu_consumer_s *c = simu.consumers[i];
+
+        if (c->stop + c->timeout > end + drain) {
+            drain = c->stop + c->timeout - end;
+        }
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &t0);
+    events = simu_run(end + drain);
+    clock_gettime(CLOCK_MONOTONIC, &t1);
+    simu_report(events, (double) (t1.tv_sec - t0.tv_sec) +
+                (double) (t1.tv_nsec - t0.tv_nsec) / 1e9, end + drain);
+
+    simu_cleanup();
+    free(byname);
+    return 0;
+}
+
+// eof
@@ -0,0 +1,1055 @@
+/*
+ * @f ccnl-simu.c
+ * @b discrete-event network of relays in virtual time
+ *
+ * Copyright (C) 2011-18, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#define _DEFAULT_SOURCE     // strdup()
+
+#include "ccnl-simu.h"
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-pkt-util.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-producer.h"
+
+// addresses: 02:00 + node index, 06:00 + consumer id
+#define SIMU_ADDR_NODE      0x02
+#define SIMU_ADDR_CONSUMER  0x06
+
+#define SIMU_AGEING         1000000     // usec between ageing runs
+
+enum { SIMU_EV_ARRIVE, SIMU_EV_REQUEST, SIMU_EV_AGEING };
+
+struct simu_event_s {
+    uint64_t time;
+    uint64_t seq;               // events at the same time run in order
+    int type;
+    void *ptr;                  // the link or consumer
+    uint8_t *data;              // an arriving packet, malloc()ed
+    size_t len;
+};
+
+struct simu_zipf_s {
+    struct simu_zipf_s *next;
+    int n;
+    double alpha;
+    double *cdf;
+};
+
+struct simu_s simu;
+uint64_t simu_now;
+
+extern struct ccnl_timer_s *eventqueue;
+
+static time_t epoch;            // what the relays see as virtual time 0
+
+static struct simu_event_s *heap;
+static size_t heapcnt, heapmax;
+static uint64_t heapseq;
+
+static struct simu_zipf_s *zipfs;
+static uint64_t rng;
+static uint32_t nonce;
+
+// the packet being received: replies to its sender during the same
+// ccnl_core_RX() are from the CS, or from a producer
+static struct {
+    struct simu_node_s *node;
+    sockunion *from;
+    int interest, produced;
+} rx;
+
+// ----------------------------------------------------------------------
+
+static void
+simu_clock(struct timeval *tv)
+{
+    tv->tv_sec = epoch + (time_t) (simu_now / 1000000);
+    tv->tv_usec = (suseconds_t) (simu_now % 1000000);
+}
+
+static uint64_t
+simu_tv2usec(struct timeval *tv)
+{
+    if (tv->tv_sec < epoch) {
+        return 0;
+    }
+    return (uint64_t) (tv->tv_sec - epoch) * 1000000 + (uint64_t) tv->tv_usec;
+}
+
+// xorshift64*, so runs with the same seed are identical
+static double
+simu_random(void)
+{
+    rng ^= rng >> 12;
+    rng ^= rng << 25;
+    rng ^= rng >> 27;
+    return (double) ((rng * 0x2545F4914F6CDD1DULL) >> 11) / 9007199254740992.0;
+}
+
+static uint64_t
+simu_hash(const uint8_t *p, size_t len)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    while (len--) {
+        h = (h ^ *p++) * 0x100000001b3ULL;
+    }
+    return h ? h : 1;   // 0 marks a free slot
+}
+
+static int
+simu_bucket(uint64_t us)
+{
+    int e, b;
+
+    if (us < 1) {
+        return 0;
+    }
+    e = ilogb((double) us);
+    if (e >= SIMU_OCTAVES) {
+        return SIMU_BUCKETS - 1;
+    }
+    b = (int) (((double) us / ldexp(1, e) - 1) * SIMU_SUB);
+    return e * SIMU_SUB + (b < SIMU_SUB ? b : SIMU_SUB - 1);
+}
+
+double
+simu_percentile(const struct simu_consumer_s *c, double p)
+{
+    unsigned long n = 0, want;
+    int i;
+
+    for (i = 0; i < SIMU_BUCKETS; i++) {
+        n += c->hist[i];
+    }
+    if (!n) {
+        return 0;
+    }
+    want = (unsigned long) ceil(p / 100 * (double) n);
+    for (i = 0, n = 0; i < SIMU_BUCKETS - 1; i++) {
+        n += c->hist[i];
+        if (n >= want && n) {
+            break;
+        }
+    }
+    // upper end of the bucket
+    return ldexp(1, i / SIMU_SUB) * (1 + (double) (i % SIMU_SUB + 1) / SIMU_SUB);
+}
+
+// ----------------------------------------------------------------------
+// the event heap
+
+static int
+simu_before(const struct simu_event_s *a, const struct simu_event_s *b)
+{
+    return a->time < b->time || (a->time == b->time && a->seq < b->seq);
+}
+
+static int
+simu_schedule(uint64_t time, int type, void *ptr, uint8_t *data, size_t len)
+{
+    struct simu_event_s e;
+    size_t i;
+
+    if (heapcnt == heapmax) {
+        size_t max = heapmax ? 2 * heapmax : 1024;
+        struct simu_event_s *h = realloc(heap, max * sizeof(*h));
+
+        if (!h) {
+            return -1;
+        }
+        heap = h;
+        heapmax = max;
+    }
+    e.time = time;
+    e.seq = heapseq++;
+    e.type = type;
+    e.ptr = ptr;
+    e.data = data;
+    e.len = len;
+    for (i = heapcnt++; i > 0 && simu_before(&e, heap + (i - 1) / 2);
+         i = (i - 1) / 2) {
+        heap[i] = heap[(i - 1) / 2];
+    }
+    heap[i] = e;
+    return 0;
+}
+
+static void
+simu_pop(struct simu_event_s *out)
+{
+    struct simu_event_s last;
+    size_t i, c;
+
+    *out = heap[0];
+    last = heap[--heapcnt];
+    for (i = 0; (c = 2 * i + 1) < heapcnt; i = c) {
+        if (c + 1 < heapcnt && simu_before(heap + c + 1, heap + c)) {
+            c++;
+        }
+        if (!simu_before(heap + c, &last)) {
+            break;
+        }
+        heap[i] = heap[c];
+    }
+    heap[i] = last;
+}
+
+// ----------------------------------------------------------------------
+// packets
+
+static void
+simu_addr(sockunion *su, int kind, uint32_t idx)
+{
+    memset(su, 0, sizeof(*su));
+    su->linklayer.sll_family = AF_PACKET;
+    su->linklayer.sll_halen = ETH_ALEN;
+    su->linklayer.sll_addr[0] = (unsigned char) kind;
+    su->linklayer.sll_addr[2] = (unsigned char) (idx >> 24);
+    su->linklayer.sll_addr[3] = (unsigned char) (idx >> 16);
+    su->linklayer.sll_addr[4] = (unsigned char) (idx >> 8);
+    su->linklayer.sll_addr[5] = (unsigned char) idx;
+}
+
+static uint32_t
+simu_addr2idx(sockunion *su)
+{
+    const unsigned char *a = su->linklayer.sll_addr;
+
+    return (uint32_t) a[2] << 24 | (uint32_t) a[3] << 16 |
+           (uint32_t) a[4] << 8 | a[5];
+}
+
+static int
+simu_isInterest(uint8_t *data, size_t len)
+{
+    size_t skip;
+    int suite = ccnl_pkt2suite(data, len, &skip);
+
+    switch (suite) {
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        return data[skip] == NDN_TLV_Interest;
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        return len > skip + 1 && data[skip + 1] == CCNX_PT_Interest;
+#endif
+    default:
+        return 0;
+    }
+}
+
+// the Name TLV of an Interest or Data, without copying
+static int
+simu_name(uint8_t *data, size_t len, uint8_t **name, size_t *namelen)
+{
+    switch (simu.suite) {
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        size_t hdrlen;
+
+        // fixed header, message TLV, then the name comes first
+        if (len < 8 || ccnl_ccntlv_getHdrLen(data, len, &hdrlen) ||
+            hdrlen + 8 > len) {
+            return -1;
+        }
+        data += hdrlen + 4;
+        len -= hdrlen + 4;
+        *namelen = 4 + (size_t) (data[2] << 8 | data[3]);
+        if ((data[0] << 8 | data[1]) != CCNX_TLV_M_Name || *namelen > len) {
+            return -1;
+        }
+        *name = data;
+        return 0;
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        uint8_t *start;
+        uint64_t typ;
+        size_t vallen;
+
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+            return -1;
+        }
+        start = data;
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) ||
+            typ != NDN_TLV_Name || vallen > len) {
+            return -1;
+        }
+        *name = start;
+        *namelen = (size_t) (data - start) + vallen;
+        return 0;
+    }
+#endif
+    default:
+        return -1;
+    }
+}
+
+static void
+simu_deliver(struct simu_node_s *n, sockunion *from, uint8_t *data,
+             size_t len)
+{
+    rx.node = n;
+    rx.from = from;
+    rx.interest = simu_isInterest(data, len);
+    rx.produced = 0;
+    if (rx.interest) {
+        n->st.rx_interests++;
+    } else {
+        n->st.rx_data++;
+    }
+    ccnl_core_RX(n->relay, 0, data, len, &from->sa, sizeof(from->linklayer));
+    rx.node = NULL;
+}
+
+static void
+simu_link_send(struct simu_link_s *l, struct ccnl_buf_s *buf)
+{
+    uint64_t start, done;
+    uint8_t *data;
+
+    // packets that left the transmitter are no longer queued
+    while (l->qlen && l->departs[l->qhead] <= simu_now) {
+        l->qhead = (l->qhead + 1) % l->qmax;
+        l->qlen--;
+    }
+    if (l->qlen >= l->qmax) {
+        l->drops++;
+        return;
+    }
+    start = l->busy > simu_now ? l->busy : simu_now;
+    done = start;
+    if (l->bps) {
+        done += (buf->datalen * 8 * 1000000 + l->bps - 1) / l->bps;
+    }
+    l->busy = done;
+    l->departs[(l->qhead + l->qlen++) % l->qmax] = done;
+    l->pkts++;
+    l->bytes += buf->datalen;
+    if (l->loss > 0 && simu_random() < l->loss) {
+        l->lost++;
+        return;
+    }
+    data = malloc(buf->datalen);
+    if (!data) {
+        l->drops++;
+        return;
+    }
+    memcpy(data, buf->data, buf->datalen);
+    simu_schedule(done + l->delay, SIMU_EV_ARRIVE, l, data, buf->datalen);
+}
+
+static struct simu_pending_s*
+simu_pending_find(struct simu_consumer_s *c, uint64_t hash)
+{
+    size_t i;
+
+    if (!c->pending) {
+        return NULL;
+    }
+    for (i = hash & c->mask; c->pending[i].hash; i = (i + 1) & c->mask) {
+        if (c->pending[i].hash == hash) {
+            return c->pending + i;
+        }
+    }
+    return NULL;
+}
+
+// backward-shift deletion, no tombstones
+static void
+simu_pending_remove(struct simu_consumer_s *c, struct simu_pending_s *p)
+{
+    size_t i = (size_t) (p - c->pending), j = i, k;
+
+    for (;;) {
+        j = (j + 1) & c->mask;
+        if (!c->pending[j].hash) {
+            break;
+        }
+        k = c->pending[j].hash & c->mask;
+        if ((j > i && (k <= i || k > j)) || (j < i && k <= i && k > j)) {
+            c->pending[i] = c->pending[j];
+            i = j;
+        }
+    }
+    c->pending[i].hash = 0;
+    c->inflight--;
+}
+
+static int
+simu_pending_add(struct simu_consumer_s *c, uint64_t hash, uint64_t sent)
+{
+    size_t i;
+
+    if (2 * (c->inflight + 1) > c->mask + 1) {
+        struct simu_pending_s *old = c->pending;
+        size_t oldsize = c->mask + 1, size = old ? 2 * oldsize : 256;
+
+        c->pending = calloc(size, sizeof(*c->pending));
+        if (!c->pending) {
+            c->pending = old;
+            return -1;
+        }
+        c->mask = size - 1;
+        c->inflight = 0;
+        for (i = 0; old && i < oldsize; i++) {
+            if (old[i].hash) {
+                simu_pending_add(c, old[i].hash, old[i].sent);
+            }
+        }
+        free(old);
+    }
+    for (i = hash & c->mask; c->pending[i].hash; i = (i + 1) & c->mask);
+    c->pending[i].hash = hash;
+    c->pending[i].sent = sent;
+    c->inflight++;
+
+    if (c->olen == c->omax) {
+        size_t max = c->omax ? 2 * c->omax : 256, n;
+        void *o = malloc(max * sizeof(*c->order));
+
+        if (!o) {
+            return -1;
+        }
+        // unroll the ring
+        for (n = 0; n < c->olen; n++) {
+            memcpy((char*) o + n * sizeof(*c->order),
+                   c->order + (c->ohead + n) % c->omax, sizeof(*c->order));
+        }
+        free(c->order);
+        c->order = o;
+        c->ohead = 0;
+        c->omax = max;
+    }
+    i = (c->ohead + c->olen++) % c->omax;
+    c->order[i].hash = hash;
+    c->order[i].sent = sent;
+    return 0;
+}
+
+// gives up on the Interests older than the timeout, or on all of them
+static void
+simu_expire(struct simu_consumer_s *c, int all)
+{
+    struct simu_pending_s *p;
+
+    while (c->olen) {
+        uint64_t hash = c->order[c->ohead].hash, sent = c->order[c->ohead].sent;
+
+        if (!all && sent + c->timeout > simu_now) {
+            break;
+        }
+        c->ohead = (c->ohead + 1) % c->omax;
+        c->olen--;
+        p = simu_pending_find(c, hash);
+        // not if answered, or requested again since
+        if (p && p->sent == sent) {
+            simu_pending_remove(c, p);
+            c->timeouts++;
+        }
+    }
+}
+
+static void
+simu_consumer_RX(struct simu_consumer_s *c, struct ccnl_buf_s *buf)
+{
+    struct simu_pending_s *p;
+    uint8_t *name;
+    size_t namelen;
+    uint64_t lat;
+
+    if (simu_name(buf->data, buf->datalen, &name, &namelen)) {
+        return;
+    }
+    p = simu_pending_find(c, simu_hash(name, namelen));
+    if (!p) {
+        return; // a duplicate, or it was given up
+    }
+    lat = simu_now - p->sent;
+    if (lat > c->timeout) {
+        c->timeouts++;
+    } else {
+        c->satisfied++;
+        c->hist[simu_bucket(lat)]++;
+    }
+    simu_pending_remove(c, p);
+}
+
+// stands in for the sockets: the buffer belongs to the caller
+static void
+simu_TX(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc, sockunion *dst,
+        struct ccnl_buf_s *buf)
+{
+    struct simu_node_s *n = relay->aux;
+    uint32_t idx = simu_addr2idx(dst);
+    int i, interest = simu_isInterest(buf->data, buf->datalen);
+
+    (void) ifc;
+    n->st.tx_bytes += buf->datalen;
+    if (interest) {
+        n->st.tx_interests++;
+    } else {
+        n->st.tx_data++;
+        if (rx.node == n && rx.interest && !ccnl_addr_cmp(dst, rx.from)) {
+            if (!rx.produced) {
+                n->st.hits++;
+            }
+            rx.interest = 0;
+        }
+    }
+    if (dst->sa.sa_family != AF_PACKET) {
+        n->st.unroutable++;
+        return;
+    }
+    switch (dst->linklayer.sll_addr[0]) {
+    case SIMU_ADDR_CONSUMER:
+        if (idx < (uint32_t) simu.consumercnt &&
+            simu.consumers[idx]->node == n) {
+            simu_consumer_RX(simu.consumers[idx], buf);
+            return;
+        }
+        break;
+    case SIMU_ADDR_NODE:
+        for (i = 0; i < n->linkcnt; i++) {
+            if ((uint32_t) n->links[i]->to->idx == idx) {
+                simu_link_send(n->links[i], buf);
+                return;
+            }
+        }
+        break;
+    }
+    n->st.unroutable++;
+}
+
+static struct ccnl_buf_s*
+simu_mkData(struct ccnl_prefix_s *name, size_t size)
+{
+    static uint8_t tmp[CCNL_MAX_PACKET_SIZE], payload[CCNL_MAX_PACKET_SIZE];
+    ccnl_data_opts_u opts;
+    size_t len = 0, contentpos = 0, offs = sizeof(tmp);
+
+    memset(&opts, 0, sizeof(opts));
+    if (ccnl_mkContent(name, payload, size, tmp, &len, &contentpos, &offs,
+                       &opts) || !len) {
+        return NULL;
+    }
+    return ccnl_buf_new(tmp + offs, len);
+}
+
+static int
+simu_produce(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+             struct ccnl_pkt_s *pkt)
+{
+    struct simu_node_s *n = relay->aux;
+    struct simu_producer_s *p;
+    struct ccnl_buf_s *buf;
+
+    if (!n || !from || !pkt->pfx) {
+        return 0;
+    }
+    for (p = n->producers; p; p = p->next) {
+        if (ccnl_prefix_cmp(p->prefix, NULL, pkt->pfx, CMP_MATCH) ==
+                                            (int32_t) p->prefix->compcnt) {
+            break;
+        }
+    }
+    if (!p) {
+        return 0;
+    }
+    buf = simu_mkData(pkt->pfx, p->size);
+    if (!buf) {
+        return 0;
+    }
+    n->st.produced++;
+    if (rx.node == n) {
+        rx.produced = 1;
+    }
+    ccnl_face_enqueue(relay, from, buf);
+    return 1;
+}
+
+// ----------------------------------------------------------------------
+// the network
+
+void
+simu_init(int suite, uint64_t seed)
+{
+    memset(&simu, 0, sizeof(simu));
+    simu.suite = suite;
+    simu.seed = seed;
+    simu.cache = -1;
+    rng = seed ? seed : 1;
+    epoch = time(NULL);
+    simu_now = 0;
+    ccnl_clock_ptr = simu_clock;
+    ccnl_set_local_producer(simu_produce);
+}
+
+struct simu_node_s*
+simu_node_add(const char *name, int cache)
+{
+    struct simu_node_s *n;
+    struct ccnl_relay_s *r;
+
+    if (simu.nodecnt == simu.nodemax) {
+        int max = simu.nodemax ? 2 * simu.nodemax : 64;
+        struct simu_node_s **nodes = realloc(simu.nodes, max * sizeof(*nodes));
+
+        if (!nodes) {
+            return NULL;
+        }
+        simu.nodes = nodes;
+        simu.nodemax = max;
+    }
+    n = calloc(1, sizeof(*n));
+    r = calloc(1, sizeof(*r));
+    if (!n || !r || !(n->name = strdup(name))) {
+        free(n);
+        free(r);
+        return NULL;
+    }
+    n->idx = simu.nodecnt;
+    n->relay = r;
+
+    r->id = n->idx;
+    r->aux = n;
+    r->ccnl_ll_TX_ptr = simu_TX;
+    r->startup_time = epoch;
+    r->max_cache_entries = cache;
+    r->max_pit_entries = CCNL_DEFAULT_MAX_PIT_ENTRIES;
+    r->max_pit_bytes = CCNL_DEFAULT_MAX_PIT_BYTES;
+    r->ifcount = 1;
+    simu_addr(&r->ifs[0].addr, SIMU_ADDR_NODE, (uint32_t) n->idx);
+    r->ifs[0].sock = -1;
+    r->ifs[0].mtu = CCNL_MAX_PACKET_SIZE;
+
+    simu.nodes[simu.nodecnt++] = n;
+    return n;
+}
+
+static struct simu_link_s*
+simu_link_new(struct simu_node_s *from, struct simu_node_s *to,
+              uint64_t delay, uint64_t bps, double loss, int qmax)
+{
+    struct simu_link_s *l;
+
+    if (from->linkcnt == from->linkmax) {
+        int max = from->linkmax ? 2 * from->linkmax : 4;
+        struct simu_link_s **links = realloc(from->links, max * sizeof(*links));
+
+        if (!links) {
+            return NULL;
+        }
+        from->links = links;
+        from->linkmax = max;
+    }
+    l = calloc(1, sizeof(*l));
+    if (!l || !(l->departs = calloc((size_t) qmax, sizeof(*l->departs)))) {
+        free(l);
+        return NULL;
+    }
+    l->from = from;
+    l->to = to;
+    l->delay = delay;
+    l->bps = bps;
+    l->loss = loss;
+    l->qmax = qmax;
+    from->links[from->linkcnt++] = l;
+    return l;
+}
+
+int
+simu_link_add(struct simu_node_s *a, struct simu_node_s *b, uint64_t delay,
+              uint64_t bps, double loss, int qmax)
+{
+    if (a == b || qmax < 1 || loss < 0 || loss > 1 ||
+        !simu_link_new(a, b, delay, bps, loss, qmax) ||
+        !simu_link_new(b, a, delay, bps, loss, qmax)) {
+        return -1;
+    }
+    simu.linkcnt++;
+    return 0;
+}
+
+int
+simu_route_add(struct simu_node_s *node, const char *uri,
+               struct simu_node_s *nexthop)
+{
+    struct ccnl_face_s *f;
+    struct ccnl_prefix_s *pfx;
+    sockunion su;
+    char *dup;
+    int i;
+
+    for (i = 0; i < node->linkcnt; i++) {
+        if (node->links[i]->to == nexthop) {
+            break;
+        }
+    }
+    if (i == node->linkcnt) {
+        return -1;
+    }
+    simu_addr(&su, SIMU_ADDR_NODE, (uint32_t) nexthop->idx);
+    f = ccnl_get_face_or_create(node->relay, 0, &su.sa, sizeof(su.linklayer));
+    if (!f) {
+        return -1;
+    }
+    f->flags |= CCNL_FACE_FLAGS_STATIC;
+    dup = ccnl_strdup(uri);
+    pfx = dup ? ccnl_URItoPrefix(dup, simu.suite, NULL) : NULL;
+    ccnl_free(dup);
+    if (!pfx || ccnl_fib_add_entry(node->relay, pfx, f)) {
+        return -1;
+    }
+    return 0;
+}
+
+int
+simu_route_shortest(const char *uri, struct simu_node_s *dst)
+{
+    struct simu_node_s **queue;
+    char *seen;
+    int head = 0, tail = 0, cnt = 0, i;
+
+    queue = malloc((size_t) simu.nodecnt * sizeof(*queue));
+    seen = calloc((size_t) simu.nodecnt, 1);
+    if (!queue || !seen) {
+        free(queue);
+        free(seen);
+        return -1;
+    }
+    // breadth first from dst, each node routes to where it was reached from
+    seen[dst->idx] = 1;
+    queue[tail++] = dst;
+    while (head < tail) {
+        struct simu_node_s *n = queue[head++];
+
+        for (i = 0; i < n->linkcnt; i++) {
+            struct simu_node_s *m = n->links[i]->to;
+
+            if (seen[m->idx]) {
+                continue;
+            }
+            seen[m->idx] = 1;
+            queue[tail++] = m;
+            if (simu_route_add(m, uri, n)) {
+                cnt = -1;
+                goto done;
+            }
+            cnt++;
+        }
+    }
+done:
+    free(queue);
+    free(seen);
+    return cnt;
+}
+
+int
+simu_producer_add(struct simu_node_s *node, const char *uri, size_t size)
+{
+    struct simu_producer_s *p;
+    char *dup;
+
+    if (size > CCNL_MAX_PACKET_SIZE / 2) {
+        return -1;
+    }
+    p = calloc(1, sizeof(*p));
+    dup = ccnl_strdup(uri);
+    if (!p || !dup) {
+        free(p);
+        ccnl_free(dup);
+        return -1;
+    }
+    p->prefix = ccnl_URItoPrefix(dup, simu.suite, NULL);
+    ccnl_free(dup);
+    if (!p->prefix) {
+        free(p);
+        return -1;
+    }
+    p->size = size;
+    p->next = node->producers;
+    node->producers = p;
+    return 0;
+}
+
+struct simu_consumer_s*
+simu_consumer_add(struct simu_node_s *node, const char *uri)
+{
+    struct simu_consumer_s *c;
+
+    if (simu.consumercnt == simu.consumermax) {
+        int max = simu.consumermax ? 2 * simu.consumermax : 64;
+        struct simu_consumer_s **cs = realloc(simu.consumers,
+                                              max * sizeof(*cs));
+
+        if (!cs) {
+            return NULL;
+        }
+        simu.consumers = cs;
+        simu.consumermax = max;
+    }
+    c = calloc(1, sizeof(*c));
+    if (!c || !(c->prefix = strdup(uri))) {
+        free(c);
+        return NULL;
+    }
+    c->id = simu.consumercnt;
+    c->node = node;
+    simu_addr(&c->addr, SIMU_ADDR_CONSUMER, (uint32_t) c->id);
+    simu.consumers[simu.consumercnt++] = c;
+    return c;
+}
+
+const double*
+simu_zipf(int n, double alpha)
+{
+    struct simu_zipf_s *z;
+    double sum = 0;
+    int i;
+
+    for (z = zipfs; z; z = z->next) {
+        if (z->n == n && z->alpha == alpha) {
+            return z->cdf;
+        }
+    }
+    z = calloc(1, sizeof(*z));
+    if (!z || !(z->cdf = malloc((size_t) n * sizeof(double)))) {
+        free(z);
+        return NULL;
+    }
+    for (i = 0; i < n; i++) {
+        sum += 1 / pow(i + 1, alpha);
+        z->cdf[i] = sum;
+    }
+    for (i = 0; i < n; i++) {
+        z->cdf[i] /= sum;
+    }
+    z->n = n;
+    z->alpha = alpha;
+    z->next = zipfs;
+    zipfs = z;
+    return z->cdf;
+}
+
+// ----------------------------------------------------------------------
+// the event loop
+
+static int
+simu_pick(struct simu_consumer_s *c)
+{
+    double u;
+    int lo = 0, hi = c->names - 1;
+
+    if (!c->cdf) {
+        return (int) (c->seq++ % (uint64_t) c->names);
+    }
+    u = simu_random();
+    while (lo < hi) {
+        int mid = (lo + hi) / 2;
+
+        if (c->cdf[mid] < u) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo;
+}
+
+static void
+simu_request(struct simu_consumer_s *c)
+{
+    static uint8_t tmp[CCNL_MAX_PACKET_SIZE];
+    char uri[CCNL_MAX_PREFIX_SIZE];
+    struct ccnl_prefix_s *pfx;
+    ccnl_interest_opts_u opts;
+    size_t len = 0, offs = sizeof(tmp), namelen;
+    uint8_t *name;
+    uint64_t hash;
+    double gap;
+
+    if (simu_now >= c->stop) {
+        return;
+    }
+    gap = c->poisson ? -log(1 - simu_random()) : 1;
+    c->due += gap * 1e6 / c->rate;
+    simu_schedule(c->due > (double) simu_now ? (uint64_t) c->due : simu_now,
+                  SIMU_EV_REQUEST, c, NULL, 0);
+
+    simu_expire(c, 0);
+    c->requests++;
+    snprintf(uri, sizeof(uri), "%s/%d", c->prefix, simu_pick(c));
+    pfx = ccnl_URItoPrefix(uri, simu.suite, NULL);
+    if (!pfx) {
+        return;
+    }
+    memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+    opts.ndntlv.nonce = (int32_t) (++nonce & 0x7fffffff);
+    opts.ndntlv.interestlifetime = (uint32_t) (c->timeout / 1000);
+#endif
+    if (ccnl_mkInterest(pfx, &opts, tmp, tmp + sizeof(tmp), &len, &offs) ||
+        !len || simu_name(tmp + offs, len, &name, &namelen)) {
+        ccnl_prefix_free(pfx);
+        return;
+    }
+    ccnl_prefix_free(pfx);
+    hash = simu_hash(name, namelen);
+    if (simu_pending_find(c, hash)) {
+        c->joined++;
+        return;
+    }
+    if (simu_pending_add(c, hash, simu_now)) {
+        return;
+    }
+    simu_deliver(c->node, &c->addr, tmp + offs, len);
+}
+
+unsigned long
+simu_run(uint64_t end)
+{
+    struct simu_event_s e;
+    unsigned long cnt = 0;
+    int i;
+
+    for (i = 0; i < simu.consumercnt; i++) {
+        struct simu_consumer_s *c = simu.consumers[i];
+
+        c->due = (double) c->start;
+        simu_schedule(c->start, SIMU_EV_REQUEST, c, NULL, 0);
+    }
+    simu_schedule(simu_now + SIMU_AGEING, SIMU_EV_AGEING, NULL, NULL, 0);
+
+    for (;;) {
+        uint64_t t = heapcnt ? heap[0].time : UINT64_MAX;
+        uint64_t tt = eventqueue ? simu_tv2usec(&eventqueue->timeout)
+                                 : UINT64_MAX;
+
+        if (tt <= t) {
+            if (tt > end) {
+                break;
+            }
+            // ccnl_run_events() serves the timers that are overdue
+            if (simu_now <= tt) {
+                simu_now = tt + 1;
+            }
+            ccnl_run_events();
+            cnt++;
+            continue;
+        }
+        if (t > end) {
+            break;
+        }
+        simu_pop(&e);
+        if (e.time > simu_now) {
+            simu_now = e.time;
+        }
+        switch (e.type) {
+        case SIMU_EV_ARRIVE: {
+            struct simu_link_s *l = e.ptr;
+
+            simu_deliver(l->to, &l->from->relay->ifs[0].addr, e.data, e.len);
+            free(e.data);
+            break;
+        }
+        case SIMU_EV_REQUEST:
+            simu_request(e.ptr);
+            break;
+        case SIMU_EV_AGEING:
+            for (i = 0; i < simu.nodecnt; i++) {
+                ccnl_do_ageing(simu.nodes[i]->relay, NULL);
+            }
+            simu_schedule(simu_now + SIMU_AGEING, SIMU_EV_AGEING,
+                          NULL, NULL, 0);
+            break;
+        }
+        cnt++;
+    }
+    simu_now = end;
+    for (i = 0; i < simu.consumercnt; i++) {
+        simu_expire(simu.consumers[i], 1);
+    }
+    return cnt;
+}
+
+void
+simu_cleanup(void)
+{
+    struct simu_producer_s *p;
+    struct simu_zipf_s *z;
+    int i, j;
+
+    while (heapcnt) {
+        free(heap[--heapcnt].data);
+    }
+    free(heap);
+    heap = NULL;
+    heapmax = 0;
+    while (eventqueue) {
+        ccnl_rem_timer(eventqueue);
+    }
+    for (i = 0; i < simu.nodecnt; i++) {
+        struct simu_node_s *n = simu.nodes[i];
+
+        ccnl_core_cleanup(n->relay);
+        for (j = 0; j < n->linkcnt; j++) {
+            free(n->links[j]->departs);
+            free(n->links[j]);
+        }
+        while ((p = n->producers)) {
+            n->producers = p->next;
+            ccnl_prefix_free(p->prefix);
+            free(p);
+        }
+        free(n->links);
+        free(n->relay);
+        free(n->name);
+        free(n);
+    }
+    for (i = 0; i < simu.consumercnt; i++) {
+        free(simu.consumers[i]->pending);
+        free(simu.consumers[i]->order);
+        free(simu.consumers[i]->prefix);
+        free(simu.consumers[i]);
+    }
+    while ((z = zipfs)) {
+        zipfs = z->next;
+        free(z->cdf);
+        free(z);
+    }
+    free(simu.nodes);
+    free(simu.consumers);
+    memset(&simu, 0, sizeof(simu));
+    ccnl_set_local_producer(NULL);
+    ccnl_clock_ptr = NULL;
+}
@@ -0,0 +1,226 @@
+/*
+ * @f ccnl-simu.h
+ * @b discrete-event network of relays in virtual time
+ *
+ * Copyright (C) 2011-18, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+/*
+ * Every node is a complete relay with one link-layer interface. Its
+ * ccnl_ll_TX_ptr hands packets to the links of the node, which deliver
+ * them to the neighbour after the queueing, transmission and propagation
+ * delay. Time is virtual: the relays' clock (ccnl_clock_ptr) is set to the
+ * time of the event being processed, their timers run from the same event
+ * loop. Consumers are attached to a node and send Interests to it as a
+ * local peer; producers answer Interests for their prefix at their node.
+ */
+
+#ifndef CCNL_SIMU_H
+#define CCNL_SIMU_H
+
+#include "ccnl-core.h"
+
+// latency histogram: SIMU_SUB buckets per power of two of usec
+#define SIMU_SUB            16
+#define SIMU_OCTAVES        40
+#define SIMU_BUCKETS        (SIMU_SUB * SIMU_OCTAVES)
+
+struct simu_node_s;
+
+/** one direction of a link */
+struct simu_link_s {
+    struct simu_node_s *from, *to;
+    uint64_t delay;             /**< propagation delay, usec */
+    uint64_t bps;               /**< bandwidth in bit/s, 0: unlimited */
+    double loss;                /**< probability that a packet is lost */
+    int qmax;                   /**< packets queued for the transmitter */
+    uint64_t busy;              /**< the transmitter is busy until then */
+    uint64_t *departs;          /**< when the queued packets leave, a ring */
+    int qhead, qlen;
+    unsigned long pkts, bytes;  /**< sent */
+    unsigned long drops;        /**< found the queue full */
+    unsigned long lost;         /**< sent, but lost on the way */
+};
+
+/** answers Interests under a prefix at its node */
+struct simu_producer_s {
+    struct simu_producer_s *next;
+    struct ccnl_prefix_s *prefix;
+    size_t size;                /**< payload bytes of each Data */
+};
+
+struct simu_stats_s {
+    unsigned long rx_interests, rx_data;
+    unsigned long tx_interests, tx_data, tx_bytes;
+    unsigned long hits;         /**< Interests answered from the CS */
+    unsigned long produced;     /**< Interests answered by a producer */
+    unsigned long unroutable;   /**< packets to a peer that is no neighbour */
+};
+
+struct simu_node_s {
+    char *name;
+    int idx;
+    struct ccnl_relay_s *relay;
+    struct simu_link_s **links; /**< outgoing */
+    int linkcnt, linkmax;
+    struct simu_producer_s *producers;
+    struct simu_stats_s st;
+};
+
+/** the Interests of a consumer in flight, by name */
+struct simu_pending_s {
+    uint64_t hash;              /**< of the name, 0: free slot */
+    uint64_t sent;
+};
+
+/** requests names under a prefix at a node, at a mean rate */
+struct simu_consumer_s {
+    int id;
+    struct simu_node_s *node;
+    sockunion addr;             /**< as a peer of its node */
+    char *prefix;
+    int names;                  /**< requests go to prefix/0 .. /names-1 */
+    double alpha;               /**< Zipf exponent, 0: uniform */
+    const double *cdf;          /**< NULL: the names in sequence */
+    int poisson;                /**< exponential gaps instead of 1/rate */
+    double rate;                /**< requests per second */
+    uint64_t start, stop;       /**< usec */
+    uint64_t timeout;           /**< usec until an Interest is given up */
+    uint64_t seq;               /**< next name in sequence */
+    double due;                 /**< of the next request, usec */
+
+    struct simu_pending_s *pending;
+    size_t mask, inflight;
+    struct { uint64_t hash, sent; } *order;    /**< sent, oldest first */
+    size_t ohead, olen, omax;
+
+    unsigned long requests;     /**< wanted by the workload */
+    unsigned long joined;       /**< wanted while pending, not sent again */
+    unsigned long satisfied, timeouts;
+    unsigned long hist[SIMU_BUCKETS];
+};
+
+/** all of the network */
+struct simu_s {
+    int suite;
+    struct simu_node_s **nodes;
+    int nodecnt, nodemax;
+    struct simu_consumer_s **consumers;
+    int consumercnt, consumermax;
+    int linkcnt;
+    int cache;                  /**< default cache size of the nodes */
+    uint64_t seed;
+};
+
+extern struct simu_s simu;
+extern uint64_t simu_now;       /**< virtual time, usec */
+
+/**
+ * @brief Sets up the virtual clock and the local producer hook
+ *
+ * Must be called before anything touches a timer or logs.
+ */
+void
+simu_init(int suite, uint64_t seed);
+
+/**
+ * @brief Adds a relay
+ *
+ * @param[in] name  unique name of the node
+ * @param[in] cache max content entries, -1: unlimited, 0: no caching
+ *
+ * @return the node, NULL if out of memory
+ */
+struct simu_node_s*
+simu_node_add(const char *name, int cache);
+
+/**
+ * @brief Connects two nodes in both directions
+ *
+ * @return 0 on success, -1 on invalid parameters or out of memory
+ */
+int
+simu_link_add(struct simu_node_s *a, struct simu_node_s *b, uint64_t delay,
+              uint64_t bps, double loss, int qmax);
+
+/**
+ * @brief Adds a FIB entry on \p node for \p uri towards the neighbour
+ *        \p nexthop
+ *
+ * @return 0 on success, -1 if \p nexthop is no neighbour or on errors
+ */
+int
+simu_route_add(struct simu_node_s *node, const char *uri,
+               struct simu_node_s *nexthop);
+
+/**
+ * @brief Routes \p uri towards \p dst on all nodes, along the paths with
+ *        fewest hops
+ *
+ * @return number of routes added, -1 on errors
+ */
+int
+simu_route_shortest(const char *uri, struct simu_node_s *dst);
+
+/**
+ * @brief Lets \p node answer all Interests under \p uri
+ *
+ * @return 0 on success, -1 on errors
+ */
+int
+simu_producer_add(struct simu_node_s *node, const char *uri, size_t size);
+
+/**
+ * @brief Adds a consumer, filled in by the caller
+ *
+ * @return the consumer, NULL if out of memory
+ */
+struct simu_consumer_s*
+simu_consumer_add(struct simu_node_s *node, const char *uri);
+
+/**
+ * @brief The cumulative Zipf distribution over \p n names, shared between
+ *        consumers with the same parameters
+ */
+const double*
+simu_zipf(int n, double alpha);
+
+/**
+ * @brief Runs the simulation until virtual time \p end (usec)
+ *
+ * Consumers stop sending at their stop time, Interests still pending at
+ * \p end count as timed out.
+ *
+ * @return number of events processed
+ */
+unsigned long
+simu_run(uint64_t end);
+
+/**
+ * @brief Latency percentile of a consumer, in usec
+ */
+double
+simu_percentile(const struct simu_consumer_s *c, double p);
+
+/**
+ * @brief Frees the network
+ */
+void
+simu_cleanup(void);
+
+#endif // CCNL_SIMU_H
@@ -0,0 +1,159 @@
+/*
+ * @f ccnl-archive.h
+ * @b packed, indexed content archives
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+/*
+ * An archive holds static Data packets in a single file that is mapped
+ * read-only and searched in place, so nothing has to be loaded at startup.
+ * All integers are in network byte order.
+ *
+ *   header   64 bytes at offset 0, see below
+ *   index    one 24 byte entry per packet, sorted by (suite, name)
+ *   names    the names of the packets, each component as
+ *            (uint16 length, bytes) as the parser of the suite returns it
+ *   data     the packets, starting on a page boundary; a packet smaller
+ *            than a page does not straddle a page boundary
+ *
+ * header:  "CCNLARC1", uint32 version, uint32 entry count,
+ *          uint64 offset and length of the index, of the names and of
+ *          the data, 8 bytes padding
+ * entry:   uint64 packet offset (into data), uint32 packet length,
+ *          uint32 name offset (into names), uint16 name length,
+ *          uint16 component count, uint8 suite, 3 bytes padding
+ *
+ * Names sort component by component, a shorter component before a longer
+ * one and components of the same length bytewise; a name sorts before the
+ * names it is a prefix of, so all names under a prefix are adjacent.
+ */
+
+#ifndef CCNL_ARCHIVE_H
+#define CCNL_ARCHIVE_H
+
+#include "ccnl-core.h"
+
+#define CCNL_ARCHIVE_MAGIC      "CCNLARC1"
+#define CCNL_ARCHIVE_VERSION    1
+#define CCNL_ARCHIVE_HDRLEN     64
+#define CCNL_ARCHIVE_ENTRYLEN   24
+#define CCNL_ARCHIVE_PAGE       4096
+
+#ifndef CCNL_ARCHIVE_SCAN
+#define CCNL_ARCHIVE_SCAN       16  // candidates checked for a prefix match
+#endif
+
+/**
+ * @brief A packet to put into an archive
+ */
+struct ccnl_archive_item_s {
+    int suite;                      /**< packet format */
+    struct ccnl_prefix_s *pfx;      /**< the name, as parsed */
+    uint8_t *data;                  /**< the encoded packet */
+    size_t len;                     /**< its length */
+};
+
+struct ccnl_archive_s;
+
+/**
+ * @brief Writes an archive
+ *
+ * The items are sorted in place. Of several packets with the same name
+ * only the first is kept.
+ *
+ * @param[in] path  the file to create
+ * @param[in] items the packets
+ * @param[in] count number of items
+ *
+ * @return number of packets written, -1 on error
+ */
+int
+ccnl_archive_write(const char *path, struct ccnl_archive_item_s *items,
+                   size_t count);
+
+/**
+ * @brief Maps an archive
+ *
+ * Only the header is checked, index entries are validated when they are
+ * read.
+ *
+ * @param[in] path the archive
+ *
+ * @return the archive, NULL if it cannot be mapped or is malformed
+ */
+struct ccnl_archive_s*
+ccnl_archive_open(const char *path);
+
+/**
+ * @brief Unmaps an archive
+ */
+void
+ccnl_archive_close(struct ccnl_archive_s *a);
+
+/**
+ * @brief Number of packets in an archive
+ */
+uint32_t
+ccnl_archive_count(struct ccnl_archive_s *a);
+
+/**
+ * @brief Finds a packet satisfying an Interest
+ *
+ * A binary search over the index. CCNx Interests match exactly, NDN
+ * Interests by prefix within their Min- and MaxSuffixComponents; NDN
+ * names ending in an implicit digest are not looked up.
+ *
+ * @param[in]  a    the archive
+ * @param[in]  pkt  the Interest
+ * @param[out] data the packet, points into the mapping
+ * @param[out] len  its length
+ *
+ * @return 0 if a packet was found, -1 otherwise
+ */
+int
+ccnl_archive_lookup(struct ccnl_archive_s *a, struct ccnl_pkt_s *pkt,
+                    uint8_t **data, size_t *len);
+
+/**
+ * @brief Serves the packets of an archive from the relay
+ *
+ * @param[in] path the archive
+ *
+ * @return 0 on success, -1 if the archive cannot be opened
+ */
+int
+ccnl_archive_add(const char *path);
+
+/**
+ * @brief The \ref ccnl_producer_func answering from the archives added with
+ *        ccnl_archive_add()
+ *
+ * @return 1 if the Interest was answered, 0 if it is left to the relay
+ */
+int
+ccnl_archive_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                      struct ccnl_pkt_s *pkt);
+
+/**
+ * @brief Closes all archives added with ccnl_archive_add()
+ */
+void
+ccnl_archive_cleanup(void);
+
+#endif // CCNL_ARCHIVE_H
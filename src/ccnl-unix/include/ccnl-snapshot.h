@@ -0,0 +1,106 @@
+/*
+ * @f ccnl-snapshot.h
+ * @b warm restart: content store and routing state across relay restarts
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+/*
+ * A snapshot is a header followed by records, all integers in network
+ * byte order. Faces come first, then the FIB, then the content store, so
+ * routing is back before the first content record is read.
+ *
+ *   header   "CCNLSNP1", uint32 version, uint32 sizeof(sockunion),
+ *            uint64 time written (seconds since the epoch)
+ *   record   uint8 type, uint32 payload length, payload
+ *
+ *   face     uint32 face id, uint32 flags, uint32 weight, uint32 irate,
+ *            uint32 iburst, the peer address (sockunion, as in memory)
+ *   fib      uint32 face id, uint8 suite, uint16 component count,
+ *            each component as (uint16 length, bytes)
+ *   content  uint32 seconds since last use, uint32 times served,
+ *            uint8 flags, the packet
+ *
+ * Content ages across the downtime. Peer addresses are stored as the
+ * relay holds them, a snapshot is only read back by a relay built with
+ * the same address families.
+ */
+
+#ifndef CCNL_SNAPSHOT_H
+#define CCNL_SNAPSHOT_H
+
+#include "ccnl-core.h"
+
+#define CCNL_SNAPSHOT_MAGIC     "CCNLSNP1"
+#define CCNL_SNAPSHOT_VERSION   1
+#define CCNL_SNAPSHOT_HDRLEN    24
+
+#define CCNL_SNAPSHOT_FACE      1
+#define CCNL_SNAPSHOT_FIB       2
+#define CCNL_SNAPSHOT_CONTENT   3
+
+#ifndef CCNL_SNAPSHOT_BATCH
+#define CCNL_SNAPSHOT_BATCH     256 // content records restored per event
+#endif
+
+#ifndef CCNL_SNAPSHOT_POLL
+#define CCNL_SNAPSHOT_POLL      1000000 // usec between checks for SIGUSR1
+#endif
+
+/**
+ * @brief Writes a snapshot of the relay
+ *
+ * Saved are the static faces, the FIB entries through them, and all
+ * content that is not static (that is reloaded from -d, -f and -a anyway).
+ * The snapshot is written next to \p path and renamed over it, so a crash
+ * in between leaves the previous one in place. A restore still in progress
+ * is completed first.
+ *
+ * @param[in] relay the relay
+ * @param[in] path  the snapshot file
+ *
+ * @return number of content objects saved, -1 on error
+ */
+int
+ccnl_snapshot_write(struct ccnl_relay_s *relay, const char *path);
+
+/**
+ * @brief Restores a snapshot written by ccnl_snapshot_write()
+ *
+ * Faces and FIB entries are restored right away. The content objects are
+ * streamed in from a timer event, \ref CCNL_SNAPSHOT_BATCH at a time, so
+ * the relay serves packets while the cache fills. Content that arrived in
+ * the meantime is kept over its older copy in the snapshot.
+ *
+ * @param[in] relay the relay, with its interfaces configured
+ * @param[in] path  the snapshot file
+ *
+ * @return 0 if the snapshot is being restored, -1 if it cannot be read
+ */
+int
+ccnl_snapshot_restore(struct ccnl_relay_s *relay, const char *path);
+
+/**
+ * @brief Completes a restore in progress
+ *
+ * @return number of content objects restored by the last restore
+ */
+int
+ccnl_snapshot_finish(void);
+
+#endif // CCNL_SNAPSHOT_H
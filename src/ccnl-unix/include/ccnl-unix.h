@@ -29,6 +29,7 @@
 #include <sys/stat.h>
 #include <sys/types.h>
 #include <inttypes.h>
+#include <signal.h>
 
 #include <netinet/in.h>
 #include "ccnl-sockunion.h"
@@ -104,6 +105,12 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
                   char *uxpath, int suite, int max_cache_entries,
                   char *crypto_face_path);
 
+/**
+ * @brief Makes ccnl_io_loop() return when set, safe to set from a signal
+ *        handler (unlike ccnl->halt_flag)
+ */
+extern volatile sig_atomic_t ccnl_io_halt;
+
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl);
 
@@ -0,0 +1,506 @@
+/*
+ * @f ccnl-archive.c
+ * @b packed, indexed content archives
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#define _DEFAULT_SOURCE     // posix_madvise()
+
+#include "ccnl-archive.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "ccnl-face.h"
+#include "ccnl-relay.h"
+
+struct ccnl_archive_s {
+    struct ccnl_archive_s *next;    // archives served by the relay
+    uint8_t *map;
+    size_t size;
+    uint32_t count;
+    const uint8_t *index, *names, *data;
+    uint64_t nameslen, datalen;
+    unsigned long served;
+};
+
+// an index entry, decoded
+struct ccnl_archive_entry_s {
+    uint64_t offset;
+    uint32_t len;
+    const uint8_t *name;
+    uint16_t namelen, compcnt;
+    uint8_t suite;
+};
+
+static struct ccnl_archive_s *archives;
+
+// ----------------------------------------------------------------------
+// byte order
+
+static uint16_t
+ccnl_archive_get16(const uint8_t *p)
+{
+    return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+static uint32_t
+ccnl_archive_get32(const uint8_t *p)
+{
+    return ((uint32_t) ccnl_archive_get16(p) << 16) | ccnl_archive_get16(p + 2);
+}
+
+static uint64_t
+ccnl_archive_get64(const uint8_t *p)
+{
+    return ((uint64_t) ccnl_archive_get32(p) << 32) | ccnl_archive_get32(p + 4);
+}
+
+static void
+ccnl_archive_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t) (v >> 8);
+    p[1] = (uint8_t) v;
+}
+
+static void
+ccnl_archive_put32(uint8_t *p, uint32_t v)
+{
+    ccnl_archive_put16(p, (uint16_t) (v >> 16));
+    ccnl_archive_put16(p + 2, (uint16_t) v);
+}
+
+static void
+ccnl_archive_put64(uint8_t *p, uint64_t v)
+{
+    ccnl_archive_put32(p, (uint32_t) (v >> 32));
+    ccnl_archive_put32(p + 4, (uint32_t) v);
+}
+
+// ----------------------------------------------------------------------
+// name order
+
+static int
+ccnl_archive_cmpComp(const uint8_t *a, size_t alen,
+                     const uint8_t *b, size_t blen)
+{
+    if (alen != blen) {
+        return alen < blen ? -1 : 1;
+    }
+    return alen ? memcmp(a, b, alen) : 0;
+}
+
+// orders two items by suite, then by name
+static int
+ccnl_archive_cmpItems(const void *x, const void *y)
+{
+    const struct ccnl_archive_item_s *a = x, *b = y;
+    uint32_t i, n;
+    int rc;
+
+    if (a->suite != b->suite) {
+        return a->suite < b->suite ? -1 : 1;
+    }
+    n = a->pfx->compcnt < b->pfx->compcnt ? a->pfx->compcnt : b->pfx->compcnt;
+    for (i = 0; i < n; i++) {
+        rc = ccnl_archive_cmpComp(a->pfx->comp[i], a->pfx->complen[i],
+                                  b->pfx->comp[i], b->pfx->complen[i]);
+        if (rc) {
+            return rc;
+        }
+    }
+    if (a->pfx->compcnt == b->pfx->compcnt) {
+        return 0;
+    }
+    return a->pfx->compcnt < b->pfx->compcnt ? -1 : 1;
+}
+
+// decodes and checks entry i
+static int
+ccnl_archive_entry(struct ccnl_archive_s *a, uint32_t i,
+                   struct ccnl_archive_entry_s *e)
+{
+    const uint8_t *p = a->index + (size_t) i * CCNL_ARCHIVE_ENTRYLEN;
+    uint32_t name;
+
+    e->offset = ccnl_archive_get64(p);
+    e->len = ccnl_archive_get32(p + 8);
+    name = ccnl_archive_get32(p + 12);
+    e->namelen = ccnl_archive_get16(p + 16);
+    e->compcnt = ccnl_archive_get16(p + 18);
+    e->suite = p[20];
+    if (e->offset > a->datalen || e->len > a->datalen - e->offset ||
+        name > a->nameslen || e->namelen > a->nameslen - name) {
+        DEBUGMSG(WARNING, "archive: entry %u is out of bounds\n", i);
+        return -1;
+    }
+    e->name = a->names + name;
+    return 0;
+}
+
+// compares entry e with (suite, pfx); *prefixof tells whether pfx is a
+// prefix of (or equal to) the name of e
+static int
+ccnl_archive_cmpEntry(struct ccnl_archive_entry_s *e, int suite,
+                      struct ccnl_prefix_s *pfx, int *prefixof)
+{
+    const uint8_t *p = e->name, *end = e->name + e->namelen;
+    uint32_t i, n = e->compcnt < pfx->compcnt ? e->compcnt : pfx->compcnt;
+    uint16_t len;
+    int rc;
+
+    *prefixof = 0;
+    if (e->suite != suite) {
+        return e->suite < suite ? -1 : 1;
+    }
+    for (i = 0; i < n; i++) {
+        if (end - p < 2 || (len = ccnl_archive_get16(p)) > end - p - 2) {
+            return 1; // malformed, never matches
+        }
+        rc = ccnl_archive_cmpComp(p + 2, len, pfx->comp[i], pfx->complen[i]);
+        if (rc) {
+            return rc;
+        }
+        p += 2 + len;
+    }
+    *prefixof = e->compcnt >= pfx->compcnt;
+    if (e->compcnt == pfx->compcnt) {
+        return 0;
+    }
+    return e->compcnt < pfx->compcnt ? -1 : 1;
+}
+
+// ----------------------------------------------------------------------
+
+int
+ccnl_archive_write(const char *path, struct ccnl_archive_item_s *items,
+                   size_t count)
+{
+    static const uint8_t zero[CCNL_ARCHIVE_PAGE];
+    uint8_t hdr[CCNL_ARCHIVE_HDRLEN], entry[CCNL_ARCHIVE_ENTRYLEN], len2[2];
+    uint64_t *offs = NULL, nameslen = 0, names, data, pos, off;
+    size_t i, j, kept = 0;
+    FILE *fp = NULL;
+    int rc = -1;
+
+    qsort(items, count, sizeof(*items), ccnl_archive_cmpItems);
+    // keep the first of several packets with the same name
+    for (i = 0; i < count; i++) {
+        if (kept && !ccnl_archive_cmpItems(items + kept - 1, items + i)) {
+            DEBUGMSG(WARNING, "archive: duplicate name, packet dropped\n");
+            continue;
+        }
+        items[kept++] = items[i];
+    }
+    if (kept > UINT32_MAX) {
+        return -1;
+    }
+
+    offs = (uint64_t*) ccnl_malloc((kept ? kept : 1) * sizeof(*offs));
+    if (!offs) {
+        return -1;
+    }
+    off = 0;
+    for (i = 0; i < kept; i++) {
+        size_t namelen = 0;
+
+        for (j = 0; j < items[i].pfx->compcnt; j++) {
+            namelen += 2 + items[i].pfx->complen[j];
+        }
+        if (namelen > UINT16_MAX || items[i].pfx->compcnt > UINT16_MAX ||
+            items[i].len > UINT32_MAX) {
+            DEBUGMSG(ERROR, "archive: name or packet too long\n");
+            goto Done;
+        }
+        nameslen += namelen;
+        // a small packet stays within one page
+        if (items[i].len <= CCNL_ARCHIVE_PAGE &&
+            off % CCNL_ARCHIVE_PAGE + items[i].len > CCNL_ARCHIVE_PAGE) {
+            off += CCNL_ARCHIVE_PAGE - off % CCNL_ARCHIVE_PAGE;
+        }
+        offs[i] = off;
+        off += items[i].len;
+    }
+    names = CCNL_ARCHIVE_HDRLEN + (uint64_t) kept * CCNL_ARCHIVE_ENTRYLEN;
+    data = names + nameslen;
+    data += (CCNL_ARCHIVE_PAGE - data % CCNL_ARCHIVE_PAGE) % CCNL_ARCHIVE_PAGE;
+
+    fp = fopen(path, "wb");
+    if (!fp) {
+        DEBUGMSG(ERROR, "archive: cannot create %s\n", path);
+        goto Done;
+    }
+    memset(hdr, 0, sizeof(hdr));
+    memcpy(hdr, CCNL_ARCHIVE_MAGIC, 8);
+    ccnl_archive_put32(hdr + 8, CCNL_ARCHIVE_VERSION);
+    ccnl_archive_put32(hdr + 12, (uint32_t) kept);
+    ccnl_archive_put64(hdr + 16, CCNL_ARCHIVE_HDRLEN);
+    ccnl_archive_put64(hdr + 24, (uint64_t) kept * CCNL_ARCHIVE_ENTRYLEN);
+    ccnl_archive_put64(hdr + 32, names);
+    ccnl_archive_put64(hdr + 40, nameslen);
+    ccnl_archive_put64(hdr + 48, data);
+    ccnl_archive_put64(hdr + 56, off);
+    if (fwrite(hdr, sizeof(hdr), 1, fp) != 1) {
+        goto Done;
+    }
+
+    pos = 0;
+    for (i = 0; i < kept; i++) {
+        uint16_t namelen = 0;
+
+        for (j = 0; j < items[i].pfx->compcnt; j++) {
+            namelen += 2 + items[i].pfx->complen[j];
+        }
+        memset(entry, 0, sizeof(entry));
+        ccnl_archive_put64(entry, offs[i]);
+        ccnl_archive_put32(entry + 8, (uint32_t) items[i].len);
+        ccnl_archive_put32(entry + 12, (uint32_t) pos);
+        ccnl_archive_put16(entry + 16, namelen);
+        ccnl_archive_put16(entry + 18, (uint16_t) items[i].pfx->compcnt);
+        entry[20] = (uint8_t) items[i].suite;
+        if (fwrite(entry, sizeof(entry), 1, fp) != 1) {
+            goto Done;
+        }
+        pos += namelen;
+    }
+    for (i = 0; i < kept; i++) {
+        for (j = 0; j < items[i].pfx->compcnt; j++) {
+            ccnl_archive_put16(len2, (uint16_t) items[i].pfx->complen[j]);
+            if (fwrite(len2, 2, 1, fp) != 1 ||
+                fwrite(items[i].pfx->comp[j], 1, items[i].pfx->complen[j],
+                       fp) != items[i].pfx->complen[j]) {
+                goto Done;
+            }
+        }
+    }
+    if (fwrite(zero, 1, data - names - nameslen, fp) != data - names - nameslen) {
+        goto Done;
+    }
+    pos = 0;
+    for (i = 0; i < kept; i++) {
+        if (fwrite(zero, 1, offs[i] - pos, fp) != offs[i] - pos ||
+            fwrite(items[i].data, 1, items[i].len, fp) != items[i].len) {
+            goto Done;
+        }
+        pos = offs[i] + items[i].len;
+    }
+    rc = (int) kept;
+
+Done:
+    if (fp && fclose(fp) && rc >= 0) {
+        rc = -1;
+    }
+    if (rc < 0) {
+        DEBUGMSG(ERROR, "archive: could not write %s\n", path);
+    }
+    ccnl_free(offs);
+    return rc;
+}
+
+struct ccnl_archive_s*
+ccnl_archive_open(const char *path)
+{
+    struct ccnl_archive_s *a;
+    uint64_t index, indexlen, names, data;
+    struct stat st;
+    int fd;
+
+    fd = open(path, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) < 0 || st.st_size < CCNL_ARCHIVE_HDRLEN) {
+        DEBUGMSG(ERROR, "archive: cannot open %s or it is too short\n", path);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    a = (struct ccnl_archive_s*) ccnl_calloc(1, sizeof(*a));
+    if (!a) {
+        close(fd);
+        return NULL;
+    }
+    a->size = (size_t) st.st_size;
+    a->map = (uint8_t*) mmap(NULL, a->size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (a->map == MAP_FAILED) {
+        DEBUGMSG(ERROR, "archive: cannot map %s\n", path);
+        ccnl_free(a);
+        return NULL;
+    }
+    // lookups touch a few index pages and one data page each
+    posix_madvise(a->map, a->size, POSIX_MADV_RANDOM);
+
+    a->count = ccnl_archive_get32(a->map + 12);
+    index = ccnl_archive_get64(a->map + 16);
+    indexlen = ccnl_archive_get64(a->map + 24);
+    names = ccnl_archive_get64(a->map + 32);
+    a->nameslen = ccnl_archive_get64(a->map + 40);
+    data = ccnl_archive_get64(a->map + 48);
+    a->datalen = ccnl_archive_get64(a->map + 56);
+    if (memcmp(a->map, CCNL_ARCHIVE_MAGIC, 8) ||
+        ccnl_archive_get32(a->map + 8) != CCNL_ARCHIVE_VERSION ||
+        indexlen != (uint64_t) a->count * CCNL_ARCHIVE_ENTRYLEN ||
+        index > a->size || indexlen > a->size - index ||
+        names > a->size || a->nameslen > a->size - names ||
+        data > a->size || a->datalen > a->size - data) {
+        DEBUGMSG(ERROR, "archive: %s is not an archive or damaged\n", path);
+        ccnl_archive_close(a);
+        return NULL;
+    }
+    a->index = a->map + index;
+    a->names = a->map + names;
+    a->data = a->map + data;
+    return a;
+}
+
+void
+ccnl_archive_close(struct ccnl_archive_s *a)
+{
+    if (a) {
+        munmap(a->map, a->size);
+        ccnl_free(a);
+    }
+}
+
+uint32_t
+ccnl_archive_count(struct ccnl_archive_s *a)
+{
+    return a->count;
+}
+
+int
+ccnl_archive_lookup(struct ccnl_archive_s *a, struct ccnl_pkt_s *pkt,
+                    uint8_t **data, size_t *len)
+{
+    struct ccnl_archive_entry_s e;
+    struct ccnl_prefix_s *pfx = pkt->pfx;
+    uint32_t lo = 0, hi = a->count, mid, i;
+    int prefixof;
+
+    if (!pfx) {
+        return -1;
+    }
+    // the first entry not below (suite, name)
+    while (lo < hi) {
+        mid = lo + (hi - lo) / 2;
+        if (!ccnl_archive_entry(a, mid, &e) &&
+            ccnl_archive_cmpEntry(&e, pkt->suite, pfx, &prefixof) < 0) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+
+    for (i = lo; i < a->count && i - lo < CCNL_ARCHIVE_SCAN; i++) {
+        if (ccnl_archive_entry(a, i, &e)) {
+            return -1;
+        }
+        ccnl_archive_cmpEntry(&e, pkt->suite, pfx, &prefixof);
+        if (!prefixof) {
+            return -1; // past the names under pfx
+        }
+        switch (pkt->suite) {
+#ifdef USE_SUITE_CCNTLV
+        case CCNL_SUITE_CCNTLV:
+            if (e.compcnt != pfx->compcnt) {
+                return -1; // exact match only
+            }
+            break;
+#endif
+#ifdef USE_SUITE_NDNTLV
+        case CCNL_SUITE_NDNTLV:
+            // the implicit digest counts as a component, see
+            // ccnl_i_prefixof_c()
+            if (pfx->compcnt + pkt->s.ndntlv.minsuffix > (uint64_t) e.compcnt + 1 ||
+                pfx->compcnt + pkt->s.ndntlv.maxsuffix < (uint64_t) e.compcnt + 1) {
+                continue;
+            }
+            break;
+#endif
+        default:
+            return -1;
+        }
+        *data = (uint8_t*) a->data + e.offset;
+        *len = e.len;
+        return 0;
+    }
+    return -1;
+}
+
+// ----------------------------------------------------------------------
+
+int
+ccnl_archive_add(const char *path)
+{
+    struct ccnl_archive_s *a = ccnl_archive_open(path);
+
+    if (!a) {
+        return -1;
+    }
+    a->next = archives;
+    archives = a;
+    DEBUGMSG(INFO, "archive: serving %u packets from %s\n", a->count, path);
+    return 0;
+}
+
+int
+ccnl_archive_producer(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+                      struct ccnl_pkt_s *pkt)
+{
+    struct ccnl_archive_s *a;
+    struct ccnl_buf_s *buf;
+    uint8_t *data;
+    size_t len;
+
+    if (!from) {
+        return 0;
+    }
+    for (a = archives; a; a = a->next) {
+        if (ccnl_archive_lookup(a, pkt, &data, &len)) {
+            continue;
+        }
+        buf = ccnl_buf_new(data, len);
+        if (!buf) {
+            return 0;
+        }
+        a->served++;
+        ccnl_face_enqueue(relay, from, buf);
+        return 1;
+    }
+    return 0;
+}
+
+void
+ccnl_archive_cleanup(void)
+{
+    struct ccnl_archive_s *a;
+
+    while (archives) {
+        a = archives;
+        archives = a->next;
+        DEBUGMSG(INFO, "archive: %lu packets served\n", a->served);
+        ccnl_archive_close(a);
+    }
+}
+
+// eof
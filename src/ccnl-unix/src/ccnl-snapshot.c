@@ -0,0 +1,636 @@
+/*
+ * @f ccnl-snapshot.c
+ * @b warm restart: content store and routing state across relay restarts
+ *
+ * Copyright (C) 2011-18 University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#include "ccnl-snapshot.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ccnl-face.h"
+#include "ccnl-relay.h"
+#include "ccnl-pkt-util.h"
+#include "ccnl-pkt-ccnb.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-ndntlv.h"
+
+// restored face: its id in the snapshot and in this relay
+struct ccnl_snapshot_face_s {
+    uint32_t oldid;
+    struct ccnl_face_s *face;
+};
+
+struct ccnl_snapshot_restore_s {
+    struct ccnl_relay_s *relay;
+    FILE *fp;
+    void *timer;                    // pending ccnl_snapshot_step()
+    uint32_t downtime;              // seconds between writing and reading
+    struct ccnl_snapshot_face_s *faces;
+    int facecnt, facemax;
+    int restored, skipped;
+};
+
+static struct ccnl_snapshot_restore_s *restoring;
+static int lastcount;
+
+// ----------------------------------------------------------------------
+// byte order
+
+static uint16_t
+ccnl_snapshot_get16(const uint8_t *p)
+{
+    return (uint16_t) ((p[0] << 8) | p[1]);
+}
+
+static uint32_t
+ccnl_snapshot_get32(const uint8_t *p)
+{
+    return ((uint32_t) ccnl_snapshot_get16(p) << 16) |
+           ccnl_snapshot_get16(p + 2);
+}
+
+static void
+ccnl_snapshot_put16(uint8_t *p, uint16_t v)
+{
+    p[0] = (uint8_t) (v >> 8);
+    p[1] = (uint8_t) v;
+}
+
+static void
+ccnl_snapshot_put32(uint8_t *p, uint32_t v)
+{
+    ccnl_snapshot_put16(p, (uint16_t) (v >> 16));
+    ccnl_snapshot_put16(p + 2, (uint16_t) v);
+}
+
+// ----------------------------------------------------------------------
+// writing
+
+static int
+ccnl_snapshot_putRecord(FILE *fp, uint8_t type, const uint8_t *hdr,
+                        size_t hdrlen, const uint8_t *data, size_t datalen)
+{
+    uint8_t tl[5];
+
+    tl[0] = type;
+    ccnl_snapshot_put32(tl + 1, (uint32_t) (hdrlen + datalen));
+    if (fwrite(tl, 1, sizeof(tl), fp) != sizeof(tl) ||
+        fwrite(hdr, 1, hdrlen, fp) != hdrlen ||
+        (datalen && fwrite(data, 1, datalen, fp) != datalen)) {
+        return -1;
+    }
+    return 0;
+}
+
+// static faces on a real interface can be recreated after a restart
+static int
+ccnl_snapshot_keepFace(struct ccnl_face_s *f)
+{
+    return f && f->ifndx >= 0 && (f->flags & CCNL_FACE_FLAGS_STATIC);
+}
+
+static int
+ccnl_snapshot_putFace(FILE *fp, struct ccnl_face_s *f)
+{
+    uint8_t hdr[20];
+
+    ccnl_snapshot_put32(hdr, (uint32_t) f->faceid);
+    ccnl_snapshot_put32(hdr + 4, (uint32_t) f->flags);
+    ccnl_snapshot_put32(hdr + 8, (uint32_t) f->weight);
+    ccnl_snapshot_put32(hdr + 12, (uint32_t) f->irate);
+    ccnl_snapshot_put32(hdr + 16, (uint32_t) f->iburst);
+    return ccnl_snapshot_putRecord(fp, CCNL_SNAPSHOT_FACE, hdr, sizeof(hdr),
+                                   (uint8_t*) &f->peer, sizeof(f->peer));
+}
+
+static int
+ccnl_snapshot_putFib(FILE *fp, struct ccnl_forward_s *fwd)
+{
+    struct ccnl_prefix_s *pfx = fwd->prefix;
+    size_t len = 7;
+    uint8_t *buf, *p;
+    uint32_t i;
+    int rc;
+
+    for (i = 0; i < pfx->compcnt; i++) {
+        if (pfx->complen[i] > 0xffff) {
+            return 0;
+        }
+        len += 2 + pfx->complen[i];
+    }
+    buf = (uint8_t*) ccnl_malloc(len);
+    if (!buf) {
+        return -1;
+    }
+    ccnl_snapshot_put32(buf, (uint32_t) fwd->face->faceid);
+    buf[4] = (uint8_t) fwd->suite;
+    ccnl_snapshot_put16(buf + 5, (uint16_t) pfx->compcnt);
+    for (i = 0, p = buf + 7; i < pfx->compcnt; i++) {
+        ccnl_snapshot_put16(p, (uint16_t) pfx->complen[i]);
+        memcpy(p + 2, pfx->comp[i], pfx->complen[i]);
+        p += 2 + pfx->complen[i];
+    }
+    rc = ccnl_snapshot_putRecord(fp, CCNL_SNAPSHOT_FIB, buf, len, NULL, 0);
+    ccnl_free(buf);
+    return rc;
+}
+
+static int
+ccnl_snapshot_putContent(FILE *fp, struct ccnl_content_s *c, uint32_t now)
+{
+    uint8_t hdr[9];
+
+    ccnl_snapshot_put32(hdr, c->last_used < now ? now - c->last_used : 0);
+    ccnl_snapshot_put32(hdr + 4, (uint32_t) c->served_cnt);
+    hdr[8] = (uint8_t) (c->flags & CCNL_CONTENT_FLAGS_STALE);
+    return ccnl_snapshot_putRecord(fp, CCNL_SNAPSHOT_CONTENT, hdr, sizeof(hdr),
+                                   c->pkt->buf->data, c->pkt->buf->datalen);
+}
+
+int
+ccnl_snapshot_write(struct ccnl_relay_s *relay, const char *path)
+{
+    struct ccnl_face_s *f;
+    struct ccnl_forward_s *fwd;
+    struct ccnl_content_s *c;
+    uint8_t hdr[CCNL_SNAPSHOT_HDRLEN];
+    uint32_t now = (uint32_t) CCNL_NOW();
+    uint64_t t = (uint64_t) time(NULL);
+    char tmp[1024];
+    int cnt = 0;
+    FILE *fp;
+
+    // do not lose what has not been read back yet
+    ccnl_snapshot_finish();
+
+    snprintf(tmp, sizeof(tmp), "%s.tmp", path);
+    fp = fopen(tmp, "wb");
+    if (!fp) {
+        DEBUGMSG(ERROR, "snapshot: cannot create %s\n", tmp);
+        return -1;
+    }
+    memcpy(hdr, CCNL_SNAPSHOT_MAGIC, 8);
+    ccnl_snapshot_put32(hdr + 8, CCNL_SNAPSHOT_VERSION);
+    ccnl_snapshot_put32(hdr + 12, (uint32_t) sizeof(sockunion));
+    ccnl_snapshot_put32(hdr + 16, (uint32_t) (t >> 32));
+    ccnl_snapshot_put32(hdr + 20, (uint32_t) t);
+    if (fwrite(hdr, 1, sizeof(hdr), fp) != sizeof(hdr)) {
+        goto Bail;
+    }
+
+    for (f = relay->faces; f; f = f->next) {
+        if (ccnl_snapshot_keepFace(f) && ccnl_snapshot_putFace(fp, f)) {
+            goto Bail;
+        }
+    }
+    for (fwd = relay->fib; fwd; fwd = fwd->next) {
+        if (fwd->prefix && ccnl_snapshot_keepFace(fwd->face) &&
+            ccnl_snapshot_putFib(fp, fwd)) {
+            goto Bail;
+        }
+    }
+    // from the tail, restoring prepends each object and keeps the order
+    for (c = relay->contents; c && c->next; c = c->next);
+    for (; c; c = c->prev) {
+        if ((c->flags & CCNL_CONTENT_FLAGS_STATIC) || !c->pkt->buf) {
+            continue;
+        }
+        if (ccnl_snapshot_putContent(fp, c, now)) {
+            goto Bail;
+        }
+        cnt++;
+    }
+
+    if (fflush(fp) || fsync(fileno(fp))) {
+        goto Bail;
+    }
+    fclose(fp);
+    if (rename(tmp, path)) {
+        DEBUGMSG(ERROR, "snapshot: cannot rename %s to %s\n", tmp, path);
+        unlink(tmp);
+        return -1;
+    }
+    DEBUGMSG(INFO, "snapshot: %d content objects saved to %s\n", cnt, path);
+    return cnt;
+
+Bail:
+    DEBUGMSG(ERROR, "snapshot: cannot write %s\n", tmp);
+    fclose(fp);
+    unlink(tmp);
+    return -1;
+}
+
+// ----------------------------------------------------------------------
+// reading
+
+// reads one record, 1 if there is one, 0 at the end, -1 on error
+static int
+ccnl_snapshot_getRecord(FILE *fp, uint8_t *type, uint8_t **payload,
+                        uint32_t *len)
+{
+    uint8_t tl[5];
+    size_t n = fread(tl, 1, sizeof(tl), fp);
+
+    if (!n) {
+        return 0;
+    }
+    if (n != sizeof(tl)) {
+        return -1;
+    }
+    *type = tl[0];
+    *len = ccnl_snapshot_get32(tl + 1);
+    if (*len > CCNL_MAX_PACKET_SIZE + 9) {
+        return -1;
+    }
+    *payload = (uint8_t*) ccnl_malloc(*len ? *len : 1);
+    if (!*payload) {
+        return -1;
+    }
+    if (fread(*payload, 1, *len, fp) != *len) {
+        ccnl_free(*payload);
+        return -1;
+    }
+    return 1;
+}
+
+static int
+ccnl_snapshot_addFace(struct ccnl_snapshot_restore_s *r, uint8_t *p,
+                      uint32_t len)
+{
+    struct ccnl_face_s *f;
+    sockunion peer;
+
+    if (len != 20 + sizeof(peer)) {
+        return -1;
+    }
+    memcpy(&peer, p + 20, sizeof(peer));
+    f = ccnl_get_face_or_create(r->relay, -1, &peer.sa, sizeof(peer));
+    if (!f) {
+        DEBUGMSG(WARNING, "snapshot: no interface for face %s\n",
+                 ccnl_addr2ascii(&peer));
+        return 0;
+    }
+    f->flags |= (int) ccnl_snapshot_get32(p + 4);
+    f->weight = (int) ccnl_snapshot_get32(p + 8);
+    if (ccnl_snapshot_get32(p + 12)) {
+        ccnl_face_set_interest_rate(f, (int) ccnl_snapshot_get32(p + 12),
+                                    (int) ccnl_snapshot_get32(p + 16));
+    }
+
+    if (r->facecnt == r->facemax) {
+        int max = r->facemax ? 2 * r->facemax : 8;
+        struct ccnl_snapshot_face_s *faces = (struct ccnl_snapshot_face_s*)
+                                    ccnl_malloc(max * sizeof(*faces));
+        if (!faces) {
+            return -1;
+        }
+        if (r->facecnt) {
+            memcpy(faces, r->faces, r->facecnt * sizeof(*faces));
+        }
+        ccnl_free(r->faces);
+        r->faces = faces;
+        r->facemax = max;
+    }
+    r->faces[r->facecnt].oldid = ccnl_snapshot_get32(p);
+    r->faces[r->facecnt].face = f;
+    r->facecnt++;
+    return 0;
+}
+
+static int
+ccnl_snapshot_addFib(struct ccnl_snapshot_restore_s *r, uint8_t *p,
+                     uint32_t len)
+{
+    struct ccnl_face_s *face = NULL;
+    struct ccnl_prefix_s *pfx;
+    uint32_t oldid, i, cnt, off, total = 0;
+    int n;
+
+    if (len < 7) {
+        return -1;
+    }
+    oldid = ccnl_snapshot_get32(p);
+    cnt = ccnl_snapshot_get16(p + 5);
+    if (!cnt || cnt > CCNL_MAX_NAME_COMP) {
+        return -1;
+    }
+    // check the components before building the prefix
+    for (i = 0, off = 7; i < cnt; i++) {
+        if (off + 2 > len || off + 2 + ccnl_snapshot_get16(p + off) > len) {
+            return -1;
+        }
+        total += ccnl_snapshot_get16(p + off);
+        off += 2 + ccnl_snapshot_get16(p + off);
+    }
+    for (n = 0; n < r->facecnt; n++) {
+        if (r->faces[n].oldid == oldid) {
+            face = r->faces[n].face;
+            break;
+        }
+    }
+    if (!face) {
+        return 0;
+    }
+
+    pfx = ccnl_prefix_new((char) p[4], cnt);
+    if (!pfx) {
+        return -1;
+    }
+    pfx->bytes = (uint8_t*) ccnl_malloc(total ? total : 1);
+    if (!pfx->bytes) {
+        ccnl_prefix_free(pfx);
+        return -1;
+    }
+    for (i = 0, off = 7, total = 0; i < cnt; i++) {
+        pfx->complen[i] = ccnl_snapshot_get16(p + off);
+        pfx->comp[i] = pfx->bytes + total;
+        memcpy(pfx->comp[i], p + off + 2, pfx->complen[i]);
+        total += (uint32_t) pfx->complen[i];
+        off += 2 + (uint32_t) pfx->complen[i];
+    }
+    ccnl_prefix_updateHashes(pfx);
+    if (ccnl_fib_add_entry(r->relay, pfx, face)) {
+        ccnl_prefix_free(pfx);
+        return -1;
+    }
+    return 0;
+}
+
+// parses a Data packet, as ccnl_populate_cache() does
+static struct ccnl_pkt_s*
+ccnl_snapshot_parse(uint8_t *data, size_t datalen)
+{
+    size_t skip = 0;
+    int suite = ccnl_pkt2suite(data, datalen, &skip);
+    uint8_t *start;
+
+    if (skip > datalen) {
+        return NULL;
+    }
+    start = data += skip;
+    datalen -= skip;
+    (void) start;
+
+    switch (suite) {
+#ifdef USE_SUITE_CCNB
+    case CCNL_SUITE_CCNB:
+        if (datalen < 2 || data[0] != 0x04 || data[1] != 0x82) {
+            return NULL;
+        }
+        data += 2;
+        datalen -= 2;
+        return ccnl_ccnb_bytes2pkt(start, &data, &datalen);
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        size_t hdrlen;
+
+        if (ccnl_ccntlv_getHdrLen(data, datalen, &hdrlen)) {
+            return NULL;
+        }
+        data += hdrlen;
+        datalen -= hdrlen;
+        return ccnl_ccntlv_bytes2pkt(start, &data, &datalen);
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        uint64_t typ;
+        size_t len;
+
+        if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &len) ||
+            typ != NDN_TLV_Data) {
+            return NULL;
+        }
+        return ccnl_ndntlv_bytes2pkt(typ, start, &data, &datalen);
+    }
+#endif
+    default:
+        return NULL;
+    }
+}
+
+// 1 if the object was added, 0 if it was dropped, -1 on error
+static int
+ccnl_snapshot_addContent(struct ccnl_snapshot_restore_s *r, uint8_t *p,
+                         uint32_t len)
+{
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c;
+    uint32_t age, now = (uint32_t) CCNL_NOW();
+
+    if (len < 9) {
+        return -1;
+    }
+    age = ccnl_snapshot_get32(p) + r->downtime;
+    if (age >= CCNL_CONTENT_TIMEOUT) {
+        return 0;
+    }
+    pkt = ccnl_snapshot_parse(p + 9, len - 9);
+    if (!pkt || !pkt->pfx) {
+        ccnl_pkt_free(pkt);
+        return -1;
+    }
+    c = ccnl_content_new(&pkt);
+    if (!c) {
+        ccnl_pkt_free(pkt);
+        return -1;
+    }
+    c->served_cnt = (int) ccnl_snapshot_get32(p + 4);
+    c->flags = p[8] & CCNL_CONTENT_FLAGS_STALE;
+    if (age <= now) {
+        c->last_used = now - age;
+    } else {
+        // the relay clock starts at zero, the part of the age before it
+        // comes off the freshness period instead
+        c->last_used = 0;
+#ifdef USE_SUITE_NDNTLV
+        if (c->pkt->suite == CCNL_SUITE_NDNTLV) {
+            uint64_t early = (uint64_t) (age - now) * 1000;
+            uint64_t *fp = &c->pkt->s.ndntlv.freshnessperiod;
+
+            *fp = *fp > early ? *fp - early : 0;
+        }
+#endif
+    }
+#ifdef USE_SUITE_NDNTLV
+    if (c->pkt->suite == CCNL_SUITE_NDNTLV &&
+        c->last_used + c->pkt->s.ndntlv.freshnessperiod / 1000 <= now) {
+        c->flags |= CCNL_CONTENT_FLAGS_STALE;
+    }
+#endif
+
+    // a copy received since the start is newer
+    if (!ccnl_content_add2cache(r->relay, c)) {
+        ccnl_content_free(c);
+        return 0;
+    }
+    if (r->relay->pit) {
+        ccnl_content_serve_pending(r->relay, c);
+    }
+    return 1;
+}
+
+// restores records up to max content objects (all if max < 0), 1 if
+// there are more
+static int
+ccnl_snapshot_load(struct ccnl_snapshot_restore_s *r, int max)
+{
+    uint8_t type, *payload;
+    uint32_t len;
+    int rc;
+
+    while (max < 0 || max > 0) {
+        rc = ccnl_snapshot_getRecord(r->fp, &type, &payload, &len);
+        if (rc <= 0) {
+            if (rc < 0) {
+                DEBUGMSG(WARNING, "snapshot: truncated or corrupt\n");
+            }
+            return 0;
+        }
+        switch (type) {
+        case CCNL_SNAPSHOT_FACE:
+            rc = ccnl_snapshot_addFace(r, payload, len);
+            break;
+        case CCNL_SNAPSHOT_FIB:
+            rc = ccnl_snapshot_addFib(r, payload, len);
+            break;
+        case CCNL_SNAPSHOT_CONTENT:
+            rc = ccnl_snapshot_addContent(r, payload, len);
+            if (rc > 0) {
+                r->restored++;
+            } else if (!rc) {
+                r->skipped++;
+            }
+            rc = rc < 0 ? rc : 0;
+            if (max > 0) {
+                max--;
+            }
+            break;
+        default:    // written by a later version
+            rc = 0;
+            break;
+        }
+        ccnl_free(payload);
+        if (rc < 0) {
+            DEBUGMSG(WARNING, "snapshot: bad record of type %d\n", type);
+            r->skipped++;
+        }
+    }
+    return 1;
+}
+
+static void
+ccnl_snapshot_done(struct ccnl_snapshot_restore_s *r)
+{
+    DEBUGMSG(INFO, "snapshot: %d content objects restored, %d dropped\n",
+             r->restored, r->skipped);
+    lastcount = r->restored;
+    fclose(r->fp);
+    ccnl_free(r->faces);
+    ccnl_free(r);
+    restoring = NULL;
+}
+
+static void
+ccnl_snapshot_step(void *relay, void *aux)
+{
+    struct ccnl_snapshot_restore_s *r = (struct ccnl_snapshot_restore_s*) aux;
+
+    (void) relay;
+    r->timer = NULL;
+    if (ccnl_snapshot_load(r, CCNL_SNAPSHOT_BATCH)) {
+        // let the IO loop in before the next batch
+        r->timer = ccnl_set_timer(0, ccnl_snapshot_step, relay, r);
+        if (r->timer) {
+            return;
+        }
+        ccnl_snapshot_load(r, -1);
+    }
+    ccnl_snapshot_done(r);
+}
+
+int
+ccnl_snapshot_restore(struct ccnl_relay_s *relay, const char *path)
+{
+    struct ccnl_snapshot_restore_s *r;
+    uint8_t hdr[CCNL_SNAPSHOT_HDRLEN];
+    uint64_t written, now = (uint64_t) time(NULL);
+    FILE *fp;
+
+    ccnl_snapshot_finish();
+    fp = fopen(path, "rb");
+    if (!fp) {
+        DEBUGMSG(INFO, "snapshot: no %s, starting cold\n", path);
+        return -1;
+    }
+    if (fread(hdr, 1, sizeof(hdr), fp) != sizeof(hdr) ||
+        memcmp(hdr, CCNL_SNAPSHOT_MAGIC, 8) ||
+        ccnl_snapshot_get32(hdr + 8) != CCNL_SNAPSHOT_VERSION ||
+        ccnl_snapshot_get32(hdr + 12) != sizeof(sockunion)) {
+        DEBUGMSG(WARNING, "snapshot: %s is not a snapshot of this relay\n",
+                 path);
+        fclose(fp);
+        return -1;
+    }
+    written = (uint64_t) ccnl_snapshot_get32(hdr + 16) << 32 |
+              ccnl_snapshot_get32(hdr + 20);
+
+    r = (struct ccnl_snapshot_restore_s*) ccnl_calloc(1, sizeof(*r));
+    if (!r) {
+        fclose(fp);
+        return -1;
+    }
+    r->relay = relay;
+    r->fp = fp;
+    r->downtime = now > written ? (uint32_t) (now - written) : 0;
+    restoring = r;
+    DEBUGMSG(INFO, "snapshot: restoring %s, written %lu s ago\n",
+             path, (unsigned long) r->downtime);
+
+    // faces and FIB now, the content store in the background
+    if (ccnl_snapshot_load(r, 1)) {
+        r->timer = ccnl_set_timer(0, ccnl_snapshot_step, relay, r);
+        if (r->timer) {
+            return 0;
+        }
+        ccnl_snapshot_load(r, -1);
+    }
+    ccnl_snapshot_done(r);
+    return 0;
+}
+
+int
+ccnl_snapshot_finish(void)
+{
+    if (restoring) {
+        if (restoring->timer) {
+            ccnl_rem_timer(restoring->timer);
+        }
+        ccnl_snapshot_load(restoring, -1);
+        ccnl_snapshot_done(restoring);
+    }
+    return lastcount;
+}
+
+// eof
@@ -35,6 +35,9 @@
 #ifdef USE_HTTP_STATUS
 #include "ccnl-http-status.h"
 #endif
+#ifdef USE_VERIFY_POOL
+#include "ccnl-verify.h"
+#endif
 
 /**
  * TODO: The variables are never updated within the context of
@@ -46,6 +49,8 @@ static int inter_ccn_interval = 0; // in usec
 static int inter_pkt_interval = 0; // in usec
 #endif 
 
+volatile sig_atomic_t ccnl_io_halt;
+
 #ifdef USE_LINKLAYER
 int
 ccnl_open_ethdev(char *devname, struct sockaddr_ll *sll, uint16_t ethtype)
@@ -441,6 +446,7 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     relay->nonces = NULL;
     relay->max_cache_entries = max_cache_entries;
     relay->max_pit_entries = CCNL_DEFAULT_MAX_PIT_ENTRIES;
+    relay->max_pit_bytes = CCNL_DEFAULT_MAX_PIT_BYTES;
     relay->ccnl_ll_TX_ptr = &ccnl_ll_TX;
 
 #ifdef USE_SCHEDULER
@@ -559,13 +565,76 @@ ccnl_relay_config(struct ccnl_relay_s *relay, char *ethdev, char *wpandev,
     ccnl_set_timer(1000000, ccnl_ageing, relay, 0);
 }
 
+// reads what is queued on an interface, up to CCNL_RX_BATCH datagrams,
+// and hands them to the forwarder as one vector
+static void
+ccnl_io_RXbatch(struct ccnl_relay_s *ccnl, int ifndx)
+{
+    static uint8_t bufs[CCNL_RX_BATCH][CCNL_MAX_PACKET_SIZE];
+    struct ccnl_rx_s rx[CCNL_RX_BATCH];
+    size_t n = 0, tries;
+
+    // the socket is readable, so only the first read may block
+    for (tries = 0; tries < CCNL_RX_BATCH; tries++) {
+        struct ccnl_rx_s *r = rx + n;
+        socklen_t addrlen = sizeof(sockunion);
+        ssize_t recvlen;
+
+        recvlen = recvfrom(ccnl->ifs[ifndx].sock, bufs[n], sizeof(bufs[n]),
+                           tries ? MSG_DONTWAIT : 0, &r->src.sa, &addrlen);
+        if (recvlen <= 0) {
+            break;
+        }
+        r->ifndx = ifndx;
+        r->data = bufs[n];
+        r->datalen = (size_t) recvlen;
+        if (0) {}
+#ifdef USE_IPV4
+        else if (r->src.sa.sa_family == AF_INET) {
+            r->addrlen = sizeof(r->src.ip4);
+        }
+#endif
+#ifdef USE_IPV6
+        else if (r->src.sa.sa_family == AF_INET6) {
+            r->addrlen = sizeof(r->src.ip6);
+        }
+#endif
+#ifdef USE_LINKLAYER
+        else if (r->src.sa.sa_family == AF_PACKET) {
+            if (r->datalen <= 14) {
+                continue;
+            }
+            r->data += 14;
+            r->datalen -= 14;
+            r->addrlen = sizeof(r->src.linklayer);
+        }
+#endif
+#ifdef USE_WPAN
+        else if (r->src.sa.sa_family == AF_IEEE802154) {
+            if (r->datalen <= 14) {
+                continue;
+            }
+            r->addrlen = sizeof(r->src.linklayer);
+        }
+#endif
+#ifdef USE_UNIXSOCKET
+        else if (r->src.sa.sa_family == AF_UNIX) {
+            r->addrlen = sizeof(r->src.ux);
+        }
+#endif
+        else {
+            continue;
+        }
+        n++;
+    }
+    ccnl_core_RXbatch(ccnl, rx, n);
+}
+
 int
 ccnl_io_loop(struct ccnl_relay_s *ccnl)
 {
     int i, maxfd = -1, rc;
-    size_t len;
     fd_set readfs, writefs;
-    unsigned char buf[CCNL_MAX_PACKET_SIZE];
 
     if (ccnl->ifcount == 0) {
         DEBUGMSG(ERROR, "no socket to work with, not good, quitting\n");
@@ -579,7 +648,7 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
     maxfd++;
 
     DEBUGMSG(INFO, "starting main event and IO loop\n");
-    while (!ccnl->halt_flag) {
+    while (!ccnl->halt_flag && !ccnl_io_halt) {
         int usec;
 
         FD_ZERO(&readfs);
@@ -594,6 +663,15 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
                 FD_SET(ccnl->ifs[i].sock, &writefs);
             }
         }
+#ifdef USE_VERIFY_POOL
+        if (ccnl_verify_fd(ccnl->verify) >= 0) {
+            int fd = ccnl_verify_fd(ccnl->verify);
+            FD_SET(fd, &readfs);
+            if (fd >= maxfd) {
+                maxfd = fd + 1;
+            }
+        }
+#endif
 
         usec = ccnl_run_events();
         if (usec >= 0) {
@@ -606,57 +684,25 @@ ccnl_io_loop(struct ccnl_relay_s *ccnl)
         }
 
         if (rc < 0) {
+            if (errno == EINTR) { // a signal, maybe to halt
+                continue;
+            }
             perror("select(): ");
             exit(EXIT_FAILURE);
         }
 
 #ifdef USE_HTTP_STATUS
         ccnl_http_postselect(ccnl, ccnl->http, &readfs, &writefs);
+#endif
+#ifdef USE_VERIFY_POOL
+        if (ccnl_verify_fd(ccnl->verify) >= 0 &&
+            FD_ISSET(ccnl_verify_fd(ccnl->verify), &readfs)) {
+            ccnl_verify_poll(ccnl);
+        }
 #endif
         for (i = 0; i < ccnl->ifcount; i++) {
             if (FD_ISSET(ccnl->ifs[i].sock, &readfs)) {
-                sockunion src_addr;
-                socklen_t addrlen = sizeof(sockunion);
-                ssize_t recvlen;
-                if ((recvlen = recvfrom(ccnl->ifs[i].sock, buf, sizeof(buf), 0,
-                                (struct sockaddr*) &src_addr, &addrlen)) > 0) {
-                    len = (size_t) recvlen;
-                    if (0) {}
-#ifdef USE_IPV4
-                    else if (src_addr.sa.sa_family == AF_INET) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip4));
-                    }
-#endif
-#ifdef USE_IPV6
-                    else if (src_addr.sa.sa_family == AF_INET6) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ip6));
-                    }
-#endif
-#ifdef USE_LINKLAYER
-                    else if (src_addr.sa.sa_family == AF_PACKET) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf + 14, len - 14,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_WPAN
-                    else if (src_addr.sa.sa_family == AF_IEEE802154) {
-                        if (len > 14) {
-                            ccnl_core_RX(ccnl, i, buf, len,
-                                         &src_addr.sa, sizeof(src_addr.linklayer));
-                        }
-                    }
-#endif
-#ifdef USE_UNIXSOCKET
-                    else if (src_addr.sa.sa_family == AF_UNIX) {
-                        ccnl_core_RX(ccnl, i, buf, len,
-                                     &src_addr.sa, sizeof(src_addr.ux));
-                    }
-#endif
-                }
+                ccnl_io_RXbatch(ccnl, i);
             }
 
             if (FD_ISSET(ccnl->ifs[i].sock, &writefs)) {
@@ -740,6 +786,7 @@ ccnl_populate_cache(struct ccnl_relay_s *ccnl, char *path)
             continue;
         }
         buf->datalen = datalen;
+        buf->flags = 0;
         suite = ccnl_pkt2suite(buf->data, datalen, &skip);
 
         pk = NULL;
@@ -812,7 +859,7 @@ Done:
         ccnl_pkt_free(pk);
         ccnl_free(buf);
         continue;
-#if defined(USE_SUITE_CCNB) || defined(USE_SUITE_NDNTLV)
+#if defined(USE_SUITE_CCNB) || defined(USE_SUITE_CCNTLV) || defined(USE_SUITE_NDNTLV)
 notacontent:
         DEBUGMSG(WARNING, "not a content object (%s)\n", de->d_name);
         ccnl_free(buf);
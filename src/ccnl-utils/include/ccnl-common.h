@@ -80,7 +80,7 @@ int ccnl_pkt_prependComponent(int suite, char *src, int *offset, unsigned char *
 
 // include only the utils, not the core routines:
 #ifdef USE_FRAG
-#include "../ccnl-frag.h"
+#include "ccnl-frag.h"
 #endif
 
 #else // CCNL_UAPI_H_ is defined
@@ -23,6 +23,9 @@
 #define CCNL_EXT_MAC_H_
 
 #include "lib-sha256.h"
+#ifdef USE_VERIFY_POOL
+#include "ccnl-verify.h"
+#endif
 
 #include "ccnl-pkt-ccnb.h"
 #include "ccnl-pkt-ccntlv.h"
@@ -30,6 +33,14 @@
 #include "ccnl-pkt-ndntlv.h"
 #include "ccnl-pkt-switch.h"
 
+/**
+ * @brief HMAC key with its inner and outer pad blocks already hashed
+ */
+struct ccnl_hmac256_key_s {
+    SHA256_CTX_t inner; /**< state after hashing key XOR ipad */
+    SHA256_CTX_t outer; /**< state after hashing key XOR opad */
+};
+
 /**
  * @brief Generates an HMAC key
  * 
@@ -73,6 +84,9 @@ ccnl_hmac256_keysetup(SHA256_CTX_t *ctx, uint8_t *keyval, size_t kvlen,
 
 /**
  * @brief Generates an HMAC signature
+ *
+ * Sets up the key for this one signature: to sign many messages with the
+ * same key, use ccnl_hmac256_keyinit() once and ccnl_hmac256_signKey().
  * 
  * @param[in]  keyval The key
  * @param[in]  kvlen The lengthof the key
@@ -86,6 +100,68 @@ ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
                   uint8_t *data, size_t dlen,
                   uint8_t *md, size_t *mlen);
 
+/**
+ * @brief Prepares a key for repeated signing
+ *
+ * Hashes the inner and outer pad blocks once, so that signing with
+ * \p key costs two SHA-256 compressions less per message.
+ *
+ * @param[out] key    The prepared key
+ * @param[in]  keyval The key value (see \ref ccnl_hmac256_keyval)
+ * @param[in]  kvlen  The length of \p keyval
+ */
+void
+ccnl_hmac256_keyinit(struct ccnl_hmac256_key_s *key,
+                     uint8_t *keyval, size_t kvlen);
+
+/**
+ * @brief Generates an HMAC signature with a prepared key
+ *
+ * @param[in]  key  The prepared key
+ * @param[in]  data The data to sign
+ * @param[in]  dlen The length of \p data
+ * @param[out] md   The message digest
+ * @param[in,out] mlen The size of \p md, the length of the digest
+ */
+void
+ccnl_hmac256_signKey(struct ccnl_hmac256_key_s *key,
+                     uint8_t *data, size_t dlen,
+                     uint8_t *md, size_t *mlen);
+
+/**
+ * @brief Generates \p n HMAC signatures with the same key at once
+ *
+ * Uses the SHA-256 batch kernels, see \ref ccnl_SHA256_Batch.
+ *
+ * @param[in]  key  The prepared key
+ * @param[in]  n    The number of messages
+ * @param[in]  data The messages to sign
+ * @param[in]  dlen The lengths of the messages
+ * @param[out] md   \p n buffers of SHA256_DIGEST_LENGTH bytes each
+ */
+void
+ccnl_hmac256_signBatch(struct ccnl_hmac256_key_s *key, size_t n,
+                       uint8_t *data[], size_t dlen[], uint8_t *md[]);
+
+#ifdef USE_VERIFY_POOL
+/**
+ * @brief Checks the HMAC signatures of a batch of verification jobs
+ *
+ * A 
+ef ccnl_verify_func for 
+ef ccnl_verify_new, with a prepared key as
+ * context. The signatures are computed with 
+ef ccnl_hmac256_signBatch
+ * and compared in constant time.
+ *
+ * @param[in] key  The prepared key (struct ccnl_hmac256_key_s*)
+ * @param[in] n    The number of jobs
+ * @param[in] jobs The jobs, their result is set
+ */
+void
+ccnl_hmac256_verifyBatch(void *key, size_t n, struct ccnl_verify_job_s *jobs[]);
+#endif
+
 
 #ifdef NEEDS_PACKET_CRAFTING
 #ifdef USE_SUITE_CCNTLV
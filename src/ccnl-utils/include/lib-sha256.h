@@ -2,7 +2,11 @@
  * @f lib-sha256.c
  * @b implementation of NIST SHA256, based on Aaron Gifford's code
  *
+ * 2026-10-19 SHA-NI and AVX2 multi-buffer kernels, batch API
  */
+#ifndef CCNL_LIB_SHA256_H
+#define CCNL_LIB_SHA256_H
+
 #include <assert.h>
 #include <stdint.h>
 #include <string.h>
@@ -125,4 +129,34 @@ void ccnl_SHA256_Update(SHA256_CTX_t* context, const sha2_byte *data, size_t len
 
 void ccnl_SHA256_Final(sha2_byte digest[], SHA256_CTX_t* context);
 
+/*** kernel selection and batches ************************************/
+
+#define CCNL_SHA256_SCALAR	0	/* portable C */
+#define CCNL_SHA256_AVX2	1	/* 8 messages at once, batches only */
+#define CCNL_SHA256_SHANI	2	/* SHA extensions, one message at a time */
+
+/*
+ * Selects the kernels to use. Without a call, the best level supported
+ * by the CPU is chosen on first use, which is not thread-safe: programs
+ * hashing from several threads call this before starting them. Forcing
+ * a lower level is meant for tests and benchmarks. Returns the level in
+ * effect, which may be lower than requested; pass -1 for the best one.
+ */
+int ccnl_SHA256_setLevel(int level);
+
+/* returns "scalar", "avx2" or "sha-ni" */
+const char* ccnl_SHA256_name(void);
+
+/*
+ * Finishes n hashes at once: context[i] is updated with data[i] and
+ * finalized into digest[i], as ccnl_SHA256_Update() followed by
+ * ccnl_SHA256_Final() would do. With the AVX2 kernel, up to eight
+ * messages share each compression; contexts holding a partial block
+ * are finished one at a time.
+ */
+void ccnl_SHA256_Batch(SHA256_CTX_t* context[], const sha2_byte *data[],
+		       const size_t len[], sha2_byte *digest[], size_t n);
+
+#endif /* CCNL_LIB_SHA256_H */
+
 // eof
@@ -0,0 +1,262 @@
+/*
+ * @f util/ccn-lite-archive.c
+ * @b CLI archive, packs Data packets into an indexed archive for the relay
+ *
+ * Copyright (C) 2011-18, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#include <dirent.h>
+
+#include "ccnl-common.h"
+#include "ccnl-archive.h"
+
+static struct ccnl_pkt_s **pkts;
+static size_t pktcnt, pktmax;
+
+// keeps a parsed Data packet
+static int
+addPkt(struct ccnl_pkt_s *pkt)
+{
+    if (pktcnt == pktmax) {
+        size_t max = pktmax ? 2 * pktmax : 1024;
+        struct ccnl_pkt_s **p = realloc(pkts, max * sizeof(*p));
+
+        if (!p) {
+            return -1;
+        }
+        pkts = p;
+        pktmax = max;
+    }
+    pkts[pktcnt++] = pkt;
+    return 0;
+}
+
+// splits a file into packets, as written by ccn-lite-produce or ccn-lite-mkC
+static void
+addFile(const char *fname)
+{
+    uint8_t *buf, *data;
+    size_t flen, datalen;
+    struct stat st;
+    int fd, suite;
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) || st.st_size <= 0) {
+        DEBUGMSG(WARNING, "cannot read %s\n", fname);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return;
+    }
+    flen = (size_t) st.st_size;
+    buf = (uint8_t*) ccnl_malloc(flen);
+    if (!buf || read(fd, buf, flen) != (ssize_t) flen) {
+        DEBUGMSG(WARNING, "cannot read %s\n", fname);
+        close(fd);
+        ccnl_free(buf);
+        return;
+    }
+    close(fd);
+
+    data = buf;
+    datalen = flen;
+    while (datalen >= 2) {
+        struct ccnl_pkt_s *pkt = NULL;
+        uint8_t *start;
+        size_t skip = 0, len;
+
+        suite = ccnl_pkt2suite(data, datalen, &skip);
+        if (skip > datalen) {
+            break;
+        }
+        data += skip;
+        datalen -= skip;
+        start = data;
+
+        switch (suite) {
+#ifdef USE_SUITE_CCNTLV
+        case CCNL_SUITE_CCNTLV: {
+            size_t hdrlen, pktlen;
+            uint8_t *body;
+
+            if (ccnl_ccntlv_getHdrLen(data, datalen, &hdrlen) ||
+                (pktlen = (size_t) (data[2] << 8 | data[3])) > datalen ||
+                pktlen < hdrlen) {
+                goto Bail;
+            }
+            data += pktlen;
+            datalen -= pktlen;
+            if (!ccntlv_isData(start, pktlen)) {
+                DEBUGMSG(INFO, "%s: skipping a non-Data packet\n", fname);
+                continue;
+            }
+            body = start + hdrlen;
+            len = pktlen - hdrlen;
+            pkt = ccnl_ccntlv_bytes2pkt(start, &body, &len);
+            break;
+        }
+#endif
+#ifdef USE_SUITE_NDNTLV
+        case CCNL_SUITE_NDNTLV: {
+            uint64_t typ;
+            size_t vallen;
+            uint8_t *value = data;
+
+            len = datalen;
+            if (ccnl_ndntlv_dehead(&value, &len, &typ, &vallen) ||
+                vallen > len) {
+                goto Bail;
+            }
+            len = vallen;
+            data = value + vallen;
+            datalen -= (size_t) (data - start);
+            if (typ != NDN_TLV_Data) {
+                DEBUGMSG(INFO, "%s: skipping a non-Data packet\n", fname);
+                continue;
+            }
+            pkt = ccnl_ndntlv_bytes2pkt(typ, start, &value, &len);
+            break;
+        }
+#endif
+        default:
+            goto Bail;
+        }
+        if (!pkt || !pkt->pfx || !pkt->buf) {
+            DEBUGMSG(WARNING, "%s: parsing error\n", fname);
+            ccnl_pkt_free(pkt);
+            continue;
+        }
+        if (addPkt(pkt)) {
+            ccnl_pkt_free(pkt);
+            break;
+        }
+    }
+    ccnl_free(buf);
+    return;
+
+Bail:
+    DEBUGMSG(WARNING, "%s: unknown packet format at byte %zu\n",
+             fname, flen - datalen);
+    ccnl_free(buf);
+}
+
+static void
+addPath(const char *path)
+{
+    struct stat st;
+    struct dirent *de;
+    DIR *dir;
+
+    if (stat(path, &st)) {
+        perror(path);
+        return;
+    }
+    if (!S_ISDIR(st.st_mode)) {
+        addFile(path);
+        return;
+    }
+    dir = opendir(path);
+    if (!dir) {
+        perror(path);
+        return;
+    }
+    while ((de = readdir(dir))) {
+        char fname[1000];
+
+        if (de->d_name[0] == '.') {
+            continue;
+        }
+        snprintf(fname, sizeof(fname), "%s/%s", path, de->d_name);
+        if (!stat(fname, &st) && S_ISREG(st.st_mode)) {
+            addFile(fname);
+        }
+    }
+    closedir(dir);
+}
+
+int
+main(int argc, char *argv[])
+{
+    struct ccnl_archive_item_s *items;
+    char *outfname = NULL;
+    size_t i;
+    int opt, rc;
+
+    while ((opt = getopt(argc, argv, "ho:v:")) != -1) {
+        switch (opt) {
+        case 'o':
+            outfname = optarg;
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0]))
+                debug_level =  (int)strtol(optarg, (char **)NULL, 10);
+            else
+                debug_level = ccnl_debug_str2level(optarg);
+#endif
+            break;
+        case 'h':
+        default:
+Usage:
+            fprintf(stderr,
+            "Packs Data packets into an archive for ccn-lite-relay -a.\n"
+            "usage: %s [options] FILE|DIR ...\n"
+            "  -o FNAME         the archive to write\n"
+#ifdef USE_LOGGING
+            "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+#endif
+            "A FILE can hold several packets (ccn-lite-produce output), of a DIR\n"
+            "all files are read (ccn-lite-produce -o output).\n",
+            argv[0]);
+            exit(1);
+        }
+    }
+    if (!outfname || optind >= argc) {
+        goto Usage;
+    }
+
+    for (; optind < argc; optind++) {
+        addPath(argv[optind]);
+    }
+
+    items = (struct ccnl_archive_item_s*)
+                        ccnl_calloc(pktcnt ? pktcnt : 1, sizeof(*items));
+    if (!items) {
+        return 1;
+    }
+    for (i = 0; i < pktcnt; i++) {
+        items[i].suite = pkts[i]->suite;
+        items[i].pfx = pkts[i]->pfx;
+        items[i].data = pkts[i]->buf->data;
+        items[i].len = pkts[i]->buf->datalen;
+    }
+    rc = ccnl_archive_write(outfname, items, pktcnt);
+    if (rc >= 0) {
+        fprintf(stderr, "%s: %d packets\n", outfname, rc);
+    }
+
+    ccnl_free(items);
+    // newest first, cheap for the debug allocator
+    while (pktcnt) {
+        ccnl_pkt_free(pkts[--pktcnt]);
+    }
+    free(pkts);
+    return rc < 0;
+}
+
+// eof
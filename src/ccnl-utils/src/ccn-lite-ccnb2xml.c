@@ -88,6 +88,8 @@ dtag2str(uint64_t dtag)
     case CCNL_DTAG_DEVNAME:       return "DEVNAME";
     case CCNL_DTAG_DEVFLAGS:      return "DEVFLAGS";
     case CCNL_DTAG_MTU:           return "MTU";
+    case CCNL_DTAG_CURSOR:        return "CURSOR";
+    case CCNL_DTAG_WEIGHT:        return "WEIGHT";
     case CCNL_DTAG_DEBUGREQUEST:  return "DEBUGREQUEST";
     case CCNL_DTAG_DEBUGACTION:   return "DEBUGACTION";
     case CCNL_DTAG_DEBUGREPLY:    return "DEBUGREPLY";
@@ -309,8 +311,8 @@ print_ccnb(uint8_t **buf, size_t *len, size_t offset, uint8_t ignoreBlobTag, int
 int
 main(int argc, char *argv[])
 {
-    unsigned char out[64000];
-    unsigned char *p_out;
+    unsigned char *out = NULL, *p_out;
+    size_t max = 0;
     size_t len;
     ssize_t len_s;
     int opt;
@@ -332,14 +334,28 @@ main(int argc, char *argv[])
         }
     }
 
-    len_s = read(0, out, sizeof(out));
-    if (len_s < 0) {
-        perror("read");
-        exit(-1);
-    }
-    len = (size_t) len_s;
+    // all of the input: a paged tabledump is one reply after the other
+    len = 0;
+    do {
+        if (len == max) {
+            max = max ? 2 * max : 64000;
+            p_out = (unsigned char*) realloc(out, max);
+            if (!p_out) {
+                perror("realloc");
+                exit(-1);
+            }
+            out = p_out;
+        }
+        len_s = read(0, out + len, max - len);
+        if (len_s < 0) {
+            perror("read");
+            exit(-1);
+        }
+        len += (size_t) len_s;
+    } while (len_s > 0);
 
     p_out = out;
     print_ccnb(&p_out, &len, 0, ignoreBlobTag, 0);
+    free(out);
     return 0;
 }
@@ -18,16 +18,25 @@
  *
  * File history:
  * 2013-07-22 created <christopher.scherb@unibas.ch>
+ * 2026-10-19 worker threads, requests are served concurrently
  */
 
 
 #include "ccnl-common.h"
 #include "ccnl-crypto.h"
 
+#include <pthread.h>
+
+#define CRYPTO_MAX_THREADS      16
+
 // ----------------------------------------------------------------------
 
 char *ux_path, *private_key, *ctrl_public_key;
 
+// Workers each receive and answer whole requests. Parsing and encoding
+// share ccnl_malloc() and stdout, so only the RSA operations run unlocked.
+static pthread_mutex_t crypto_lock = PTHREAD_MUTEX_INITIALIZER;
+
 /*int ux_sendto(int sock, char *topath, unsigned char *data, int len)
 {
     struct sockaddr_un name;
@@ -124,7 +133,9 @@ handle_verify(uint8_t **buf, size_t *buflen, int sock, char *callback){
 
     printf(" \tHandeling TXID: %s; Type: Verify; Siglen: %zu; Contentlen: %zu;\n", txid_s, siglen, contentlen);
 #ifdef USE_SIGNATURES
+    pthread_mutex_unlock(&crypto_lock);
     verified = verify(ctrl_public_key, content, contentlen, sig, siglen);
+    pthread_mutex_lock(&crypto_lock);
     printf("\tResult: Verified: %d\n", verified);
 #endif
 
@@ -238,7 +249,9 @@ handle_sign(uint8_t **buf, size_t *buflen, int sock, char *callback){
         goto Bail;
     }
 #ifdef USE_SIGNATURES
+    pthread_mutex_unlock(&crypto_lock);
     sign(private_key, content, contentlen, sig, &siglen);
+    pthread_mutex_lock(&crypto_lock);
 #endif
     if (siglen <= 0) {
         ccnl_free(sig);
@@ -490,15 +503,20 @@ int crypto_main_loop(int sock)
     }
     len = (size_t) len_s;
 
-    //pid = fork();
-    //if(pid == 0){
-        parse_crypto_packet(buf, len, sock);
-    //    _exit(0);
-    //}
+    pthread_mutex_lock(&crypto_lock);
+    parse_crypto_packet(buf, len, sock);
+    pthread_mutex_unlock(&crypto_lock);
 
     return 1;
 }
 
+static void*
+crypto_worker(void *arg)
+{
+    while (crypto_main_loop(*(int*) arg));
+    return NULL;
+}
+
 int main(int argc, char **argv)
 {
     if(argc < 3) {
@@ -509,13 +527,30 @@ int main(int argc, char **argv)
     if(argc >= 3) {
         private_key = argv[3];
     }
+    int nthreads = argc > 4 ? atoi(argv[4]) : 1;
+    if (nthreads < 1 || nthreads > CRYPTO_MAX_THREADS) {
+        goto Bail;
+    }
 
     int sock = ccnl_crypto_ux_open(ux_path);
-    while (crypto_main_loop(sock));
+    pthread_t threads[CRYPTO_MAX_THREADS];
+    int i, started = 0;
+    // datagrams are received whole, so the workers can share the socket
+    for (i = 1; i < nthreads; i++) {
+        if (pthread_create(threads + started, NULL, crypto_worker, &sock)) {
+            perror("pthread_create");
+            break;
+        }
+        started++;
+    }
+    crypto_worker(&sock);
+    for (i = 0; i < started; i++) {
+        pthread_join(threads[i], NULL);
+    }
     return 0;
 
     Bail:
     printf("Usage: %s crypto_ux_socket_path"
-        " public_key [private_key]\n", argv[0]);
+        " public_key [private_key [threads]]\n", argv[0]);
     return -1;
 }
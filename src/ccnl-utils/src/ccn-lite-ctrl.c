@@ -901,6 +901,88 @@ mkSetfragRequest(uint8_t *out, size_t outlen, char *faceid, char *frag, char *mt
 }
 
 
+int8_t
+mkSetweightRequest(uint8_t *out, size_t outlen, char *faceid, char *weight, char *private_key_path,
+                   size_t *reslen)
+{
+    size_t len = 0, len1 = 0, len2 = 0, len3 = 0;
+    uint8_t out1[CCNL_MAX_PACKET_SIZE];
+    uint8_t contentobj[2000];
+    uint8_t faceinst[2000];
+    (void)private_key_path;
+
+    if (ccnl_ccnb_mkHeader(out, out + outlen, CCN_DTAG_INTEREST, CCN_TT_DTAG, &len)) {   // interest
+        return -1;
+    }
+    if (ccnl_ccnb_mkHeader(out+len, out + outlen, CCN_DTAG_NAME, CCN_TT_DTAG, &len)) {  // name
+        return -1;
+    }
+
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "ccnx", &len1)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "", &len1)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "setweight", &len1)) {
+        return -1;
+    }
+
+    // prepare FACEINSTANCE
+    if (ccnl_ccnb_mkHeader(faceinst, faceinst + sizeof(faceinst), CCN_DTAG_FACEINSTANCE, CCN_TT_DTAG, &len3)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCN_DTAG_ACTION, CCN_TT_DTAG, "setweight", &len3)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCN_DTAG_FACEID, CCN_TT_DTAG, faceid, &len3)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(faceinst+len3, faceinst + sizeof(faceinst), CCNL_DTAG_WEIGHT, CCN_TT_DTAG, weight, &len3)) {
+        return -1;
+    }
+    if (len3 >= sizeof(faceinst)) {
+        return -1;
+    }
+    faceinst[len3++] = 0; // end-of-faceinst
+
+    // prepare CONTENTOBJ with CONTENT
+    if (ccnl_ccnb_mkHeader(contentobj, contentobj + sizeof(contentobj), CCN_DTAG_CONTENTOBJ, CCN_TT_DTAG, &len2)) {   // contentobj
+        return -1;
+    }
+    if (ccnl_ccnb_mkBlob(contentobj+len2, contentobj + sizeof(contentobj), CCN_DTAG_CONTENT, CCN_TT_DTAG,  // content
+                             (char*) faceinst, len3, &len2)) {
+        return -1;
+    }
+    if (len2 >= sizeof(contentobj)) {
+        return -1;
+    }
+    contentobj[len2++] = 0; // end-of-contentobj
+
+    // add CONTENTOBJ as the final name component
+    if (ccnl_ccnb_mkBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG,  // comp
+                             (char*) contentobj, len2, &len1)) {
+        return -1;
+    }
+
+#ifdef USE_SIGNATURES
+    if(private_key_path) {
+        len += add_signature(out+len, private_key_path, out1, len1);
+    }
+#endif /*USE_SIGNATURES*/
+    if (len + len1 + 2 >= outlen) {
+        return -1;
+    }
+    memcpy(out+len, out1, len1);
+    len += len1;
+    out[len++] = 0; // end-of-name
+    out[len++] = 0; // end-of-interest
+
+    *reslen += len;
+    return 0;
+}
+
+
 // ----------------------------------------------------------------------
 
 int8_t
@@ -1031,6 +1113,297 @@ mkPrefixregRequest(uint8_t *out, size_t outlen, char reg, char *path, char *face
     return 0;
 }
 
+// ----------------------------------------------------------------------
+
+// route lines per part of a prefixregbatch, the rest of the Interest fits
+// into the remaining bytes of a packet
+#define BATCH_PART_SIZE     (CCNL_MAX_PACKET_SIZE - 1024)
+
+// builds the next part of a prefixregbatch from the routes at *off, cut at
+// the end of a line where possible; the part that takes the last routes
+// tells the relay to apply the batch
+int8_t
+mkPrefixregbatchRequest(uint8_t *out, size_t outlen, char *routes,
+                        size_t routeslen, size_t *off, long part, int suite,
+                        char *private_key_path, size_t *reslen)
+{
+    size_t len = 0, len1 = 0, len2 = 0, len3 = 0, n;
+    uint8_t out1[CCNL_MAX_PACKET_SIZE];
+    uint8_t contentobj[CCNL_MAX_PACKET_SIZE];
+    uint8_t fwdentry[CCNL_MAX_PACKET_SIZE];
+    char suite_s[2], part_s[24];
+    (void)private_key_path;
+
+    n = routeslen - *off;
+    if (n > BATCH_PART_SIZE) {
+        n = BATCH_PART_SIZE;
+        while (n > 1 && routes[*off + n - 1] != '\n') {
+            n--;
+        }
+        if (n == 1) {
+            n = BATCH_PART_SIZE;
+        }
+    }
+
+    if (ccnl_ccnb_mkHeader(out, out + outlen, CCN_DTAG_INTEREST, CCN_TT_DTAG, &len)) {  // interest
+        return -1;
+    }
+    if (ccnl_ccnb_mkHeader(out+len, out + outlen, CCN_DTAG_NAME, CCN_TT_DTAG, &len)) {  // name
+        return -1;
+    }
+
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "ccnx", &len1)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "", &len1)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "prefixregbatch", &len1)) {
+        return -1;
+    }
+
+    // prepare FWDENTRY
+    if (ccnl_ccnb_mkHeader(fwdentry, fwdentry + sizeof(fwdentry), CCN_DTAG_FWDINGENTRY, CCN_TT_DTAG, &len3)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(fwdentry+len3, fwdentry + sizeof(fwdentry), CCN_DTAG_ACTION, CCN_TT_DTAG,
+                            "prefixregbatch", &len3)) {
+        return -1;
+    }
+    suite_s[0] = suite;
+    suite_s[1] = 0;
+    if (ccnl_ccnb_mkStrBlob(fwdentry+len3, fwdentry + sizeof(fwdentry), CCNL_DTAG_SUITE, CCN_TT_DTAG, suite_s, &len3)) {
+        return -1;
+    }
+    sprintf(part_s, "%ld", part);
+    if (ccnl_ccnb_mkStrBlob(fwdentry+len3, fwdentry + sizeof(fwdentry), CCN_DTAG_SEQNO, CCN_TT_DTAG, part_s, &len3)) {
+        return -1;
+    }
+    if (*off + n == routeslen &&
+        ccnl_ccnb_mkStrBlob(fwdentry+len3, fwdentry + sizeof(fwdentry), CCNL_DTAG_LASTPART, CCN_TT_DTAG, "1", &len3)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkBlob(fwdentry+len3, fwdentry + sizeof(fwdentry), CCNL_DTAG_ROUTES, CCN_TT_DTAG,
+                         routes + *off, n, &len3)) {
+        return -1;
+    }
+    if (len3 + 1 >= sizeof(fwdentry)) {
+        return -1;
+    }
+    fwdentry[len3++] = 0; // end-of-fwdentry
+
+    // prepare CONTENTOBJ with CONTENT
+    if (ccnl_ccnb_mkHeader(contentobj, contentobj + sizeof(contentobj), CCN_DTAG_CONTENTOBJ, CCN_TT_DTAG, &len2)) {  // contentobj
+        return -1;
+    }
+    if (ccnl_ccnb_mkBlob(contentobj+len2, contentobj + sizeof(contentobj), CCN_DTAG_CONTENT, CCN_TT_DTAG,  // content
+                   (char*) fwdentry, len3, &len2)) {
+        return -1;
+    }
+    if (len2 + 1 >= sizeof(contentobj)) {
+        return -1;
+    }
+    contentobj[len2++] = 0; // end-of-contentobj
+
+    // add CONTENTOBJ as the final name component
+    if (ccnl_ccnb_mkBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG,  // comp
+                  (char*) contentobj, len2, &len1)) {
+        return -1;
+    }
+
+#ifdef USE_SIGNATURES
+    if (private_key_path) {
+        len += add_signature(out+len, private_key_path, out1, len1);
+    }
+#endif /*USE_SIGNATURES*/
+    if (len + len1 + 2 >= outlen) {
+        return -1;
+    }
+    memcpy(out+len, out1, len1);
+    len += len1;
+
+    out[len++] = 0; // end-of-name
+    out[len++] = 0; // end-of-interest
+
+    *off += n;
+    *reslen = len;
+    return 0;
+}
+
+// whether a reply holds the given text
+int
+buf_contains(uint8_t *buf, size_t len, const char *s)
+{
+    size_t i, n = strlen(s);
+
+    for (i = 0; buf && i + n <= len; i++) {
+        if (!memcmp(buf + i, s, n)) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// reads a whole file, NULL on errors
+char*
+read_file(const char *path, size_t *len)
+{
+    FILE *fp = fopen(path, "r");
+    char *buf = NULL;
+    long size;
+
+    if (!fp) {
+        perror(path);
+        return NULL;
+    }
+    if (fseek(fp, 0L, SEEK_END) || (size = ftell(fp)) < 0 ||
+        fseek(fp, 0L, SEEK_SET)) {
+        goto Done;
+    }
+    buf = (char*) malloc((size_t) size + 1);
+    if (buf && fread(buf, 1, (size_t) size, fp) != (size_t) size) {
+        free(buf);
+        buf = NULL;
+    }
+    if (buf) {
+        buf[size] = 0;
+        *len = (size_t) size;
+    }
+Done:
+    fclose(fp);
+    return buf;
+}
+
+// builds a request for a page of a table dump: the first page names the
+// table and filters, the further ones the cursor the relay returned
+int8_t
+mkTabledumpRequest(uint8_t *out, size_t outlen, char *table, char *filter,
+                   char *faceid, unsigned long cursor, char *private_key_path,
+                   size_t *reslen)
+{
+    size_t len = 0, len1 = 0, len2 = 0, len3 = 0;
+    uint8_t out1[CCNL_MAX_PACKET_SIZE];
+    uint8_t contentobj[2000];
+    uint8_t stmt[1000];
+    char cursor_s[24];
+    (void)private_key_path;
+
+    if (ccnl_ccnb_mkHeader(out, out + outlen, CCN_DTAG_INTEREST, CCN_TT_DTAG, &len)) {   // interest
+        return -1;
+    }
+    if (ccnl_ccnb_mkHeader(out+len, out + outlen, CCN_DTAG_NAME, CCN_TT_DTAG, &len)) {  // name
+        return -1;
+    }
+
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "ccnx", &len1)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "", &len1)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG, "tabledump", &len1)) {
+        return -1;
+    }
+
+    // prepare tabledump statement
+    if (ccnl_ccnb_mkHeader(stmt, stmt + sizeof(stmt), CCNL_DTAG_DEBUGREQUEST, CCN_TT_DTAG, &len3)) {
+        return -1;
+    }
+    if (ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCN_DTAG_ACTION, CCN_TT_DTAG, "tabledump", &len3)) {
+        return -1;
+    }
+    if (cursor) {
+        sprintf(cursor_s, "%lu", cursor);
+        if (ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCNL_DTAG_CURSOR, CCN_TT_DTAG, cursor_s, &len3)) {
+            return -1;
+        }
+    } else {
+        if (ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCNL_DTAG_DEBUGACTION, CCN_TT_DTAG, table, &len3)) {
+            return -1;
+        }
+        if (filter && ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCNL_DTAG_PREFIX, CCN_TT_DTAG,
+                                          filter, &len3)) {
+            return -1;
+        }
+        if (faceid && ccnl_ccnb_mkStrBlob(stmt+len3, stmt + sizeof(stmt), CCN_DTAG_FACEID, CCN_TT_DTAG,
+                                          faceid, &len3)) {
+            return -1;
+        }
+    }
+    if (len3 + 1 >= sizeof(stmt)) {
+        return -1;
+    }
+    stmt[len3++] = 0; // end-of-tabledumpstmt
+
+    // prepare CONTENTOBJ with CONTENT
+    if (ccnl_ccnb_mkHeader(contentobj, contentobj+sizeof(contentobj), CCN_DTAG_CONTENTOBJ, CCN_TT_DTAG, &len2)) {  // contentobj
+        return -1;
+    }
+    if (ccnl_ccnb_mkBlob(contentobj+len2, contentobj+sizeof(contentobj), CCN_DTAG_CONTENT, CCN_TT_DTAG,  // content
+                         (char*) stmt, len3, &len2)) {
+        return -1;
+    }
+    if (len2 + 1 >= sizeof(contentobj)) {
+        return -1;
+    }
+    contentobj[len2++] = 0; // end-of-contentobj
+
+    // add CONTENTOBJ as the final name component
+    if (ccnl_ccnb_mkBlob(out1+len1, out1 + sizeof(out1), CCN_DTAG_COMPONENT, CCN_TT_DTAG,  // comp
+                         (char*) contentobj, len2, &len1)) {
+        return -1;
+    }
+
+#ifdef USE_SIGNATURES
+    if(private_key_path) {
+        len += add_signature(out+len, private_key_path, out1, len1);
+    }
+#endif /*USE_SIGNATURES*/
+    if (len + len1 + 2 >= outlen) {
+        return -1;
+    }
+    memcpy(out+len, out1, len1);
+    len += len1;
+    out[len++] = 0; // end-of-name
+    out[len++] = 0; // end-of-interest
+
+    *reslen = len;
+    return 0;
+}
+
+// the cursor in a tabledump reply, 0 once the dump is complete
+unsigned long
+tabledump_cursor(uint8_t *buf, size_t len)
+{
+    uint64_t num, dtag = 0;
+    uint8_t typ;
+    char s[24];
+
+    while (!ccnl_ccnb_dehead(&buf, &len, &num, &typ)) {
+        if (typ == CCN_TT_DTAG) {
+            dtag = num;
+            continue;
+        }
+        if (typ != CCN_TT_BLOB && typ != CCN_TT_UDATA) {
+            continue;
+        }
+        if (num > len) {
+            break;
+        }
+        if (dtag == CCNL_DTAG_CURSOR && num < sizeof(s)) {
+            memcpy(s, buf, num);
+            s[num] = '\0';
+            return strtoul(s, NULL, 10);
+        }
+        if (dtag != CCN_DTAG_CONTENT) { // the reply is inside the content
+            buf += num;
+            len -= num;
+        }
+        dtag = 0;
+    }
+    return 0;
+}
+
 struct ccnl_prefix_s*
 getPrefix(uint8_t *data, size_t datalen, int32_t *suite)
 {
@@ -1606,6 +1979,12 @@ main(int argc, char *argv[])
     int opt, i = 0, ret = -1;
     FILE *f = NULL;
     char *udp_temp = NULL;
+    char *routes = NULL;
+    size_t routeslen = 0, routesoff = 0;
+    long part = 0;
+    char *dumptable = NULL;
+    unsigned long cursor;
+    size_t pageoff = 0;
 
     while ((opt = getopt(argc, argv, "hk:mp:v:u:x:")) != -1) {
         switch (opt) {
@@ -1667,8 +2046,11 @@ help:
        "  destroyface   FACEID\n"
        "  prefixreg     PREFIX FACEID [SUITE]\n"
        "  prefixunreg   PREFIX FACEID [SUITE]\n"
+       "  prefixregbatch ROUTEFILE [SUITE]\n"
+       "  tabledump     faces|fib|pit|cs [PREFIX [FACEID]]\n"
 #ifdef USE_FRAG
        "  setfrag       FACEID FRAG MTU\n"
+       "  setweight     FACEID WEIGHT\n"
 #endif
        "  debug         dump\n"
        "  debug         halt\n"
@@ -1677,6 +2059,7 @@ help:
        "  removeContentFromCache        ccn-path\n"
        "where FRAG in one of (none, seqd2012, ccnx2013)\n"
        "      SUITE is one of (ccnb, ccnx2015, ndn2013)\n"
+       "      ROUTEFILE has lines of PREFIX FACEID or PREFIX IP/PORT\n"
        "-m is a special mode which only prints the interest message of the corresponding command\n",
                     argv[0]);
 
@@ -1790,6 +2173,13 @@ help:
         if (mkSetfragRequest(out, sizeof(out), argv[2], argv[3], argv[4], private_key_path, &len)) {
             goto Bail;
         }
+    } else if (!strcmp(argv[1], "setweight")) {
+        if (argc < 4) {
+            goto help;
+        }
+        if (mkSetweightRequest(out, sizeof(out), argv[2], argv[3], private_key_path, &len)) {
+            goto Bail;
+        }
     } else if (!strcmp(argv[1], "destroyface")) {
         if (argc < 3) {
             goto help;
@@ -1820,6 +2210,35 @@ help:
         if (mkPrefixregRequest(out, sizeof(out), 0, argv[2], argv[3], suite, private_key_path, &len)) {
             goto Bail;
         }
+    } else if (!strcmp(argv[1], "prefixregbatch")) {
+        if (argc > 3) {
+            suite = ccnl_str2suite(argv[3]);
+            if (!ccnl_isSuite(suite)) {
+                goto help;
+            }
+        }
+        if (argc < 3) {
+            goto help;
+        }
+        routes = read_file(argv[2], &routeslen);
+        if (!routes) {
+            goto Bail;
+        }
+        if (mkPrefixregbatchRequest(out, sizeof(out), routes, routeslen, &routesoff,
+                                    part++, suite, private_key_path, &len)) {
+            goto Bail;
+        }
+    } else if (!strcmp(argv[1], "tabledump")) {
+        if (argc < 3) {
+            goto help;
+        }
+        dumptable = argv[2];
+        if (mkTabledumpRequest(out, sizeof(out), dumptable,
+                               argc > 3 ? argv[3] : NULL,
+                               argc > 4 ? argv[4] : NULL, 0,
+                               private_key_path, &len)) {
+            goto Bail;
+        }
     } else if (!strcmp(argv[1], "addContentToCache")){
         if (argc < 3) {
             goto help;
@@ -1888,6 +2307,80 @@ help:
             verified = 0;
         }
 
+        // the further parts of a prefixregbatch, each once the relay has
+        // staged the one before
+        while (routes && routesoff < routeslen &&
+               buf_contains(recvbuffer, recvbufferlen, "staged")) {
+            if (mkPrefixregbatchRequest(out, sizeof(out), routes, routeslen, &routesoff,
+                                        part++, suite, private_key_path, &len)) {
+                goto Bail;
+            }
+            if (!use_udp) {
+                ux_sendto2(sock, ux, out, len);
+            } else {
+                udp_sendto2(sock, udp, port, (uint8_t *) out, len);
+            }
+            memset(out, 0, sizeof(out));
+            if (!use_udp) {
+                ssize_t recvlen;
+                recvlen = recv(sock, out, sizeof(out), 0);
+                if (recvlen < 0) {
+                    goto Bail;
+                }
+                len = (size_t) recvlen;
+            } else {
+                ssize_t recvlen;
+                recvlen = recvfrom(sock, out, sizeof(out), 0, (struct sockaddr *) &si, &slen);
+                if (recvlen < 0) {
+                    goto Bail;
+                }
+                len = (size_t) recvlen;
+            }
+            free(recvbuffer);
+            recvbuffer = NULL;
+            recvbufferlen = 0;
+            hasNext = check_has_next(out, len, (char**)&recvbuffer, &recvbufferlen, relay_public_key, &verified_i);
+            if (!verified_i) {
+                verified = 0;
+            }
+        }
+
+        // the further pages of a tabledump, until the relay returns no cursor
+        while (dumptable &&
+               (cursor = tabledump_cursor(recvbuffer + pageoff, recvbufferlen - pageoff))) {
+            if (mkTabledumpRequest(out, sizeof(out), dumptable, NULL, NULL, cursor,
+                                   private_key_path, &len)) {
+                goto Bail;
+            }
+            if (!use_udp) {
+                ux_sendto2(sock, ux, out, len);
+            } else {
+                udp_sendto2(sock, udp, port, (uint8_t *) out, len);
+            }
+            memset(out, 0, sizeof(out));
+            if (!use_udp) {
+                ssize_t recvlen;
+                recvlen = recv(sock, out, sizeof(out), 0);
+                if (recvlen < 0) {
+                    goto Bail;
+                }
+                len = (size_t) recvlen;
+            } else {
+                ssize_t recvlen;
+                recvlen = recvfrom(sock, out, sizeof(out), 0, (struct sockaddr *) &si, &slen);
+                if (recvlen < 0) {
+                    goto Bail;
+                }
+                len = (size_t) recvlen;
+            }
+            pageoff = recvbufferlen;
+            hasNext = check_has_next(out, len, (char**)&recvbuffer, &recvbufferlen, relay_public_key, &verified_i);
+            if (!verified_i) {
+                verified = 0;
+            }
+            ++numOfParts;
+        }
+
         while (hasNext) {
             //send an interest for debug packets... and store content in a array...
             uint8_t interest2[100];
@@ -2023,6 +2516,13 @@ help:
         }
     } else if(msgOnly) {
         fwrite(out, len, 1, stdout);
+        while (routes && routesoff < routeslen) {
+            if (mkPrefixregbatchRequest(out, sizeof(out), routes, routeslen, &routesoff,
+                                        part++, suite, private_key_path, &len)) {
+                goto Bail;
+            }
+            fwrite(out, len, 1, stdout);
+        }
     } else {
         DEBUGMSG(ERROR, "nothing to send, program terminates\n");
     }
@@ -2035,6 +2535,7 @@ Bail:
     }
     free(recvbuffer2);
     free(recvbuffer);
+    free(routes);
     close(sock);
     unlink(mysockname);
 
@@ -18,6 +18,8 @@
  *
  * File history:
  * 2014-10-13  created
+ * 2026-10-19  back off on NDNLPv2 congestion marks
+ * 2026-10-19  pipelined fetching of chunk streams with a fixed or AIMD window
  */
 
 
@@ -26,19 +28,63 @@
 #include "ccnl-common.h"
 
 #include <stdlib.h>
+#include <stdbool.h>
+#include <math.h>
 
 //#include "ccnl-socket.c"
 
+// pacing between Interests while the path signals congestion (usec)
+#define FETCH_GAP_INIT      10000
+#define FETCH_GAP_MAX       1000000
+
+// chunks in flight or held for reordering, bounds any window
+#define FETCH_WINDOW_MAX    256
+#define FETCH_CWND_INIT     2.0
+// retransmission timeout bounds (sec), the upper one is the -w timeout
+#define FETCH_RTO_MIN       0.2
+// replies to later Interests that declare a chunk lost before its timeout
+#define FETCH_REORDER       3
+
 // ----------------------------------------------------------------------
 
+// strips an NDNLPv2 frame around a reply, remembering its congestion mark
+static int
+ccnl_fetchUnwrap(int suite, uint8_t *out, size_t *len, int *marked)
+{
+    *marked = 0;
+#ifdef USE_SUITE_NDNTLV
+    if (suite == CCNL_SUITE_NDNTLV && *len > 0 && out[0] == NDN_TLV_LpPacket) {
+        struct ccnl_ndntlv_lp_s lp;
+        uint8_t *data = out;
+        size_t datalen = *len, lplen;
+        uint64_t typ;
+
+        if (ccnl_ndntlv_dehead(&data, &datalen, &typ, &lplen) ||
+            ccnl_ndntlv_parseLpPacket(data, lplen, &lp) || !lp.frag) {
+            DEBUGMSG(WARNING, "could not parse LpPacket\n");
+            return -1;
+        }
+        *marked = lp.congmark != 0;
+        memmove(out, lp.frag, lp.fraglen);
+        *len = lp.fraglen;
+    }
+#else
+    (void) suite;
+    (void) out;
+    (void) len;
+#endif
+    return 0;
+}
+
 int
 ccnl_fetchContentForChunkName(struct ccnl_prefix_s *prefix,
                               uint32_t *chunknum,
                               int suite,
                               uint8_t *out, size_t out_len,
-                              size_t *len,
+                              size_t *len, int *marked,
                               float wait, int sock, struct sockaddr sa) {
     (void) chunknum;
+    *marked = 0;
 #ifdef USE_SUITE_CCNB
     if (suite == CCNL_SUITE_CCNB) {
         DEBUGMSG(ERROR, "CCNB not implemented\n");
@@ -66,6 +112,9 @@ ccnl_fetchContentForChunkName(struct ccnl_prefix_s *prefix,
         return -1;
     }
     *len = recv(sock, out, out_len, 0);
+    if (ccnl_fetchUnwrap(suite, out, len, marked)) {
+        return -1;
+    }
 /*
         {
             int fd = open("incoming.bin", O_WRONLY|O_CREAT|O_TRUNC);
@@ -90,7 +139,7 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
         size_t hdrlen;
         uint8_t *start = *data;
 
-        if (ccntlv_isData(*data, *datalen)) {
+        if (!ccntlv_isData(*data, *datalen)) {
             DEBUGMSG(WARNING, "Received non-content-object\n");
             return -1;
         }
@@ -102,6 +151,10 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
         *datalen -= hdrlen;
 
         pkt = ccnl_ccntlv_bytes2pkt(start, data, datalen);
+        // the content must outlive pkt: point into the caller's buffer
+        if (pkt && pkt->content) {
+            pkt->content = start + (pkt->content - pkt->buf->data);
+        }
         break;
     }
 #endif
@@ -120,7 +173,8 @@ ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
             return -1;
         }
 
-        pkt = ccnl_ndntlv_bytes2pkt(typ, start, data, datalen);
+        // a view: the content returned below points into the caller's buffer
+        pkt = ccnl_ndntlv_bytes2pktView(typ, start, data, datalen);
         break;
     }
 #endif
@@ -175,6 +229,408 @@ ccnl_prefix_removeChunkNumComponent(int suite,
 }
 
 
+// ----------------------------------------------------------------------
+// pipelined fetching: keeps a window of Interests for consecutive chunks
+// in flight, retransmits each on its own timer and writes the content in
+// chunk order
+
+struct ccnl_fetch_seg_s {
+    uint8_t *data;          // content, held until it can be written in order
+    size_t len;
+    double sent;            // time of the last transmission
+    int tries;              // transmissions so far
+    int skipped;            // replies to Interests sent after this one
+    bool done;
+};
+
+struct ccnl_fetch_s {
+    struct ccnl_prefix_s *prefix;   // stream name without the chunk number
+    int suite, sock, outfd;
+    struct sockaddr sa;
+    int64_t last;                   // final chunk number, -1 while unknown
+    uint32_t next_send, next_write;
+    struct ccnl_fetch_seg_s seg[FETCH_WINDOW_MAX];
+
+    int fixed;                      // fixed window size, 0 for AIMD
+    double cwnd, ssthresh;
+    double last_decrease;           // shrink the window once per RTT only
+
+    double srtt, rttvar, rto, rto_max; // RFC 6298, in seconds
+    int maxretry;
+
+    double start;                   // statistics
+    size_t bytes;
+    unsigned long segments, retransmissions, fast, marks;
+    double *rtt;
+    size_t rttcnt, rttsize;
+};
+
+static double
+ccnl_fetchNow(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static int
+ccnl_fetchWindow(struct ccnl_fetch_s *f)
+{
+    int w = f->fixed ? f->fixed : (int) f->cwnd;
+
+    return w < 1 ? 1 : w > FETCH_WINDOW_MAX ? FETCH_WINDOW_MAX : w;
+}
+
+static int
+ccnl_fetchSend(struct ccnl_fetch_s *f, uint32_t chunknum)
+{
+    struct ccnl_fetch_seg_s *s = f->seg + chunknum % FETCH_WINDOW_MAX;
+    ccnl_interest_opts_u int_opts;
+    struct ccnl_buf_s *buf;
+    uint32_t cn = chunknum, *old = f->prefix->chunknum;
+    int rc = 0;
+
+    memset(&int_opts, 0, sizeof(int_opts));
+#ifdef USE_SUITE_NDNTLV
+    int_opts.ndntlv.nonce = random(); // a retransmission is not a duplicate
+#endif
+    f->prefix->chunknum = &cn;
+    buf = ccnl_mkSimpleInterest(f->prefix, &int_opts);
+    f->prefix->chunknum = old;
+    if (!buf) {
+        return -1;
+    }
+    if (sendto(f->sock, buf->data, buf->datalen, 0, &f->sa, sizeof(f->sa)) < 0) {
+        perror("sendto");
+        rc = -1;
+    }
+    ccnl_free(buf);
+
+    s->sent = ccnl_fetchNow();
+    s->skipped = 0;
+    if (s->tries++) {
+        f->retransmissions++;
+    }
+    DEBUGMSG(DEBUG, "sent Interest for chunk %u (try %d)\n", chunknum, s->tries);
+    return rc;
+}
+
+static void
+ccnl_fetchRttSample(struct ccnl_fetch_s *f, double rtt)
+{
+    if (f->rttcnt == f->rttsize) {
+        size_t size = f->rttsize ? 2 * f->rttsize : 1024;
+        double *p = (double*) ccnl_realloc(f->rtt, size * sizeof(double));
+        if (p) {
+            f->rtt = p;
+            f->rttsize = size;
+        }
+    }
+    if (f->rttcnt < f->rttsize) {
+        f->rtt[f->rttcnt++] = rtt;
+    }
+
+    if (f->rttcnt == 1) {
+        f->srtt = rtt;
+        f->rttvar = rtt / 2;
+    } else {
+        f->rttvar = 0.75 * f->rttvar + 0.25 * fabs(f->srtt - rtt);
+        f->srtt = 0.875 * f->srtt + 0.125 * rtt;
+    }
+    f->rto = f->srtt + 4 * f->rttvar;
+    if (f->rto < FETCH_RTO_MIN) {
+        f->rto = FETCH_RTO_MIN;
+    }
+    if (f->rto > f->rto_max) {
+        f->rto = f->rto_max;
+    }
+}
+
+// multiplicative decrease on a loss or a congestion mark
+static void
+ccnl_fetchDecrease(struct ccnl_fetch_s *f, double now)
+{
+    if (f->fixed || now - f->last_decrease < f->srtt) {
+        return;
+    }
+    f->ssthresh = f->cwnd / 2 < 1 ? 1 : f->cwnd / 2;
+    f->cwnd = f->ssthresh;
+    f->last_decrease = now;
+    DEBUGMSG(INFO, "window decreased to %.1f\n", f->cwnd);
+}
+
+// slow start up to ssthresh, then additive increase of one chunk per RTT
+static void
+ccnl_fetchIncrease(struct ccnl_fetch_s *f)
+{
+    if (f->fixed) {
+        return;
+    }
+    f->cwnd += f->cwnd < f->ssthresh ? 1 : 1 / f->cwnd;
+    if (f->cwnd > FETCH_WINDOW_MAX) {
+        f->cwnd = FETCH_WINDOW_MAX;
+    }
+}
+
+// writes the chunks that are next in order
+static int
+ccnl_fetchFlush(struct ccnl_fetch_s *f)
+{
+    struct ccnl_fetch_seg_s *s;
+
+    while (f->next_write != f->next_send &&
+           (s = f->seg + f->next_write % FETCH_WINDOW_MAX)->done) {
+        if (s->len && write(f->outfd, s->data, s->len) != (ssize_t) s->len) {
+            perror("write");
+            return -1;
+        }
+        f->bytes += s->len;
+        f->segments++;
+        ccnl_free(s->data);
+        memset(s, 0, sizeof(*s));
+        f->next_write++;
+    }
+    return 0;
+}
+
+// fast retransmission: a chunk is lost once FETCH_REORDER Interests sent
+// after its own were answered
+static void
+ccnl_fetchSkipped(struct ccnl_fetch_s *f, uint32_t chunknum, double sent,
+                  double now)
+{
+    uint32_t cn;
+
+    for (cn = f->next_write; cn != chunknum; cn++) {
+        struct ccnl_fetch_seg_s *s = f->seg + cn % FETCH_WINDOW_MAX;
+        if (s->done || s->sent >= sent || ++s->skipped < FETCH_REORDER) {
+            continue;
+        }
+        if (s->tries > f->maxretry) {
+            continue; // left to the timer, which gives up
+        }
+        DEBUGMSG(INFO, "chunk %u overtaken, retransmitting\n", cn);
+        f->fast++;
+        ccnl_fetchDecrease(f, now);
+        ccnl_fetchSend(f, cn);
+    }
+}
+
+static void
+ccnl_fetchReceive(struct ccnl_fetch_s *f, uint8_t *out, size_t len)
+{
+    struct ccnl_prefix_s *prefix = NULL;
+    struct ccnl_fetch_seg_s *s;
+    uint8_t *content, *t = out;
+    size_t contlen;
+    int64_t lastchunknum;
+    uint32_t chunknum;
+    int marked;
+    double now = ccnl_fetchNow();
+
+    if (ccnl_fetchUnwrap(f->suite, out, &len, &marked) ||
+        ccnl_extractDataAndChunkInfo(&t, &len, f->suite, &prefix,
+                                     &lastchunknum, &content, &contlen)) {
+        DEBUGMSG(WARNING, "could not extract a reply\n");
+        return;
+    }
+    if (!prefix->chunknum) {
+        DEBUGMSG(WARNING, "reply without chunk number, ignored\n");
+        goto Done;
+    }
+    chunknum = *prefix->chunknum;
+    if (ccnl_prefix_removeChunkNumComponent(f->suite, prefix) ||
+        prefix->compcnt != f->prefix->compcnt ||
+        ccnl_prefix_cmp(prefix, NULL, f->prefix, CMP_MATCH) !=
+                                            (int32_t) f->prefix->compcnt) {
+        DEBUGMSG(WARNING, "reply for another name, ignored\n");
+        goto Done;
+    }
+    // unsigned distances, the chunk numbers may wrap
+    if (chunknum - f->next_write >= f->next_send - f->next_write) {
+        DEBUGMSG(DEBUG, "chunk %u outside of the window\n", chunknum);
+        goto Done;
+    }
+    s = f->seg + chunknum % FETCH_WINDOW_MAX;
+    if (s->done) {
+        DEBUGMSG(DEBUG, "duplicate chunk %u\n", chunknum);
+        goto Done;
+    }
+    if (s->tries == 1) { // Karn: no samples from retransmitted chunks
+        ccnl_fetchRttSample(f, now - s->sent);
+    }
+    ccnl_fetchSkipped(f, chunknum, s->sent, now);
+    if (contlen) {
+        s->data = ccnl_malloc(contlen);
+        if (!s->data) {
+            DEBUGMSG(ERROR, "Failed to allocate memory: %d", errno);
+            goto Done; // is fetched again on timeout
+        }
+        memcpy(s->data, content, contlen);
+    }
+    s->len = contlen;
+    s->done = true;
+    if (lastchunknum >= 0) {
+        f->last = lastchunknum;
+    }
+    if (marked) {
+        f->marks++;
+        ccnl_fetchDecrease(f, now);
+    } else {
+        ccnl_fetchIncrease(f);
+    }
+Done:
+    ccnl_prefix_free(prefix);
+}
+
+static int
+ccnl_fetchCmpDouble(const void *a, const void *b)
+{
+    double x = *(const double*) a, y = *(const double*) b;
+
+    return x < y ? -1 : x > y;
+}
+
+static void
+ccnl_fetchStats(struct ccnl_fetch_s *f)
+{
+    double elapsed = ccnl_fetchNow() - f->start, sum = 0;
+    size_t i, n = f->rttcnt;
+
+    fprintf(stderr, "fetch: %lu chunks, %zu bytes in %.3f s, goodput %.3f Mbit/s\n",
+            f->segments, f->bytes, elapsed,
+            elapsed > 0 ? f->bytes * 8 / elapsed / 1e6 : 0);
+    fprintf(stderr, "fetch: %lu retransmissions (%lu fast), %lu congestion "
+            "marks, window %s %d\n", f->retransmissions, f->fast, f->marks,
+            f->fixed ? "fixed" : "aimd", ccnl_fetchWindow(f));
+    if (!n) {
+        return;
+    }
+    qsort(f->rtt, n, sizeof(double), ccnl_fetchCmpDouble);
+    for (i = 0; i < n; i++) {
+        sum += f->rtt[i];
+    }
+    fprintf(stderr, "fetch: rtt min/avg/p50/p95/p99/max = "
+            "%.3f/%.3f/%.3f/%.3f/%.3f/%.3f ms (%zu samples)\n",
+            f->rtt[0] * 1e3, sum / n * 1e3, f->rtt[n / 2] * 1e3,
+            f->rtt[n * 95 / 100] * 1e3, f->rtt[n * 99 / 100] * 1e3,
+            f->rtt[n - 1] * 1e3, n);
+}
+
+/**
+ * @brief Fetches the chunks \p first to \p last of a stream with a window of
+ *        Interests in flight, writing the content to \p outfd in order
+ *
+ * @param prefix    name of the stream, without the chunk number
+ * @param last      final chunk number, -1 if not known yet
+ * @param window    fixed window size in chunks, 0 for AIMD
+ * @param wait      initial and maximum retransmission timeout (sec)
+ * @param maxretry  retransmissions per chunk before giving up
+ * @param stats     print statistics to stderr at the end of the transfer
+ *
+ * @return 0 once the final chunk was written, -1 otherwise
+ */
+static int
+ccnl_fetchPipelined(struct ccnl_prefix_s *prefix, int suite, uint32_t first,
+                    int64_t last, int window, float wait, int maxretry,
+                    int sock, struct sockaddr sa, int outfd, int stats)
+{
+    static uint8_t out[64*1024];
+    struct ccnl_fetch_s *f;
+    uint32_t cn;
+    int rc = -1, bufsize = FETCH_WINDOW_MAX * 8192;
+
+    f = (struct ccnl_fetch_s*) ccnl_calloc(1, sizeof(*f));
+    if (!f) {
+        return -1;
+    }
+    f->prefix = prefix;
+    f->suite = suite;
+    f->sock = sock;
+    f->sa = sa;
+    f->outfd = outfd;
+    f->last = last;
+    f->next_send = f->next_write = first;
+    f->fixed = window;
+    f->cwnd = FETCH_CWND_INIT;
+    f->ssthresh = FETCH_WINDOW_MAX;
+    f->rto = f->rto_max = wait > FETCH_RTO_MIN ? wait : FETCH_RTO_MIN;
+    f->maxretry = maxretry;
+    f->start = ccnl_fetchNow();
+
+    // room for a full window of replies, the kernel caps this at rmem_max
+    if (setsockopt(sock, SOL_SOCKET, SO_RCVBUF, &bufsize, sizeof(bufsize)) < 0) {
+        DEBUGMSG(WARNING, "could not enlarge the receive buffer\n");
+    }
+
+    while (f->last < 0 || (int64_t) f->next_write <= f->last) {
+        double now, due, timeout = f->rto;
+
+        while (f->next_send - f->next_write < (uint32_t) ccnl_fetchWindow(f) &&
+               (f->last < 0 || (int64_t) f->next_send <= f->last)) {
+            if (ccnl_fetchSend(f, f->next_send++)) {
+                goto Done;
+            }
+        }
+
+        // wait for a reply until the earliest retransmission is due
+        now = ccnl_fetchNow();
+        for (cn = f->next_write; cn != f->next_send; cn++) {
+            struct ccnl_fetch_seg_s *s = f->seg + cn % FETCH_WINDOW_MAX;
+            if (!s->done && s->sent + f->rto - now < timeout) {
+                timeout = s->sent + f->rto - now;
+            }
+        }
+        if (timeout > 0 && block_on_read(sock, timeout) > 0) {
+            ssize_t len = recv(sock, out, sizeof(out), 0);
+            if (len > 0) {
+                ccnl_fetchReceive(f, out, (size_t) len);
+                if (ccnl_fetchFlush(f)) {
+                    goto Done;
+                }
+            }
+            continue;
+        }
+
+        now = ccnl_fetchNow();
+        due = 0;
+        for (cn = f->next_write; cn != f->next_send; cn++) {
+            struct ccnl_fetch_seg_s *s = f->seg + cn % FETCH_WINDOW_MAX;
+            if (s->done || now - s->sent < f->rto ||
+                (f->last >= 0 && (int64_t) cn > f->last)) {
+                continue;
+            }
+            if (s->tries > maxretry) {
+                DEBUGMSG(WARNING, "chunk %u: no reply after %d tries\n",
+                         cn, s->tries);
+                goto Done;
+            }
+            DEBUGMSG(INFO, "timeout for chunk %u\n", cn);
+            due = now;
+            if (ccnl_fetchSend(f, cn)) {
+                goto Done;
+            }
+        }
+        if (due) { // back off once per round of timeouts
+            ccnl_fetchDecrease(f, due);
+            f->rto = 2 * f->rto > f->rto_max ? f->rto_max : 2 * f->rto;
+        }
+    }
+    rc = 0;
+
+Done:
+    if (stats) {
+        ccnl_fetchStats(f);
+    }
+    for (cn = 0; cn < FETCH_WINDOW_MAX; cn++) {
+        ccnl_free(f->seg[cn].data);
+    }
+    ccnl_free(f->rtt);
+    ccnl_free(f);
+    return rc;
+}
+
 // ----------------------------------------------------------------------
 
 int
@@ -186,9 +642,17 @@ main(int argc, char *argv[])
     char *addr = NULL, *udp = NULL, *ux = NULL;
     struct sockaddr sa;
     float wait = 3.0;
+    int outfd = 1, window = 0, stats = 0;
 
-    while ((opt = getopt(argc, argv, "hs:u:v:w:x:")) != -1) {
+    while ((opt = getopt(argc, argv, "ho:s:Su:v:w:W:x:")) != -1) {
         switch (opt) {
+        case 'o':
+            outfd = open(optarg, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+            if (outfd < 0) {
+                perror("open");
+                exit(1);
+            }
+            break;
         case 's':
             suite = ccnl_str2suite(optarg);
             if (!ccnl_isSuite(suite)) {
@@ -196,12 +660,27 @@ main(int argc, char *argv[])
                 goto usage;
             }
             break;
+        case 'S':
+            stats = 1;
+            break;
         case 'u':
             udp = optarg;
             break;
         case 'w':
             wait = (float)strtof(optarg, (char**) NULL);
             break;
+        case 'W':
+            if (!strcmp(optarg, "aimd")) {
+                window = 0;
+            } else {
+                window = (int) strtol(optarg, (char**) NULL, 10);
+                if (window < 1 || window > FETCH_WINDOW_MAX) {
+                    DEBUGMSG(ERROR, "window must be aimd or 1..%d\n",
+                             FETCH_WINDOW_MAX);
+                    goto usage;
+                }
+            }
+            break;
             case 'v':
 #ifdef USE_LOGGING
             if (isdigit(optarg[0]))
@@ -219,19 +698,22 @@ main(int argc, char *argv[])
         default:
 usage:
             fprintf(stderr, "usage: %s [options] URI [NFNexpr]\n"
+            "  -o FILE          write the content to FILE instead of stdout\n"
             "  -s SUITE         (ccnb, ccnx2015, ndn2013)\n"
+            "  -S               print transfer statistics to stderr\n"
             "  -u a.b.c.d/port  UDP destination (default is 127.0.0.1/6363)\n"
 #ifdef USE_LOGGING
             "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
 #endif
             "  -w timeout       in sec (float)\n"
+            "  -W WINDOW        chunks in flight: aimd (default) or a fixed 1..%d\n"
             "  -x ux_path_name  UNIX IPC: use this instead of UDP\n"
             "Examples:\n"
             "%% peek /ndn/edu/wustl/ping             (classic lookup)\n"
             "%% peek /th/ere  \"lambda expr\"          (lambda expr, in-net)\n"
             "%% peek \"\" \"add 1 1\"                    (lambda expr, local)\n"
             "%% peek /rpc/site \"call 1 /test/data\"   (lambda RPC, directed)\n",
-            argv[0]);
+            argv[0], FETCH_WINDOW_MAX);
             exit(1);
         }
     }
@@ -284,10 +766,15 @@ usage:
 
 
     const int maxretry = 3;
-    int retry = 0;
+    int retry = 0, marked;
+    long gap = 0;
 
     while (retry < maxretry) {
 
+        if (gap) {
+            usleep(gap);
+        }
+
         if (curchunknum) {
             if (!prefix->chunknum) {
                 prefix->chunknum = ccnl_malloc(sizeof(uint32_t));
@@ -308,11 +795,21 @@ usage:
                                           curchunknum,
                                           suite,
                                           out, sizeof(out),
-                                          &len,
+                                          &len, &marked,
                                           wait, sock, sa)) {
             retry++;
             DEBUGMSG(WARNING, "timeout\n");//, retry number %d of %d\n", retry, maxretry);
         } else {
+            // multiplicative increase on marks, decay on unmarked replies
+            if (marked) {
+                gap = gap ? 2 * gap : FETCH_GAP_INIT;
+                if (gap > FETCH_GAP_MAX) {
+                    gap = FETCH_GAP_MAX;
+                }
+                DEBUGMSG(INFO, "congestion mark, pacing at %ld usec\n", gap);
+            } else {
+                gap = gap * 3 / 4;
+            }
 
             int64_t lastchunknum;
             uint8_t *t = &out[0];
@@ -332,7 +829,7 @@ usage:
                 // Check if the fetched content is a chunk
                 if (!(prefix->chunknum)) {
                     // Response is not chunked, print content and exit
-                    write(1, content, contlen);
+                    write(outfd, content, contlen);
                     goto Done;
                 } else {
                     uint32_t chunknum = *(prefix->chunknum);
@@ -357,10 +854,19 @@ usage:
                     if (chunknum == 0 || (curchunknum && *curchunknum == chunknum)) {
                         DEBUGMSG(DEBUG, "Found chunk %d with contlen=%zu, lastchunk=%ld\n", *curchunknum, contlen, lastchunknum);
 
-                        write(1, content, contlen);
+                        write(outfd, content, contlen);
 
                         if (lastchunknum != -1 && lastchunknum == chunknum) {
                             goto Done;
+                        } else if (window != 1) {
+                            // the stream's name is known now, pipeline the rest
+                            if (ccnl_fetchPipelined(prefix, suite, chunknum + 1,
+                                                    lastchunknum, window, wait,
+                                                    maxretry, sock, sa, outfd,
+                                                    stats)) {
+                                break;
+                            }
+                            goto Done;
                         } else {
                             *curchunknum += 1;
                             retry = 0;
@@ -385,6 +891,9 @@ usage:
 Done:
     DEBUGMSG(DEBUG, "Sucessfully fetched content\n");
     close(sock);
+    if (outfd != 1) {
+        close(outfd);
+    }
     return 0;
 }
 
@@ -0,0 +1,858 @@
+/*
+ * @f util/ccn-lite-loadgen.c
+ * @b load generator: Interests at a target rate from several threads and
+ *    sockets, with rate, loss and latency percentiles over time
+ *
+ * Copyright (C) 2011-18, University of Basel
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+#include "ccnl-common.h"
+#include "ccnl-simd.h"
+
+#include <errno.h>
+#include <math.h>
+#include <poll.h>
+#include <pthread.h>
+
+#define LG_MAXTHREADS   64
+#define LG_MAXSOCKS     64      // per thread
+#define LG_BURST        64      // Interests sent at once when behind
+#define LG_POLL_MS      5       // longest sleep, bounds the report delay
+
+// latency histogram: LG_SUB buckets per power of two of usec
+#define LG_SUB          16
+#define LG_OCTAVES      32
+#define LG_BUCKETS      (LG_SUB * LG_OCTAVES)
+
+// unique names end in a component of this many hex digits
+#define LG_UNIQUE_LEN   16
+
+enum { LG_ZIPF, LG_SEQ, LG_UNIQUE };
+
+struct lg_stats_s {
+    unsigned long sent, rcvd, lost, unsolicited, errors;
+    unsigned long hist[LG_BUCKETS];
+};
+
+// the Interests to send, built once
+struct lg_name_s {
+    uint8_t *pkt;
+    size_t len;
+    uint64_t hash;              // of the Name TLV
+    size_t nonceoff;            // 0 if the suite has no nonce
+};
+
+// one Interest in flight
+struct lg_pending_s {
+    uint64_t hash;
+    double sent;
+};
+
+struct lg_thread_s {
+    pthread_t tid;
+    int id;
+    int socks[LG_MAXSOCKS];
+    uint64_t rnd;
+    unsigned long next;         // for sequential and unique names
+    uint8_t pkt[CCNL_MAX_PACKET_SIZE];   // the Interest being sent
+    // open addressing table and send order ring of what is in flight
+    struct lg_pending_s *table, *ring;
+    size_t mask, head, tail, inflight;
+    struct lg_stats_s st;       // of the current interval
+    int interval;
+};
+
+static struct {
+    int suite, mode, threads, socks, intervals;
+    double rate, duration, period, wait, alpha, start;
+    struct sockaddr_storage dst;
+    socklen_t dstlen;
+    struct lg_name_s *names;
+    size_t namecnt;
+    double *cdf;                // Zipf
+    size_t uniqueoff;           // where the unique digits go
+    struct lg_name_s unique;
+} lg;
+
+static pthread_mutex_t lg_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t lg_cond = PTHREAD_COND_INITIALIZER;
+static struct lg_stats_s *lg_slots;     // per interval, summed over threads
+static int *lg_merged;                  // threads done with an interval
+static struct lg_stats_s lg_total;
+
+// ----------------------------------------------------------------------
+
+static double
+lg_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec / 1e9;
+}
+
+static uint64_t
+lg_random(uint64_t *s)
+{
+    // xorshift64*
+    *s ^= *s >> 12;
+    *s ^= *s << 25;
+    *s ^= *s >> 27;
+    return *s * 0x2545f4914f6cdd1dULL;
+}
+
+static uint64_t
+lg_hash(const uint8_t *p, size_t len)
+{
+    uint64_t h = 0xcbf29ce484222325ULL;
+
+    while (len--) {
+        h = (h ^ *p++) * 0x100000001b3ULL;
+    }
+    return h ? h : 1;   // 0 marks a free slot
+}
+
+static int
+lg_bucket(double sec)
+{
+    double us = sec * 1e6;
+    int e, b;
+
+    if (us < 1) {
+        return 0;
+    }
+    e = ilogb(us);
+    if (e >= LG_OCTAVES) {
+        return LG_BUCKETS - 1;
+    }
+    b = (int) ((us / ldexp(1, e) - 1) * LG_SUB);
+    return e * LG_SUB + (b < LG_SUB ? b : LG_SUB - 1);
+}
+
+// upper end of a bucket, in usec
+static double
+lg_bucket2us(int i)
+{
+    return ldexp(1, i / LG_SUB) * (1 + (double) (i % LG_SUB + 1) / LG_SUB);
+}
+
+static double
+lg_percentile(const struct lg_stats_s *s, double p)
+{
+    unsigned long n = 0, want;
+    int i;
+
+    for (i = 0; i < LG_BUCKETS; i++) {
+        n += s->hist[i];
+    }
+    if (!n) {
+        return 0;
+    }
+    want = (unsigned long) ceil(p / 100 * (double) n);
+    for (i = 0, n = 0; i < LG_BUCKETS; i++) {
+        n += s->hist[i];
+        if (n >= want && n) {
+            break;
+        }
+    }
+    return lg_bucket2us(i < LG_BUCKETS ? i : LG_BUCKETS - 1);
+}
+
+static void
+lg_add(struct lg_stats_s *to, const struct lg_stats_s *from)
+{
+    int i;
+
+    to->sent += from->sent;
+    to->rcvd += from->rcvd;
+    to->lost += from->lost;
+    to->unsolicited += from->unsolicited;
+    to->errors += from->errors;
+    for (i = 0; i < LG_BUCKETS; i++) {
+        to->hist[i] += from->hist[i];
+    }
+}
+
+// ----------------------------------------------------------------------
+
+// the Name TLV of an Interest or Data, without copying
+static int
+lg_name(uint8_t *data, size_t len, uint8_t **name, size_t *namelen)
+{
+    switch (lg.suite) {
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV: {
+        size_t hdrlen;
+
+        // fixed header, message TLV, then the name comes first
+        if (len < 8 || ccnl_ccntlv_getHdrLen(data, len, &hdrlen) ||
+            hdrlen + 8 > len) {
+            return -1;
+        }
+        data += hdrlen + 4;
+        len -= hdrlen + 4;
+        *namelen = 4 + (size_t) (data[2] << 8 | data[3]);
+        if ((data[0] << 8 | data[1]) != CCNX_TLV_M_Name || *namelen > len) {
+            return -1;
+        }
+        *name = data;
+        return 0;
+    }
+#endif
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV: {
+        uint8_t *start;
+        uint64_t typ;
+        size_t vallen;
+
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+            return -1;
+        }
+        start = data;
+        if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen) ||
+            typ != NDN_TLV_Name || vallen > len) {
+            return -1;
+        }
+        *name = start;
+        *namelen = (size_t) (data - start) + vallen;
+        return 0;
+    }
+#endif
+    default:
+        return -1;
+    }
+}
+
+#ifdef USE_SUITE_NDNTLV
+// where the 4 nonce bytes of an NDN Interest are
+static size_t
+lg_nonceOffset(uint8_t *pkt, size_t len)
+{
+    uint8_t *data = pkt;
+    uint64_t typ;
+    size_t vallen;
+
+    if (ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+        return 0;
+    }
+    while (len > 0 && !ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+        if (typ == NDN_TLV_Nonce && vallen == 4) {
+            return (size_t) (data - pkt);
+        }
+        data += vallen;
+        len -= vallen;
+    }
+    return 0;
+}
+#endif
+
+static int
+lg_mkName(struct lg_name_s *n, char *uri, uint32_t *chunknum)
+{
+    struct ccnl_prefix_s *p = ccnl_URItoPrefix(uri, lg.suite, chunknum);
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *buf;
+    uint8_t *name;
+    size_t namelen;
+
+    if (!p) {
+        return -1;
+    }
+    memset(&opts, 0, sizeof(opts));
+#ifdef USE_SUITE_NDNTLV
+    opts.ndntlv.nonce = 0x40000001; // four bytes, replaced per send
+#endif
+    buf = ccnl_mkSimpleInterest(p, &opts);
+    ccnl_prefix_free(p);
+    if (!buf) {
+        return -1;
+    }
+    n->pkt = malloc(buf->datalen);
+    if (!n->pkt) {
+        ccnl_free(buf);
+        return -1;
+    }
+    memcpy(n->pkt, buf->data, buf->datalen);
+    n->len = buf->datalen;
+    ccnl_free(buf);
+    if (lg_name(n->pkt, n->len, &name, &namelen)) {
+        return -1;
+    }
+    n->hash = lg_hash(name, namelen);
+#ifdef USE_SUITE_NDNTLV
+    if (lg.suite == CCNL_SUITE_NDNTLV) {
+        n->nonceoff = lg_nonceOffset(n->pkt, n->len);
+    }
+#endif
+    return 0;
+}
+
+static int
+lg_mkNames(const char *prefix)
+{
+    char uri[CCNL_MAX_PREFIX_SIZE];
+    size_t i;
+    double sum = 0;
+
+    if (lg.mode == LG_UNIQUE) {
+        uint8_t *name;
+        size_t namelen;
+
+        snprintf(uri, sizeof(uri), "%s/%0*d", prefix, LG_UNIQUE_LEN, 0);
+        if (lg_mkName(&lg.unique, uri, NULL) ||
+            lg_name(lg.unique.pkt, lg.unique.len, &name, &namelen)) {
+            return -1;
+        }
+        // the last component, the zeros at the end of the name
+        lg.uniqueoff = (size_t) (name - lg.unique.pkt) + namelen - LG_UNIQUE_LEN;
+        return 0;
+    }
+
+    lg.names = calloc(lg.namecnt, sizeof(*lg.names));
+    if (!lg.names) {
+        return -1;
+    }
+    for (i = 0; i < lg.namecnt; i++) {
+        uint32_t chunk = (uint32_t) i;
+
+        if (lg.mode == LG_SEQ) {
+            snprintf(uri, sizeof(uri), "%s", prefix);
+            if (lg_mkName(lg.names + i, uri, &chunk)) {
+                return -1;
+            }
+        } else {
+            snprintf(uri, sizeof(uri), "%s/%lu", prefix, (unsigned long) i);
+            if (lg_mkName(lg.names + i, uri, NULL)) {
+                return -1;
+            }
+        }
+    }
+
+    if (lg.mode == LG_ZIPF) {
+        // P(rank k) ~ 1 / k^alpha, rank 1 is the first name
+        lg.cdf = malloc(lg.namecnt * sizeof(double));
+        if (!lg.cdf) {
+            return -1;
+        }
+        for (i = 0; i < lg.namecnt; i++) {
+            sum += 1.0 / pow((double) (i + 1), lg.alpha);
+            lg.cdf[i] = sum;
+        }
+        for (i = 0; i < lg.namecnt; i++) {
+            lg.cdf[i] /= sum;
+        }
+    }
+    return 0;
+}
+
+// the next Interest of a thread, copied to t->pkt with a fresh nonce
+static size_t
+lg_next(struct lg_thread_s *t, uint64_t *hash)
+{
+    struct lg_name_s *n;
+    uint32_t nonce = (uint32_t) lg_random(&t->rnd);
+
+    switch (lg.mode) {
+    case LG_UNIQUE:
+        n = &lg.unique;
+        break;
+    case LG_SEQ:
+        n = lg.names + t->next % lg.namecnt;
+        t->next += (unsigned long) lg.threads;
+        break;
+    default: {
+        double u = (double) (lg_random(&t->rnd) >> 11) / 9007199254740992.0;
+        size_t lo = 0, hi = lg.namecnt - 1;
+
+        while (lo < hi) {
+            size_t mid = (lo + hi) / 2;
+
+            if (lg.cdf[mid] < u) {
+                lo = mid + 1;
+            } else {
+                hi = mid;
+            }
+        }
+        n = lg.names + lo;
+        break;
+    }
+    }
+    memcpy(t->pkt, n->pkt, n->len);
+    if (n->nonceoff) {
+        memcpy(t->pkt + n->nonceoff, &nonce, 4);
+    }
+    *hash = n->hash;
+    if (lg.mode == LG_UNIQUE) {
+        uint64_t v = (uint64_t) t->id << 48 | t->next++;
+        char hex[LG_UNIQUE_LEN + 1];
+        uint8_t *name;
+        size_t namelen;
+
+        snprintf(hex, sizeof(hex), "%016llx", (unsigned long long) v);
+        memcpy(t->pkt + lg.uniqueoff, hex, LG_UNIQUE_LEN);
+        lg_name(t->pkt, n->len, &name, &namelen);
+        *hash = lg_hash(name, namelen);
+    }
+    return n->len;
+}
+
+// ----------------------------------------------------------------------
+
+static void
+lg_pendingRemove(struct lg_thread_s *t, size_t i)
+{
+    size_t j = i;
+
+    // backward shift, the table stays free of tombstones
+    t->table[i].hash = 0;
+    for (;;) {
+        size_t home;
+
+        j = (j + 1) & t->mask;
+        if (!t->table[j].hash) {
+            break;
+        }
+        home = t->table[j].hash & t->mask;
+        if ((j > i && (home <= i || home > j)) ||
+            (j < i && (home <= i && home > j))) {
+            t->table[i] = t->table[j];
+            t->table[j].hash = 0;
+            i = j;
+        }
+    }
+    t->inflight--;
+}
+
+static int
+lg_pendingAdd(struct lg_thread_s *t, uint64_t hash, double now)
+{
+    size_t i;
+
+    if (t->inflight >= t->mask / 2 || ((t->tail + 1) & t->mask) == t->head) {
+        return -1;
+    }
+    for (i = hash & t->mask; t->table[i].hash; i = (i + 1) & t->mask);
+    t->table[i].hash = hash;
+    t->table[i].sent = now;
+    t->inflight++;
+    t->ring[t->tail].hash = hash;
+    t->ring[t->tail].sent = now;
+    t->tail = (t->tail + 1) & t->mask;
+    return 0;
+}
+
+// Interests are told apart by name and socket, the relay sees one face
+// per socket
+static uint64_t
+lg_key(uint64_t namehash, int sock)
+{
+    uint64_t h = namehash ^ (uint64_t) sock * 0x9e3779b97f4a7c15ULL;
+
+    return h ? h : 1;
+}
+
+// a reply answers the oldest Interest for its name on the socket; from the
+// content store every Interest gets its own reply
+static void
+lg_reply(struct lg_thread_s *t, uint64_t hash, double now)
+{
+    size_t i;
+
+    for (i = hash & t->mask; t->table[i].hash; i = (i + 1) & t->mask) {
+        if (t->table[i].hash == hash) {
+            t->st.rcvd++;
+            t->st.hist[lg_bucket(now - t->table[i].sent)]++;
+            lg_pendingRemove(t, i);
+            return;
+        }
+    }
+    t->st.unsolicited++;
+}
+
+// Interests older than the timeout are lost
+static void
+lg_expire(struct lg_thread_s *t, double now)
+{
+    while (t->head != t->tail && t->ring[t->head].sent + lg.wait <= now) {
+        struct lg_pending_s *r = t->ring + t->head;
+        size_t i;
+
+        for (i = r->hash & t->mask; t->table[i].hash; i = (i + 1) & t->mask) {
+            if (t->table[i].hash == r->hash && t->table[i].sent == r->sent) {
+                t->st.lost++;
+                lg_pendingRemove(t, i);
+                break;
+            }
+        }
+        t->head = (t->head + 1) & t->mask;
+    }
+}
+
+static void
+lg_receive(struct lg_thread_s *t, int s)
+{
+    uint8_t buf[CCNL_MAX_PACKET_SIZE], *data, *name;
+    size_t namelen;
+    ssize_t len;
+
+    while ((len = recv(t->socks[s], buf, sizeof(buf), MSG_DONTWAIT)) > 0) {
+        data = buf;
+#ifdef USE_SUITE_NDNTLV
+        if (lg.suite == CCNL_SUITE_NDNTLV && buf[0] == NDN_TLV_LpPacket) {
+            struct ccnl_ndntlv_lp_s lp;
+            size_t lplen, left = (size_t) len;
+            uint64_t typ;
+
+            if (ccnl_ndntlv_dehead(&data, &left, &typ, &lplen) ||
+                ccnl_ndntlv_parseLpPacket(data, lplen, &lp) || !lp.frag) {
+                continue;
+            }
+            data = lp.frag;
+            len = (ssize_t) lp.fraglen;
+        }
+#endif
+        if (!ccnl_isContent(data, (size_t) len, lg.suite) ||
+            lg_name(data, (size_t) len, &name, &namelen)) {
+            continue;
+        }
+        lg_reply(t, lg_key(lg_hash(name, namelen), s), lg_now());
+    }
+}
+
+// hands the interval over to the reporter
+static void
+lg_merge(struct lg_thread_s *t)
+{
+    pthread_mutex_lock(&lg_lock);
+    lg_add(lg_slots + t->interval, &t->st);
+    lg_add(&lg_total, &t->st);
+    lg_merged[t->interval]++;
+    pthread_cond_signal(&lg_cond);
+    pthread_mutex_unlock(&lg_lock);
+    memset(&t->st, 0, sizeof(t->st));
+    t->interval++;
+}
+
+static void*
+lg_run(void *arg)
+{
+    struct lg_thread_s *t = arg;
+    struct pollfd pfd[LG_MAXSOCKS];
+    double now, due = lg.start, end = lg.start + lg.duration;
+    double tick = lg.start + lg.period;
+    int i, s = 0;
+
+    for (i = 0; i < lg.socks; i++) {
+        pfd[i].fd = t->socks[i];
+        pfd[i].events = POLLIN;
+    }
+    for (;;) {
+        int ms;
+
+        now = lg_now();
+        // the last interval also takes what comes in after the end
+        while (now >= tick && t->interval < lg.intervals - 1) {
+            lg_merge(t);
+            tick += lg.period;
+        }
+        if (now >= end + lg.wait || (now >= end && !t->inflight)) {
+            break;
+        }
+
+        // open loop: what is due, bounded when far behind
+        for (i = 0; now < end && due <= now && i < LG_BURST; i++) {
+            uint64_t hash;
+            size_t len = lg_next(t, &hash);
+
+            due += (double) lg.threads / lg.rate;
+            if (lg_pendingAdd(t, lg_key(hash, s), now)) {
+                t->st.errors++;
+                continue;
+            }
+            if (sendto(t->socks[s], t->pkt, len, 0,
+                       (struct sockaddr*) &lg.dst, lg.dstlen) < 0) {
+                t->st.errors++;
+            }
+            t->st.sent++;
+            s = (s + 1) % lg.socks;
+        }
+        if (due < now - 1) {
+            due = now - 1;   // never more than a second to catch up
+        }
+
+        lg_expire(t, now);
+        ms = now < end ? (int) ((due - now) * 1000) : LG_POLL_MS;
+        ms = ms < 0 ? 0 : ms > LG_POLL_MS ? LG_POLL_MS : ms;
+        if (poll(pfd, (nfds_t) lg.socks, ms) > 0) {
+            for (i = 0; i < lg.socks; i++) {
+                if (pfd[i].revents & POLLIN) {
+                    lg_receive(t, i);
+                }
+            }
+        }
+    }
+    // what is still in flight after the timeout is lost
+    lg_expire(t, end + lg.wait + 1);
+    while (t->interval < lg.intervals) {
+        lg_merge(t);
+    }
+    return NULL;
+}
+
+// ----------------------------------------------------------------------
+
+// the loss is of the Interests answered or timed out in the interval
+static void
+lg_print(const char *what, const struct lg_stats_s *s, double secs)
+{
+    unsigned long done = s->rcvd + s->lost;
+
+    printf("%-8s %9lu %9lu %7lu %6.2f%% %10.0f %8.0f %8.0f %8.0f %8.0f\n",
+           what, s->sent, s->rcvd, s->lost,
+           done ? 100.0 * (double) s->lost / (double) done : 0.0,
+           (double) s->rcvd / secs,
+           lg_percentile(s, 50), lg_percentile(s, 90),
+           lg_percentile(s, 99), lg_percentile(s, 99.9));
+    fflush(stdout);
+}
+
+int
+main(int argc, char *argv[])
+{
+    static struct lg_thread_s threads[LG_MAXTHREADS];
+    char *udp = NULL, *addr = NULL, *ux = NULL, *mode = "zipf";
+    int opt, port, i, j;
+    size_t slots;
+
+    lg.suite = CCNL_SUITE_NDNTLV;
+    lg.threads = 1;
+    lg.socks = 1;
+    lg.rate = 1000;
+    lg.duration = 10;
+    lg.period = 1;
+    lg.wait = 1;
+    lg.alpha = 1;
+    lg.namecnt = 10000;
+
+    while ((opt = getopt(argc, argv, "a:d:hi:k:m:n:r:s:t:u:v:w:x:")) != -1) {
+        switch (opt) {
+        case 'a':
+            lg.alpha = strtod(optarg, NULL);
+            break;
+        case 'd':
+            lg.duration = strtod(optarg, NULL);
+            break;
+        case 'i':
+            lg.period = strtod(optarg, NULL);
+            break;
+        case 'k':
+            lg.socks = atoi(optarg);
+            break;
+        case 'm':
+            mode = optarg;
+            break;
+        case 'n':
+            lg.namecnt = (size_t) strtoul(optarg, NULL, 10);
+            break;
+        case 'r':
+            lg.rate = strtod(optarg, NULL);
+            break;
+        case 's':
+            lg.suite = ccnl_str2suite(optarg);
+            if (!ccnl_isSuite(lg.suite))
+                goto usage;
+            break;
+        case 't':
+            lg.threads = atoi(optarg);
+            break;
+        case 'u':
+            udp = optarg;
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0]))
+                debug_level =  (int)strtol(optarg, (char **)NULL, 10);
+            else
+                debug_level = ccnl_debug_str2level(optarg);
+#endif
+            break;
+        case 'w':
+            lg.wait = strtod(optarg, NULL);
+            break;
+        case 'x':
+            ux = optarg;
+            break;
+        case 'h':
+        default:
+usage:
+            fprintf(stderr, "usage: %s [options] URI\n"
+            "  -a ALPHA         Zipf exponent (default 1.0)\n"
+            "  -d SECONDS       how long to send (default 10)\n"
+            "  -i SECONDS       report interval (default 1)\n"
+            "  -k SOCKETS       per thread (default 1)\n"
+            "  -m MODE          names: zipf (URI/0 is the most popular, default),\n"
+            "                   seq (the segments of URI in turn),\n"
+            "                   unique (never repeated)\n"
+            "  -n NAMES         how many names or segments (default 10000)\n"
+            "  -r RATE          Interests per second, all threads (default 1000)\n"
+            "  -s SUITE         (ccnx2015, ndn2013)\n"
+            "  -t THREADS       (default 1)\n"
+            "  -u a.b.c.d/port  UDP destination (default is suite-dependent)\n"
+#ifdef USE_LOGGING
+            "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+#endif
+            "  -w SECONDS       until an unanswered Interest is lost (default 1)\n"
+            "  -x ux_path_name  UNIX IPC: use this instead of UDP\n"
+            "Latencies are in usec, the rate is of answered Interests.\n",
+            argv[0]);
+            exit(1);
+        }
+    }
+
+    if (!strcmp(mode, "zipf")) {
+        lg.mode = LG_ZIPF;
+    } else if (!strcmp(mode, "seq")) {
+        lg.mode = LG_SEQ;
+    } else if (!strcmp(mode, "unique")) {
+        lg.mode = LG_UNIQUE;
+    } else {
+        goto usage;
+    }
+    if (!argv[optind] || argv[optind + 1] || lg.rate <= 0 ||
+        lg.duration <= 0 || lg.period <= 0 || lg.wait <= 0 || !lg.namecnt ||
+        lg.threads < 1 || lg.threads > LG_MAXTHREADS ||
+        lg.socks < 1 || lg.socks > LG_MAXSOCKS ||
+        (lg.mode == LG_UNIQUE && lg.threads > 0xffff)) {
+        goto usage;
+    }
+    if (lg.suite != CCNL_SUITE_NDNTLV
+#ifdef USE_SUITE_CCNTLV
+        && lg.suite != CCNL_SUITE_CCNTLV
+#endif
+        ) {
+        DEBUGMSG(ERROR, "suite %s is not supported\n", ccnl_suite2str(lg.suite));
+        exit(1);
+    }
+    if (ccnl_parseUdp(udp, lg.suite, &addr, &port) != 0) {
+        exit(1);
+    }
+
+    memset(&lg.dst, 0, sizeof(lg.dst));
+    if (ux) {
+        struct sockaddr_un *su = (struct sockaddr_un*) &lg.dst;
+
+        if (lg.threads * lg.socks > 1) {
+            DEBUGMSG(ERROR, "UNIX IPC allows one thread and one socket\n");
+            exit(1);
+        }
+        su->sun_family = AF_UNIX;
+        strncpy(su->sun_path, ux, sizeof(su->sun_path) - 1);
+        lg.dstlen = sizeof(*su);
+    } else {
+        struct sockaddr_in *si = (struct sockaddr_in*) &lg.dst;
+
+        si->sin_family = AF_INET;
+        si->sin_addr.s_addr = inet_addr(addr);
+        si->sin_port = htons(port);
+        lg.dstlen = sizeof(*si);
+    }
+
+    if (lg_mkNames(argv[optind])) {
+        DEBUGMSG(ERROR, "cannot build Interests for %s\n", argv[optind]);
+        exit(1);
+    }
+
+    // room for everything sent within the timeout, twice over
+    slots = 64;
+    while ((double) slots < 4 * (lg.rate / lg.threads * lg.wait + LG_BURST)) {
+        slots *= 2;
+    }
+    lg.intervals = (int) ceil(lg.duration / lg.period);
+    lg_slots = calloc((size_t) lg.intervals, sizeof(*lg_slots));
+    lg_merged = calloc((size_t) lg.intervals, sizeof(*lg_merged));
+    if (!lg_slots || !lg_merged) {
+        exit(1);
+    }
+    srandom((unsigned) time(NULL));
+    for (i = 0; i < lg.threads; i++) {
+        struct lg_thread_s *t = threads + i;
+
+        t->id = i;
+        t->rnd = ((uint64_t) random() << 32 | (uint64_t) random()) | 1;
+        t->next = (unsigned long) i;
+        t->mask = slots - 1;
+        t->table = calloc(slots, sizeof(*t->table));
+        t->ring = calloc(slots, sizeof(*t->ring));
+        if (!t->table || !t->ring) {
+            exit(1);
+        }
+        for (j = 0; j < lg.socks; j++) {
+            t->socks[j] = ux ? ux_open() : udp_open();
+        }
+    }
+    if (lg.mode == LG_UNIQUE) {
+        for (i = 0; i < lg.threads; i++) {
+            threads[i].next = 0;
+        }
+    }
+
+    printf("# %s, %.0f Interests/s, %d thread(s) x %d socket(s), %s names\n",
+           argv[optind], lg.rate, lg.threads, lg.socks, mode);
+    printf("%-8s %9s %9s %7s %7s %10s %8s %8s %8s %8s\n", "time", "sent",
+           "rcvd", "lost", "loss", "rate", "p50", "p90", "p99", "p99.9");
+
+    // the threads compare and hash names, detect the kernels before
+    ccnl_simd_setLevel(-1);
+    lg.start = lg_now();
+    for (i = 0; i < lg.threads; i++) {
+        if (pthread_create(&threads[i].tid, NULL, lg_run, threads + i)) {
+            perror("pthread_create");
+            exit(1);
+        }
+    }
+    // an interval is printed when all threads have handed it over, losses
+    // show up in the interval where the timeout struck
+    for (i = 0; i < lg.intervals; i++) {
+        char when[16];
+        struct lg_stats_s s;
+        double secs = lg.period;
+
+        pthread_mutex_lock(&lg_lock);
+        while (lg_merged[i] < lg.threads) {
+            pthread_cond_wait(&lg_cond, &lg_lock);
+        }
+        s = lg_slots[i];
+        pthread_mutex_unlock(&lg_lock);
+        if (i == lg.intervals - 1) {
+            secs = lg.duration - i * lg.period;
+        }
+        snprintf(when, sizeof(when), "%.1f", (i + 1) * lg.period);
+        lg_print(when, &s, secs);
+    }
+    for (i = 0; i < lg.threads; i++) {
+        pthread_join(threads[i].tid, NULL);
+    }
+
+    printf("# %lu sent, %lu answered, %lu lost, %lu unsolicited, "
+           "%lu not sent\n", lg_total.sent, lg_total.rcvd, lg_total.lost,
+           lg_total.unsolicited, lg_total.errors);
+    lg_print("total", &lg_total, lg.duration);
+    return 0;
+}
+
+// eof
@@ -18,19 +18,23 @@
  *
  * File history:
  * 2013-07-06  created
+ * 2026-10-19  fragments written from header and payload view
  */
 
 
 #include "ccnl-common.h"
 
+#include <sys/uio.h>
+
 // ----------------------------------------------------------------------
 void
 file2frags(int suite, unsigned char *data, int datalen, char *fileprefix,
            int bytelimit, unsigned int *seqnr, unsigned int seqnrwidth,
            uint8_t noclobber)
 {
-    struct ccnl_buf_s *fragbuf;
+    struct ccnl_frag_iov_s frag;
     struct ccnl_frag_s fr;
+    struct iovec iov[2];
     char fname[512];
     int cnt = 0, f;
 
@@ -45,25 +49,26 @@ file2frags(int suite, unsigned char *data, int datalen, char *fileprefix,
     fr.flagwidth = 1;
     fr.outsuite = suite;
 
-    //    fragbuf = ccnl_frag_getnext(&fr);
-    fragbuf = ccnl_frag_getnext(&fr, NULL, NULL);
-    while (fragbuf) {
+    // header and payload view go out with one writev, no copy
+    while (!ccnl_frag_getnextIov(&fr, &frag, NULL, NULL)) {
         sprintf(fname, "%s%03d.frag", fileprefix, cnt);
         if (noclobber && !access(fname, F_OK)) {
             printf("file %s already exists, skipping this name\n", fname);
         } else {
-            printf("new fragment, len=%zd / %d --> %s\n",
-                   fragbuf->datalen, fr.sendseq, fname);
+            printf("new fragment, len=%zu / %d --> %s\n",
+                   frag.hdrlen + frag.datalen, fr.sendseq, fname);
             f = creat(fname, 0666);
             if (f < 0)
                 perror("open");
             else {
-                if (write(f, fragbuf->data, fragbuf->datalen) < 0)
+                iov[0].iov_base = frag.hdr;
+                iov[0].iov_len = frag.hdrlen;
+                iov[1].iov_base = frag.data;
+                iov[1].iov_len = frag.datalen;
+                if (writev(f, iov, 2) < 0)
                     perror("write");
                 close(f);
             }
-            ccnl_free(fragbuf);
-            fragbuf = ccnl_frag_getnext(&fr, NULL, NULL); //ccnl_frag_getnext(&fr);
         }
         cnt++;
     }
@@ -32,16 +32,16 @@
 unsigned char out[8*CCNL_MAX_PACKET_SIZE];
 int outlen;
 
-int
+int8_t
 frag_cb(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
-        unsigned char **data, int *len)
+        uint8_t **data, size_t *len)
 {
     (void)relay;
     (void)from;
     DEBUGMSG(INFO, "frag_cb\n");
 
     memcpy(out, *data, *len);
-    outlen = *len;
+    outlen = (int) *len;
     return 0;
 }
 
@@ -217,6 +217,7 @@ usage:
             if (isFragment && isFragment(cp, len2)) {
                 int t;
                 int len3;
+                size_t fraglen;
                 DEBUGMSG(DEBUG, "  fragment, %d bytes\n", len2);
                 switch(suite) {
                 case CCNL_SUITE_CCNTLV: {
@@ -235,10 +236,11 @@ usage:
                                       ntohs(*(uint16_t*) hp->fill) & 0x03fff,
                                       &cp, (int*) &len2);
                     */
+                    fraglen = (size_t) len3;
                     rc = ccnl_frag_RX_BeginEnd2015(frag_cb, NULL, &dummyFace,
                                       4096, hp->fill[0] >> 6,
                                       ntohs(*(uint16_t*) hp->fill) & 0x03fff,
-                                      &cp, (int*) &len3);
+                                      &cp, &fraglen);
                     break;
                 }
                 default:
@@ -18,6 +18,7 @@
  *
  * File history:
  * 2014-09-01 created <basil.kohler@unibas.ch>
+ * 2026-10-19 NDN segments are encoded from a template
  */
 
 
@@ -41,6 +42,7 @@ main(int argc, char *argv[])
     size_t chunk_size = CCNL_MAX_CHUNK_SIZE;
     struct ccnl_prefix_s *name;
     ccnl_data_opts_u data_opts;
+    struct ccnl_ndntlv_template_s tmpl;
 
     while ((opt = getopt(argc, argv, "hc:f:i:o:p:k:w:s:v:")) != -1) {
         switch (opt) {
@@ -120,7 +122,7 @@ Usage:
     }
 
     char *url_orig = argv[optind];
-    char url[strlen(url_orig)];
+    char url[strlen(url_orig) + 1];
     optind++;
 
     int status;
@@ -167,8 +169,8 @@ Usage:
         DEBUGMSG(WARNING, "filename -f without -o output dir does nothing\n");
     }
 
-    uint8_t *chunk_buf;
-    chunk_buf = ccnl_malloc(chunk_size * sizeof(uint8_t));
+    uint8_t *chunk_buf, *chunk_mem;
+    chunk_buf = chunk_mem = ccnl_malloc(chunk_size * sizeof(uint8_t));
     if (!chunk_buf) {
         DEBUGMSG(ERROR, "Error: Failed to allocate memory\n");
         exit(1);
@@ -222,6 +224,22 @@ Usage:
         --lastchunknum;
     }
 
+    memset(&tmpl, 0, sizeof(tmpl));
+    if (suite == CCNL_SUITE_NDNTLV) {
+        // name and MetaInfo are the same for all segments: encode them once
+        // and read each chunk to where its Content value goes
+        strcpy(url, url_orig);
+        name = ccnl_URItoPrefix(url, suite, NULL);
+        data_opts.ndntlv.freshnessperiod = 0;
+        data_opts.ndntlv.finalblockid = lastchunknum;
+        if (!name || ccnl_ndntlv_mkContentTemplate(&tmpl, name, &(data_opts.ndntlv))) {
+            DEBUGMSG(ERROR, "Error: Failed to encode the name\n");
+            goto Error;
+        }
+        ccnl_prefix_free(name);
+        chunk_buf = out + CCNL_MAX_PACKET_SIZE - tmpl.taillen - chunk_size;
+    }
+
     s_chunk_len = read(f, chunk_buf, chunk_size);
     if (s_chunk_len < 0) {
         DEBUGMSG(ERROR, "Error reading input file; error: %d\n", errno);
@@ -234,24 +252,24 @@ Usage:
             is_last = 1;
         }
 
-        strcpy(url, url_orig);
         offs = CCNL_MAX_PACKET_SIZE;
-        name = ccnl_URItoPrefix(url, suite, &chunknum);
 
         switch (suite) {
         case CCNL_SUITE_CCNTLV:
+            strcpy(url, url_orig);
+            name = ccnl_URItoPrefix(url, suite, &chunknum);
             if (ccnl_ccntlv_prependContentWithHdr(name, chunk_buf, chunk_len, &lastchunknum,
                                                   //is_last ? &chunknum : NULL,
                                                   NULL, // int *contentpos
                                                   &offs, out, &contentlen)) {
+                ccnl_prefix_free(name);
                 goto Error;
             }
+            ccnl_prefix_free(name);
             break;
         case CCNL_SUITE_NDNTLV:
-            data_opts.ndntlv.finalblockid = lastchunknum;
-            if (ccnl_ndntlv_prependContent(name, chunk_buf, chunk_len, NULL,
-                                           &(data_opts.ndntlv),// is_last ? &chunknum : NULL,
-                                           &offs, out, &contentlen)) {
+            if (ccnl_ndntlv_fillContent(&tmpl, &chunknum, chunk_buf, chunk_len,
+                                        &offs, out, &contentlen)) {
                 goto Error;
             }
             break;
@@ -286,12 +304,14 @@ Usage:
     }
 
     close(f);
-    ccnl_free(chunk_buf);
+    ccnl_free(chunk_mem);
+    ccnl_ndntlv_freeTemplate(&tmpl);
     return 0;
 
 Error:
     close(f);
-    ccnl_free(chunk_buf);
+    ccnl_free(chunk_mem);
+    ccnl_ndntlv_freeTemplate(&tmpl);
     return -1;
 }
 
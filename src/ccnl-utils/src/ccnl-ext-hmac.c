@@ -65,22 +65,29 @@ ccnl_hmac256_keysetup(SHA256_CTX_t *ctx, uint8_t *keyval, size_t kvlen,
     ccnl_SHA256_Update(ctx, buf, sizeof(buf));
 }
 
-// RFC2104 signature generation
 void
-ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
-                  uint8_t *data, size_t dlen,
-                  uint8_t *md, size_t *mlen)
+ccnl_hmac256_keyinit(struct ccnl_hmac256_key_s *key,
+                     uint8_t *keyval, size_t kvlen)
+{
+    ccnl_hmac256_keysetup(&key->inner, keyval, kvlen, 0x36);
+    ccnl_hmac256_keysetup(&key->outer, keyval, kvlen, 0x5c);
+}
+
+void
+ccnl_hmac256_signKey(struct ccnl_hmac256_key_s *key,
+                     uint8_t *data, size_t dlen,
+                     uint8_t *md, size_t *mlen)
 {
     uint8_t tmp[SHA256_DIGEST_LENGTH];
     SHA256_CTX_t ctx;
 
     DEBUGMSG(TRACE, "ccnl_hmac_sign %zu bytes\n", dlen);
 
-    ccnl_hmac256_keysetup(&ctx, keyval, kvlen, 0x36); // inner hash
+    ctx = key->inner; // inner hash
     ccnl_SHA256_Update(&ctx, data, dlen);
     ccnl_SHA256_Final(tmp, &ctx);
 
-    ccnl_hmac256_keysetup(&ctx, keyval, kvlen, 0x5c); // outer hash
+    ctx = key->outer; // outer hash
     ccnl_SHA256_Update(&ctx, tmp, sizeof(tmp));
     ccnl_SHA256_Final(tmp, &ctx);
 
@@ -90,6 +97,77 @@ ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
     memcpy(md, tmp, *mlen);
 }
 
+void
+ccnl_hmac256_signBatch(struct ccnl_hmac256_key_s *key, size_t n,
+                       uint8_t *data[], size_t dlen[], uint8_t *md[])
+{
+    SHA256_CTX_t ctx[8], *ctxp[8];
+    const sha2_byte *in[8];
+    size_t len[8], i, j, cnt;
+
+    DEBUGMSG(TRACE, "ccnl_hmac_signBatch %zu messages\n", n);
+
+    for (i = 0; i < n; i += cnt) {
+        cnt = n - i < 8 ? n - i : 8;
+        for (j = 0; j < cnt; j++) { // inner hashes
+            ctx[j] = key->inner;
+            ctxp[j] = ctx + j;
+            in[j] = data[i + j];
+            len[j] = dlen[i + j];
+        }
+        ccnl_SHA256_Batch(ctxp, in, len, md + i, cnt);
+        for (j = 0; j < cnt; j++) { // outer hashes, over the inner ones
+            ctx[j] = key->outer;
+            in[j] = md[i + j];
+            len[j] = SHA256_DIGEST_LENGTH;
+        }
+        ccnl_SHA256_Batch(ctxp, in, len, md + i, cnt);
+    }
+}
+
+#ifdef USE_VERIFY_POOL
+void
+ccnl_hmac256_verifyBatch(void *key, size_t n, struct ccnl_verify_job_s *jobs[])
+{
+    uint8_t md[8][SHA256_DIGEST_LENGTH], *data[8], *mdp[8], diff;
+    size_t dlen[8], i, j, k, cnt;
+
+    for (i = 0; i < n; i += cnt) {
+        cnt = n - i < 8 ? n - i : 8;
+        for (j = 0; j < cnt; j++) {
+            data[j] = (uint8_t*) jobs[i + j]->data;
+            dlen[j] = jobs[i + j]->datalen;
+            mdp[j] = md[j];
+        }
+        ccnl_hmac256_signBatch((struct ccnl_hmac256_key_s*) key, cnt,
+                               data, dlen, mdp);
+        for (j = 0; j < cnt; j++) {
+            struct ccnl_verify_job_s *job = jobs[i + j];
+            if (job->siglen != SHA256_DIGEST_LENGTH) {
+                job->result = 0;
+                continue;
+            }
+            for (diff = 0, k = 0; k < SHA256_DIGEST_LENGTH; k++) {
+                diff |= md[j][k] ^ job->sig[k];
+            }
+            job->result = !diff;
+        }
+    }
+}
+#endif
+
+// RFC2104 signature generation
+void
+ccnl_hmac256_sign(uint8_t *keyval, size_t kvlen,
+                  uint8_t *data, size_t dlen,
+                  uint8_t *md, size_t *mlen)
+{
+    struct ccnl_hmac256_key_s key;
+
+    ccnl_hmac256_keyinit(&key, keyval, kvlen);
+    ccnl_hmac256_signKey(&key, data, dlen, md, mlen);
+}
+
 #ifdef NEEDS_PACKET_CRAFTING
 
 #ifdef USE_SUITE_CCNTLV
@@ -140,11 +218,11 @@ ccnl_ccntlv_prependSignedContentWithHdr(struct ccnl_prefix_s *name,
         return -1;
     }
 
-    len = oldoffset - *offset;
     if (ccnl_ccntlv_prependContent(name, payload, paylen, lastchunknum,
                                    contentpos, offset, buf, &len)) {
         return -1;
     }
+    len = oldoffset - *offset; // the validation TLVs belong to the packet
     if (len > (UINT16_MAX - 8)) {
         DEBUGMSG(ERROR, "payload to sign is too large\n");
         return -1;
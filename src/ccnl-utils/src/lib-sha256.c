@@ -2,8 +2,15 @@
  * @f lib-sha256.c
  * @b implementation of NIST SHA256, based on Aaron Gifford's code
  *
+ * 2026-10-19 SHA-NI and AVX2 multi-buffer kernels, batch API
  */
 #include "lib-sha256.h"
+#include "ccnl-simd.h"
+
+#ifdef CCNL_SIMD_X86
+#include <cpuid.h>
+#include <immintrin.h>
+#endif
 
 /*
  * AUTHOR:	Aaron D. Gifford - http://www.aarongifford.com/
@@ -74,6 +81,8 @@ static const sha2_word32 sha256_initial_hash_value[8] _MEMLOCATION_ = {
 };
 
 
+static int ccnl_sha256_level = -1;
+
 /*** SHA-256: *********************************************************/
 
 void ccnl_SHA256_Init(SHA256_CTX_t* context) {
@@ -89,7 +98,7 @@ void ccnl_SHA256_Init(SHA256_CTX_t* context) {
 	context->bitcount = 0;
 }
 
-void ccnl_SHA256_Transform(SHA256_CTX_t* context, const sha2_word32* data) {
+static void ccnl_SHA256_Transform_scalar(SHA256_CTX_t* context, const sha2_word32* data) {
 	sha2_word32	a, b, c, d, e, f, g, h, s0, s1;
 	sha2_word32	T1, T2, *W256;
 	int		j;
@@ -167,6 +176,202 @@ void ccnl_SHA256_Transform(SHA256_CTX_t* context, const sha2_word32* data) {
 	a = b = c = d = e = f = g = h = T1 = T2 = 0;
 }
 
+/*** x86 kernels, compiled for their target, called if supported ******/
+
+#ifdef CCNL_SIMD_X86
+
+#define CCNL_SHA256_LANES	8
+
+/* two rounds per sha256rnds2, message schedule four words at a time */
+__attribute__((target("sha,sse4.1")))
+static void ccnl_SHA256_Blocks_shani(sha2_word32 state[8], const sha2_byte *data, size_t nblocks) {
+	const __m128i	bswap = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+	__m128i		abef, cdgh, abef_save, cdgh_save, msg, tmp, w[4];
+	int		i;
+
+	tmp = _mm_loadu_si128((const __m128i*) &state[0]);
+	cdgh = _mm_loadu_si128((const __m128i*) &state[4]);
+	tmp = _mm_shuffle_epi32(tmp, 0xB1);		/* CDAB */
+	cdgh = _mm_shuffle_epi32(cdgh, 0x1B);		/* EFGH */
+	abef = _mm_alignr_epi8(tmp, cdgh, 8);		/* ABEF */
+	cdgh = _mm_blend_epi16(cdgh, tmp, 0xF0);	/* CDGH */
+
+	for (; nblocks > 0; nblocks--, data += SHA256_BLOCK_LENGTH) {
+		abef_save = abef;
+		cdgh_save = cdgh;
+		for (i = 0; i < 4; i++) {
+			w[i] = _mm_shuffle_epi8(_mm_loadu_si128((const __m128i*) (data + 16 * i)), bswap);
+		}
+		for (i = 0; i < 16; i++) {
+			msg = _mm_add_epi32(w[i & 3], _mm_loadu_si128((const __m128i*) (K256 + 4 * i)));
+			cdgh = _mm_sha256rnds2_epu32(cdgh, abef, msg);
+			if (i < 12) {
+				/* words 4i+16..4i+19 replace 4i..4i+3 */
+				tmp = _mm_alignr_epi8(w[(i + 3) & 3], w[(i + 2) & 3], 4);
+				tmp = _mm_add_epi32(_mm_sha256msg1_epu32(w[i & 3], w[(i + 1) & 3]), tmp);
+				w[i & 3] = _mm_sha256msg2_epu32(tmp, w[(i + 3) & 3]);
+			}
+			msg = _mm_shuffle_epi32(msg, 0x0E);
+			abef = _mm_sha256rnds2_epu32(abef, cdgh, msg);
+		}
+		abef = _mm_add_epi32(abef, abef_save);
+		cdgh = _mm_add_epi32(cdgh, cdgh_save);
+	}
+
+	tmp = _mm_shuffle_epi32(abef, 0x1B);		/* FEBA */
+	cdgh = _mm_shuffle_epi32(cdgh, 0xB1);		/* DCHG */
+	abef = _mm_blend_epi16(tmp, cdgh, 0xF0);	/* DCBA */
+	cdgh = _mm_alignr_epi8(cdgh, tmp, 8);		/* HGFE */
+	_mm_storeu_si128((__m128i*) &state[0], abef);
+	_mm_storeu_si128((__m128i*) &state[4], cdgh);
+}
+
+static sha2_word32 ccnl_sha256_load32(const sha2_byte *p) {
+	sha2_word32	v;
+
+	memcpy(&v, p, sizeof(v));
+	return v;
+}
+
+#define ROTR8(x,n)	_mm256_or_si256(_mm256_srli_epi32((x), (n)), _mm256_slli_epi32((x), 32 - (n)))
+
+/*
+ * one block of eight independent messages, one per 32 bit lane; the
+ * state is kept transposed (word-major) and only updated in lanes
+ * whose bit is set in active
+ */
+__attribute__((target("avx2")))
+static void ccnl_SHA256_Block_avx2(sha2_word32 state[8][CCNL_SHA256_LANES],
+				   const sha2_byte *blk[CCNL_SHA256_LANES], int active) {
+	const __m256i	bswap = _mm256_set_epi8(12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3,
+						12, 13, 14, 15, 8, 9, 10, 11, 4, 5, 6, 7, 0, 1, 2, 3);
+	__m256i		w[16], s[8], a, b, c, d, e, f, g, h, t1, t2, s0, s1, mask;
+	int		j;
+
+	for (j = 0; j < 16; j++) {
+		w[j] = _mm256_set_epi32(
+			(int) ccnl_sha256_load32(blk[7] + 4 * j), (int) ccnl_sha256_load32(blk[6] + 4 * j),
+			(int) ccnl_sha256_load32(blk[5] + 4 * j), (int) ccnl_sha256_load32(blk[4] + 4 * j),
+			(int) ccnl_sha256_load32(blk[3] + 4 * j), (int) ccnl_sha256_load32(blk[2] + 4 * j),
+			(int) ccnl_sha256_load32(blk[1] + 4 * j), (int) ccnl_sha256_load32(blk[0] + 4 * j));
+		w[j] = _mm256_shuffle_epi8(w[j], bswap);
+	}
+	for (j = 0; j < 8; j++) {
+		s[j] = _mm256_loadu_si256((const __m256i*) state[j]);
+	}
+	a = s[0]; b = s[1]; c = s[2]; d = s[3];
+	e = s[4]; f = s[5]; g = s[6]; h = s[7];
+
+	for (j = 0; j < 64; j++) {
+		if (j >= 16) {
+			s0 = w[(j + 1) & 0x0f];
+			s0 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(s0, 7), ROTR8(s0, 18)),
+					      _mm256_srli_epi32(s0, 3));
+			s1 = w[(j + 14) & 0x0f];
+			s1 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(s1, 17), ROTR8(s1, 19)),
+					      _mm256_srli_epi32(s1, 10));
+			w[j & 0x0f] = _mm256_add_epi32(_mm256_add_epi32(w[j & 0x0f], s0),
+						       _mm256_add_epi32(w[(j + 9) & 0x0f], s1));
+		}
+		t1 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(e, 6), ROTR8(e, 11)), ROTR8(e, 25));
+		t1 = _mm256_add_epi32(_mm256_add_epi32(h, t1),
+				      _mm256_xor_si256(_mm256_and_si256(e, f), _mm256_andnot_si256(e, g)));
+		t1 = _mm256_add_epi32(_mm256_add_epi32(t1, _mm256_set1_epi32((int) K256[j])), w[j & 0x0f]);
+		t2 = _mm256_xor_si256(_mm256_xor_si256(ROTR8(a, 2), ROTR8(a, 13)), ROTR8(a, 22));
+		t2 = _mm256_add_epi32(t2, _mm256_xor_si256(_mm256_and_si256(a, b),
+			_mm256_and_si256(c, _mm256_xor_si256(a, b))));
+		h = g;
+		g = f;
+		f = e;
+		e = _mm256_add_epi32(d, t1);
+		d = c;
+		c = b;
+		b = a;
+		a = _mm256_add_epi32(t1, t2);
+	}
+
+	mask = _mm256_set_epi32(-((active >> 7) & 1), -((active >> 6) & 1), -((active >> 5) & 1),
+				-((active >> 4) & 1), -((active >> 3) & 1), -((active >> 2) & 1),
+				-((active >> 1) & 1), -(active & 1));
+	s[0] = _mm256_add_epi32(s[0], _mm256_and_si256(a, mask));
+	s[1] = _mm256_add_epi32(s[1], _mm256_and_si256(b, mask));
+	s[2] = _mm256_add_epi32(s[2], _mm256_and_si256(c, mask));
+	s[3] = _mm256_add_epi32(s[3], _mm256_and_si256(d, mask));
+	s[4] = _mm256_add_epi32(s[4], _mm256_and_si256(e, mask));
+	s[5] = _mm256_add_epi32(s[5], _mm256_and_si256(f, mask));
+	s[6] = _mm256_add_epi32(s[6], _mm256_and_si256(g, mask));
+	s[7] = _mm256_add_epi32(s[7], _mm256_and_si256(h, mask));
+	for (j = 0; j < 8; j++) {
+		_mm256_storeu_si256((__m256i*) state[j], s[j]);
+	}
+}
+
+static int ccnl_sha256_supported(void) {
+	unsigned int	eax, ebx, ecx, edx;
+
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("sse4.1") &&
+	    __get_cpuid_count(7, 0, &eax, &ebx, &ecx, &edx) && (ebx & bit_SHA)) {
+		return CCNL_SHA256_SHANI;
+	}
+	if (__builtin_cpu_supports("avx2")) {
+		return CCNL_SHA256_AVX2;
+	}
+	return CCNL_SHA256_SCALAR;
+}
+
+#else
+
+static int ccnl_sha256_supported(void) {
+	return CCNL_SHA256_SCALAR;
+}
+
+#endif /* CCNL_SIMD_X86 */
+
+int ccnl_SHA256_setLevel(int level) {
+	int	best = ccnl_sha256_supported();
+
+	if (level < 0 || level > best) {
+		level = best;
+	}
+	ccnl_sha256_level = level;
+	return level;
+}
+
+const char* ccnl_SHA256_name(void) {
+	if (ccnl_sha256_level < 0) {
+		ccnl_SHA256_setLevel(-1);
+	}
+	switch (ccnl_sha256_level) {
+	case CCNL_SHA256_SHANI:
+		return "sha-ni";
+	case CCNL_SHA256_AVX2:
+		return "avx2";
+	default:
+		return "scalar";
+	}
+}
+
+/* compresses nblocks full blocks from data into the context state */
+static void ccnl_SHA256_Blocks(SHA256_CTX_t* context, const sha2_byte *data, size_t nblocks) {
+	if (ccnl_sha256_level < 0) {
+		ccnl_SHA256_setLevel(-1);
+	}
+#ifdef CCNL_SIMD_X86
+	if (ccnl_sha256_level == CCNL_SHA256_SHANI) {
+		ccnl_SHA256_Blocks_shani(context->state, data, nblocks);
+		return;
+	}
+#endif
+	for (; nblocks > 0; nblocks--, data += SHA256_BLOCK_LENGTH) {
+		ccnl_SHA256_Transform_scalar(context, (const sha2_word32*) data);
+	}
+}
+
+void ccnl_SHA256_Transform(SHA256_CTX_t* context, const sha2_word32* data) {
+	ccnl_SHA256_Blocks(context, (const sha2_byte*) data, 1);
+}
+
 
 void ccnl_SHA256_Update(SHA256_CTX_t* context, const sha2_byte *data, size_t len) {
 	unsigned int	freespace, usedspace;
@@ -200,12 +405,14 @@ void ccnl_SHA256_Update(SHA256_CTX_t* context, const sha2_byte *data, size_t len
 			return;
 		}
 	}
-	while (len >= SHA256_BLOCK_LENGTH) {
+	if (len >= SHA256_BLOCK_LENGTH) {
 		/* Process as many complete blocks as we can */
-		ccnl_SHA256_Transform(context, (sha2_word32*)data);
-		context->bitcount += SHA256_BLOCK_LENGTH << 3;
-		len -= SHA256_BLOCK_LENGTH;
-		data += SHA256_BLOCK_LENGTH;
+		size_t	nblocks = len / SHA256_BLOCK_LENGTH;
+
+		ccnl_SHA256_Blocks(context, data, nblocks);
+		context->bitcount += (sha2_word64) nblocks * SHA256_BLOCK_LENGTH << 3;
+		len -= nblocks * SHA256_BLOCK_LENGTH;
+		data += nblocks * SHA256_BLOCK_LENGTH;
 	}
 	if (len > 0) {
 		/* There's left-overs, so save 'em */
@@ -279,4 +486,117 @@ void ccnl_SHA256_Final(sha2_byte digest[], SHA256_CTX_t* context) {
 	usedspace = 0;
 }
 
+/*** batches ********************************************************/
+
+#ifdef CCNL_SIMD_X86
+
+/*
+ * Finishes up to eight messages, each continuing from a context at a
+ * block boundary. Full blocks are read in place; the last one or two
+ * blocks of each message are padded in tail[].
+ */
+static void ccnl_SHA256_Batch_avx2(SHA256_CTX_t* context[], const sha2_byte *data[],
+				   const size_t len[], sha2_byte *digest[], size_t n) {
+	static const sha2_byte	zero[SHA256_BLOCK_LENGTH];
+	sha2_byte	tail[CCNL_SHA256_LANES][2 * SHA256_BLOCK_LENGTH];
+	sha2_word32	state[8][CCNL_SHA256_LANES];
+	const sha2_byte	*blk[CCNL_SHA256_LANES];
+	size_t		full[CCNL_SHA256_LANES], nb[CCNL_SHA256_LANES], maxnb = 0, b, i, j, rest;
+	sha2_word64	bits;
+	int		active;
+
+	for (i = 0; i < CCNL_SHA256_LANES; i++) {
+		full[i] = nb[i] = 0;
+		for (j = 0; j < 8; j++) {
+			state[j][i] = i < n ? context[i]->state[j] : 0;
+		}
+		if (i >= n) {
+			continue;
+		}
+		full[i] = len[i] / SHA256_BLOCK_LENGTH;
+		rest = len[i] % SHA256_BLOCK_LENGTH;
+		nb[i] = full[i] + (rest < SHA256_SHORT_BLOCK_LENGTH ? 1 : 2);
+		memset(tail[i], 0, sizeof(tail[i]));
+		memcpy(tail[i], data[i] + full[i] * SHA256_BLOCK_LENGTH, rest);
+		tail[i][rest] = 0x80;
+		bits = context[i]->bitcount + ((sha2_word64) len[i] << 3);
+		for (j = 0; j < 8; j++) {
+			tail[i][(nb[i] - full[i]) * SHA256_BLOCK_LENGTH - 1 - j] = (sha2_byte) (bits >> (8 * j));
+		}
+		if (nb[i] > maxnb) {
+			maxnb = nb[i];
+		}
+	}
+
+	for (b = 0; b < maxnb; b++) {
+		active = 0;
+		for (i = 0; i < CCNL_SHA256_LANES; i++) {
+			if (b < full[i]) {
+				blk[i] = data[i] + b * SHA256_BLOCK_LENGTH;
+			} else if (b < nb[i]) {
+				blk[i] = tail[i] + (b - full[i]) * SHA256_BLOCK_LENGTH;
+			} else {
+				blk[i] = zero;
+				continue;
+			}
+			active |= 1 << i;
+		}
+		ccnl_SHA256_Block_avx2(state, blk, active);
+	}
+
+	for (i = 0; i < n; i++) {
+		for (j = 0; j < 8; j++) {
+			digest[i][4 * j]     = (sha2_byte) (state[j][i] >> 24);
+			digest[i][4 * j + 1] = (sha2_byte) (state[j][i] >> 16);
+			digest[i][4 * j + 2] = (sha2_byte) (state[j][i] >> 8);
+			digest[i][4 * j + 3] = (sha2_byte) state[j][i];
+		}
+		MEMSET_BZERO(context[i], sizeof(SHA256_CTX_t));
+	}
+	MEMSET_BZERO(tail, sizeof(tail));
+}
+
+#endif /* CCNL_SIMD_X86 */
+
+void ccnl_SHA256_Batch(SHA256_CTX_t* context[], const sha2_byte *data[],
+		       const size_t len[], sha2_byte *digest[], size_t n) {
+	size_t	i;
+
+	if (ccnl_sha256_level < 0) {
+		ccnl_SHA256_setLevel(-1);
+	}
+#ifdef CCNL_SIMD_X86
+	if (ccnl_sha256_level == CCNL_SHA256_AVX2) {
+		SHA256_CTX_t	*lctx[CCNL_SHA256_LANES];
+		const sha2_byte	*ldata[CCNL_SHA256_LANES];
+		sha2_byte	*ldigest[CCNL_SHA256_LANES];
+		size_t		llen[CCNL_SHA256_LANES], cnt = 0;
+
+		for (i = 0; i < n; i++) {
+			if ((context[i]->bitcount >> 3) % SHA256_BLOCK_LENGTH) {
+				ccnl_SHA256_Update(context[i], data[i], len[i]);
+				ccnl_SHA256_Final(digest[i], context[i]);
+				continue;
+			}
+			lctx[cnt] = context[i];
+			ldata[cnt] = data[i];
+			llen[cnt] = len[i];
+			ldigest[cnt++] = digest[i];
+			if (cnt == CCNL_SHA256_LANES || i == n - 1) {
+				ccnl_SHA256_Batch_avx2(lctx, ldata, llen, ldigest, cnt);
+				cnt = 0;
+			}
+		}
+		if (cnt) {
+			ccnl_SHA256_Batch_avx2(lctx, ldata, llen, ldigest, cnt);
+		}
+		return;
+	}
+#endif
+	for (i = 0; i < n; i++) {
+		ccnl_SHA256_Update(context[i], data[i], len[i]);
+		ccnl_SHA256_Final(digest[i], context[i]);
+	}
+}
+
 // eof
@@ -0,0 +1,609 @@
+/**
+ * @file ccn-lite-replay.c
+ * @brief Replays packet traces through the forwarding core of an in-process
+ *        relay, for comparing core changes
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ *
+ * File history:
+ * 2026-10-19 created
+ */
+
+/*
+ * Two trace formats are read:
+ *
+ *   pcap     UDP datagrams over IPv4 or IPv6 (Ethernet, VLAN, raw IP, BSD
+ *            loopback, Linux cooked v1 and v2), those sent to one of the
+ *            -p ports are replayed as received from their source address
+ *   CCNLTRC1 "CCNLTRC1", then per packet a uint32 length, a uint32 face
+ *            number and a uint64 timestamp in usec (network byte order),
+ *            followed by the packet. Each face number becomes a peer
+ *            10.x.y.z:6363
+ *
+ * Packets leave through a stub ccnl_ll_TX_ptr that only counts them. An
+ * Interest answered to its own sender counts as a CS hit.
+ */
+
+#define _POSIX_C_SOURCE 200809L
+
+#include <ctype.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <sys/stat.h>
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-unix.h"
+
+#define REPLAY_MAXPORTS     8
+#define REPLAY_EVENTS       1024    // packets between two timer runs
+
+#define TRACE_MAGIC         "CCNLTRC1"
+
+struct replay_pkt_s {
+    uint8_t *data;
+    size_t len;
+    uint64_t usec;          // capture time
+    int ifndx;
+    sockunion peer;
+    size_t peerlen;
+};
+
+static struct replay_pkt_s *pkts;
+static size_t pktcnt, pktmax;
+
+static uint16_t ports[REPLAY_MAXPORTS];
+static int portcnt;
+
+static struct {
+    unsigned long pkts, bytes;
+    unsigned long upstream, downstream;
+    unsigned long interests, hits;
+} stats;
+
+static struct ccnl_face_s *upstream;
+static sockunion *current;      // the peer being replayed
+static int current_is_interest;
+
+static double
+replay_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static uint16_t
+get16(const uint8_t *p)
+{
+    return (uint16_t) (p[0] << 8 | p[1]);
+}
+
+static uint32_t
+get32(const uint8_t *p, int swap)
+{
+    if (swap) {
+        return (uint32_t) p[3] << 24 | (uint32_t) p[2] << 16 |
+               (uint32_t) p[1] << 8 | p[0];
+    }
+    return (uint32_t) p[0] << 24 | (uint32_t) p[1] << 16 |
+           (uint32_t) p[2] << 8 | p[3];
+}
+
+static int
+addPkt(uint8_t *data, size_t len, uint64_t usec, sockunion *peer)
+{
+    struct replay_pkt_s *p;
+
+    if (pktcnt == pktmax) {
+        size_t max = pktmax ? 2 * pktmax : 4096;
+
+        p = realloc(pkts, max * sizeof(*p));
+        if (!p) {
+            return -1;
+        }
+        pkts = p;
+        pktmax = max;
+    }
+    p = pkts + pktcnt++;
+    p->data = data;
+    p->len = len;
+    p->usec = usec;
+    p->peer = *peer;
+    if (peer->sa.sa_family == AF_INET6) {
+        p->ifndx = 1;
+        p->peerlen = sizeof(peer->ip6);
+    } else {
+        p->ifndx = 0;
+        p->peerlen = sizeof(peer->ip4);
+    }
+    return 0;
+}
+
+static int
+portMatch(uint16_t port)
+{
+    int i;
+
+    for (i = 0; i < portcnt; i++) {
+        if (ports[i] == port) {
+            return 1;
+        }
+    }
+    return 0;
+}
+
+// an IP packet, keeps the UDP payload if it is for one of the ports
+static void
+addIP(uint8_t *ip, size_t len, uint64_t usec)
+{
+    sockunion peer;
+    uint8_t *udp;
+    size_t udplen;
+
+    memset(&peer, 0, sizeof(peer));
+    if (len >= 20 && ip[0] >> 4 == 4) {
+        size_t hlen = (size_t) (ip[0] & 0x0f) * 4, tot = get16(ip + 2);
+
+        // fragments are not reassembled
+        if (ip[9] != 17 || hlen < 20 || tot > len || tot < hlen + 8 ||
+            (get16(ip + 6) & 0x3fff)) {
+            return;
+        }
+        udp = ip + hlen;
+        udplen = tot - hlen;
+        peer.ip4.sin_family = AF_INET;
+        memcpy(&peer.ip4.sin_addr, ip + 12, 4);
+        memcpy(&peer.ip4.sin_port, udp, 2);
+    } else if (len >= 48 && ip[0] >> 4 == 6) {
+        // extension headers are not followed
+        if (ip[6] != 17 || (size_t) get16(ip + 4) + 40 > len) {
+            return;
+        }
+        udp = ip + 40;
+        udplen = get16(ip + 4);
+        peer.ip6.sin6_family = AF_INET6;
+        memcpy(&peer.ip6.sin6_addr, ip + 8, 16);
+        memcpy(&peer.ip6.sin6_port, udp, 2);
+    } else {
+        return;
+    }
+    if (get16(udp + 4) < 8 || get16(udp + 4) > udplen ||
+        !portMatch(get16(udp + 2))) {
+        return;
+    }
+    if (get16(udp + 4) > 8) {
+        addPkt(udp + 8, get16(udp + 4) - 8u, usec, &peer);
+    }
+}
+
+static int
+readPcap(uint8_t *buf, size_t len)
+{
+    uint32_t magic, linktype;
+    int swap, nsec;
+    size_t off;
+
+    magic = get32(buf, 0);
+    if (magic == 0xa1b2c3d4 || magic == 0xa1b23c4d) {
+        swap = 0;
+    } else if (magic == 0xd4c3b2a1 || magic == 0x4d3cb2a1) {
+        swap = 1;
+    } else {
+        return -1;
+    }
+    nsec = magic == 0xa1b23c4d || magic == 0x4d3cb2a1;
+    if (len < 24) {
+        return -1;
+    }
+    linktype = get32(buf + 20, swap) & 0x0fffffff;
+
+    for (off = 24; off + 16 <= len; ) {
+        uint8_t *frame = buf + off + 16;
+        size_t caplen = get32(buf + off + 8, swap), hdr;
+        uint64_t usec = (uint64_t) get32(buf + off, swap) * 1000000 +
+                        get32(buf + off + 4, swap) / (nsec ? 1000 : 1);
+        uint16_t proto = 0;
+
+        if (caplen > len - off - 16) {
+            DEBUGMSG(WARNING, "truncated pcap record at byte %zu\n", off);
+            break;
+        }
+        off += 16 + caplen;
+
+        switch (linktype) {
+        case 0:     // BSD loopback, the family in the capturer's byte order
+            hdr = 4;
+            break;
+        case 1:     // Ethernet
+            hdr = 14;
+            if (caplen >= 18 && get16(frame + 12) == 0x8100) {
+                hdr = 18;
+            }
+            if (caplen >= hdr) {
+                proto = get16(frame + hdr - 2);
+            }
+            break;
+        case 12:
+        case 101:   // raw IP
+            hdr = 0;
+            break;
+        case 113:   // Linux cooked
+            hdr = 16;
+            if (caplen >= hdr) {
+                proto = get16(frame + 14);
+            }
+            break;
+        case 276:   // Linux cooked v2
+            hdr = 20;
+            if (caplen >= hdr) {
+                proto = get16(frame);
+            }
+            break;
+        default:
+            DEBUGMSG(ERROR, "pcap link type %u is not supported\n", linktype);
+            return -1;
+        }
+        if (caplen < hdr ||
+            (proto && proto != 0x0800 && proto != 0x86dd)) {
+            continue;
+        }
+        addIP(frame + hdr, caplen - hdr, usec);
+    }
+    return 0;
+}
+
+static int
+readTrace(uint8_t *buf, size_t len)
+{
+    size_t off;
+
+    for (off = strlen(TRACE_MAGIC); off + 16 <= len; ) {
+        uint32_t plen = get32(buf + off, 0), face = get32(buf + off + 4, 0);
+        uint64_t usec = (uint64_t) get32(buf + off + 8, 0) << 32 |
+                        get32(buf + off + 12, 0);
+        sockunion peer;
+
+        if (plen > len - off - 16) {
+            DEBUGMSG(WARNING, "truncated trace record at byte %zu\n", off);
+            break;
+        }
+        memset(&peer, 0, sizeof(peer));
+        peer.ip4.sin_family = AF_INET;
+        peer.ip4.sin_addr.s_addr = htonl(0x0a000000 | (face & 0x00ffffff));
+        peer.ip4.sin_port = htons(NDN_UDP_PORT);
+        addPkt(buf + off + 16, plen, usec, &peer);
+        off += 16 + plen;
+    }
+    return 0;
+}
+
+// the file stays in memory, the packets point into it
+static uint8_t*
+readFile(const char *fname)
+{
+    uint8_t *buf;
+    struct stat st;
+    size_t len;
+    int fd, rc;
+
+    fd = open(fname, O_RDONLY);
+    if (fd < 0 || fstat(fd, &st) || st.st_size < 24) {
+        DEBUGMSG(ERROR, "cannot read %s\n", fname);
+        if (fd >= 0) {
+            close(fd);
+        }
+        return NULL;
+    }
+    len = (size_t) st.st_size;
+    buf = malloc(len);
+    if (!buf || read(fd, buf, len) != (ssize_t) len) {
+        DEBUGMSG(ERROR, "cannot read %s\n", fname);
+        close(fd);
+        free(buf);
+        return NULL;
+    }
+    close(fd);
+
+    if (!memcmp(buf, TRACE_MAGIC, strlen(TRACE_MAGIC))) {
+        rc = readTrace(buf, len);
+    } else {
+        rc = readPcap(buf, len);
+    }
+    if (rc) {
+        DEBUGMSG(ERROR, "%s: neither pcap nor %s\n", fname, TRACE_MAGIC);
+        free(buf);
+        return NULL;
+    }
+    return buf;
+}
+
+// stands in for the sockets: the buffer belongs to the caller
+static void
+replay_TX(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc,
+          sockunion *dst, struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) ifc;
+
+    stats.pkts++;
+    stats.bytes += buf->datalen;
+    if (upstream && !ccnl_addr_cmp(dst, &upstream->peer)) {
+        stats.upstream++;
+        return;
+    }
+    stats.downstream++;
+    if (current_is_interest && current && !ccnl_addr_cmp(dst, current)) {
+        stats.hits++;
+        current_is_interest = 0; // one hit per Interest
+    }
+}
+
+static int
+isInterest(const uint8_t *data, size_t len)
+{
+    size_t skip;
+    int suite = ccnl_pkt2suite((uint8_t*) data, len, &skip);
+
+    switch (suite) {
+#ifdef USE_SUITE_NDNTLV
+    case CCNL_SUITE_NDNTLV:
+        return data[skip] == NDN_TLV_Interest;
+#endif
+#ifdef USE_SUITE_CCNTLV
+    case CCNL_SUITE_CCNTLV:
+        return len > skip + 1 && data[skip + 1] == CCNX_PT_Interest;
+#endif
+    default:
+        return 0;
+    }
+}
+
+static int
+cmpDouble(const void *a, const void *b)
+{
+    double x = *(const double*) a, y = *(const double*) b;
+
+    return x < y ? -1 : x > y;
+}
+
+static double
+percentile(const double *sorted, size_t n, double p)
+{
+    size_t i = (size_t) (p / 100.0 * (double) n);
+
+    return sorted[i < n ? i : n - 1];
+}
+
+static void
+waitUntil(double ns)
+{
+    double d = ns - replay_now();
+
+    if (d > 0) {
+        struct timespec ts;
+
+        ts.tv_sec = (time_t) (d / 1e9);
+        ts.tv_nsec = (long) (d - (double) ts.tv_sec * 1e9);
+        while (nanosleep(&ts, &ts) && errno == EINTR);
+    }
+}
+
+static struct ccnl_face_s*
+mkUpstream(struct ccnl_relay_s *relay, char *uri, int suite)
+{
+    struct ccnl_face_s *f;
+    struct ccnl_prefix_s *pfx;
+    sockunion su;
+
+    memset(&su, 0, sizeof(su));
+    su.ip4.sin_family = AF_INET;
+    su.ip4.sin_addr.s_addr = htonl(0xc0000201);     // 192.0.2.1, TEST-NET-1
+    su.ip4.sin_port = htons(NDN_UDP_PORT);
+    f = ccnl_get_face_or_create(relay, 0, &su.sa, sizeof(su.ip4));
+    if (!f) {
+        return NULL;
+    }
+    f->flags |= CCNL_FACE_FLAGS_STATIC;
+    pfx = ccnl_URItoPrefix(uri, suite, NULL);
+    if (!pfx || ccnl_fib_add_entry(relay, pfx, f)) {
+        DEBUGMSG(ERROR, "cannot add a route for %s\n", uri);
+        return NULL;
+    }
+    return f;
+}
+
+int
+main(int argc, char *argv[])
+{
+    static struct ccnl_relay_s relay;
+    char *route = "/";
+    double *lat, speed = 0, t0, t, elapsed;
+    size_t i, nlat = 0;
+    struct ccnl_face_s *f;
+    int faces = 0;
+    int opt, suite = CCNL_SUITE_DEFAULT, loops = 1, loop;
+    uint8_t *trace;
+#ifdef USE_DEBUG_MALLOC
+    struct ccnl_malloc_stats_s mstats;
+#endif
+
+    memset(&relay, 0, sizeof(relay));
+    relay.max_cache_entries = -1;
+    while ((opt = getopt(argc, argv, "hc:l:p:P:r:s:v:")) != -1) {
+        switch (opt) {
+        case 'c':
+            relay.max_cache_entries = atoi(optarg);
+            break;
+        case 'l':
+            loops = atoi(optarg);
+            break;
+        case 'p':
+            if (portcnt < REPLAY_MAXPORTS) {
+                ports[portcnt++] = (uint16_t) atoi(optarg);
+            }
+            break;
+        case 'P':
+            speed = atof(optarg);
+            break;
+        case 'r':
+            route = optarg;
+            break;
+        case 's':
+            suite = ccnl_str2suite(optarg);
+            if (!ccnl_isSuite(suite)) {
+                goto Usage;
+            }
+            break;
+        case 'v':
+#ifdef USE_LOGGING
+            if (isdigit(optarg[0]))
+                debug_level =  (int)strtol(optarg, (char **)NULL, 10);
+            else
+                debug_level = ccnl_debug_str2level(optarg);
+#endif
+            break;
+        case 'h':
+        default:
+Usage:
+            fprintf(stderr,
+            "Replays a packet trace through the forwarding core, no sockets.\n"
+            "usage: %s [options] TRACE\n"
+            "  -c MAX_CONTENT_ENTRIES  (dflt: unlimited)\n"
+            "  -l LOOPS         replay the trace this many times (dflt: 1)\n"
+            "  -p PORT          UDP port the relay listened on, repeatable\n"
+            "                   (dflt: %d and %d)\n"
+            "  -P SPEED         keep the recorded pacing, 2 = twice as fast\n"
+            "                   (dflt: as fast as possible)\n"
+            "  -r URI           route to the upstream face (dflt: /)\n"
+            "  -s SUITE         of the route (ccnb, ccnx2015, ndn2013)\n"
+#ifdef USE_LOGGING
+            "  -v DEBUG_LEVEL (fatal, error, warning, info, debug, verbose, trace)\n"
+#endif
+            "A TRACE is a pcap file or in the %s format, see the source.\n",
+            argv[0], NDN_UDP_PORT, CCN_UDP_PORT, TRACE_MAGIC);
+            exit(1);
+        }
+    }
+    if (optind != argc - 1 || loops < 1 || speed < 0) {
+        goto Usage;
+    }
+    if (!portcnt) {
+        ports[portcnt++] = NDN_UDP_PORT;
+        ports[portcnt++] = CCN_UDP_PORT;
+    }
+
+    trace = readFile(argv[optind]);
+    if (!trace) {
+        return 1;
+    }
+    if (!pktcnt) {
+        DEBUGMSG(ERROR, "%s: no packets to replay\n", argv[optind]);
+        return 1;
+    }
+    lat = malloc(pktcnt * (size_t) loops * sizeof(*lat));
+    if (!lat) {
+        return 1;
+    }
+
+    ccnl_core_init();
+    relay.ccnl_ll_TX_ptr = replay_TX;
+    relay.max_pit_entries = CCNL_DEFAULT_MAX_PIT_ENTRIES;
+    relay.max_pit_bytes = CCNL_DEFAULT_MAX_PIT_BYTES;
+    relay.ifcount = 2;
+    relay.ifs[0].addr.sa.sa_family = AF_INET;
+    relay.ifs[0].sock = -1;
+    relay.ifs[1].addr.sa.sa_family = AF_INET6;
+    relay.ifs[1].sock = -1;
+    upstream = mkUpstream(&relay, route, suite);
+    if (!upstream) {
+        return 1;
+    }
+    ccnl_set_timer(1000000, ccnl_ageing, &relay, 0);
+
+#ifdef USE_DEBUG_MALLOC
+    mstats = ccnl_malloc_stats;
+#endif
+    t0 = replay_now();
+    for (loop = 0; loop < loops; loop++) {
+        double base = replay_now();
+
+        for (i = 0; i < pktcnt; i++) {
+            struct replay_pkt_s *p = pkts + i;
+
+            if (speed > 0) {
+                waitUntil(base + (double) (p->usec - pkts[0].usec) * 1e3 / speed);
+            }
+            if (!(i % REPLAY_EVENTS)) {
+                ccnl_run_events();
+            }
+            current_is_interest = isInterest(p->data, p->len);
+            stats.interests += (unsigned long) current_is_interest;
+
+            current = &p->peer;
+            t = replay_now();
+            ccnl_core_RX(&relay, p->ifndx, p->data, p->len,
+                         &p->peer.sa, p->peerlen);
+            lat[nlat++] = replay_now() - t;
+        }
+    }
+    elapsed = replay_now() - t0;
+
+    for (f = relay.faces; f; f = f->next) {
+        faces++;
+    }
+    qsort(lat, nlat, sizeof(*lat), cmpDouble);
+    printf("packets        %zu (%zu x %d)\n", nlat, pktcnt, loops);
+    printf("elapsed        %.3f s\n", elapsed / 1e9);
+    printf("rate           %.0f pkt/s\n", (double) nlat * 1e9 / elapsed);
+    printf("latency        p50 %.0f  p90 %.0f  p99 %.0f  p99.9 %.0f  "
+           "max %.0f ns\n",
+           percentile(lat, nlat, 50), percentile(lat, nlat, 90),
+           percentile(lat, nlat, 99), percentile(lat, nlat, 99.9),
+           lat[nlat - 1]);
+    printf("cs hits        %lu of %lu Interests (%.1f%%)\n", stats.hits,
+           stats.interests,
+           stats.interests ? 100.0 * stats.hits / stats.interests : 0.0);
+    printf("sent           %lu packets, %lu bytes (%lu upstream, "
+           "%lu downstream)\n", stats.pkts, stats.bytes, stats.upstream,
+           stats.downstream);
+    printf("relay          %d faces, %d pit, %d contents\n",
+           faces, relay.pitcnt, relay.contentcnt);
+#ifdef USE_DEBUG_MALLOC
+    printf("allocator      %lu allocs, %lu frees, %.2f allocs/pkt, "
+           "%.1f bytes/pkt\n",
+           ccnl_malloc_stats.allocs - mstats.allocs,
+           ccnl_malloc_stats.frees - mstats.frees,
+           (double) (ccnl_malloc_stats.allocs - mstats.allocs) / (double) nlat,
+           (double) (ccnl_malloc_stats.bytes - mstats.bytes) / (double) nlat);
+#endif
+
+    ccnl_core_cleanup(&relay);
+    free(lat);
+    free(pkts);
+    free(trace);
+    return 0;
+}
+
+// eof
@@ -0,0 +1,764 @@
+/**
+ * @file ccnl-bench.c
+ * @brief Micro-benchmarks for the forwarding hot paths
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#define _POSIX_C_SOURCE 200809L
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#include "ccnl-core.h"
+#include "ccnl-simd.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-fwd.h"
+#include "ccnl-ext-hmac.h"
+
+#define BENCH_NAMES     64
+#define BENCH_INTERESTS 1024    // distinct nonces, more than CCNL_MAX_NONCES
+#define BENCH_PIT       1024
+#define BENCH_FIB_MAX   1000000
+#define BENCH_CS_MAX    100000  // content store and FIB of the large RX runs
+
+#ifdef CCNL_SUITE_FIXED
+# define BENCH_FWD_VARIANT  "fixed"
+#else
+# define BENCH_FWD_VARIANT  "generic"
+#endif
+
+// 5 to 10 components, as seen for versioned and segmented NDN names
+static const char *bench_uris[] = {
+    "/ndn/edu/unibas/cs/video/2018/talk.mp4/v1/seg",
+    "/com/example/www/index.html/v3",
+    "/org/ccn-lite/sensors/building-7/floor-2/room-214/temperature/latest",
+    "/localhost/nfd/rib/register/params/signature",
+};
+
+static volatile uint32_t bench_sink;
+
+static int bench_json;
+static int bench_count;
+
+// time and allocations, only while running
+struct bench_clock_s {
+    double ns, t0;
+    unsigned long allocs, a0;
+};
+
+static double
+bench_now(void)
+{
+    struct timespec ts;
+
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec * 1e9 + ts.tv_nsec;
+}
+
+static void
+bench_resume(struct bench_clock_s *c)
+{
+    c->a0 = ccnl_malloc_stats.allocs;
+    c->t0 = bench_now();
+}
+
+static void
+bench_pause(struct bench_clock_s *c)
+{
+    c->ns += bench_now() - c->t0;
+    c->allocs += ccnl_malloc_stats.allocs - c->a0;
+}
+
+static void
+bench_start(struct bench_clock_s *c)
+{
+    c->ns = 0;
+    c->allocs = 0;
+    bench_resume(c);
+}
+
+static void
+bench_report(const char *name, const char *variant, struct bench_clock_s *c,
+             long ops)
+{
+    bench_pause(c);
+    if (!bench_json) {
+        printf("%-24s %-8s %10.1f ns/op %8.2f allocs/op\n", name, variant,
+               c->ns / ops, (double) c->allocs / ops);
+        return;
+    }
+    printf("%s\n    {\"name\": \"%s\", \"variant\": \"%s\", "
+           "\"ops\": %ld, \"ns_per_op\": %.1f, \"allocs_per_op\": %.2f}",
+           bench_count++ ? "," : "", name, variant, ops, c->ns / ops,
+           (double) c->allocs / ops);
+}
+
+// names that differ in the last component only: the expensive case
+static struct ccnl_prefix_s*
+bench_name(int i)
+{
+    char uri[256];
+
+    snprintf(uri, sizeof(uri), "%s/%d",
+             bench_uris[i % (sizeof(bench_uris) / sizeof(*bench_uris))], i / 4);
+    return ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+}
+
+static void
+bench_prefix_cmp(long ops)
+{
+    struct ccnl_prefix_s *n[BENCH_NAMES];
+    struct bench_clock_s t;
+    long k;
+    int i;
+
+    for (i = 0; i < BENCH_NAMES; i++) {
+        n[i] = bench_name(i);
+    }
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        i = (int) (k % BENCH_NAMES);
+        bench_sink += ccnl_prefix_cmp(n[i], NULL, n[(i + 4) % BENCH_NAMES],
+                                      CMP_LONGEST);
+        bench_sink += ccnl_prefix_cmp(n[i], NULL, n[(i + 1) % BENCH_NAMES],
+                                      CMP_EXACT);
+    }
+    bench_report("prefix_cmp", ccnl_simd_name(), &t, 2 * ops);
+
+    for (i = 0; i < BENCH_NAMES; i++) {
+        ccnl_prefix_free(n[i]);
+    }
+}
+
+static void
+bench_memeq(long ops, size_t len)
+{
+    uint8_t *a = malloc(len), *b = malloc(len);
+    char name[32];
+    struct bench_clock_s t;
+    long k;
+
+    memset(a, 'x', len);
+    memset(b, 'x', len);
+    snprintf(name, sizeof(name), "memeq/%lu", (unsigned long) len);
+
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        b[k % len] ^= (uint8_t) (k & 1);
+        bench_sink += ccnl_simd_memeq(a, b, len);
+    }
+    bench_report(name, ccnl_simd_name(), &t, ops);
+
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        b[k % len] ^= (uint8_t) (k & 1);
+        bench_sink += !memcmp(a, b, len);
+    }
+    bench_report(name, "memcmp", &t, ops);
+
+    free(a);
+    free(b);
+}
+
+static void
+bench_crc32c(long ops, size_t len)
+{
+    uint8_t *a = malloc(len);
+    char name[32];
+    struct bench_clock_s t;
+    long k;
+
+    memset(a, 'y', len);
+    snprintf(name, sizeof(name), "crc32c/%lu", (unsigned long) len);
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        bench_sink += ccnl_simd_crc32c((uint32_t) k, a, len);
+    }
+    bench_report(name, ccnl_simd_name(), &t, ops);
+    free(a);
+}
+
+// walks the TLVs of an encoded name as the NDN parser does
+static void
+bench_ndntlv_name(long ops)
+{
+    struct ccnl_prefix_s *p = bench_name(0);
+    uint8_t buf[CCNL_MAX_PACKET_SIZE];
+    size_t offset = sizeof(buf), len;
+    struct bench_clock_s t;
+    long k;
+
+    ccnl_ndntlv_prependName(p, &offset, buf);
+    len = sizeof(buf) - offset;
+
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        uint8_t *cp = buf + offset;
+        size_t left = len, vallen;
+        uint64_t typ;
+        if (ccnl_ndntlv_dehead(&cp, &left, &typ, &vallen)) {
+            break;
+        }
+        while (left > 0 && !ccnl_ndntlv_dehead(&cp, &left, &typ, &vallen)) {
+            bench_sink += cp[0];
+            cp += vallen;
+            left -= vallen;
+        }
+    }
+    bench_report("ndntlv_name_walk", "-", &t, ops);
+    ccnl_prefix_free(p);
+}
+
+// one 4 KiB segment, encoded from scratch and from a template
+static void
+bench_ndntlv_encode(long ops)
+{
+    struct ccnl_prefix_s *p = bench_name(0);
+    struct ccnl_ndntlv_data_opts_s opts = { 0, 1000 };
+    struct ccnl_ndntlv_template_s t;
+    uint8_t buf[CCNL_MAX_PACKET_SIZE], payload[4096];
+    size_t offset, len;
+    uint32_t seg = 0;
+    struct bench_clock_s tm;
+    long k;
+
+    memset(payload, 'd', sizeof(payload));
+    p->chunknum = (uint32_t*) ccnl_malloc(sizeof(uint32_t));
+    bench_start(&tm);
+    for (k = 0; k < ops; k++) {
+        *p->chunknum = (uint32_t) k;
+        offset = sizeof(buf);
+        ccnl_ndntlv_prependContent(p, payload, sizeof(payload), NULL, &opts,
+                                   &offset, buf, &len);
+    }
+    bench_report("ndntlv_encode", "prepend", &tm, ops);
+
+    ccnl_ndntlv_mkContentTemplate(&t, p, &opts);
+    bench_start(&tm);
+    for (k = 0; k < ops; k++) {
+        seg = (uint32_t) k;
+        offset = sizeof(buf);
+        ccnl_ndntlv_fillContent(&t, &seg, payload, sizeof(payload),
+                                &offset, buf, &len);
+    }
+    bench_report("ndntlv_encode", "template", &tm, ops);
+
+    ccnl_ndntlv_freeTemplate(&t);
+    ccnl_prefix_free(p);
+}
+
+// HMAC over 4 KiB segments: one by one from the key value, and in batches
+static void
+bench_hmac256(long ops)
+{
+    static uint8_t seg[8][4096];
+    uint8_t keyval[64], md[8][32], *mdp[8], *data[8];
+    struct ccnl_hmac256_key_s key;
+    size_t len[8], mlen;
+    struct bench_clock_s t;
+    long k;
+    int i;
+
+    memset(keyval, 'k', sizeof(keyval));
+    for (i = 0; i < 8; i++) {
+        memset(seg[i], 'a' + i, sizeof(seg[i]));
+        data[i] = seg[i];
+        len[i] = sizeof(seg[i]);
+        mdp[i] = md[i];
+    }
+    ccnl_hmac256_keyinit(&key, keyval, sizeof(keyval));
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        mlen = sizeof(md[0]);
+        ccnl_hmac256_signKey(&key, seg[k % 8], sizeof(seg[0]), md[0], &mlen);
+        bench_sink += md[0][0];
+    }
+    bench_report("hmac256/4096", ccnl_SHA256_name(), &t, ops);
+
+    bench_start(&t);
+    for (k = 0; k < ops; k += 8) {
+        ccnl_hmac256_signBatch(&key, 8, data, len, mdp);
+        bench_sink += md[7][0];
+    }
+    bench_report("hmac256/4096", "batch", &t, ops);
+}
+
+static void
+bench_TX(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc, sockunion *dst,
+         struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) ifc;
+    (void) dst;
+    bench_sink += (uint32_t) buf->datalen;
+}
+
+// a relay that sends everything to one upstream face, through bench_TX
+static struct ccnl_face_s*
+bench_relay(struct ccnl_relay_s *relay)
+{
+    struct ccnl_face_s *f;
+    sockunion su;
+
+    memset(relay, 0, sizeof(*relay));
+    relay->ccnl_ll_TX_ptr = bench_TX;
+    relay->max_cache_entries = -1;
+    relay->max_pit_entries = -1;
+    relay->ifcount = 1;
+    relay->ifs[0].addr.sa.sa_family = AF_INET;
+    relay->ifs[0].sock = -1;
+    ccnl_core_init();
+
+    memset(&su, 0, sizeof(su));
+    su.ip4.sin_family = AF_INET;
+    su.ip4.sin_port = htons(NDN_UDP_PORT);
+    su.ip4.sin_addr.s_addr = htonl(0xc0000201);
+    f = ccnl_get_face_or_create(relay, 0, &su.sa, sizeof(su.ip4));
+    f->flags |= CCNL_FACE_FLAGS_STATIC;
+    return f;
+}
+
+// Interests through ccnl_core_RX, answered from a content store of \p size
+// objects next to a FIB of \p size routes: suite dispatch, nonce check and
+// CS walk. Compare the numbers of a default build with a
+// -DCCNL_SINGLE_SUITE=NDN one. The same Interests once more in vectors of
+// CCNL_RX_BATCH frames through ccnl_core_RXbatch(), which walks the content
+// store once per vector. The tables are linked directly, inserting checks
+// for duplicates and would be quadratic.
+static void
+bench_fwd_interest(long ops, long size)
+{
+    static struct ccnl_relay_s relay;
+    struct ccnl_buf_s *in[BENCH_INTERESTS];
+    struct ccnl_rx_s rx[CCNL_RX_BATCH];
+    struct ccnl_face_s *up;
+    ccnl_interest_opts_u opts;
+    uint8_t payload[64];
+    struct bench_clock_s t;
+    char uri[64], name[40];
+    long k;
+    int i, n;
+
+    up = bench_relay(&relay);
+    memset(payload, 'p', sizeof(payload));
+    for (k = 0; k < size; k++) {
+        struct ccnl_prefix_s *p = bench_name((int) k);
+        struct ccnl_content_s *c;
+        struct ccnl_forward_s *fwd = ccnl_calloc(1, sizeof(*fwd));
+
+        c = ccnl_mkContentObject(p, payload, sizeof(payload), NULL);
+        DBL_LINKED_LIST_ADD(relay.contents, c);
+        relay.contentcnt++;
+        ccnl_prefix_free(p);
+
+        snprintf(uri, sizeof(uri), "/bench/fib/%ld", k);
+        fwd->prefix = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+        fwd->suite = CCNL_SUITE_NDNTLV;
+        fwd->face = up;
+        fwd->next = relay.fib;
+        relay.fib = fwd;
+    }
+    relay.csgen++;
+    // spread over the whole content store
+    for (i = 0; i < BENCH_INTERESTS; i++) {
+        struct ccnl_prefix_s *p;
+
+        p = bench_name((int) (size > BENCH_INTERESTS ?
+                              i * (size / BENCH_INTERESTS) : i % size));
+        memset(&opts, 0, sizeof(opts));
+        opts.ndntlv.nonce = (uint32_t) i + 1;
+        in[i] = ccnl_mkSimpleInterest(p, &opts);
+        ccnl_prefix_free(p);
+    }
+
+    snprintf(name, sizeof(name), "fwd_interest_cs_hit/%ld", size);
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        struct ccnl_buf_s *b = in[k % BENCH_INTERESTS];
+        ccnl_core_RX(&relay, -1, b->data, b->datalen, NULL, 0);
+    }
+    bench_report(name, BENCH_FWD_VARIANT, &t, ops);
+
+    snprintf(name, sizeof(name), "fwd_interest_cs_hit_batch/%ld", size);
+    memset(rx, 0, sizeof(rx));
+    bench_start(&t);
+    for (k = 0; k < ops; k += n) {
+        for (n = 0; n < CCNL_RX_BATCH && k + n < ops; n++) {
+            struct ccnl_buf_s *b = in[(k + n) % BENCH_INTERESTS];
+            rx[n].ifndx = -1;
+            rx[n].data = b->data;
+            rx[n].datalen = b->datalen;
+        }
+        ccnl_core_RXbatch(&relay, rx, (size_t) n);
+    }
+    bench_report(name, BENCH_FWD_VARIANT, &t, ops);
+
+    for (i = 0; i < BENCH_INTERESTS; i++) {
+        ccnl_free(in[i]);
+    }
+    ccnl_core_cleanup(&relay);
+}
+
+static void
+bench_uri2prefix(long ops)
+{
+    char uri[256];
+    struct bench_clock_s t;
+    long k;
+
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        struct ccnl_prefix_s *p;
+
+        // the URI is split in place
+        strcpy(uri, bench_uris[k % (sizeof(bench_uris) / sizeof(*bench_uris))]);
+        p = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+        bench_sink += p->compcnt;
+        ccnl_prefix_free(p);
+    }
+    bench_report("uri2prefix", "ndntlv", &t, ops);
+}
+
+// Interest and 1 KiB Data: encoding, and parsing into a ccnl_pkt_s
+static void
+bench_codec(long ops, int suite)
+{
+    struct ccnl_prefix_s *p;
+    struct ccnl_buf_s *b[2];
+    ccnl_interest_opts_u opts;
+    uint8_t payload[1024];
+    const char *variant[2] = { "interest", "data" };
+    struct bench_clock_s t;
+    char uri[] = "/ndn/edu/unibas/cs/video/2018/talk.mp4", name[32];
+    size_t off;
+    long k;
+    int j;
+
+    memset(payload, 'p', sizeof(payload));
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = 1;
+    p = ccnl_URItoPrefix(uri, suite, NULL);
+
+    snprintf(name, sizeof(name), "mk/%s", ccnl_suite2str(suite));
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        b[0] = ccnl_mkSimpleInterest(p, &opts);
+        ccnl_free(b[0]);
+    }
+    bench_report(name, variant[0], &t, ops);
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        b[1] = ccnl_mkSimpleContent(p, payload, sizeof(payload), &off, NULL);
+        ccnl_free(b[1]);
+    }
+    bench_report(name, variant[1], &t, ops);
+
+    b[0] = ccnl_mkSimpleInterest(p, &opts);
+    b[1] = ccnl_mkSimpleContent(p, payload, sizeof(payload), &off, NULL);
+    for (j = 0; j < 2; j++) {
+        snprintf(name, sizeof(name), "bytes2pkt/%s", ccnl_suite2str(suite));
+        bench_start(&t);
+        for (k = 0; k < ops; k++) {
+            struct ccnl_pkt_s *pkt = NULL;
+            uint8_t *start = b[j]->data, *data = start;
+            size_t len = b[j]->datalen;
+
+            switch (suite) {
+#ifdef USE_SUITE_CCNTLV
+            case CCNL_SUITE_CCNTLV: {
+                size_t hdrlen;
+
+                if (!ccnl_ccntlv_getHdrLen(data, len, &hdrlen)) {
+                    data += hdrlen;
+                    len -= hdrlen;
+                    pkt = ccnl_ccntlv_bytes2pkt(start, &data, &len);
+                }
+                break;
+            }
+#endif
+            case CCNL_SUITE_NDNTLV: {
+                uint64_t typ;
+                size_t vallen;
+
+                if (!ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+                    pkt = ccnl_ndntlv_bytes2pkt(typ, start, &data, &len);
+                }
+                break;
+            }
+            default:
+                break;
+            }
+            bench_sink += pkt != NULL;
+            ccnl_pkt_free(pkt);
+        }
+        bench_report(name, variant[j], &t, ops);
+    }
+
+    ccnl_free(b[0]);
+    ccnl_free(b[1]);
+    ccnl_prefix_free(p);
+}
+
+// a full cache of BENCH_NAMES objects, every insert evicts the oldest
+static void
+bench_add2cache(long ops)
+{
+    static struct ccnl_relay_s relay;
+    struct ccnl_content_s *c;
+    struct bench_clock_s t;
+    uint8_t payload[64];
+    char uri[64];
+    long k;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(payload, 'p', sizeof(payload));
+    relay.max_cache_entries = BENCH_NAMES;
+    ccnl_core_init();
+
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        struct ccnl_prefix_s *p;
+
+        bench_pause(&t);
+        snprintf(uri, sizeof(uri), "/bench/cache/%ld", k);
+        p = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+        c = ccnl_mkContentObject(p, payload, sizeof(payload), NULL);
+        ccnl_prefix_free(p);
+        c->last_used = (uint32_t) k + 1; // oldest first, as in real time
+        bench_resume(&t);
+
+        if (!ccnl_content_add2cache(&relay, c)) {
+            ccnl_content_free(c);
+        }
+    }
+    bench_report("content_add2cache", "evict", &t, ops);
+    ccnl_core_cleanup(&relay);
+}
+
+// parses one Interest, the nonce is new for every call
+static struct ccnl_pkt_s*
+bench_interest(struct ccnl_prefix_s *p)
+{
+    static uint32_t nonce;
+    ccnl_interest_opts_u opts;
+    struct ccnl_buf_s *b;
+    struct ccnl_pkt_s *pkt = NULL;
+    uint8_t *data;
+    size_t len, vallen;
+    uint64_t typ;
+
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = ++nonce;
+    b = ccnl_mkSimpleInterest(p, &opts);
+    data = b->data;
+    len = b->datalen;
+    if (!ccnl_ndntlv_dehead(&data, &len, &typ, &vallen)) {
+        pkt = ccnl_ndntlv_bytes2pkt(typ, b->data, &data, &len);
+    }
+    ccnl_free(b);
+    return pkt;
+}
+
+// a PIT filled with BENCH_PIT Interests from a local face, then the same
+// names once more with new nonces, which are aggregated
+static void
+bench_pit(long ops)
+{
+    static struct ccnl_relay_s relay;
+    struct ccnl_prefix_s *names[BENCH_PIT];
+    struct ccnl_face_s *from, *up;
+    struct bench_clock_s t[2];
+    char root[] = "/";
+    long k, n = 0;
+    int i, j;
+
+    up = bench_relay(&relay);
+    ccnl_fib_add_entry(&relay, ccnl_URItoPrefix(root, CCNL_SUITE_NDNTLV, NULL),
+                       up);
+    from = ccnl_get_face_or_create(&relay, -1, NULL, 0);
+    for (i = 0; i < BENCH_PIT; i++) {
+        names[i] = bench_name(BENCH_NAMES + i);
+    }
+
+    bench_start(&t[0]);
+    bench_start(&t[1]);
+    bench_pause(&t[0]);
+    bench_pause(&t[1]);
+    for (k = 0; k < ops; k += BENCH_PIT) {
+        for (j = 0; j < 2; j++) {
+            for (i = 0; i < BENCH_PIT; i++) {
+                struct ccnl_pkt_s *pkt = bench_interest(names[i]);
+
+                bench_resume(&t[j]);
+                ccnl_fwd_handleInterest(&relay, from, &pkt, ccnl_ndntlv_cMatch);
+                bench_pause(&t[j]);
+                ccnl_pkt_free(pkt);
+            }
+        }
+        while (relay.pit) {
+            ccnl_interest_remove(&relay, relay.pit);
+        }
+        n += BENCH_PIT;
+    }
+    bench_resume(&t[0]);
+    bench_report("fwd_interest_pit", "insert", &t[0], n);
+    bench_resume(&t[1]);
+    bench_report("fwd_interest_pit", "aggregate", &t[1], n);
+
+    for (i = 0; i < BENCH_PIT; i++) {
+        ccnl_prefix_free(names[i]);
+    }
+    ccnl_core_cleanup(&relay);
+}
+
+// one Interest forwarded against a FIB of \p size routes; the FIB is
+// linked directly, ccnl_fib_add_entry() scans it on every insert
+static void
+bench_propagate(long ops, long size)
+{
+    static struct ccnl_relay_s relay;
+    struct ccnl_interest_s *i;
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_face_s *up;
+    struct ccnl_prefix_s *p;
+    struct bench_clock_s t;
+    char uri[64], name[32];
+    long k;
+
+    up = bench_relay(&relay);
+    for (k = 0; k < size; k++) {
+        struct ccnl_forward_s *fwd = ccnl_calloc(1, sizeof(*fwd));
+
+        snprintf(uri, sizeof(uri), "/bench/fib/%ld", k);
+        fwd->prefix = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+        fwd->suite = CCNL_SUITE_NDNTLV;
+        fwd->face = up;
+        fwd->next = relay.fib;
+        relay.fib = fwd;
+    }
+    snprintf(uri, sizeof(uri), "/bench/fib/%ld/video/seg", size / 2);
+    p = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    pkt = bench_interest(p);
+    i = ccnl_interest_new(&relay, NULL, &pkt);
+
+    snprintf(name, sizeof(name), "interest_propagate/%ld", size);
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        ccnl_interest_propagate(&relay, i);
+    }
+    bench_report(name, "linear", &t, ops);
+
+    ccnl_prefix_free(p);
+    ccnl_core_cleanup(&relay);
+}
+
+// a digest over 4 KiB, as for the implicit digest of a segment
+static void
+bench_sha256(long ops)
+{
+    static uint8_t seg[4096];
+    uint8_t md[32];
+    SHA256_CTX_t ctx;
+    struct bench_clock_s t;
+    long k;
+
+    memset(seg, 's', sizeof(seg));
+    bench_start(&t);
+    for (k = 0; k < ops; k++) {
+        ccnl_SHA256_Init(&ctx);
+        ccnl_SHA256_Update(&ctx, seg, sizeof(seg));
+        ccnl_SHA256_Final(md, &ctx);
+        bench_sink += md[0];
+    }
+    bench_report("sha256/4096", ccnl_SHA256_name(), &t, ops);
+}
+
+int
+main(int argc, char *argv[])
+{
+    long ops = 1000000, fibmax = BENCH_FIB_MAX, size;
+    int opt, level, best = ccnl_simd_setLevel(-1);
+
+    while ((opt = getopt(argc, argv, "f:hj")) != -1) {
+        switch (opt) {
+        case 'f':
+            fibmax = atol(optarg);
+            break;
+        case 'j':
+            bench_json = 1;
+            break;
+        case 'h':
+        default:
+            goto Usage;
+        }
+    }
+    if (optind < argc) {
+        ops = atol(argv[optind]);
+    }
+    if (ops <= 0 || optind < argc - 1) {
+Usage:
+        fprintf(stderr, "usage: %s [-j] [-f MAX_FIB_SIZE] [iterations]\n"
+                "  -j  results as JSON\n", argv[0]);
+        return 1;
+    }
+    if (bench_json) {
+        printf("{\"iterations\": %ld, \"results\": [", ops);
+    }
+
+    bench_ndntlv_name(ops);
+    bench_uri2prefix(ops / 100);
+    bench_codec(ops / 100, CCNL_SUITE_NDNTLV);
+#ifdef USE_SUITE_CCNTLV
+    bench_codec(ops / 100, CCNL_SUITE_CCNTLV);
+#endif
+    bench_fwd_interest(ops / 10, BENCH_NAMES);
+    bench_pit(ops / 100);
+    bench_add2cache(ops / 100);
+    bench_ndntlv_encode(ops / 10);
+    bench_sha256(ops / 100);
+    for (level = CCNL_SHA256_SCALAR; level <= ccnl_SHA256_setLevel(-1); level++) {
+        ccnl_SHA256_setLevel(level);
+        bench_hmac256(ops / 100);
+    }
+    ccnl_SHA256_setLevel(-1);
+    for (level = CCNL_SIMD_SCALAR; level <= best; level++) {
+        ccnl_simd_setLevel(level);
+        bench_prefix_cmp(ops);
+        bench_memeq(ops, 8);
+        bench_memeq(ops, 32);
+        bench_memeq(ops, 256);
+        bench_crc32c(ops, 12);
+        bench_crc32c(ops, 256);
+    }
+    // last, the large tables are kept by the debug allocator
+    for (size = 10000; size <= fibmax && size <= BENCH_CS_MAX; size *= 10) {
+        bench_fwd_interest(ops / size > 4 * CCNL_RX_BATCH ?
+                           ops / size : 4 * CCNL_RX_BATCH, size);
+    }
+    for (size = 10; size <= fibmax; size *= 10) {
+        bench_propagate(ops / 10 / size > 10 ? ops / 10 / size : 10, size);
+    }
+
+    if (bench_json) {
+        printf("\n]}\n");
+    }
+    return 0;
+}
@@ -0,0 +1,87 @@
+/**
+ * @file ccnl-test-relay.h
+ * @brief A relay and NDN packets shared by the unit tests
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#ifndef CCNL_TEST_RELAY_H
+#define CCNL_TEST_RELAY_H
+
+// include after cmocka.h, the helpers assert
+
+#include <string.h>
+#include <arpa/inet.h>
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-dispatch.h"
+
+/**
+ * @brief Sets up an empty relay with unbounded tables and one IPv4 interface
+ *
+ * @param[out] relay The relay to set up
+ */
+static inline void
+relay_setup(struct ccnl_relay_s *relay)
+{
+    memset(relay, 0, sizeof(*relay));
+    relay->max_cache_entries = -1;
+    relay->max_pit_entries = -1;
+    relay->ifcount = 1;
+    relay->ifs[0].addr.sa.sa_family = AF_INET;
+    ccnl_core_init();
+}
+
+/**
+ * @brief Encodes an NDN Data packet with Name /<name> and Content "hi"
+ *
+ * @param[in] name The only name component, one character
+ * @param[out] len The length of the packet
+ *
+ * @return The packet, valid until the next call
+ */
+static inline uint8_t*
+mkdata(char name, size_t *len)
+{
+    static uint8_t pkt[] = { 0x06, 0x09, 0x07, 0x03, 0x08, 0x01, 0,
+                             0x15, 0x02, 'h', 'i' };
+
+    pkt[6] = (uint8_t) name;
+    *len = sizeof(pkt);
+    return pkt;
+}
+
+/**
+ * @brief Creates a content object from the packet of @ref mkdata
+ *
+ * @param[in] name The only name component, one character
+ *
+ * @return The content object, not yet in the cache
+ */
+static inline struct ccnl_content_s*
+mkcontent(char name)
+{
+    size_t datalen;
+    uint8_t *start = mkdata(name, &datalen), *data = start + 2;
+    struct ccnl_pkt_s *pkt;
+
+    datalen -= 2;
+    pkt = ccnl_ndntlv_bytes2pkt(NDN_TLV_Data, start, &data, &datalen);
+    assert_non_null(pkt);
+    return ccnl_content_new(&pkt);
+}
+
+#endif // CCNL_TEST_RELAY_H
@@ -0,0 +1,175 @@
+/**
+ * @file test_archive.c
+ * @brief Tests for the content archives
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#define USE_SUITE_NDNTLV
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-archive.h"
+
+// an NDN Interest or Data for the name given as one letter per component
+static struct ccnl_pkt_s*
+mkpkt(uint8_t type, const char *name, uint8_t tag)
+{
+    uint8_t buf[64], *data;
+    size_t i, n = strlen(name), len = 0, datalen;
+    uint64_t typ;
+
+    buf[len++] = type;
+    buf[len++] = (uint8_t) (2 + 3 * n + 3);
+    buf[len++] = 0x07;
+    buf[len++] = (uint8_t) (3 * n);
+    for (i = 0; i < n; i++) {
+        buf[len++] = 0x08;
+        buf[len++] = 1;
+        buf[len++] = (uint8_t) name[i];
+    }
+    buf[len++] = type == 0x05 ? 0x0a : 0x15; // Nonce or Content
+    buf[len++] = 1;
+    buf[len++] = tag;
+
+    data = buf;
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &datalen), 0);
+    return ccnl_ndntlv_bytes2pkt(typ, buf, &data, &datalen);
+}
+
+static struct ccnl_archive_s*
+mkarchive(char *path)
+{
+    const char *names[] = { "c", "ab", "a", "ab" };
+    struct ccnl_archive_item_s items[4];
+    struct ccnl_pkt_s *pkts[4];
+    struct ccnl_archive_s *a;
+    int i, fd;
+
+    fd = mkstemp(path);
+    assert_true(fd >= 0);
+    close(fd);
+    for (i = 0; i < 4; i++) {
+        pkts[i] = mkpkt(0x06, names[i], (uint8_t) i);
+        assert_non_null(pkts[i]);
+        items[i].suite = CCNL_SUITE_NDNTLV;
+        items[i].pfx = pkts[i]->pfx;
+        items[i].data = pkts[i]->buf->data;
+        items[i].len = pkts[i]->buf->datalen;
+    }
+    // the second /a/b is dropped
+    assert_int_equal(ccnl_archive_write(path, items, 4), 3);
+    for (i = 3; i >= 0; i--) {
+        ccnl_pkt_free(pkts[i]);
+    }
+    a = ccnl_archive_open(path);
+    assert_non_null(a);
+    assert_int_equal(ccnl_archive_count(a), 3);
+    return a;
+}
+
+// the content tag of the packet found for an Interest, -1 for none
+static int
+lookup(struct ccnl_archive_s *a, const char *name, uint64_t maxsuffix)
+{
+    struct ccnl_pkt_s *i = mkpkt(0x05, name, 1);
+    uint8_t *data;
+    size_t len;
+    int rc = -1;
+
+    assert_non_null(i);
+    if (maxsuffix) {
+        i->s.ndntlv.maxsuffix = maxsuffix;
+    }
+    if (!ccnl_archive_lookup(a, i, &data, &len)) {
+        rc = data[len - 1];
+    }
+    ccnl_pkt_free(i);
+    return rc;
+}
+
+void test_archive_lookup()
+{
+    char path[] = "/tmp/test_archiveXXXXXX";
+    struct ccnl_archive_s *a = mkarchive(path);
+
+    assert_int_equal(lookup(a, "ab", 0), 1);  // exact
+    assert_int_equal(lookup(a, "c", 0), 0);
+    assert_int_equal(lookup(a, "a", 0), 2);   // /a itself comes first
+    assert_int_equal(lookup(a, "a", 1), 2);
+    assert_int_equal(lookup(a, "b", 0), -1);
+    assert_int_equal(lookup(a, "abc", 0), -1);
+
+    ccnl_archive_close(a);
+    unlink(path);
+}
+
+void test_archive_prefix()
+{
+    char path[] = "/tmp/test_archiveXXXXXX";
+    struct ccnl_archive_s *a;
+    struct ccnl_pkt_s *i;
+    uint8_t *data;
+    size_t len;
+
+    a = mkarchive(path);
+    i = mkpkt(0x05, "a", 1);
+    assert_non_null(i);
+    // at least one more component: /a/b
+    i->s.ndntlv.minsuffix = 2;
+    assert_int_equal(ccnl_archive_lookup(a, i, &data, &len), 0);
+    assert_int_equal(data[len - 1], 1);
+    // no name under /a has three more components
+    i->s.ndntlv.minsuffix = 4;
+    assert_int_equal(ccnl_archive_lookup(a, i, &data, &len), -1);
+    ccnl_pkt_free(i);
+
+    ccnl_archive_close(a);
+    unlink(path);
+}
+
+void test_archive_open_invalid()
+{
+    char path[] = "/tmp/test_archiveXXXXXX";
+    uint8_t junk[128];
+    int fd = mkstemp(path);
+
+    assert_true(fd >= 0);
+    memset(junk, 'x', sizeof(junk));
+    assert_int_equal(write(fd, junk, sizeof(junk)), sizeof(junk));
+    close(fd);
+    assert_null(ccnl_archive_open(path));
+    assert_null(ccnl_archive_open("/nonexistent/archive"));
+    unlink(path);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_archive_lookup),
+        unit_test(test_archive_prefix),
+        unit_test(test_archive_open_invalid),
+    };
+
+    return run_tests(tests);
+}
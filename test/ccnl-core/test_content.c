@@ -24,6 +24,9 @@
 #include "ccnl-pkt.h"
 #include "ccnl-malloc.h"
 #include "ccnl-content.h"
+#include "ccnl-prefix.h"
+#include "ccnl-pkt-ndntlv.h"
+#include <string.h>
 
 void test_ccnl_content_new_invalid()
 {
@@ -31,6 +34,70 @@ void test_ccnl_content_new_invalid()
     assert_null(content);
 }
 
+void test_ccnl_content_new_from_view()
+{
+    // Data: Name /a, Content "hi"
+    uint8_t rx[] = { 0x06, 0x09, 0x07, 0x03, 0x08, 0x01, 'a',
+                     0x15, 0x02, 'h', 'i' };
+    uint8_t *data = rx + 2;
+    size_t datalen = sizeof(rx) - 2;
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c;
+
+    pkt = ccnl_ndntlv_bytes2pktView(0x06, rx, &data, &datalen);
+    assert_non_null(pkt);
+    assert_null(pkt->buf);
+    assert_true(pkt->content == rx + 9);
+    assert_true(pkt->pfx->comp[0] == rx + 6);
+
+    c = ccnl_content_new(&pkt);
+    assert_non_null(c);
+    assert_null(pkt);
+    // the content store entry must not refer to the receive buffer
+    memset(rx, 0, sizeof(rx));
+    assert_non_null(c->pkt->buf);
+    assert_int_equal(c->pkt->buf->datalen, sizeof(rx));
+    assert_true(c->pkt->content == c->pkt->buf->data + 9);
+    assert_memory_equal(c->pkt->content, "hi", 2);
+    assert_memory_equal(c->pkt->pfx->comp[0], "a", 1);
+
+    ccnl_content_free(c);
+}
+
+void test_ccnl_content_digest()
+{
+    // Data: Name /a, Content "hi"
+    uint8_t rx[] = { 0x06, 0x09, 0x07, 0x03, 0x08, 0x01, 'a',
+                     0x15, 0x02, 'h', 'i' };
+    uint8_t *data = rx + 2, *md;
+    size_t datalen = sizeof(rx) - 2;
+    struct ccnl_pkt_s *pkt;
+    struct ccnl_content_s *c;
+    struct ccnl_prefix_s *full;
+
+    pkt = ccnl_ndntlv_bytes2pktView(0x06, rx, &data, &datalen);
+    c = ccnl_content_new(&pkt);
+    assert_non_null(c);
+    assert_false(c->has_digest);
+
+    md = ccnl_content_digest(c);
+    assert_non_null(md);
+    assert_true(c->has_digest);
+    assert_true(ccnl_content_digest(c) == md);
+
+    full = ccnl_prefix_dup(c->pkt->pfx);
+    assert_int_equal(ccnl_prefix_appendCmp(full, md, CCNL_CONTENT_DIGEST_LEN), 0);
+    assert_int_equal(ccnl_content_matchFullName(c, full), 1);
+    assert_int_equal(ccnl_content_matchFullName(c, c->pkt->pfx), 0);
+
+    // later lookups use the cached value and do not hash again
+    c->digest[0] ^= 0xff;
+    assert_int_equal(ccnl_content_matchFullName(c, full), 0);
+
+    ccnl_prefix_free(full);
+    ccnl_content_free(c);
+}
+
 void test_ccnl_content_free_invalid() 
 {
     int result = ccnl_content_free(NULL); 
@@ -72,6 +139,8 @@ int main(void)
     const UnitTest tests[] = {
         unit_test(test_ccnl_content_new_invalid),
         unit_test(test_ccnl_content_new_valid),
+        unit_test(test_ccnl_content_new_from_view),
+        unit_test(test_ccnl_content_digest),
         unit_test(test_ccnl_content_free_invalid),
         unit_test(test_ccnl_content_free_valid),
     };
@@ -0,0 +1,153 @@
+/**
+ * @file test_dispatch.c
+ * @brief Tests for the batched receive path
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <string.h>
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-test-relay.h"
+
+#define FRAMES  6
+
+static uint8_t frames[FRAMES][16];
+
+// Interest: Name /<name>, Nonce <nonce> (4 bytes)
+static void
+mkinterest(struct ccnl_rx_s *rx, int i, char name, uint8_t nonce)
+{
+    uint8_t pkt[] = { 0x05, 0x0b, 0x07, 0x03, 0x08, 0x01, (uint8_t) name,
+                      0x0a, 0x04, nonce, 0, 0, 1 };
+
+    memcpy(frames[i], pkt, sizeof(pkt));
+    memset(rx + i, 0, sizeof(*rx));
+    rx[i].ifndx = -1;
+    rx[i].data = frames[i];
+    rx[i].datalen = sizeof(pkt);
+}
+
+static void
+setup(struct ccnl_relay_s *relay)
+{
+    relay_setup(relay);
+    assert_non_null(ccnl_content_add2cache(relay, mkcontent('a')));
+    assert_non_null(ccnl_content_add2cache(relay, mkcontent('b')));
+}
+
+void test_cs_lookup_batch()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_rx_s rx[3];
+    struct ccnl_pkt_s *pkts[4];
+    struct ccnl_cs_hint_s hints[4];
+    uint8_t *data;
+    size_t len, datalen;
+    uint64_t typ;
+    int i;
+
+    setup(&relay);
+    mkinterest(rx, 0, 'b', 1);
+    mkinterest(rx, 1, 'x', 2);
+    mkinterest(rx, 2, 'a', 3);
+    for (i = 0; i < 3; i++) {
+        data = rx[i].data;
+        len = rx[i].datalen;
+        assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &datalen), 0);
+        pkts[i] = ccnl_ndntlv_bytes2pkt(typ, rx[i].data, &data, &datalen);
+        assert_non_null(pkts[i]);
+    }
+    pkts[3] = NULL;
+
+    ccnl_fwd_csLookupBatch(&relay, 4, pkts, ccnl_ndntlv_cMatch, hints);
+    assert_non_null(hints[0].c);
+    assert_int_equal(hints[0].c->pkt->pfx->comp[0][0], 'b');
+    assert_null(hints[1].c);
+    assert_non_null(hints[2].c);
+    assert_int_equal(hints[2].c->pkt->pfx->comp[0][0], 'a');
+    assert_null(hints[3].c);
+    assert_int_equal(hints[0].csgen, relay.csgen);
+
+    for (i = 0; i < 3; i++) {
+        ccnl_pkt_free(pkts[i]);
+    }
+    ccnl_core_cleanup(&relay);
+}
+
+// processes the frames one by one, or as a batch
+static void
+run(struct ccnl_relay_s *relay, int batched)
+{
+    struct ccnl_rx_s rx[FRAMES];
+    uint8_t *data;
+    size_t len;
+    int i;
+
+    setup(relay);
+    mkinterest(rx, 0, 'a', 1);       // CS hit
+    mkinterest(rx, 1, 'x', 2);       // miss, goes to the PIT
+    data = mkdata('x', &len);
+    memcpy(frames[2], data, len);
+    memset(rx + 2, 0, sizeof(rx[2]));
+    rx[2].ifndx = -1;                // satisfies the PIT entry, is cached
+    rx[2].data = frames[2];
+    rx[2].datalen = len;
+    mkinterest(rx, 3, 'x', 3);       // its hint is stale: now a CS hit
+    mkinterest(rx, 4, 'b', 4);       // CS hit
+    mkinterest(rx, 5, 'a', 1);       // duplicate nonce
+
+    if (batched) {
+        ccnl_core_RXbatch(relay, rx, FRAMES);
+    } else {
+        for (i = 0; i < FRAMES; i++) {
+            ccnl_core_RX(relay, -1, rx[i].data, rx[i].datalen, NULL, 0);
+        }
+    }
+}
+
+void test_rx_batch_same_as_single()
+{
+    struct ccnl_relay_s single, batch;
+
+    run(&single, 0);
+    run(&batch, 1);
+
+    assert_int_equal(single.pitcnt, 0);
+    assert_int_equal(single.contentcnt, 3);
+    assert_int_equal(batch.pitcnt, single.pitcnt);
+    assert_int_equal(batch.contentcnt, single.contentcnt);
+    assert_non_null(batch.faces);
+    assert_null(batch.faces->next);
+
+    ccnl_core_cleanup(&single);
+    ccnl_core_cleanup(&batch);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_cs_lookup_batch),
+        unit_test(test_rx_batch_same_as_single),
+    };
+
+    return run_tests(tests);
+}
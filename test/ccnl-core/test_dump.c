@@ -0,0 +1,144 @@
+/**
+ * @file test_dump.c
+ * @brief Tests for dumping the relay's tables page by page
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#define USE_SUITE_NDNTLV
+#define NEEDS_PREFIX_MATCHING   // ccnl_fib_add_routes()
+
+#include "ccnl-core.h"
+#include "ccnl-relay.h"
+#include "ccnl-dump.h"
+#include "ccnl-test-relay.h"
+
+static void
+setup(struct ccnl_relay_s *relay)
+{
+    char routes[] = "/a/1 127.0.0.1/9001\n"
+                    "/a/2 127.0.0.1/9002\n"
+                    "/b/1 127.0.0.1/9001\n"
+                    "/b/2 127.0.0.1/9002\n"
+                    "/a/3 127.0.0.1/9001\n";
+    int lineno = 0;
+
+    relay_setup(relay);
+    assert_int_equal(ccnl_fib_add_routes(relay, CCNL_SUITE_NDNTLV, routes,
+                                         &lineno), 5);
+}
+
+// lists the rest of a dump, returns the number of entries
+static int
+drain(struct ccnl_dump_s *d)
+{
+    int budget = CCNL_DUMP_SCAN, cnt = 0;
+
+    while (ccnl_dump_peek(d, &budget)) {
+        ccnl_dump_consume(d);
+        cnt++;
+    }
+    assert_null(d->entry);
+    return cnt;
+}
+
+void test_dump_filters()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_dump_s *d;
+    char uri[] = "/a";
+    int budget = 1;
+
+    setup(&relay);
+    d = ccnl_dump_open(&relay, CCNL_DUMP_FIB, NULL, -1);
+    assert_non_null(d);
+    assert_int_equal(drain(d), 5);
+    assert_int_equal(d->pos, 5);
+
+    d = ccnl_dump_open(&relay, CCNL_DUMP_FIB,
+                       ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL), -1);
+    assert_int_equal(drain(d), 3);
+
+    d = ccnl_dump_open(&relay, CCNL_DUMP_FIB, NULL, relay.fib->face->faceid);
+    assert_int_equal(drain(d), 3);  // /a/1, /b/1 and /a/3 share a face
+
+    d = ccnl_dump_open(&relay, CCNL_DUMP_FACES, NULL, -1);
+    assert_int_equal(drain(d), 2);
+
+    // a filter that passes nothing runs out of budget before the table
+    d = ccnl_dump_open(&relay, CCNL_DUMP_FIB, NULL, 12345);
+    assert_null(ccnl_dump_peek(d, &budget));
+    assert_non_null(d->entry);
+    assert_int_equal(drain(d), 0);
+
+    assert_null(ccnl_dump_open(&relay, 42, NULL, -1));
+    assert_int_equal(ccnl_dump_str2table("pit"), CCNL_DUMP_PIT);
+    assert_int_equal(ccnl_dump_str2table("routes"), -1);
+
+    ccnl_core_cleanup(&relay);
+}
+
+void test_dump_removal()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_dump_s *d;
+    struct ccnl_forward_s *fwd;
+    struct ccnl_face_s *gone;
+    int budget = CCNL_DUMP_SCAN, left = 0;
+    uint32_t id;
+
+    setup(&relay);
+    d = ccnl_dump_open(&relay, CCNL_DUMP_FIB, NULL, -1);
+    id = d->id;
+    assert_true(ccnl_dump_find(&relay, id) == d);
+    assert_true(ccnl_dump_peek(d, &budget) == relay.fib);
+    ccnl_dump_consume(d);
+
+    // the face of the next entry goes away, with its FIB entries
+    gone = ((struct ccnl_forward_s*) d->entry)->face;
+    ccnl_face_remove(&relay, gone);
+    for (fwd = relay.fib; fwd; fwd = fwd->next) {
+        assert_true(fwd->face != gone);
+        left++;
+    }
+    // the first entry of the dump was of the other face, still listed
+    assert_int_equal(drain(d), left - 1);
+
+    ccnl_dump_close(&relay, d);
+    assert_null(ccnl_dump_find(&relay, id));
+
+    // cursors left open are closed with the relay
+    ccnl_dump_open(&relay, CCNL_DUMP_FACES, NULL, -1);
+    ccnl_core_cleanup(&relay);
+    assert_null(relay.dumps);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_dump_filters),
+        unit_test(test_dump_removal),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,81 @@
+/**
+ * @file test_fetch.c
+ * @brief Tests for the reply parsing of ccn-lite-fetch
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+// first, it sets the feature macros for the system headers
+#include "ccnl-common.h"
+
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+// ccn-lite-fetch.c, built into this test with its main() renamed
+int ccnl_extractDataAndChunkInfo(uint8_t **data, size_t *datalen,
+                                 int suite, struct ccnl_prefix_s **prefix,
+                                 int64_t *lastchunknum,
+                                 uint8_t **content, size_t *contentlen);
+
+void test_fetch_extract_ccntlv()
+{
+    uint8_t buf[256], payload[] = "chunk", *data, *content;
+    char uri[] = "/f/c";
+    uint32_t chunk = 1, last = 3;
+    struct ccnl_prefix_s *name = ccnl_URItoPrefix(uri, CCNL_SUITE_CCNTLV, &chunk);
+    struct ccnl_prefix_s *pfx = NULL;
+    size_t offs = sizeof(buf), len, contentlen;
+    int64_t lastchunknum;
+
+    assert_int_equal(ccnl_ccntlv_prependContentWithHdr(name, payload,
+                                        sizeof(payload) - 1, &last, NULL,
+                                        &offs, buf, &len), 0);
+
+    // Data is taken, and its content is still there once the packet is gone
+    data = buf + offs;
+    assert_int_equal(ccnl_extractDataAndChunkInfo(&data, &len,
+                                        CCNL_SUITE_CCNTLV, &pfx,
+                                        &lastchunknum, &content,
+                                        &contentlen), 0);
+    assert_non_null(pfx);
+    assert_non_null(pfx->chunknum);
+    assert_int_equal(*pfx->chunknum, chunk);
+    assert_int_equal(lastchunknum, last);
+    assert_int_equal(contentlen, sizeof(payload) - 1);
+    assert_memory_equal(content, payload, contentlen);
+    ccnl_prefix_free(pfx);
+
+    // an Interest is not a reply
+    offs = sizeof(buf);
+    assert_int_equal(ccnl_ccntlv_prependChunkInterestWithHdr(name, &offs,
+                                                             buf, &len), 0);
+    data = buf + offs;
+    assert_int_equal(ccnl_extractDataAndChunkInfo(&data, &len,
+                                        CCNL_SUITE_CCNTLV, &pfx,
+                                        &lastchunknum, &content,
+                                        &contentlen), -1);
+    ccnl_prefix_free(name);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_fetch_extract_ccntlv),
+    };
+
+    return run_tests(tests);
+}
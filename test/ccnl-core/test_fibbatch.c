@@ -0,0 +1,128 @@
+/**
+ * @file test_fibbatch.c
+ * @brief Tests for adding route files to the FIB in one batch
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <arpa/inet.h>
+
+#define USE_SUITE_NDNTLV
+#define NEEDS_PREFIX_MATCHING   // ccnl_fib_add_routes()
+
+#include "ccnl-core.h"
+#include "ccnl-relay.h"
+#include "ccnl-test-relay.h"
+
+static int
+fibcount(struct ccnl_relay_s *relay)
+{
+    struct ccnl_forward_s *fwd;
+    int cnt = 0;
+
+    for (fwd = relay->fib; fwd; fwd = fwd->next)
+        cnt++;
+    return cnt;
+}
+
+void test_fibbatch_add()
+{
+    struct ccnl_relay_s relay;
+    char routes[] = "# comment\n"
+                    "/a/b 127.0.0.1/9001\n"
+                    "\n"
+                    "/a/c 127.0.0.1/9001\n"
+                    "/a/b 127.0.0.1/9001\n"       // same as line 2
+                    "/a/b 127.0.0.1/9002\n";
+    int lineno = 0;
+
+    struct ccnl_face_s *f9001, *f9002;
+    struct ccnl_prefix_s *pfx;
+    char uri[] = "/a/c";
+
+    relay_setup(&relay);
+    assert_int_equal(ccnl_fib_add_routes(&relay, CCNL_SUITE_NDNTLV, routes,
+                                         &lineno), 2);
+    assert_int_equal(fibcount(&relay), 2);
+    // one entry per prefix, the last line for /a/b sets its face
+    f9001 = relay.fib->next->face;
+    f9002 = relay.fib->face;
+    assert_int_equal(relay.fib->prefix->compcnt, 2);
+    assert_memory_equal(relay.fib->prefix->comp[1], "b", 1);
+    assert_true(f9001 != f9002);
+    assert_true(f9001->flags & CCNL_FACE_FLAGS_STATIC);
+
+    // loading the file again adds nothing
+    strcpy(routes, "/a/c 127.0.0.1/9001\n");
+    assert_int_equal(ccnl_fib_add_routes(&relay, CCNL_SUITE_NDNTLV, routes,
+                                         &lineno), 0);
+    assert_int_equal(fibcount(&relay), 2);
+
+    // another face for a prefix in the FIB replaces it, as prefixreg does
+    strcpy(routes, "/a/c 127.0.0.1/9002\n");
+    assert_int_equal(ccnl_fib_add_routes(&relay, CCNL_SUITE_NDNTLV, routes,
+                                         &lineno), 0);
+    assert_int_equal(fibcount(&relay), 2);
+    assert_true(relay.fib->next->face == f9002);
+    pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    assert_int_equal(ccnl_fib_add_entry(&relay, pfx, f9001), 0);
+    assert_int_equal(fibcount(&relay), 2);
+    assert_true(relay.fib->next->face == f9001);
+
+    ccnl_core_cleanup(&relay);
+}
+
+void test_fibbatch_atomic()
+{
+    struct ccnl_relay_s relay;
+    char bad[] = "/a/b 127.0.0.1/9001\n"
+                 "/a/c bogus\n"
+                 "/a/d 127.0.0.1/9001\n";
+    char noslash[] = "a/b 127.0.0.1/9001\n";
+    char extra[] = "/a/b 127.0.0.1/9001 7\n";
+    int lineno = 0;
+
+    relay_setup(&relay);
+    assert_int_equal(ccnl_fib_add_routes(&relay, CCNL_SUITE_NDNTLV, bad,
+                                         &lineno), -1);
+    assert_int_equal(lineno, 2);
+    assert_null(relay.fib);
+
+    assert_int_equal(ccnl_fib_add_routes(&relay, CCNL_SUITE_NDNTLV, noslash,
+                                         &lineno), -1);
+    assert_int_equal(lineno, 1);
+    assert_int_equal(ccnl_fib_add_routes(&relay, CCNL_SUITE_NDNTLV, extra,
+                                         &lineno), -1);
+    assert_int_equal(lineno, 1);
+    assert_null(relay.fib);
+
+    ccnl_core_cleanup(&relay);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_fibbatch_add),
+        unit_test(test_fibbatch_atomic),
+    };
+
+    return run_tests(tests);
+}
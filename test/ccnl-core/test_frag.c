@@ -0,0 +1,257 @@
+/**
+ * @file test_frag.c
+ * @brief Tests for BeginEnd fragmentation and reassembly
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <string.h>
+
+#include "ccnl-core.h"
+#include "ccnl-frag.h"
+#include "ccnl-pkt-ndntlv.h"
+
+// packets handed up by the reassembly
+static uint8_t rcvd[4][2048];
+static size_t rcvdlen[4];
+static int rcvdcnt;
+
+static int8_t
+deliver(struct ccnl_relay_s *relay, struct ccnl_face_s *from,
+        uint8_t **data, size_t *len)
+{
+    (void) relay;
+    (void) from;
+    assert_true(rcvdcnt < 4 && *len <= sizeof(rcvd[0]));
+    memcpy(rcvd[rcvdcnt], *data, *len);
+    rcvdlen[rcvdcnt++] = *len;
+    *data += *len;
+    *len = 0;
+    return 0;
+}
+
+// virtual time for the reassembly timeout
+static struct timeval now;
+
+static void
+clock_fake(struct timeval *tv)
+{
+    *tv = now;
+}
+
+static void
+setup(struct ccnl_face_s *face)
+{
+    memset(face, 0, sizeof(*face));
+    memset(&now, 0, sizeof(now));
+    ccnl_clock_ptr = clock_fake;
+    rcvdcnt = 0;
+}
+
+static void
+rx(struct ccnl_face_s *face, unsigned int bits, unsigned int seqno,
+   const char *payload)
+{
+    uint8_t *data = (uint8_t*) payload;
+    size_t len = strlen(payload);
+
+    assert_int_equal(ccnl_frag_RX_BeginEnd2015(deliver, NULL, face, 1500,
+                                               bits, seqno, &data, &len), 1);
+}
+
+#define F   CCNL_BEFRAG_FLAG_FIRST
+#define M   CCNL_BEFRAG_FLAG_MID
+#define L   CCNL_BEFRAG_FLAG_LAST
+
+static void
+assert_rcvd(int n, const char *s)
+{
+    assert_int_equal(rcvdlen[n], strlen(s));
+    assert_memory_equal(rcvd[n], s, strlen(s));
+}
+
+void test_frag_inorder()
+{
+    struct ccnl_face_s face;
+
+    setup(&face);
+    rx(&face, F, 5, "ab");
+    rx(&face, M, 6, "cd");
+    assert_int_equal(rcvdcnt, 0);
+    rx(&face, L, 7, "ef");
+    assert_int_equal(rcvdcnt, 1);
+    assert_rcvd(0, "abcdef");
+    assert_int_equal(face.frag->reasm_cnt, 1);
+    assert_int_equal(face.frag->reasm_drop, 0);
+
+    // a packet that wraps the 14 bit sequence number
+    rx(&face, F, 0x3fff, "gh");
+    rx(&face, L, 0, "ij");
+    assert_int_equal(rcvdcnt, 2);
+    assert_rcvd(1, "ghij");
+    ccnl_frag_destroy(face.frag);
+}
+
+void test_frag_reordered()
+{
+    struct ccnl_face_s face;
+
+    setup(&face);
+    rx(&face, L, 12, "ef");
+    rx(&face, M, 11, "cd");
+    rx(&face, F, 10, "ab");
+    assert_int_equal(rcvdcnt, 1);
+    assert_rcvd(0, "abcdef");
+    ccnl_frag_destroy(face.frag);
+
+    // two packets interleaved, 20..22 and 23..24
+    setup(&face);
+    rx(&face, F, 20, "1");
+    rx(&face, F, 23, "A");
+    rx(&face, M, 21, "2");
+    rx(&face, L, 24, "B");
+    assert_int_equal(rcvdcnt, 1);
+    assert_rcvd(0, "AB");
+    rx(&face, L, 22, "3");
+    assert_int_equal(rcvdcnt, 2);
+    assert_rcvd(1, "123");
+    ccnl_frag_destroy(face.frag);
+}
+
+void test_frag_window()
+{
+    struct ccnl_face_s face;
+
+    setup(&face);
+    // a fragment a full window later takes the slot of the first one
+    rx(&face, F, 1, "x");
+    rx(&face, F, 1 + CCNL_FRAG_REASM_SLOTS, "y");
+    assert_int_equal(face.frag->reasm_drop, 1);
+    rx(&face, L, 2, "z");
+    assert_int_equal(rcvdcnt, 0);
+    rx(&face, L, 2 + CCNL_FRAG_REASM_SLOTS, "z");
+    assert_int_equal(rcvdcnt, 1);
+    assert_rcvd(0, "yz");
+
+    // a run longer than the window never completes
+    rx(&face, F, 100, "a");
+    rx(&face, L, 100 + CCNL_FRAG_REASM_SLOTS + 1, "b");
+    assert_int_equal(rcvdcnt, 1);
+    ccnl_frag_destroy(face.frag);
+}
+
+void test_frag_timeout()
+{
+    struct ccnl_face_s face;
+
+    setup(&face);
+    rx(&face, F, 1, "ab");
+    now.tv_sec += CCNL_FRAG_REASM_TIMEOUT / 1000000 + 1;
+    rx(&face, L, 2, "cd");
+    assert_int_equal(rcvdcnt, 0);
+    assert_int_equal(face.frag->reasm_drop, 1);
+
+    // fragments in time still make it
+    rx(&face, F, 3, "ef");
+    now.tv_usec += 1000;
+    rx(&face, L, 4, "gh");
+    assert_int_equal(rcvdcnt, 1);
+    assert_rcvd(0, "efgh");
+    ccnl_frag_destroy(face.frag);
+    ccnl_clock_ptr = NULL;
+}
+
+void test_frag_getnextIov()
+{
+    struct ccnl_frag_s *fr;
+    struct ccnl_frag_iov_s iov;
+    struct ccnl_face_s face;
+    struct ccnl_buf_s *pkt;
+    sockunion su;
+    uint8_t out[1000];
+    size_t offs = 0, k;
+    int cnt = 0;
+
+    memset(&su, 0, sizeof(su));
+    pkt = ccnl_buf_new(NULL, sizeof(out));
+    for (k = 0; k < sizeof(out); k++) {
+        pkt->data[k] = (uint8_t) k;
+    }
+    pkt->data[0] = NDN_TLV_Data;        // 1000 bytes of NDN Data
+    pkt->data[1] = 0xfd;
+    pkt->data[2] = 0x03;
+    pkt->data[3] = 0xe4;
+
+    fr = ccnl_frag_new(CCNL_FRAG_BEGINEND2015, 300);
+    ccnl_frag_reset(fr, pkt, 0, &su);
+    setup(&face);
+    while (!ccnl_frag_getnextIov(fr, &iov, NULL, NULL)) {
+        uint16_t fields;
+        uint8_t *data = iov.data;
+        size_t len = iov.datalen;
+
+        assert_true(iov.hdrlen + iov.datalen <= 300);
+        // the view points into the packet, no copy
+        assert_true(iov.data == pkt->data + offs);
+        offs += iov.datalen;
+        // the BeginEnd field closes the header, before the fragment TL
+        for (k = 0; k + 4 < iov.hdrlen; k++) {
+            if (iov.hdr[k] == NDN_TLV_Frag_BeginEndFields && iov.hdr[k+1] == 2)
+                break;
+        }
+        assert_true(k + 4 < iov.hdrlen);
+        fields = (uint16_t) ((iov.hdr[k+2] << 8) | iov.hdr[k+3]);
+        assert_int_equal(fields & 0x3fff, cnt);
+        assert_int_equal(fields >> 14, cnt == 0 ? CCNL_BEFRAG_FLAG_FIRST :
+                         offs == sizeof(out) ? CCNL_BEFRAG_FLAG_LAST :
+                         CCNL_BEFRAG_FLAG_MID);
+        cnt++;
+        // receiving the fragments gives back the packet
+        assert_int_equal(ccnl_frag_RX_BeginEnd2015(deliver, NULL, &face, 300,
+                                                   fields >> 14,
+                                                   fields & 0x3fff,
+                                                   &data, &len), 1);
+    }
+    assert_int_equal(offs, sizeof(out));
+    assert_int_equal(cnt, 4);
+    assert_null(fr->bigpkt);
+    assert_int_equal(ccnl_frag_getnextIov(fr, &iov, NULL, NULL), -1);
+
+    assert_int_equal(rcvdcnt, 1);
+    assert_int_equal(rcvdlen[0], sizeof(out));
+    for (k = 4; k < sizeof(out); k++) {
+        assert_int_equal(rcvd[0][k], (uint8_t) k);
+    }
+    ccnl_frag_destroy(face.frag);
+    ccnl_frag_destroy(fr);
+    ccnl_clock_ptr = NULL;
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_frag_inorder),
+        unit_test(test_frag_reordered),
+        unit_test(test_frag_window),
+        unit_test(test_frag_timeout),
+        unit_test(test_frag_getnextIov),
+    };
+
+    return run_tests(tests);
+}
@@ -20,8 +20,13 @@
 #include <stddef.h>
 #include <setjmp.h>
 #include <cmocka.h>
+#include <string.h>
  
 #include "ccnl-interest.h"
+#include "ccnl-relay.h"
+#include "ccnl-prefix.h"
+#include "ccnl-pkt-util.h"
+#include "ccnl-malloc.h"
 
 
 void test_ccnl_interest_append_pending_invalid_parameters()
@@ -54,6 +59,120 @@ void test_ccnl_interest_remove_pending_invalid_parameters()
     assert_int_equal(result, -2); 
 }
 
+void test_ccnl_pendset_fan_in()
+{
+    struct ccnl_face_s faces[100];
+    struct ccnl_pendset_s set;
+    struct ccnl_pendint_s *pi;
+    size_t k, pos = 0, seen = 0;
+
+    memset(&set, 0, sizeof(set));
+    for (k = 0; k < 100; k++) {
+        assert_non_null(ccnl_pendset_insert(&set, faces + k));
+    }
+    // duplicates are not added again
+    for (k = 0; k < 100; k++) {
+        assert_true(ccnl_pendset_insert(&set, faces + k) ==
+                    ccnl_pendset_lookup(&set, faces + k));
+    }
+    assert_int_equal(set.cnt, 100);
+    assert_non_null(set.tab);
+
+    for (k = 0; k < 100; k += 2) {
+        assert_int_equal(ccnl_pendset_remove(&set, faces + k), 1);
+    }
+    assert_int_equal(ccnl_pendset_remove(&set, faces), 0);
+    assert_int_equal(set.cnt, 50);
+    for (k = 0; k < 100; k++) {
+        if (k % 2) {
+            assert_non_null(ccnl_pendset_lookup(&set, faces + k));
+        } else {
+            assert_null(ccnl_pendset_lookup(&set, faces + k));
+        }
+    }
+    while ((pi = ccnl_pendset_next(&set, &pos)) != NULL) {
+        assert_true((pi->face - faces) % 2 == 1);
+        seen++;
+    }
+    assert_int_equal(seen, 50);
+
+    ccnl_pendset_clear(&set);
+    assert_int_equal(set.cnt, 0);
+    assert_null(ccnl_pendset_next(&set, &pos));
+}
+
+static struct ccnl_interest_s*
+new_interest(struct ccnl_relay_s *relay, struct ccnl_face_s *from)
+{
+    char uri[] = "/a/b";
+    struct ccnl_pkt_s *pkt = ccnl_calloc(1, sizeof(*pkt));
+
+    pkt->pfx = ccnl_URItoPrefix(uri, CCNL_SUITE_DEFAULT, NULL);
+    pkt->suite = CCNL_SUITE_DEFAULT;
+    return ccnl_interest_new(relay, from, &pkt);
+}
+
+void test_ccnl_pit_overload()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s heavy, light;
+    struct ccnl_interest_s *oldest;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&heavy, 0, sizeof(heavy));
+    memset(&light, 0, sizeof(light));
+    relay.faces = &heavy;
+    heavy.next = &light;
+    relay.max_pit_entries = 3;
+
+    oldest = new_interest(&relay, &heavy);
+    assert_non_null(oldest);
+    assert_non_null(new_interest(&relay, &heavy));
+    assert_non_null(new_interest(&relay, &light));
+    assert_int_equal(relay.pitcnt, 3);
+
+    // the heaviest contributor cannot grow the PIT any further ...
+    assert_null(new_interest(&relay, &heavy));
+    assert_int_equal(heavy.ioverload_cnt, 1);
+    // ... but others still get in, at the cost of its oldest entry
+    assert_non_null(new_interest(&relay, &light));
+    assert_int_equal(heavy.pitcnt, 1);
+    assert_int_equal(light.pitcnt, 2);
+    assert_int_equal(heavy.ioverload_cnt, 2);
+    assert_true(relay.pit->next->next->from == &heavy);
+    assert_true(relay.pit->next->next != oldest);
+    // the faces' own lists hold their entries, and the face that now has
+    // the most is the next to give one up
+    assert_true(heavy.pit == relay.pit->next->next && heavy.pit == heavy.pitend);
+    assert_true(light.pit == relay.pit && light.pitend == relay.pit->next);
+    assert_true(relay.pit_heavy == &light);
+    assert_null(new_interest(&relay, &light));
+    assert_int_equal(light.ioverload_cnt, 1);
+
+    while (relay.pit) {
+        ccnl_interest_remove(&relay, relay.pit);
+    }
+    assert_int_equal(relay.pitcnt, 0);
+    assert_int_equal(relay.pit_bytes, 0);
+    assert_int_equal(heavy.pitcnt, 0);
+    assert_null(heavy.pit);
+    assert_null(light.pitend);
+}
+
+void test_ccnl_face_interest_rate()
+{
+    struct ccnl_face_s f;
+
+    memset(&f, 0, sizeof(f));
+    assert_int_equal(ccnl_face_admit_interest(&f), 1);
+    assert_int_equal(ccnl_face_set_interest_rate(&f, 1, 0), -1);
+    assert_int_equal(ccnl_face_set_interest_rate(&f, 1, 2), 0);
+    assert_int_equal(ccnl_face_admit_interest(&f), 1);
+    assert_int_equal(ccnl_face_admit_interest(&f), 1);
+    assert_int_equal(ccnl_face_admit_interest(&f), 0);
+    assert_int_equal(f.ilimit_cnt, 1);
+}
+
 void test1()
 {
   int result = 0;
@@ -67,6 +186,9 @@ int main(void)
     unit_test(test_ccnl_interest_is_same_invalid_parameters),
     unit_test(test_ccnl_interest_remove_pending_invalid_parameters),
     unit_test(test_ccnl_interest_append_pending_invalid_parameters),
+    unit_test(test_ccnl_pendset_fan_in),
+    unit_test(test_ccnl_pit_overload),
+    unit_test(test_ccnl_face_interest_rate),
   };
  
   return run_tests(tests);
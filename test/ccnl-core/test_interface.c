@@ -0,0 +1,174 @@
+/**
+ * @file test_interface.c
+ * @brief Tests for the interface TX scheduler
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-core.h"
+
+// requests reported dropped, per face
+static int dropped[4];
+
+static void
+txdone(void *face, int cnt, int len)
+{
+    assert_int_equal(cnt, 1);
+    if (len < 0) {
+        dropped[((struct ccnl_face_s*) face)->faceid]++;
+    }
+}
+
+static int
+enqueue_class(struct ccnl_if_s *ifc, struct ccnl_face_s *f, size_t len,
+              int prio)
+{
+    struct ccnl_txrequest_s r;
+    int rc;
+
+    memset(&r, 0, sizeof(r));
+    r.buf = ccnl_buf_new(NULL, len);
+    r.txdone = txdone;
+    r.txdone_face = f;
+    r.prio = prio;
+    rc = ccnl_interface_sched_enqueue(ifc, &r);
+    if (rc) {
+        ccnl_free(r.buf);
+    }
+    return rc;
+}
+
+static int
+enqueue(struct ccnl_if_s *ifc, struct ccnl_face_s *f, size_t len)
+{
+    return enqueue_class(ifc, f, len, 0);
+}
+
+static struct ccnl_face_s*
+dequeue(struct ccnl_if_s *ifc)
+{
+    struct ccnl_txrequest_s r;
+
+    if (ccnl_interface_sched_dequeue(ifc, &r)) {
+        return NULL;
+    }
+    ccnl_free(r.buf);
+    return r.txdone_face;
+}
+
+static void
+drain(struct ccnl_if_s *ifc)
+{
+    while (ifc->qlen) {
+        dequeue(ifc);
+    }
+}
+
+void test_interface_sched_fair()
+{
+    struct ccnl_if_s *ifc = ccnl_calloc(1, sizeof(struct ccnl_if_s));
+    struct ccnl_face_s bulk = { .faceid = 1 }, other = { .faceid = 2 };
+    int i, cnt = 0;
+
+    for (i = 0; i < 40; i++) {
+        assert_int_equal(enqueue(ifc, &bulk, 1000), 0);
+    }
+    for (i = 0; i < 5; i++) {
+        assert_int_equal(enqueue(ifc, &other, 1000), 0);
+    }
+    assert_int_equal(ifc->qlen, 45);
+
+    // the late face is not stuck behind the whole bulk transfer
+    for (i = 0; i < 12; i++) {
+        if (dequeue(ifc) == &other) {
+            cnt++;
+        }
+    }
+    assert_int_equal(cnt, 5);
+
+    drain(ifc);
+    assert_null(dequeue(ifc));
+    ccnl_free(ifc);
+}
+
+void test_interface_sched_weight()
+{
+    struct ccnl_if_s *ifc = ccnl_calloc(1, sizeof(struct ccnl_if_s));
+    struct ccnl_face_s heavy = { .faceid = 1 }, light = { .faceid = 2 };
+    int i, cnt = 0;
+
+    assert_int_equal(ccnl_face_set_weight(&heavy, 3), 0);
+    assert_int_equal(ccnl_face_set_weight(&light, 0), -1);
+    for (i = 0; i < 30; i++) {
+        enqueue(ifc, &heavy, 500);
+        enqueue(ifc, &light, 500);
+    }
+    for (i = 0; i < 24; i++) {
+        if (dequeue(ifc) == &heavy) {
+            cnt++;
+        }
+    }
+    assert_int_equal(cnt, 18);
+
+    drain(ifc);
+    ccnl_free(ifc);
+}
+
+void test_interface_sched_priority()
+{
+    struct ccnl_if_s *ifc = ccnl_calloc(1, sizeof(struct ccnl_if_s));
+    struct ccnl_face_s bulk = { .faceid = 1 }, ctrl = { .faceid = 2 };
+    int i;
+
+    for (i = 0; i < CCNL_MAX_IF_QLEN; i++) {
+        assert_int_equal(enqueue(ifc, &bulk, 100), 0);
+    }
+    // a full interface pushes out bulk traffic, not control traffic
+    memset(dropped, 0, sizeof(dropped));
+    assert_int_equal(enqueue(ifc, &bulk, 100), -1);
+    assert_int_equal(dropped[1], 0);
+    assert_int_equal(enqueue_class(ifc, &ctrl, 100, 1), 0);
+    assert_int_equal(ifc->qlen, CCNL_MAX_IF_QLEN);
+    // the owner of the request pushed out learns about it
+    assert_int_equal(dropped[1], 1);
+    assert_int_equal(dropped[2], 0);
+    assert_true(dequeue(ifc) == &ctrl);
+    assert_true(dequeue(ifc) == &bulk);
+    drain(ifc);
+
+    // the priority is per request: other traffic of the face is bulk
+    assert_int_equal(enqueue(ifc, &ctrl, 100), 0);
+    assert_int_equal(ifc->subq[0].qlen, 0);
+    assert_int_equal(enqueue_class(ifc, &ctrl, 100, 1), 0);
+    assert_int_equal(ifc->subq[0].qlen, 1);
+
+    drain(ifc);
+    ccnl_free(ifc);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_interface_sched_fair),
+        unit_test(test_interface_sched_weight),
+        unit_test(test_interface_sched_priority),
+    };
+
+    return run_tests(tests);
+}
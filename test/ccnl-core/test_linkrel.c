@@ -0,0 +1,232 @@
+/**
+ * @file test_linkrel.c
+ * @brief Tests for the hop-by-hop link reliability layer
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#define USE_SUITE_NDNTLV        // ccnl_ndntlv_forwarder()
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-fwd.h"
+
+static void
+decode(struct ccnl_buf_s *wire, struct ccnl_ndntlv_lp_s *lp)
+{
+    uint8_t *data = wire->data;
+    size_t datalen = wire->datalen, len;
+    uint64_t typ;
+
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &datalen, &typ, &len), 0);
+    assert_int_equal(typ, NDN_TLV_LpPacket);
+    assert_int_equal(len, datalen);
+    assert_int_equal(ccnl_ndntlv_parseLpPacket(data, len, lp), 0);
+}
+
+void test_lp_packet_roundtrip()
+{
+    uint8_t buf[64], interest[] = { NDN_TLV_Interest, 0x00 };
+    struct ccnl_ndntlv_lp_s lp, out;
+    size_t offset = sizeof(buf), len;
+    uint8_t *data;
+    size_t datalen, vallen;
+    uint64_t typ;
+
+    memset(&lp, 0, sizeof(lp));
+    lp.has_txseq = 1;
+    lp.txseq = 0x1234567;
+    lp.ackcnt = 2;
+    lp.acks[0] = 0;
+    lp.acks[1] = 300;
+    lp.frag = interest;
+    lp.fraglen = sizeof(interest);
+    assert_int_equal(ccnl_ndntlv_prependLpPacket(&lp, &offset, buf, &len), 0);
+    assert_int_equal(offset + len, sizeof(buf));
+
+    data = buf + offset;
+    datalen = len;
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &datalen, &typ, &vallen), 0);
+    assert_int_equal(ccnl_ndntlv_parseLpPacket(data, vallen, &out), 0);
+    assert_true(out.has_txseq);
+    assert_int_equal(out.txseq, 0x1234567);
+    assert_int_equal(out.ackcnt, 2);
+    assert_int_equal(out.acks[1], 300);
+    assert_int_equal(out.fraglen, sizeof(interest));
+    assert_memory_equal(out.frag, interest, sizeof(interest));
+}
+
+void test_congestion_mark()
+{
+    uint8_t data[] = { NDN_TLV_Data, 0x00 };
+    uint8_t interest[] = { NDN_TLV_Interest, 0x00 };
+    struct ccnl_buf_s *buf, *marked, *again;
+    struct ccnl_ndntlv_lp_s lp;
+
+    buf = ccnl_buf_new(interest, sizeof(interest));
+    assert_null(ccnl_ndntlv_mkCongestionMark(buf));
+    ccnl_free(buf);
+
+    buf = ccnl_buf_new(data, sizeof(data));
+    marked = ccnl_ndntlv_mkCongestionMark(buf);
+    assert_non_null(marked);
+    decode(marked, &lp);
+    assert_int_equal(lp.congmark, 1);
+    assert_false(lp.has_txseq);
+    assert_int_equal(lp.fraglen, sizeof(data));
+    assert_memory_equal(lp.frag, data, sizeof(data));
+
+    // marking a marked packet does not nest LpPackets
+    again = ccnl_ndntlv_mkCongestionMark(marked);
+    assert_non_null(again);
+    assert_int_equal(again->datalen, marked->datalen);
+    assert_memory_equal(again->data, marked->data, marked->datalen);
+
+    ccnl_free(again);
+    ccnl_free(marked);
+    ccnl_free(buf);
+}
+
+void test_linkrel_ack_and_dup()
+{
+    uint8_t interest[] = { NDN_TLV_Interest, 0x00 };
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s sender, receiver;
+    struct ccnl_ndntlv_lp_s lp, ack;
+    struct ccnl_buf_s *wire;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&sender, 0, sizeof(sender));
+    memset(&receiver, 0, sizeof(receiver));
+    sender.linkrel = ccnl_linkrel_new();
+    assert_non_null(sender.linkrel);
+
+    wire = ccnl_linkrel_TX(&relay, &sender,
+                           ccnl_buf_new(interest, sizeof(interest)));
+    assert_non_null(wire);
+    decode(wire, &lp);
+    assert_true(lp.has_txseq);
+    assert_int_equal(lp.fraglen, sizeof(interest));
+    assert_int_equal(sender.linkrel->tx_cnt, 1);
+
+    // the receiver switches reliability on and queues an ack
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 1);
+    assert_non_null(receiver.linkrel);
+    assert_int_equal(receiver.linkrel->ackcnt, 1);
+    // a retransmission whose ack got lost is not delivered twice
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 0);
+    assert_int_equal(receiver.linkrel->dup_cnt, 1);
+
+    memset(&ack, 0, sizeof(ack));
+    ack.ackcnt = 1;
+    ack.acks[0] = lp.txseq;
+    assert_int_equal(ccnl_linkrel_RX(&relay, &sender, &ack), 0);
+    assert_int_equal(sender.linkrel->ack_cnt, 1);
+    assert_null(sender.linkrel->unacked[0].buf);
+
+    ccnl_free(wire);
+    ccnl_linkrel_free(sender.linkrel);
+    ccnl_linkrel_free(receiver.linkrel);
+}
+
+void test_linkrel_dup_window()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s receiver;
+    struct ccnl_ndntlv_lp_s lp;
+    uint8_t interest[] = { NDN_TLV_Interest, 0x00 };
+    int i;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&receiver, 0, sizeof(receiver));
+    memset(&lp, 0, sizeof(lp));
+    lp.has_txseq = 1;
+    lp.frag = interest;
+    lp.fraglen = sizeof(interest);
+
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 1);
+    // duplicates do not take room from the frames remembered
+    for (i = 0; i < 2 * CCNL_LINKREL_WINDOW - 2; i++) {
+        assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 0);
+    }
+    lp.txseq = 1;
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 1);
+    lp.txseq = 2;
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 1);
+    lp.txseq = 0;
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 0);
+    assert_int_equal(receiver.linkrel->dup_cnt, 2 * CCNL_LINKREL_WINDOW - 1);
+
+    // a frame a whole window later takes the slot of an old one
+    lp.txseq = 2 * CCNL_LINKREL_WINDOW;
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 1);
+    lp.txseq = 1;
+    assert_int_equal(ccnl_linkrel_RX(&relay, &receiver, &lp), 0);
+
+    ccnl_linkrel_free(receiver.linkrel);
+}
+
+void test_lp_packet_nested()
+{
+    uint8_t inner[64], outer[128], other[] = { 0x99, 0x00 };
+    uint8_t interest[] = { NDN_TLV_Interest, 0x00 };
+    struct ccnl_relay_s relay;
+    struct ccnl_ndntlv_lp_s lp;
+    size_t ioffs = sizeof(inner), ooffs = sizeof(outer), ilen, olen;
+    uint8_t *data;
+    size_t datalen;
+
+    memset(&relay, 0, sizeof(relay));
+    memset(&lp, 0, sizeof(lp));
+    lp.frag = interest;
+    lp.fraglen = sizeof(interest);
+    assert_int_equal(ccnl_ndntlv_prependLpPacket(&lp, &ioffs, inner, &ilen), 0);
+    lp.frag = inner + ioffs;
+    lp.fraglen = ilen;
+    assert_int_equal(ccnl_ndntlv_prependLpPacket(&lp, &ooffs, outer, &olen), 0);
+
+    // an LpPacket in an LpPacket is dropped, not unwrapped
+    data = outer + ooffs;
+    datalen = olen;
+    assert_int_equal(ccnl_ndntlv_forwarder(&relay, NULL, &data, &datalen), -1);
+    assert_int_equal(datalen, 0);
+
+    // any other fragment is handed on
+    ooffs = sizeof(outer);
+    lp.frag = other;
+    lp.fraglen = sizeof(other);
+    assert_int_equal(ccnl_ndntlv_prependLpPacket(&lp, &ooffs, outer, &olen), 0);
+    data = outer + ooffs;
+    datalen = olen;
+    assert_int_equal(ccnl_ndntlv_forwarder(&relay, NULL, &data, &datalen), 0);
+    assert_int_equal(datalen, 0);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_lp_packet_roundtrip),
+        unit_test(test_congestion_mark),
+        unit_test(test_linkrel_ack_and_dup),
+        unit_test(test_linkrel_dup_window),
+        unit_test(test_lp_packet_nested),
+    };
+
+    return run_tests(tests);
+}
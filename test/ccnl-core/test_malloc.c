@@ -0,0 +1,68 @@
+/**
+ * @file test-malloc.c
+ * @brief Tests for the debug memory allocator
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+
+#include <stdio.h>
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include "ccnl-malloc.h"
+
+void test_free_unlinks()
+{
+    unsigned char *a = ccnl_malloc(8), *b = ccnl_malloc(8);
+    int frees = ccnl_malloc_stats.frees;
+
+    ccnl_free(a);
+    ccnl_free(b);
+    assert_int_equal(ccnl_malloc_stats.frees, frees + 2);
+    // freeing twice is reported, not counted
+    ccnl_free(a);
+    assert_int_equal(ccnl_malloc_stats.frees, frees + 2);
+}
+
+void test_free_foreign()
+{
+    // what precedes a pointer that is not ours must not be followed
+    unsigned char buf[4 * sizeof(struct mhdr)];
+    unsigned char *a = ccnl_malloc(8);
+    int frees = ccnl_malloc_stats.frees;
+
+    memset(buf, 0xff, sizeof(buf));
+    ccnl_free(buf + 2 * sizeof(struct mhdr));
+    assert_null(ccnl_realloc(buf + 2 * sizeof(struct mhdr), 16));
+    // an interior pointer of a live block
+    memset(a, 0xff, 8);
+    ccnl_free(a + 4);
+    assert_int_equal(ccnl_malloc_stats.frees, frees);
+
+    ccnl_free(a);
+    assert_int_equal(ccnl_malloc_stats.frees, frees + 1);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_free_unlinks),
+        unit_test(test_free_foreign),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,262 @@
+/**
+ * @file test_mmap.c
+ * @brief Tests for serving a mapped file as a chunk stream
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+// built with the flags of the libraries, see CMakeLists.txt
+#include "ccnl-core.h"
+#include "ccnl-dispatch.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-builder.h"
+#include "ccnl-ext-hmac.h"
+#include "ccnl-mmap-producer.h"
+
+#define FILE_SIZE   250
+#define CHUNK_SIZE  100
+
+// the last packet sent by the relay
+static uint8_t sent[CCNL_MAX_PACKET_SIZE];
+static size_t sentlen;
+static int sentcnt;
+
+static void
+capture(struct ccnl_relay_s *relay, struct ccnl_if_s *ifc, sockunion *dst,
+        struct ccnl_buf_s *buf)
+{
+    (void) relay;
+    (void) ifc;
+    (void) dst;
+    memcpy(sent, buf->data, buf->datalen);
+    sentlen = buf->datalen;
+    sentcnt++;
+}
+
+static char path[] = "/tmp/test_mmapXXXXXX";
+
+// a relay with one face, and a file of FILE_SIZE bytes
+static struct ccnl_face_s*
+setup(struct ccnl_relay_s *relay)
+{
+    uint8_t data[FILE_SIZE];
+    struct ccnl_face_s *f;
+    sockunion su;
+    int fd, i;
+
+    memset(relay, 0, sizeof(*relay));
+    relay->ccnl_ll_TX_ptr = capture;
+    relay->ifcount = 1;
+    relay->ifs[0].addr.sa.sa_family = AF_INET;
+    relay->ifs[0].sock = -1;
+    ccnl_core_init();
+    memset(&su, 0, sizeof(su));
+    su.ip4.sin_family = AF_INET;
+    su.ip4.sin_port = htons(9000);
+    f = ccnl_get_face_or_create(relay, 0, &su.sa, sizeof(su.ip4));
+    assert_non_null(f);
+
+    strcpy(path + strlen(path) - 6, "XXXXXX");
+    fd = mkstemp(path);
+    assert_true(fd >= 0);
+    for (i = 0; i < FILE_SIZE; i++) {
+        data[i] = (uint8_t) (i * 7);
+    }
+    assert_int_equal(write(fd, data, sizeof(data)), sizeof(data));
+    close(fd);
+    sentcnt = 0;
+    return f;
+}
+
+static void
+teardown(struct ccnl_relay_s *relay)
+{
+    ccnl_mmap_producer_cleanup();
+    ccnl_core_cleanup(relay);
+    unlink(path);
+}
+
+// parses a packet of \p suite as the relay receives it
+static struct ccnl_pkt_s*
+parse(int suite, uint8_t *start, size_t len)
+{
+    struct ccnl_pkt_s *pkt;
+    uint8_t *data = start;
+    size_t hdrlen;
+    uint64_t typ;
+
+    if (suite == CCNL_SUITE_NDNTLV) {
+        assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &hdrlen), 0);
+        pkt = ccnl_ndntlv_bytes2pkt(typ, start, &data, &len);
+    } else {
+        assert_int_equal(ccnl_ccntlv_getHdrLen(data, len, &hdrlen), 0);
+        data += hdrlen;
+        len -= hdrlen;
+        pkt = ccnl_ccntlv_bytes2pkt(start, &data, &len);
+    }
+    assert_non_null(pkt);
+    return pkt;
+}
+
+// asks for chunk \p chunk of \p uri (-1: no chunk number), returns the
+// Data sent back, parsed, or NULL if the producer did not answer
+static struct ccnl_pkt_s*
+ask(struct ccnl_relay_s *relay, struct ccnl_face_s *f, int suite,
+    const char *uri, int chunk)
+{
+    struct ccnl_pkt_s *interest;
+    struct ccnl_prefix_s *pfx;
+    struct ccnl_buf_s *b;
+    ccnl_interest_opts_u opts;
+    uint32_t cn = (uint32_t) chunk;
+    char buf[64];
+    int cnt = sentcnt, rc;
+
+    strcpy(buf, uri);
+    pfx = ccnl_URItoPrefix(buf, suite, chunk < 0 ? NULL : &cn);
+    assert_non_null(pfx);
+    memset(&opts, 0, sizeof(opts));
+    opts.ndntlv.nonce = (uint32_t) cnt + 1;
+    b = ccnl_mkSimpleInterest(pfx, &opts);
+    assert_non_null(b);
+    interest = parse(suite, b->data, b->datalen);
+    rc = ccnl_mmap_producer(relay, f, interest);
+    ccnl_pkt_free(interest);
+    ccnl_free(b);
+    ccnl_prefix_free(pfx);
+    if (!rc) {
+        assert_int_equal(sentcnt, cnt);
+        return NULL;
+    }
+    assert_int_equal(sentcnt, cnt + 1);
+    return parse(suite, sent, sentlen);
+}
+
+// the Data carries chunk \p chunk of the file, and knows the last one
+static void
+assert_chunk(struct ccnl_pkt_s *pkt, int chunk)
+{
+    size_t i, len = chunk * CHUNK_SIZE + CHUNK_SIZE > FILE_SIZE ?
+                    FILE_SIZE - chunk * CHUNK_SIZE : CHUNK_SIZE;
+
+    assert_non_null(pkt->pfx->chunknum);
+    assert_int_equal(*pkt->pfx->chunknum, chunk);
+    assert_int_equal(pkt->val.final_block_id, (FILE_SIZE - 1) / CHUNK_SIZE);
+    assert_int_equal(pkt->contlen, len);
+    for (i = 0; i < len; i++) {
+        assert_int_equal(pkt->content[i], (uint8_t) ((chunk * CHUNK_SIZE + i) * 7));
+    }
+    ccnl_pkt_free(pkt);
+}
+
+void test_mmap_match()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *f = setup(&relay);
+
+    assert_int_equal(ccnl_mmap_producer_add("/mm/f", CCNL_SUITE_NDNTLV, path,
+                                            CHUNK_SIZE, NULL, NULL), 0);
+    assert_chunk(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/f", 1), 1);
+    assert_chunk(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/f", 2), 2);
+    // the stream name alone gets the first chunk
+    assert_chunk(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/f", -1), 0);
+    // again, from the encoded chunks kept
+    assert_chunk(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/f", 1), 1);
+
+    // past the end, other names, longer names and other suites are not ours
+    assert_null(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/f", 3));
+    assert_null(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/g", 0));
+    assert_null(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm", 0));
+    assert_null(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/f/x", 0));
+    assert_null(ask(&relay, f, CCNL_SUITE_CCNTLV, "/mm/f", 0));
+    assert_int_equal(ccnl_mmap_producer(&relay, NULL, NULL), 0);
+
+    teardown(&relay);
+}
+
+void test_mmap_ccntlv()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *f = setup(&relay);
+
+    assert_int_equal(ccnl_mmap_producer_add("/mm/c", CCNL_SUITE_CCNTLV, path,
+                                            CHUNK_SIZE, NULL, NULL), 0);
+    assert_chunk(ask(&relay, f, CCNL_SUITE_CCNTLV, "/mm/c", 0), 0);
+    assert_chunk(ask(&relay, f, CCNL_SUITE_CCNTLV, "/mm/c", 2), 2);
+    assert_null(ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/c", 0));
+    teardown(&relay);
+}
+
+void test_mmap_signed()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_face_s *f = setup(&relay);
+    struct ccnl_pkt_s *pkt;
+    uint8_t keyval[64], keyid[32], md[32];
+    size_t mdlen = sizeof(md);
+
+    memset(keyval, 'k', sizeof(keyval));
+    ccnl_hmac256_keyid(keyval, sizeof(keyval), keyid);
+    assert_int_equal(ccnl_mmap_producer_add("/mm/s", CCNL_SUITE_NDNTLV, path,
+                                            CHUNK_SIZE, keyval, keyid), 0);
+    pkt = ask(&relay, f, CCNL_SUITE_NDNTLV, "/mm/s", 2);
+    assert_non_null(pkt);
+    assert_true(pkt->hmacLen > 0);
+    ccnl_hmac256_sign(keyval, sizeof(keyval), pkt->hmacStart, pkt->hmacLen,
+                      md, &mdlen);
+    assert_memory_equal(md, pkt->hmacSignature, sizeof(md));
+    assert_chunk(pkt, 2);
+    teardown(&relay);
+}
+
+void test_mmap_add_invalid()
+{
+    struct ccnl_relay_s relay;
+
+    setup(&relay);
+    assert_int_equal(ccnl_mmap_producer_add("/mm/f", CCNL_SUITE_CCNB, path,
+                                            CHUNK_SIZE, NULL, NULL), -1);
+    assert_int_equal(ccnl_mmap_producer_add("/mm/f", CCNL_SUITE_NDNTLV, path,
+                                            0, NULL, NULL), -1);
+    assert_int_equal(ccnl_mmap_producer_add("/mm/f", CCNL_SUITE_NDNTLV, path,
+                                            CCNL_MAX_PACKET_SIZE, NULL,
+                                            NULL), -1);
+    assert_int_equal(ccnl_mmap_producer_add("/mm/f", CCNL_SUITE_NDNTLV,
+                                            "/nonexistent/file", CHUNK_SIZE,
+                                            NULL, NULL), -1);
+    teardown(&relay);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_mmap_match),
+        unit_test(test_mmap_ccntlv),
+        unit_test(test_mmap_signed),
+        unit_test(test_mmap_add_invalid),
+    };
+
+    return run_tests(tests);
+}
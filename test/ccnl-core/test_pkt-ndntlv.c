@@ -0,0 +1,148 @@
+/**
+ * @file test_pkt-ndntlv.c
+ * @brief Tests for the NDN TLV encoder templates
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <unistd.h>
+#include <sys/mman.h>
+
+#define USE_SUITE_NDNTLV
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+
+void test_ccnl_ndntlv_fillContent()
+{
+    char uri[] = "/ndn/test/file";
+    struct ccnl_prefix_s *name = ccnl_URItoPrefix(uri, CCNL_SUITE_DEFAULT, NULL);
+    struct ccnl_ndntlv_data_opts_s opts = { 4000, 300 };
+    struct ccnl_ndntlv_template_s t;
+    uint8_t ref[512], out[512], payload[100];
+    size_t refoffs, offs, reflen, len;
+    uint32_t segs[] = { 0, 200, 70000 }, i;
+
+    assert_int_equal(0, ccnl_ndntlv_mkContentTemplate(&t, name, &opts));
+    memset(payload, 'p', sizeof(payload));
+    name->chunknum = (uint32_t*) ccnl_malloc(sizeof(uint32_t));
+    for (i = 0; i < sizeof(segs) / sizeof(*segs); i++) {
+        *name->chunknum = segs[i];
+        refoffs = offs = sizeof(ref);
+        assert_int_equal(0, ccnl_ndntlv_prependContent(name, payload, i * 40,
+                                                       NULL, &opts, &refoffs,
+                                                       ref, &reflen));
+        assert_int_equal(0, ccnl_ndntlv_fillContent(&t, segs + i, payload,
+                                                    i * 40, &offs, out, &len));
+        assert_int_equal(reflen, len);
+        assert_memory_equal(ref + refoffs, out + offs, len);
+    }
+
+    // payload already in place
+    offs = sizeof(out);
+    memset(out + offs - t.taillen - 10, 'q', 10);
+    assert_int_equal(0, ccnl_ndntlv_fillContent(&t, NULL,
+                                                out + offs - t.taillen - 10, 10,
+                                                &offs, out, &len));
+    ccnl_free(name->chunknum);
+    name->chunknum = NULL;
+    memset(payload, 'q', 10);
+    refoffs = sizeof(ref);
+    ccnl_ndntlv_prependContent(name, payload, 10, NULL, &opts, &refoffs, ref, &reflen);
+    assert_int_equal(reflen, len);
+    assert_memory_equal(ref + refoffs, out + offs, len);
+
+    ccnl_ndntlv_freeTemplate(&t);
+    ccnl_prefix_free(name);
+}
+
+void test_ccnl_ndntlv_fillInterest()
+{
+    char uri[] = "/ndn/test/file";
+    struct ccnl_prefix_s *name = ccnl_URItoPrefix(uri, CCNL_SUITE_DEFAULT, NULL);
+    struct ccnl_ndntlv_interest_opts_s opts = { 0, 1, 4000 };
+    struct ccnl_ndntlv_template_s t;
+    uint8_t ref[256], out[256];
+    size_t refoffs = sizeof(ref), offs = sizeof(out), reflen, len;
+    uint32_t seg = 7;
+
+    assert_int_equal(0, ccnl_ndntlv_mkInterestTemplate(&t, name, 1, &opts));
+    name->chunknum = (uint32_t*) ccnl_malloc(sizeof(uint32_t));
+    *name->chunknum = seg;
+    opts.nonce = 0x12345678;
+    assert_int_equal(0, ccnl_ndntlv_prependInterest(name, 1, &opts, &refoffs,
+                                                    ref, &reflen));
+    assert_int_equal(0, ccnl_ndntlv_fillInterest(&t, &seg, opts.nonce, &offs,
+                                                 out, &len));
+    assert_int_equal(reflen, len);
+    assert_memory_equal(ref + refoffs, out + offs, len);
+
+    // a Data template does not fill Interests
+    offs = sizeof(out);
+    t.type = NDN_TLV_Data;
+    assert_int_equal(-1, ccnl_ndntlv_fillInterest(&t, &seg, 1, &offs, out, &len));
+
+    ccnl_ndntlv_freeTemplate(&t);
+    ccnl_prefix_free(name);
+}
+
+void test_ccnl_ndntlv_varlenint_end()
+{
+    // a Data /a "hi" that ends where readable memory ends
+    static const uint8_t data[] = { 0x06, 0x09, 0x07, 0x03, 0x08, 0x01, 'a',
+                                    0x15, 0x02, 'h', 'i' };
+    long pagesize = sysconf(_SC_PAGESIZE);
+    uint8_t *page, *start, *cp;
+    struct ccnl_pkt_s *pkt;
+    size_t len;
+    uint64_t val;
+
+    page = mmap(NULL, 2 * pagesize, PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    assert_true(page != MAP_FAILED);
+    assert_int_equal(mprotect(page + pagesize, pagesize, PROT_NONE), 0);
+    start = page + pagesize - sizeof(data);
+    memcpy(start, data, sizeof(data));
+
+    // nothing left: no number, and no byte read past the end
+    cp = page + pagesize;
+    len = 0;
+    assert_int_equal(ccnl_ndntlv_varlenint(&cp, &len, &val), -1);
+
+    // parsing stops at the end of the packet
+    cp = start + 2;
+    len = sizeof(data) - 2;
+    pkt = ccnl_ndntlv_bytes2pkt(NDN_TLV_Data, start, &cp, &len);
+    assert_non_null(pkt);
+    assert_int_equal(pkt->contlen, 2);
+    ccnl_pkt_free(pkt);
+
+    munmap(page, 2 * pagesize);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_ndntlv_fillContent),
+        unit_test(test_ccnl_ndntlv_fillInterest),
+        unit_test(test_ccnl_ndntlv_varlenint_end),
+    };
+
+    return run_tests(tests);
+}
@@ -178,6 +178,20 @@ void test_ccnl_pkt2suite_valid()
     assert_int_equal(result, CCNL_SUITE_CCNTLV);
 }
 
+void test_ccnl_ccntlv_prependTL()
+{
+    uint8_t buf[8];
+    size_t offset = sizeof(buf);
+
+    /** both bytes of type and length are written */
+    assert_int_equal(ccnl_ccntlv_prependTL(0x0102, 0x1234, &offset, buf), 0);
+    assert_int_equal(offset, 4);
+    assert_int_equal(buf[4], 0x01);
+    assert_int_equal(buf[5], 0x02);
+    assert_int_equal(buf[6], 0x12);
+    assert_int_equal(buf[7], 0x34);
+}
+
 int main(void)
 {
     const UnitTest tests[] = {
@@ -193,6 +207,7 @@ int main(void)
         unit_test(test_ccnl_cmp2int_valid),
         unit_test(test_ccnl_pkt2suite_invalid),
         unit_test(test_ccnl_pkt2suite_valid),
+        unit_test(test_ccnl_ccntlv_prependTL),
     };
     
     return run_tests(tests);
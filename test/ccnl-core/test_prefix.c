@@ -127,6 +127,38 @@ void test_prefix_no_longest_match()
     assert_int_equal(0, res);
 }
 
+void test_prefix_hashes()
+{
+    int prefix_cmp_suite = 0;
+    char *c1 = ccnl_malloc(100);
+    strcpy(c1, "/path/to/data");
+    struct ccnl_prefix_s *p1 = ccnl_URItoPrefix(c1, prefix_cmp_suite, NULL);
+
+    char *c2 = ccnl_malloc(100);
+    strcpy(c2, "/path/to");
+    struct ccnl_prefix_s *p2 = ccnl_URItoPrefix(c2, prefix_cmp_suite, NULL);
+    struct ccnl_prefix_s *p3 = ccnl_prefix_dup(p2);
+
+    assert_int_equal(3, p1->hashcnt);
+    assert_int_equal(2, p3->hashcnt);
+    assert_true(p1->comphash[1] == p3->comphash[1]);
+    assert_true(ccnl_prefix_hashOf(p1, 2) == ccnl_prefix_hashOf(p2, 2));
+
+    ccnl_prefix_appendCmp(p3, (uint8_t*) "data", 4);
+    assert_int_equal(3, p3->hashcnt);
+    assert_true(p1->comphash[2] == p3->comphash[2]);
+    assert_int_equal(0, ccnl_prefix_cmp(p1, 0, p3, CMP_EXACT));
+
+    ccnl_prefix_appendCmp(p2, (uint8_t*) "date", 4);
+    assert_true(p1->comphash[2] != p2->comphash[2]);
+    assert_int_equal(-1, ccnl_prefix_cmp(p1, 0, p2, CMP_EXACT));
+    assert_int_equal(2, ccnl_prefix_cmp(p1, 0, p2, CMP_LONGEST));
+
+    ccnl_prefix_free(p1);
+    ccnl_prefix_free(p2);
+    ccnl_prefix_free(p3);
+}
+
 int main(void)
 {
   const UnitTest tests[] = {
@@ -137,6 +169,7 @@ int main(void)
     unit_test(test_prefix_no_exact_match),
     unit_test(test_prefix_longest_match),
     unit_test(test_prefix_no_longest_match),
+    unit_test(test_prefix_hashes),
   };
  
   return run_tests(tests);
@@ -0,0 +1,162 @@
+/**
+ * @file test_sha256.c
+ * @brief Tests for the SHA-256 kernels and HMAC signing
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdio.h>
+#include <string.h>
+#include "ccnl-ext-hmac.h"
+
+#define BATCH   11
+
+static void
+sha256(const char *msg, size_t len, uint8_t *md)
+{
+    SHA256_CTX_t ctx;
+
+    ccnl_SHA256_Init(&ctx);
+    ccnl_SHA256_Update(&ctx, (const uint8_t*) msg, len);
+    ccnl_SHA256_Final(md, &ctx);
+}
+
+static void
+hex(const uint8_t *md, char *out)
+{
+    int i;
+
+    for (i = 0; i < 32; i++) {
+        sprintf(out + 2 * i, "%02x", md[i]);
+    }
+}
+
+void test_ccnl_sha256_vectors()
+{
+    const char *abc56 = "abcdbcdecdefdefgefghfghighijhijkijkljklmklmnlmnomnopnopq";
+    int level, best = ccnl_SHA256_setLevel(-1);
+    uint8_t md[32];
+    char s[65];
+
+    for (level = CCNL_SHA256_SCALAR; level <= best; level++) {
+        assert_int_equal(level, ccnl_SHA256_setLevel(level));
+        sha256("", 0, md);
+        hex(md, s);
+        assert_string_equal(s,
+            "e3b0c44298fc1c149afbf4c8996fb92427ae41e4649b934ca495991b7852b855");
+        sha256("abc", 3, md);
+        hex(md, s);
+        assert_string_equal(s,
+            "ba7816bf8f01cfea414140de5dae2223b00361a396177a9cb410ff61f20015ad");
+        sha256(abc56, strlen(abc56), md);
+        hex(md, s);
+        assert_string_equal(s,
+            "248d6a61d20638b8e5c026930c3e6039a33ce45964ff2167f6ecedd419db06c1");
+    }
+    ccnl_SHA256_setLevel(-1);
+}
+
+void test_ccnl_sha256_batch()
+{
+    int level, best = ccnl_SHA256_setLevel(-1);
+    static uint8_t buf[1024];
+    uint8_t ref[BATCH][32], out[BATCH][32], *md[BATCH];
+    SHA256_CTX_t ctx[BATCH], *ctxp[BATCH];
+    const uint8_t *data[BATCH];
+    size_t len[BATCH], i;
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t) (i * 13 + 5);
+    }
+    for (level = CCNL_SHA256_SCALAR; level <= best; level++) {
+        ccnl_SHA256_setLevel(level);
+        for (i = 0; i < BATCH; i++) {
+            // empty, around the padding boundaries, several blocks
+            len[i] = (i * 119) % 300;
+            data[i] = buf + i;
+            // some contexts continue a message, one of them mid-block
+            ccnl_SHA256_Init(ctx + i);
+            if (i % 3 == 1) {
+                ccnl_SHA256_Update(ctx + i, buf, i == 4 ? 70 : 64);
+            }
+            ctxp[i] = ctx + i;
+            md[i] = out[i];
+
+            ccnl_SHA256_setLevel(CCNL_SHA256_SCALAR);
+            {
+                SHA256_CTX_t c = ctx[i];
+                ccnl_SHA256_Update(&c, data[i], len[i]);
+                ccnl_SHA256_Final(ref[i], &c);
+            }
+            ccnl_SHA256_setLevel(level);
+        }
+        ccnl_SHA256_Batch(ctxp, data, len, md, BATCH);
+        for (i = 0; i < BATCH; i++) {
+            assert_memory_equal(ref[i], out[i], 32);
+        }
+    }
+    ccnl_SHA256_setLevel(-1);
+}
+
+void test_ccnl_hmac256()
+{
+    // RFC 4231, test case 2
+    char *data = "what do ya want for nothing?";
+    uint8_t md[32], out[BATCH][32], *mdp[BATCH], *msg[BATCH];
+    struct ccnl_hmac256_key_s key;
+    size_t mlen = sizeof(md), len[BATCH], i;
+    int level, best = ccnl_SHA256_setLevel(-1);
+    char s[65];
+
+    for (level = CCNL_SHA256_SCALAR; level <= best; level++) {
+        ccnl_SHA256_setLevel(level);
+        ccnl_hmac256_sign((uint8_t*) "Jefe", 4, (uint8_t*) data, strlen(data),
+                          md, &mlen);
+        hex(md, s);
+        assert_string_equal(s,
+            "5bdcc146bf60754e6a042426089575c75a003f089d2739839dec58b964ec3843");
+
+        ccnl_hmac256_keyinit(&key, (uint8_t*) "Jefe", 4);
+        for (i = 0; i < BATCH; i++) {
+            msg[i] = (uint8_t*) data;
+            len[i] = strlen(data) - i;
+            mdp[i] = out[i];
+        }
+        ccnl_hmac256_signBatch(&key, BATCH, msg, len, mdp);
+        for (i = 0; i < BATCH; i++) {
+            mlen = sizeof(md);
+            ccnl_hmac256_signKey(&key, msg[i], len[i], md, &mlen);
+            assert_memory_equal(md, out[i], 32);
+        }
+        assert_memory_equal(out[0],
+            "\x5b\xdc\xc1\x46\xbf\x60\x75\x4e\x6a\x04\x24\x26\x08\x95\x75\xc7", 16);
+    }
+    ccnl_SHA256_setLevel(-1);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_sha256_vectors),
+        unit_test(test_ccnl_sha256_batch),
+        unit_test(test_ccnl_hmac256),
+    };
+
+    return run_tests(tests);
+}
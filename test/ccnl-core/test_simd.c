@@ -0,0 +1,83 @@
+/**
+ * @file test_simd.c
+ * @brief Tests for the vectorized name component kernels
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <string.h>
+#include "ccnl-simd.h"
+
+void test_ccnl_simd_memeq()
+{
+    uint8_t a[80], b[80];
+    size_t len, i;
+    int level, best = ccnl_simd_setLevel(-1);
+
+    for (i = 0; i < sizeof(a); i++) {
+        a[i] = b[i] = (uint8_t) (i * 7 + 1);
+    }
+    for (level = CCNL_SIMD_SCALAR; level <= best; level++) {
+        assert_int_equal(level, ccnl_simd_setLevel(level));
+        for (len = 0; len <= sizeof(a); len++) {
+            assert_true(ccnl_simd_memeq(a, b, len));
+            for (i = 0; i < len; i++) {
+                b[i] ^= 0x40;
+                assert_false(ccnl_simd_memeq(a, b, len));
+                b[i] ^= 0x40;
+            }
+        }
+    }
+    ccnl_simd_setLevel(-1);
+}
+
+void test_ccnl_simd_crc32c()
+{
+    uint8_t buf[67];
+    uint32_t ref;
+    size_t i;
+    int level, best = ccnl_simd_setLevel(-1);
+
+    for (i = 0; i < sizeof(buf); i++) {
+        buf[i] = (uint8_t) (i * 13);
+    }
+    ccnl_simd_setLevel(CCNL_SIMD_SCALAR);
+    ref = ccnl_simd_crc32c(0, buf, sizeof(buf));
+    // standard check value of CRC-32C
+    assert_int_equal(0xE3069283u,
+                     ~ccnl_simd_crc32c(0xffffffffu, (uint8_t*) "123456789", 9));
+
+    for (level = CCNL_SIMD_SSE42; level <= best; level++) {
+        ccnl_simd_setLevel(level);
+        assert_int_equal(ref, ccnl_simd_crc32c(0, buf, sizeof(buf)));
+        assert_int_equal(0xE3069283u,
+                         ~ccnl_simd_crc32c(0xffffffffu, (uint8_t*) "123456789", 9));
+    }
+    ccnl_simd_setLevel(-1);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_ccnl_simd_memeq),
+        unit_test(test_ccnl_simd_crc32c),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,168 @@
+/**
+ * @file test_snapshot.c
+ * @brief Tests for the warm-restart snapshots
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+
+#define USE_SUITE_NDNTLV
+#define NEEDS_PREFIX_MATCHING   // ccnl_fib_add_entry()
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-relay.h"
+#include "ccnl-snapshot.h"
+#include "ccnl-test-relay.h"
+
+// a static UDP face with a route for /x/y, and three cached objects
+static void
+populate(struct ccnl_relay_s *relay)
+{
+    struct ccnl_face_s *f;
+    struct ccnl_content_s *c;
+    char uri[] = "/x/y";
+    sockunion su;
+    const char *names = "abc";
+
+    memset(&su, 0, sizeof(su));
+    su.ip4.sin_family = AF_INET;
+    su.ip4.sin_port = htons(9001);
+    su.ip4.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    f = ccnl_get_face_or_create(relay, -1, &su.sa, sizeof(su.ip4));
+    assert_non_null(f);
+    f->flags |= CCNL_FACE_FLAGS_STATIC;
+    assert_int_equal(ccnl_fib_add_entry(relay,
+                     ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL), f), 0);
+
+    for (; *names; names++) {
+        c = mkcontent(*names);
+        assert_non_null(c);
+        c->served_cnt = *names;
+        assert_non_null(ccnl_content_add2cache(relay, c));
+    }
+    // from -d, not saved
+    c = mkcontent('s');
+    c->flags |= CCNL_CONTENT_FLAGS_STATIC;
+    assert_non_null(ccnl_content_add2cache(relay, c));
+}
+
+void test_snapshot_roundtrip()
+{
+    char path[] = "/tmp/test_snapshotXXXXXX";
+    struct ccnl_relay_s a, b;
+    struct ccnl_content_s *c;
+    int fd, i;
+
+    fd = mkstemp(path);
+    assert_true(fd >= 0);
+    close(fd);
+
+    relay_setup(&a);
+    populate(&a);
+    assert_int_equal(ccnl_snapshot_write(&a, path), 3);
+    ccnl_core_cleanup(&a);
+
+    relay_setup(&b);
+    assert_int_equal(ccnl_snapshot_restore(&b, path), 0);
+    // routing is back at once, content follows from the event loop
+    assert_non_null(b.fib);
+    assert_int_equal(b.fib->prefix->compcnt, 2);
+    assert_true(b.fib->face->flags & CCNL_FACE_FLAGS_STATIC);
+    assert_int_equal(ntohs(b.fib->face->peer.ip4.sin_port), 9001);
+    assert_int_equal(b.contentcnt, 1);
+    for (i = 0; i < 100 && ccnl_run_events() >= 0; i++);
+    assert_int_equal(b.contentcnt, 3);
+    assert_int_equal(ccnl_snapshot_finish(), 3);
+
+    // same order as before, and the counters survive
+    c = b.contents;
+    assert_int_equal(c->pkt->pfx->comp[0][0], 'c');
+    assert_int_equal(c->next->pkt->pfx->comp[0][0], 'b');
+    assert_int_equal(c->next->next->pkt->pfx->comp[0][0], 'a');
+    for (; c; c = c->next) {
+        assert_int_equal(c->served_cnt, c->pkt->pfx->comp[0][0]);
+        assert_false(c->flags & CCNL_CONTENT_FLAGS_STATIC);
+    }
+
+    ccnl_core_cleanup(&b);
+    unlink(path);
+}
+
+void test_snapshot_write_during_restore()
+{
+    char path[] = "/tmp/test_snapshotXXXXXX";
+    struct ccnl_relay_s a;
+    int fd;
+
+    fd = mkstemp(path);
+    assert_true(fd >= 0);
+    close(fd);
+
+    relay_setup(&a);
+    populate(&a);
+    assert_int_equal(ccnl_snapshot_write(&a, path), 3);
+    ccnl_core_cleanup(&a);
+
+    // halted before the restore finished: nothing is lost
+    relay_setup(&a);
+    assert_int_equal(ccnl_snapshot_restore(&a, path), 0);
+    assert_int_equal(a.contentcnt, 1);
+    assert_int_equal(ccnl_snapshot_write(&a, path), 3);
+    assert_int_equal(a.contentcnt, 3);
+    while (ccnl_run_events() >= 0);
+    ccnl_core_cleanup(&a);
+    unlink(path);
+}
+
+void test_snapshot_invalid()
+{
+    char path[] = "/tmp/test_snapshotXXXXXX";
+    struct ccnl_relay_s a;
+    uint8_t junk[64];
+    int fd = mkstemp(path);
+
+    assert_true(fd >= 0);
+    memset(junk, 'x', sizeof(junk));
+    assert_int_equal(write(fd, junk, sizeof(junk)), sizeof(junk));
+    close(fd);
+
+    relay_setup(&a);
+    assert_int_equal(ccnl_snapshot_restore(&a, path), -1);
+    assert_int_equal(ccnl_snapshot_restore(&a, "/nonexistent/snapshot"), -1);
+    assert_null(a.fib);
+    assert_int_equal(a.contentcnt, 0);
+    ccnl_core_cleanup(&a);
+    unlink(path);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_snapshot_roundtrip),
+        unit_test(test_snapshot_write_during_restore),
+        unit_test(test_snapshot_invalid),
+    };
+
+    return run_tests(tests);
+}
@@ -0,0 +1,326 @@
+/**
+ * @file test_verify.c
+ * @brief Tests for the asynchronous signature verification pipeline
+ *
+ * Copyright (C) 2018 Safety IO
+ *
+ * Permission to use, copy, modify, and/or distribute this software for any
+ * purpose with or without fee is hereby granted, provided that the above
+ * copyright notice and this permission notice appear in all copies.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+ * WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+ * MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ * ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+ * WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ * ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+ * OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+ */
+#include <stdarg.h>
+#include <stddef.h>
+#include <setjmp.h>
+#include <cmocka.h>
+
+#include <string.h>
+#include <sys/select.h>
+
+#define USE_SUITE_CCNTLV
+#define USE_SUITE_NDNTLV
+#define USE_HMAC256
+#define USE_VERIFY_POOL
+#define NEEDS_PACKET_CRAFTING   // ccnl_ndntlv_prependSignedContent()
+
+#include "ccnl-core.h"
+#include "ccnl-pkt-ccntlv.h"
+#include "ccnl-pkt-ndntlv.h"
+#include "ccnl-verify.h"
+#include "ccnl-ext-hmac.h"
+
+#define JOBS    40
+
+static const uint8_t good[] = { 'G' }, bad[] = { 'B' };
+
+static pthread_mutex_t calls_lock = PTHREAD_MUTEX_INITIALIZER;
+static int calls, batches;
+static int released, valid, invalid;
+
+// accepts signatures that are "G"
+static void
+fake_verify(void *ctx, size_t n, struct ccnl_verify_job_s *jobs[])
+{
+    size_t i;
+
+    (void) ctx;
+    pthread_mutex_lock(&calls_lock);
+    calls += (int) n;
+    batches++;
+    pthread_mutex_unlock(&calls_lock);
+    for (i = 0; i < n; i++) {
+        jobs[i]->result = jobs[i]->siglen == 1 && jobs[i]->sig[0] == 'G';
+    }
+}
+
+static void
+done(struct ccnl_relay_s *relay, struct ccnl_content_s *c, int faceid,
+     int verified)
+{
+    (void) relay;
+    (void) faceid;
+    released++;
+    if (verified) {
+        valid++;
+    } else {
+        invalid++;
+    }
+    ccnl_content_free(c);
+}
+
+// Data: Name /a, Content "hi" with the last byte varied
+static struct ccnl_content_s*
+mkcontent(uint8_t variant)
+{
+    uint8_t rx[] = { 0x06, 0x09, 0x07, 0x03, 0x08, 0x01, 'a',
+                     0x15, 0x02, 'h', variant };
+    uint8_t *data = rx + 2;
+    size_t datalen = sizeof(rx) - 2;
+    struct ccnl_pkt_s *pkt;
+
+    pkt = ccnl_ndntlv_bytes2pktView(0x06, rx, &data, &datalen);
+    assert_non_null(pkt);
+    return ccnl_content_new(&pkt);
+}
+
+static int
+submit(struct ccnl_verify_s *v, struct ccnl_content_s *c, const uint8_t *sig)
+{
+    struct ccnl_buf_s *buf = c->pkt->buf;
+
+    return ccnl_verify_submitJob(v, c, 7, buf->data, buf->datalen, sig, 1);
+}
+
+// polls like the relay's select() loop until all held Data is released
+static void
+drain(struct ccnl_relay_s *relay, int expected)
+{
+    int fd = ccnl_verify_fd(relay->verify);
+
+    while (released < expected) {
+        fd_set readfs;
+        struct timeval tv = { 2, 0 };
+
+        FD_ZERO(&readfs);
+        FD_SET(fd, &readfs);
+        assert_true(select(fd + 1, &readfs, NULL, NULL, &tv) > 0);
+        ccnl_verify_poll(relay);
+    }
+}
+
+void test_verify_inline()
+{
+    struct ccnl_verify_s *v;
+    struct ccnl_content_s *c1 = mkcontent('1'), *c2 = mkcontent('2');
+    uint8_t keyid[CCNL_VERIFY_KEYID_LEN] = { 1 };
+
+    calls = 0;
+    v = ccnl_verify_new(0, 4, fake_verify, NULL, keyid, done);
+    assert_non_null(v);
+    assert_int_equal(ccnl_verify_fd(v), -1);
+
+    assert_int_equal(submit(v, c1, good), 0);
+    assert_int_equal(submit(v, c2, bad), -1);
+    assert_int_equal(v->fail_cnt, 1);
+    assert_int_equal(calls, 2);
+
+    // c1 was hashed by the first submission, the cache answers now
+    assert_int_equal(submit(v, c1, good), 0);
+    assert_int_equal(calls, 2);
+    assert_int_equal(v->hit_cnt, 1);
+
+    ccnl_content_free(c1);
+    ccnl_content_free(c2);
+    ccnl_verify_free(v);
+}
+
+void test_verify_pool()
+{
+    struct ccnl_relay_s relay;
+    struct ccnl_content_s *c;
+    uint8_t keyid[CCNL_VERIFY_KEYID_LEN] = { 2 };
+    int i;
+
+    memset(&relay, 0, sizeof(relay));
+    calls = batches = released = valid = invalid = 0;
+    relay.verify = ccnl_verify_new(3, 8, fake_verify, NULL, keyid, done);
+    assert_non_null(relay.verify);
+    assert_true(ccnl_verify_fd(relay.verify) >= 0);
+
+    for (i = 0; i < JOBS; i++) {
+        c = mkcontent((uint8_t) i);
+        assert_int_equal(submit(relay.verify, c, i % 4 ? good : bad), 1);
+    }
+    drain(&relay, JOBS);
+    assert_int_equal(valid, JOBS - JOBS / 4);
+    assert_int_equal(invalid, JOBS / 4);
+    assert_int_equal(relay.verify->pending, 0);
+    assert_int_equal(calls, JOBS);
+    assert_true(batches <= JOBS);
+
+    // the same packets again: valid ones come from the cache
+    released = valid = invalid = 0;
+    for (i = 0; i < JOBS; i++) {
+        c = mkcontent((uint8_t) i);
+        assert_int_equal(submit(relay.verify, c, i % 4 ? good : bad), 1);
+    }
+    drain(&relay, JOBS);
+    assert_int_equal(valid, JOBS - JOBS / 4);
+    // the cache is direct mapped, a colliding digest may have evicted one
+    assert_true(relay.verify->hit_cnt > JOBS / 2);
+    assert_int_equal(calls, 2 * JOBS - (int) relay.verify->hit_cnt);
+
+    ccnl_verify_free(relay.verify);
+}
+
+void test_verify_free_pending()
+{
+    uint8_t keyid[CCNL_VERIFY_KEYID_LEN] = { 3 };
+    struct ccnl_verify_s *v;
+    int i;
+
+    v = ccnl_verify_new(2, 4, fake_verify, NULL, keyid, done);
+    assert_non_null(v);
+    for (i = 0; i < 16; i++) {
+        submit(v, mkcontent((uint8_t) i), good);
+    }
+    // held Data is freed with the pipeline, results or not
+    ccnl_verify_free(v);
+}
+
+// Data /a/b signed with keyval, one byte of the content flipped if tamper
+static struct ccnl_content_s*
+mksigned(uint8_t *keyval, int tamper)
+{
+    uint8_t buf[256], *start, *data, payload[] = "signed";
+    char uri[] = "/a/b";
+    struct ccnl_prefix_s *name = ccnl_URItoPrefix(uri, CCNL_SUITE_NDNTLV, NULL);
+    size_t offs = sizeof(buf), len, vallen, contentpos;
+    uint64_t typ;
+    struct ccnl_pkt_s *pkt;
+
+    assert_int_equal(ccnl_ndntlv_prependSignedContent(name, payload,
+                                                      sizeof(payload) - 1,
+                                                      NULL, &contentpos,
+                                                      keyval, NULL, &offs,
+                                                      buf, &len), 0);
+    ccnl_prefix_free(name);
+    start = data = buf + offs;
+    if (tamper) {
+        start[contentpos] ^= 1;
+    }
+    assert_int_equal(ccnl_ndntlv_dehead(&data, &len, &typ, &vallen), 0);
+    pkt = ccnl_ndntlv_bytes2pktView(typ, start, &data, &vallen);
+    assert_non_null(pkt);
+    return ccnl_content_new(&pkt);
+}
+
+void test_verify_hmac()
+{
+    struct ccnl_hmac256_key_s key;
+    struct ccnl_verify_s *v;
+    struct ccnl_verify_job_s job, *jobs[1] = { &job };
+    struct ccnl_content_s *c, *t;
+    uint8_t keyval[64], keyid[CCNL_VERIFY_KEYID_LEN], other[64];
+
+    memset(keyval, 'k', sizeof(keyval));
+    memset(other, 'o', sizeof(other));
+    ccnl_hmac256_keyinit(&key, keyval, sizeof(keyval));
+    ccnl_hmac256_keyid(keyval, sizeof(keyval), keyid);
+    c = mksigned(keyval, 0);
+    t = mksigned(keyval, 1);
+    assert_int_equal(c->pkt->hmacLen, t->pkt->hmacLen);
+    assert_true(c->pkt->hmacLen > 0);
+
+    // the verifier on its own: the signed packet passes, the copy not
+    memset(&job, 0, sizeof(job));
+    job.data = c->pkt->hmacStart;
+    job.datalen = c->pkt->hmacLen;
+    job.sig = c->pkt->hmacSignature;
+    job.siglen = 32;
+    ccnl_hmac256_verifyBatch(&key, 1, jobs);
+    assert_int_equal(job.result, 1);
+    job.data = t->pkt->hmacStart;
+    job.sig = t->pkt->hmacSignature;
+    ccnl_hmac256_verifyBatch(&key, 1, jobs);
+    assert_int_equal(job.result, 0);
+    job.siglen = 31;
+    ccnl_hmac256_verifyBatch(&key, 1, jobs);
+    assert_int_equal(job.result, 0);
+
+    // as the relay submits received Data
+    v = ccnl_verify_new(0, 8, ccnl_hmac256_verifyBatch, &key, keyid, done);
+    assert_int_equal(ccnl_verify_submit(v, c, 1), 0);
+    assert_int_equal(ccnl_verify_submit(v, t, 1), -1);
+    assert_int_equal(v->fail_cnt, 1);
+    ccnl_content_free(t);
+
+    // the same packet signed with another key
+    t = mksigned(other, 0);
+    assert_int_equal(ccnl_verify_submit(v, t, 1), -1);
+    ccnl_content_free(t);
+
+    // Data without a signature only passes when asked for
+    t = mkcontent('u');
+    assert_int_equal(ccnl_verify_submit(v, t, 1), -1);
+    assert_int_equal(v->unsigned_cnt, 1);
+    v->accept_unsigned = true;
+    assert_int_equal(ccnl_verify_submit(v, t, 1), 0);
+    ccnl_content_free(t);
+
+    ccnl_content_free(c);
+    ccnl_verify_free(v);
+}
+
+void test_verify_ccntlv_signed()
+{
+    uint8_t buf[512], keyval[64], md[32], payload[] = "signed", *start, *data;
+    char uri[] = "/a/b";
+    struct ccnl_prefix_s *name = ccnl_URItoPrefix(uri, CCNL_SUITE_CCNTLV, NULL);
+    struct ccnx_tlvhdr_ccnx2015_s *hp;
+    struct ccnl_pkt_s *pkt;
+    size_t offs = sizeof(buf), len, hdrlen, mdlen = sizeof(md);
+
+    memset(keyval, 'k', sizeof(keyval));
+    assert_int_equal(ccnl_ccntlv_prependSignedContentWithHdr(name, payload,
+                                                sizeof(payload) - 1, NULL,
+                                                NULL, keyval, NULL, &offs,
+                                                buf, &len), 0);
+    ccnl_prefix_free(name);
+
+    // the packet length of the fixed header covers the validation TLVs
+    start = data = buf + offs;
+    hp = (struct ccnx_tlvhdr_ccnx2015_s *) start;
+    assert_int_equal(ntohs(hp->pktlen), len);
+
+    assert_int_equal(ccnl_ccntlv_getHdrLen(data, len, &hdrlen), 0);
+    data += hdrlen;
+    len -= hdrlen;
+    pkt = ccnl_ccntlv_bytes2pkt(start, &data, &len);
+    assert_non_null(pkt);
+    assert_true(pkt->hmacLen > 0);
+    ccnl_hmac256_sign(keyval, sizeof(keyval), pkt->hmacStart, pkt->hmacLen,
+                      md, &mdlen);
+    assert_memory_equal(md, pkt->hmacSignature, sizeof(md));
+    ccnl_pkt_free(pkt);
+}
+
+int main(void)
+{
+    const UnitTest tests[] = {
+        unit_test(test_verify_inline),
+        unit_test(test_verify_pool),
+        unit_test(test_verify_free_pending),
+        unit_test(test_verify_hmac),
+        unit_test(test_verify_ccntlv_signed),
+    };
+
+    return run_tests(tests);
+}